@@ -0,0 +1,113 @@
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "cpuRaytracer.hpp"
+#include "cpuScene.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t IMAGE_WIDTH = 256;
+const uint32_t IMAGE_HEIGHT = 192;
+const uint32_t NB_PIXELS = IMAGE_WIDTH * IMAGE_HEIGHT;
+const uint32_t REFERENCE_NB_SAMPLES = 256;
+const uint32_t UNIFORM_NB_SAMPLES[] = {8, 16, 32, 64};
+const uint32_t ADAPTIVE_MAX_NB_SAMPLES[] = {8, 16, 32, 64, 128};
+const float ERROR_TARGETS[] = {0.05f, 0.01f};
+const uint32_t MIN_NB_SAMPLES = 4;
+
+struct Run {
+    std::string _Name;
+    uint64_t _NbRays;
+    double _Rmse;
+    double _Time;
+};
+
+
+///// helpers
+CpuScenePtr initScene(){
+    std::vector<Material> materials = {Material(), Material({0.2, 0.3, 0.1, 1.})};
+    MeshPtr mesh = Mesh::load(Mesh::MODELS_DIRECTORY + "teapot.obj");
+    mesh->setMaterial(1);
+    return CpuScenePtr(new CpuScene({mesh}, materials));
+}
+
+double getRmse(const std::vector<glm::vec4>& image, const std::vector<glm::vec4>& reference){
+    double error = 0.;
+    for(size_t i=0; i<image.size(); i++){
+        glm::vec3 difference = glm::vec3(image[i] - reference[i]);
+        error += glm::dot(difference, difference);
+    }
+    return std::sqrt(error / image.size());
+}
+
+Run render(CpuRaytracer& raytracer, const CameraGPU& camera, const AdaptiveSamplingParameters& sampling, const std::vector<glm::vec4>& reference, const std::string& name){
+    raytracer._Parameters._Sampling = sampling;
+    std::vector<glm::vec4> image = raytracer.render(camera);
+    return {name, raytracer._Statistics._NbRays, getRmse(image, reference), raytracer._Statistics._RenderTime};
+}
+
+void printRun(const Run& run){
+    fprintf(stdout, "\t%-28s %7.2f spp %10.3e rmse %9.2f ms\n", run._Name.c_str(), static_cast<double>(run._NbRays) / NB_PIXELS, run._Rmse, 1000. * run._Time);
+}
+
+
+///// benchmarks
+void benchmarkAdaptiveSampling(const char* workload, bool isWireframeModeOn){
+    CpuRaytracerParameters parameters{IMAGE_WIDTH, IMAGE_HEIGHT};
+    parameters._IsWireframeModeOn = isWireframeModeOn;
+    CpuRaytracer raytracer = CpuRaytracer(initScene(), parameters);
+    Camera camera = Camera(glm::vec3(0.f, 0.f, -5.f), static_cast<float>(IMAGE_WIDTH) / IMAGE_HEIGHT);
+    CameraGPU cameraGPU = camera.getGpuData();
+
+    raytracer._Parameters._Sampling = {false, 0.f, 1, REFERENCE_NB_SAMPLES};
+    std::vector<glm::vec4> reference = raytracer.render(cameraGPU);
+
+    fprintf(stdout, "\n%s, %ux%u, error against %u uniform spp:\n", workload, IMAGE_WIDTH, IMAGE_HEIGHT, REFERENCE_NB_SAMPLES);
+    std::vector<Run> uniformRuns{};
+    for(uint32_t nbSamples : UNIFORM_NB_SAMPLES){
+        uniformRuns.push_back(render(raytracer, cameraGPU, {false, 0.f, 1, nbSamples}, reference, "uniform " + std::to_string(nbSamples)));
+        printRun(uniformRuns.back());
+    }
+    std::vector<Run> adaptiveRuns{};
+    for(uint32_t maxNbSamples : ADAPTIVE_MAX_NB_SAMPLES){
+        for(float errorTarget : ERROR_TARGETS){
+            char name[64];
+            snprintf(name, sizeof(name), "adaptive max %u target %.2f", maxNbSamples, errorTarget);
+            adaptiveRuns.push_back(render(raytracer, cameraGPU, {true, errorTarget, MIN_NB_SAMPLES, maxNbSamples}, reference, name));
+            printRun(adaptiveRuns.back());
+        }
+    }
+
+    // cheapest adaptive run at least as good as each uniform one
+    for(const Run& uniform : uniformRuns){
+        const Run* best = nullptr;
+        for(const Run& adaptive : adaptiveRuns){
+            if(adaptive._Rmse <= uniform._Rmse && (best == nullptr || adaptive._NbRays < best->_NbRays)){
+                best = &adaptive;
+            }
+        }
+        if(best == nullptr){
+            fprintf(stdout, "\tno adaptive run reaches the error of %s\n", uniform._Name.c_str());
+            continue;
+        }
+        fprintf(stdout, "\t%s matched by %s with %.1f%% of the rays\n",
+            uniform._Name.c_str(), best->_Name.c_str(), 100. * best->_NbRays / uniform._NbRays
+        );
+    }
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    benchmarkAdaptiveSampling("Teapot", false);
+    // many more edges to antialias
+    benchmarkAdaptiveSampling("Teapot wireframe", true);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
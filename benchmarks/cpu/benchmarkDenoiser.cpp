@@ -0,0 +1,159 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "cpuRaytracer.hpp"
+#include "cpuScene.hpp"
+#include "denoiser.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t IMAGE_WIDTH = 256;
+const uint32_t IMAGE_HEIGHT = 192;
+const uint32_t NB_PIXELS = IMAGE_WIDTH * IMAGE_HEIGHT;
+// ambient occlusion is the noisiest estimator the cpu raytracer can afford
+const uint32_t REFERENCE_NB_SAMPLES = 256;
+const uint32_t NB_SAMPLES[] = {1, 4, 16, 64};
+const uint32_t NB_ITERATIONS[] = {1, 3, 5};
+const float AMBIENT_OCCLUSION_DISTANCE = 2.f;
+// same offset as shaders/wavefront/shading.glsl
+const float RAY_OFFSET = 1e-4f;
+
+
+///// helpers
+CpuScenePtr initScene(){
+    std::vector<Material> materials = {Material(), Material({0.2, 0.3, 0.1, 1.}), Material({0.8, 0.8, 0.8, 1.})};
+    MeshPtr teapot = Mesh::load(Mesh::MODELS_DIRECTORY + "teapot.obj");
+    teapot->setMaterial(1);
+    // the teapot stands on a large floor
+    MeshPtr floor = Mesh::primitiveSquare();
+    floor->setModel(glm::mat4(
+        glm::vec4(8.f, 0.f, 0.f, 0.f),
+        glm::vec4(0.f, 0.f, 8.f, 0.f),
+        glm::vec4(0.f, 1.f, 0.f, 0.f),
+        glm::vec4(0.f, 0.f, 0.f, 1.f)
+    ));
+    floor->setMaterial(2);
+    return CpuScenePtr(new CpuScene({teapot, floor}, materials));
+}
+
+Camera initCamera(){
+    Camera camera = Camera(glm::vec3(0.f, 4.f, -8.f), static_cast<float>(IMAGE_WIDTH) / IMAGE_HEIGHT);
+    // looks down on the floor
+    camera.ProcessMouseMovement(0.f, 200.f);
+    return camera;
+}
+
+double getRmse(const std::vector<glm::vec4>& image, const std::vector<glm::vec4>& reference){
+    double error = 0.;
+    for(size_t i=0; i<image.size(); i++){
+        glm::vec3 difference = glm::vec3(image[i] - reference[i]);
+        error += glm::dot(difference, difference);
+    }
+    return std::sqrt(error / image.size());
+}
+
+// albedo times the unoccluded part of the cosine weighted hemisphere, in seconds
+double renderAmbientOcclusion(const CpuRaytracer& raytracer, const CameraGPU& camera, const std::vector<DenoiserGuide>& guides,
+    uint32_t nbSamples, uint32_t seed, std::vector<glm::vec4>& image){
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> distrib(0.f, 1.f);
+    std::vector<Ray> rays{};
+    std::vector<uint32_t> rayPixels{};
+    for(uint32_t y=0; y<IMAGE_HEIGHT; y++){
+        for(uint32_t x=0; x<IMAGE_WIDTH; x++){
+            const DenoiserGuide& guide = guides[y * IMAGE_WIDTH + x];
+            if(guide._Normal == glm::vec3(0.f)){
+                continue;
+            }
+            glm::vec2 pos = glm::vec2(static_cast<float>(x) / IMAGE_WIDTH, static_cast<float>(y) / IMAGE_HEIGHT);
+            Ray primaryRay = CpuRaytracer::getRay(camera, pos);
+            glm::vec3 position = primaryRay._Origin + primaryRay._Direction * guide._Depth;
+            glm::vec3 absPosition = glm::abs(position);
+            glm::vec3 origin = position + guide._Normal * RAY_OFFSET * std::max(1.f, std::max(absPosition.x, std::max(absPosition.y, absPosition.z)));
+            glm::vec3 tangent = glm::normalize(glm::cross(std::abs(guide._Normal.x) > 0.9f ? glm::vec3(0.f, 1.f, 0.f) : glm::vec3(1.f, 0.f, 0.f), guide._Normal));
+            glm::vec3 bitangent = glm::cross(guide._Normal, tangent);
+            for(uint32_t i=0; i<nbSamples; i++){
+                float r = std::sqrt(distrib(gen));
+                float phi = 2.f * static_cast<float>(M_PI) * distrib(gen);
+                glm::vec3 direction = r * std::cos(phi) * tangent + r * std::sin(phi) * bitangent + std::sqrt(std::max(0.f, 1.f - r * r)) * guide._Normal;
+                rays.push_back({origin, direction, AMBIENT_OCCLUSION_DISTANCE});
+                rayPixels.push_back(y * IMAGE_WIDTH + x);
+            }
+        }
+    }
+
+    std::unique_ptr<bool[]> areOccluded = std::unique_ptr<bool[]>(new bool[rays.size()]);
+    auto start = std::chrono::steady_clock::now();
+    raytracer.traceAnyHit(rays, std::span<bool>(areOccluded.get(), rays.size()));
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    image = std::vector<glm::vec4>(NB_PIXELS, glm::vec4(0.f, 0.f, 0.f, 1.f));
+    for(size_t i=0; i<rays.size(); i++){
+        if(!areOccluded[i]){
+            image[rayPixels[i]] += glm::vec4(guides[rayPixels[i]]._Albedo / static_cast<float>(nbSamples), 0.f);
+        }
+    }
+    return elapsed.count();
+}
+
+
+///// benchmarks
+void benchmarkDenoiser(){
+    CpuRaytracer raytracer = CpuRaytracer(initScene(), {IMAGE_WIDTH, IMAGE_HEIGHT});
+    CameraGPU camera = initCamera().getGpuData();
+    std::vector<DenoiserGuide> guides = raytracer.renderGuides(camera);
+    std::vector<glm::vec4> reference{};
+    renderAmbientOcclusion(raytracer, camera, guides, REFERENCE_NB_SAMPLES, 0, reference);
+
+    fprintf(stdout, "\nAmbient occlusion, %ux%u, error against %u spp:\n", IMAGE_WIDTH, IMAGE_HEIGHT, REFERENCE_NB_SAMPLES);
+    fprintf(stdout, "\t%-28s %10s %12s %12s\n", "", "rmse", "trace ms", "denoise ms");
+    double denoisedRmse = 0.;
+    std::vector<double> noisyRmses{};
+    for(uint32_t nbSamples : NB_SAMPLES){
+        std::vector<glm::vec4> image{};
+        double traceTime = renderAmbientOcclusion(raytracer, camera, guides, nbSamples, nbSamples, image);
+        noisyRmses.push_back(getRmse(image, reference));
+        std::string name = std::to_string(nbSamples) + " spp";
+        fprintf(stdout, "\t%-28s %10.3e %12.2f %12s\n", name.c_str(), noisyRmses.back(), 1000. * traceTime, "-");
+
+        for(uint32_t nbIterations : NB_ITERATIONS){
+            Denoiser denoiser = Denoiser(IMAGE_WIDTH, IMAGE_HEIGHT, {._IsOn = true, ._NbIterations = nbIterations});
+            auto start = std::chrono::steady_clock::now();
+            std::vector<glm::vec4> denoisedImage = denoiser.denoise(image, guides);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            double rmse = getRmse(denoisedImage, reference);
+            if(nbSamples == 1 && nbIterations == NB_ITERATIONS[std::size(NB_ITERATIONS) - 1]){
+                denoisedRmse = rmse;
+            }
+            std::string denoisedName = name + ", " + std::to_string(nbIterations) + " iterations";
+            fprintf(stdout, "\t%-28s %10.3e %12.2f %12.2f\n", denoisedName.c_str(), rmse, 1000. * traceTime, 1000. * elapsed.count());
+        }
+    }
+
+    // most samples the denoised image still beats without the denoiser
+    uint32_t nbBeatenSamples = 0;
+    for(size_t i=0; i<noisyRmses.size(); i++){
+        if(noisyRmses[i] > denoisedRmse){
+            nbBeatenSamples = NB_SAMPLES[i];
+        }
+    }
+    fprintf(stdout, "\t1 spp denoised is better than %u spp\n", nbBeatenSamples);
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    benchmarkDenoiser();
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
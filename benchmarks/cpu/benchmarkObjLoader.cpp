@@ -0,0 +1,114 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <tiny_obj_loader.h>
+
+#include "meshCache.hpp"
+#include "objLoader.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t NB_REPETITIONS = 3;
+// two triangles per cell, about 10M faces
+const uint32_t SYNTHETIC_GRID_SIZE = 2237;
+
+
+///// helpers
+// best of a few runs, in seconds
+double measure(const std::function<void()>& run){
+    double best = INFINITY;
+    for(uint32_t i=0; i<NB_REPETITIONS; i++){
+        auto start = std::chrono::steady_clock::now();
+        run();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// a bumpy height field, written like the output of a scanner
+std::string writeSyntheticObj(){
+    std::string path = (std::filesystem::temp_directory_path() / "benchmarkObjLoader.obj").string();
+    FILE* file = fopen(path.c_str(), "w");
+    fprintf(file, "# synthetic grid of %u x %u vertices\n", SYNTHETIC_GRID_SIZE, SYNTHETIC_GRID_SIZE);
+    for(uint32_t y=0; y<SYNTHETIC_GRID_SIZE; y++){
+        for(uint32_t x=0; x<SYNTHETIC_GRID_SIZE; x++){
+            float height = 0.05f * std::sin(0.1f * x) * std::cos(0.13f * y);
+            fprintf(file, "v %.6f %.6f %.6f\n", static_cast<float>(x) / SYNTHETIC_GRID_SIZE, height, static_cast<float>(y) / SYNTHETIC_GRID_SIZE);
+        }
+    }
+    for(uint32_t y=0; y+1<SYNTHETIC_GRID_SIZE; y++){
+        for(uint32_t x=0; x+1<SYNTHETIC_GRID_SIZE; x++){
+            uint32_t v = y * SYNTHETIC_GRID_SIZE + x + 1;
+            fprintf(file, "f %u %u %u\n", v, v + SYNTHETIC_GRID_SIZE, v + 1);
+            fprintf(file, "f %u %u %u\n", v + 1, v + SYNTHETIC_GRID_SIZE, v + SYNTHETIC_GRID_SIZE + 1);
+        }
+    }
+    fclose(file);
+    return path;
+}
+
+// what Mesh::load used to do
+size_t loadTinyObj(const std::string& path){
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+    tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str());
+    size_t nbIndices = 0;
+    for(const tinyobj::shape_t& shape : shapes){
+        nbIndices += shape.mesh.indices.size();
+    }
+    return nbIndices / 3;
+}
+
+
+///// benchmarks
+void benchmarkLoad(const std::string& name, const std::string& path){
+    size_t fileSize = std::filesystem::file_size(path);
+    size_t nbTriangles = 0;
+    double tinyObj = measure([&](){
+        nbTriangles = loadTinyObj(path);
+    });
+    MeshPtr parsed = nullptr;
+    double objLoader = measure([&](){
+        parsed = ObjLoader::load(path);
+    });
+    // mapping and checking the blocks, the pages are likely in the os cache
+    MeshCache::write(path, *parsed);
+    size_t cacheSize = std::filesystem::file_size(MeshCache::getPath(path));
+    double meshCache = measure([&](){
+        MeshPtr mesh = MeshCache::load(path);
+        if(mesh == nullptr || mesh->getNbTriangles() != nbTriangles || parsed->getNbTriangles() != nbTriangles){
+            fprintf(stderr, "\tThe loaders don't read the same number of triangles!\n");
+        }
+    });
+    std::filesystem::remove(MeshCache::getPath(path));
+    fprintf(stdout, "\n%s, %zu triangles, %.1f MB:\n", name.c_str(), nbTriangles, fileSize / 1e6);
+    fprintf(stdout, "\t%-12s %10.2f ms %8.1f MB/s\n", "tinyobj", 1000. * tinyObj, fileSize / tinyObj / 1e6);
+    fprintf(stdout, "\t%-12s %10.2f ms %8.1f MB/s (%.2fx)\n", "objLoader", 1000. * objLoader, fileSize / objLoader / 1e6, tinyObj / objLoader);
+    fprintf(stdout, "\t%-12s %10.2f ms %8.1f MB/s (%.2fx), %.1f MB of cache\n", "meshCache", 1000. * meshCache, cacheSize / meshCache / 1e6, tinyObj / meshCache, cacheSize / 1e6);
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    benchmarkLoad("stanford-bunny.obj", Mesh::MODELS_DIRECTORY + "stanford-bunny.obj");
+
+    std::string syntheticPath = writeSyntheticObj();
+    benchmarkLoad("synthetic grid", syntheticPath);
+    std::filesystem::remove(syntheticPath);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
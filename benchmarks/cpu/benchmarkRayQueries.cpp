@@ -0,0 +1,130 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cpuRaytracer.hpp"
+#include "cpuScene.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t NB_RAYS = 1 << 20;
+const uint32_t NB_REPETITIONS = 3;
+const uint32_t IMAGE_WIDTH = 1024;
+const uint32_t IMAGE_HEIGHT = NB_RAYS / IMAGE_WIDTH;
+
+
+///// helpers
+CpuScenePtr initScene(const std::string& model, float scale){
+    std::vector<Material> materials = {Material(), Material({0.2, 0.3, 0.1, 1.})};
+    MeshPtr mesh = Mesh::load(Mesh::MODELS_DIRECTORY + model);
+    mesh->setScale(scale);
+    mesh->setMaterial(1);
+    return CpuScenePtr(new CpuScene({mesh}, materials));
+}
+
+// best of a few runs, in seconds
+double measure(const std::function<void()>& run){
+    double best = INFINITY;
+    for(uint32_t i=0; i<NB_REPETITIONS; i++){
+        auto start = std::chrono::steady_clock::now();
+        run();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+void printRaysPerSecond(const char* name, double time){
+    fprintf(stdout, "\t%-24s %8.2f ms %8.2f Mrays/s\n", name, 1000. * time, NB_RAYS / time / 1e6);
+}
+
+// rays from around the scene towards it, in random order
+std::vector<Ray> initIncoherentRays(std::mt19937& gen){
+    std::uniform_real_distribution<float> distrib(-1.f, 1.f);
+    std::vector<Ray> rays{};
+    rays.reserve(NB_RAYS);
+    for(uint32_t i=0; i<NB_RAYS; i++){
+        glm::vec3 origin = 6.f * glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        glm::vec3 target = glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        rays.push_back({origin, glm::normalize(target - origin)});
+    }
+    return rays;
+}
+
+// primary rays of an image, shuffled as if they came from an unordered tool
+std::vector<Ray> initShuffledPrimaryRays(std::mt19937& gen){
+    Camera camera = Camera(glm::vec3(0.f, 0.f, -5.f), static_cast<float>(IMAGE_WIDTH) / IMAGE_HEIGHT);
+    CameraGPU cameraGPU = camera.getGpuData();
+    std::vector<Ray> rays{};
+    rays.reserve(NB_RAYS);
+    for(uint32_t y=0; y<IMAGE_HEIGHT; y++){
+        for(uint32_t x=0; x<IMAGE_WIDTH; x++){
+            glm::vec2 pos = glm::vec2(static_cast<float>(x) / IMAGE_WIDTH, static_cast<float>(y) / IMAGE_HEIGHT);
+            rays.push_back(CpuRaytracer::getRay(cameraGPU, pos));
+        }
+    }
+    std::shuffle(rays.begin(), rays.end(), gen);
+    return rays;
+}
+
+
+///// benchmarks
+void benchmarkQueries(const char* workload, const CpuRaytracer& raytracer, const std::vector<Ray>& rays){
+    fprintf(stdout, "\n%s, %u rays:\n", workload, NB_RAYS);
+    std::vector<Hit> hits = std::vector<Hit>(rays.size());
+    std::unique_ptr<bool[]> areOccluded = std::unique_ptr<bool[]>(new bool[rays.size()]);
+    std::span<bool> occlusions = std::span<bool>(areOccluded.get(), rays.size());
+
+    // one ray at a time in the given order, the baseline
+    double singleClosest = measure([&](){
+        #pragma omp parallel for schedule(dynamic, 64)
+        for(size_t i=0; i<rays.size(); i++){
+            hits[i] = raytracer.traceClosest(Intersection::setupRay(rays[i]), rays[i]._TMax);
+        }
+    });
+    double batchedClosest = measure([&](){
+        raytracer.traceClosest(rays, hits);
+    });
+    double singleAnyHit = measure([&](){
+        #pragma omp parallel for schedule(dynamic, 64)
+        for(size_t i=0; i<rays.size(); i++){
+            occlusions[i] = raytracer.traceAnyHit(Intersection::setupRay(rays[i]), 0.f, rays[i]._TMax);
+        }
+    });
+    double batchedAnyHit = measure([&](){
+        raytracer.traceAnyHit(rays, occlusions);
+    });
+
+    printRaysPerSecond("closest, single rays", singleClosest);
+    printRaysPerSecond("closest, batched", batchedClosest);
+    printRaysPerSecond("any hit, single rays", singleAnyHit);
+    printRaysPerSecond("any hit, batched", batchedAnyHit);
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    std::mt19937 gen(42);
+    std::vector<Ray> incoherentRays = initIncoherentRays(gen);
+    std::vector<Ray> primaryRays = initShuffledPrimaryRays(gen);
+
+    // the bunny is about 0.15 units large
+    const std::pair<std::string, float> scenes[] = {{"teapot.obj", 1.f}, {"stanford-bunny.obj", 15.f}};
+    for(const auto& [model, scale] : scenes){
+        fprintf(stdout, "\n===== %s =====\n", model.c_str());
+        CpuRaytracer raytracer = CpuRaytracer(initScene(model, scale), {IMAGE_WIDTH, IMAGE_HEIGHT});
+        benchmarkQueries("Incoherent rays", raytracer, incoherentRays);
+        benchmarkQueries("Shuffled primary rays", raytracer, primaryRays);
+    }
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
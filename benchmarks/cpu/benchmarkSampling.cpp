@@ -0,0 +1,108 @@
+#include <iostream>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "sampler.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t NB_PIXELS_X = 32;
+const uint32_t NB_PIXELS_Y = 32;
+const uint32_t MAX_NB_SAMPLES = 1024;
+// dimensions of a second bounce, as read by shaders/wavefront/shading.glsl
+const uint32_t DIMENSION = 2;
+const SamplerType SAMPLER_TYPES[] = {SAMPLER_WHITE_NOISE, SAMPLER_SOBOL, SAMPLER_RANK1_LATTICE, SAMPLER_BLUE_NOISE};
+const char* SAMPLER_NAMES[] = {"white noise", "sobol", "rank-1 lattice", "blue noise"};
+
+struct Integrand {
+    const char* _Name;
+    std::function<float(const glm::vec2&)> _Function;
+    double _Reference;
+};
+
+
+///// helpers
+// root mean square error over the pixels of the estimates with 1 to MAX_NB_SAMPLES samples
+std::vector<double> getErrors(const Sampler& sampler, const Integrand& integrand){
+    std::vector<double> errors(MAX_NB_SAMPLES + 1, 0.);
+    for(uint32_t y=0; y<NB_PIXELS_Y; y++){
+        for(uint32_t x=0; x<NB_PIXELS_X; x++){
+            double sum = 0.;
+            for(uint32_t i=0; i<MAX_NB_SAMPLES; i++){
+                sum += integrand._Function(sampler.get2D(glm::uvec2(x, y), i, DIMENSION));
+                double difference = sum / (i + 1) - integrand._Reference;
+                errors[i + 1] += difference * difference;
+            }
+        }
+    }
+    for(double& error : errors){
+        error = std::sqrt(error / (NB_PIXELS_X * NB_PIXELS_Y));
+    }
+    return errors;
+}
+
+// fewest samples for which the error stays under the target
+uint32_t getNbSamplesToReach(const std::vector<double>& errors, double target){
+    for(uint32_t n=MAX_NB_SAMPLES; n>=1; n--){
+        if(errors[n] > target){
+            return n == MAX_NB_SAMPLES ? 0 : n + 1;
+        }
+    }
+    return 1;
+}
+
+
+///// benchmarks
+void benchmarkIntegrand(Sampler& sampler, const Integrand& integrand){
+    std::vector<std::vector<double>> errors{};
+    for(SamplerType type : SAMPLER_TYPES){
+        sampler.setSamplerType(type);
+        errors.push_back(getErrors(sampler, integrand));
+    }
+
+    fprintf(stdout, "\n%s, rmse over %u pixels:\n", integrand._Name, NB_PIXELS_X * NB_PIXELS_Y);
+    fprintf(stdout, "\t%-16s", "spp");
+    for(uint32_t n=4; n<=MAX_NB_SAMPLES; n*=4){
+        fprintf(stdout, " %9u", n);
+    }
+    fprintf(stdout, "\n");
+    for(size_t s=0; s<errors.size(); s++){
+        fprintf(stdout, "\t%-16s", SAMPLER_NAMES[s]);
+        for(uint32_t n=4; n<=MAX_NB_SAMPLES; n*=4){
+            fprintf(stdout, " %9.2e", errors[s][n]);
+        }
+        fprintf(stdout, "\n");
+    }
+
+    // the noise of white noise at a few sample counts, 0 means not reached
+    for(uint32_t reference : {64u, 256u, 1024u}){
+        double target = errors[0][reference];
+        fprintf(stdout, "\tspp to reach the error of %u white noise samples (%.2e):", reference, target);
+        for(size_t s=1; s<errors.size(); s++){
+            fprintf(stdout, " %s %u,", SAMPLER_NAMES[s], getNbSamplesToReach(errors[s], target));
+        }
+        fprintf(stdout, "\n");
+    }
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    Sampler sampler = Sampler();
+    const Integrand integrands[] = {
+        // smooth, like the cosine term of a diffuse bounce
+        {"smooth", [](const glm::vec2& u){return std::sqrt(1.f - u.x) * std::cos(2.f * static_cast<float>(M_PI) * u.y) + u.x * u.y;}, 0.25},
+        // discontinuous, like the edge of an occluder
+        {"discontinuous", [](const glm::vec2& u){return u.x * u.x + u.y * u.y < 0.5f ? 1.f : 0.f;}, M_PI / 8.},
+    };
+    for(const Integrand& integrand : integrands){
+        benchmarkIntegrand(sampler, integrand);
+    }
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
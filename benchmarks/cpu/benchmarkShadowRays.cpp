@@ -0,0 +1,140 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cpuRaytracer.hpp"
+#include "cpuScene.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t NB_REPETITIONS = 3;
+const uint32_t IMAGE_WIDTH = 1024;
+const uint32_t IMAGE_HEIGHT = 1024;
+// same light and offset as shaders/wavefront/shading.glsl
+const glm::vec3 SUN_DIRECTION = glm::normalize(glm::vec3(0.3f, 1.f, -0.5f));
+const float RAY_OFFSET = 1e-4f;
+// ambient occlusion rays only look for nearby geometry
+const uint32_t NB_AMBIENT_OCCLUSION_RAYS = 4;
+const float AMBIENT_OCCLUSION_DISTANCE = 0.5f;
+
+
+///// helpers
+CpuScenePtr initScene(const std::string& model, float scale){
+    std::vector<Material> materials = {Material(), Material({0.2, 0.3, 0.1, 1.})};
+    MeshPtr mesh = Mesh::load(Mesh::MODELS_DIRECTORY + model);
+    mesh->setScale(scale);
+    mesh->setMaterial(1);
+    return CpuScenePtr(new CpuScene({mesh}, materials));
+}
+
+// best of a few runs, in seconds
+double measure(const std::function<void()>& run){
+    double best = INFINITY;
+    for(uint32_t i=0; i<NB_REPETITIONS; i++){
+        auto start = std::chrono::steady_clock::now();
+        run();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+void printRaysPerSecond(const char* name, size_t nbRays, double time){
+    fprintf(stdout, "\t%-24s %8.2f ms %8.2f Mrays/s\n", name, 1000. * time, nbRays / time / 1e6);
+}
+
+// shadow and ambient occlusion rays leaving the visible surfaces
+void initOcclusionRays(const CpuScenePtr& scene, const CpuRaytracer& raytracer, std::vector<Ray>& shadowRays, std::vector<Ray>& ambientOcclusionRays){
+    Camera camera = Camera(glm::vec3(0.f, 0.f, -5.f), static_cast<float>(IMAGE_WIDTH) / IMAGE_HEIGHT);
+    CameraGPU cameraGPU = camera.getGpuData();
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> distrib(0.f, 1.f);
+    for(uint32_t y=0; y<IMAGE_HEIGHT; y++){
+        for(uint32_t x=0; x<IMAGE_WIDTH; x++){
+            glm::vec2 pos = glm::vec2(static_cast<float>(x) / IMAGE_WIDTH, static_cast<float>(y) / IMAGE_HEIGHT);
+            Ray ray = CpuRaytracer::getRay(cameraGPU, pos);
+            Hit hit = raytracer.traceClosest(Intersection::setupRay(ray), INFINITY);
+            if(!hit._DidHit){
+                continue;
+            }
+
+            // geometric normal facing the ray
+            glm::vec3 p0, p1, p2;
+            scene->getTriangleVertices(hit._InstanceId, hit._TriangleId, p0, p1, p2);
+            glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+            if(glm::dot(normal, ray._Direction) > 0.f){
+                normal = -normal;
+            }
+            glm::vec3 position = ray._Origin + ray._Direction * hit._Coords.w;
+            glm::vec3 absPosition = glm::abs(position);
+            glm::vec3 origin = position + normal * RAY_OFFSET * std::max(1.f, std::max(absPosition.x, std::max(absPosition.y, absPosition.z)));
+
+            if(glm::dot(normal, SUN_DIRECTION) > 0.f){
+                shadowRays.push_back({origin, SUN_DIRECTION});
+            }
+            // uniform directions in the hemisphere of the normal
+            for(uint32_t i=0; i<NB_AMBIENT_OCCLUSION_RAYS; i++){
+                float cosTheta = distrib(gen);
+                float sinTheta = std::sqrt(1.f - cosTheta * cosTheta);
+                float phi = 2.f * static_cast<float>(M_PI) * distrib(gen);
+                glm::vec3 tangent = glm::normalize(glm::cross(std::abs(normal.x) > 0.9f ? glm::vec3(0.f, 1.f, 0.f) : glm::vec3(1.f, 0.f, 0.f), normal));
+                glm::vec3 bitangent = glm::cross(normal, tangent);
+                glm::vec3 direction = sinTheta * (std::cos(phi) * tangent + std::sin(phi) * bitangent) + cosTheta * normal;
+                ambientOcclusionRays.push_back({origin, direction, AMBIENT_OCCLUSION_DISTANCE});
+            }
+        }
+    }
+}
+
+
+///// benchmarks
+void benchmarkOcclusion(const char* workload, const CpuRaytracer& raytracer, const std::vector<Ray>& rays){
+    std::unique_ptr<bool[]> areOccluded = std::unique_ptr<bool[]>(new bool[rays.size()]);
+
+    // occlusion answered by the closest hit, as the connect kernel used to do
+    double closest = measure([&](){
+        #pragma omp parallel for schedule(dynamic, 64)
+        for(size_t i=0; i<rays.size(); i++){
+            areOccluded[i] = raytracer.traceClosest(Intersection::setupRay(rays[i]), rays[i]._TMax)._DidHit;
+        }
+    });
+    double anyHit = measure([&](){
+        #pragma omp parallel for schedule(dynamic, 64)
+        for(size_t i=0; i<rays.size(); i++){
+            areOccluded[i] = raytracer.traceAnyHit(Intersection::setupRay(rays[i]), 0.f, rays[i]._TMax);
+        }
+    });
+
+    size_t nbOccluded = std::count(areOccluded.get(), areOccluded.get() + rays.size(), true);
+    fprintf(stdout, "\n%s, %zu rays, %.1f%% occluded:\n", workload, rays.size(), 100. * nbOccluded / std::max<size_t>(rays.size(), 1));
+    printRaysPerSecond("closest hit", rays.size(), closest);
+    printRaysPerSecond("any hit", rays.size(), anyHit);
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    // the bunny is about 0.15 units large
+    const std::pair<std::string, float> scenes[] = {{"teapot.obj", 1.f}, {"stanford-bunny.obj", 15.f}};
+    for(const auto& [model, scale] : scenes){
+        fprintf(stdout, "\n===== %s =====\n", model.c_str());
+        CpuScenePtr scene = initScene(model, scale);
+        CpuRaytracer raytracer = CpuRaytracer(scene, {IMAGE_WIDTH, IMAGE_HEIGHT});
+        std::vector<Ray> shadowRays{};
+        std::vector<Ray> ambientOcclusionRays{};
+        initOcclusionRays(scene, raytracer, shadowRays, ambientOcclusionRays);
+        benchmarkOcclusion("Shadow rays", raytracer, shadowRays);
+        benchmarkOcclusion("Ambient occlusion rays", raytracer, ambientOcclusionRays);
+    }
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -3,23 +3,26 @@
 BUILD_DIR=build
 MAIN_PRGM_OPENGL=srcOpenGL/appVersionOpenGL
 MAIN_PRGM_VULKAN=srcVulkan/appVersionVulkan
+MAIN_PRGM_CPU=srcCpu/appVersionCpu
 
 # Default to OpenGL
 use_opengl=true
+use_cpu=false
 compile=true  # Default to compile before running
 
 # Function to display help message
 usage() {
-  echo "Usage: $0 [-v] [-g] [-r] [-h|--help]"
+  echo "Usage: $0 [-v] [-g] [-c] [-r] [-h|--help]"
   echo "  -v        Use Vulkan version"
   echo "  -g        Use OpenGL version (default)"
+  echo "  -c        Use the headless CPU version"
   echo "  -r        Run only, skip compilation"
   echo "  -h, --help Display this help message"
   exit 0
 }
 
 # Parse arguments
-while getopts ":vgrh-:" opt; do
+while getopts ":vgcrh-:" opt; do
   case ${opt} in
     v )
       use_opengl=false
@@ -27,6 +30,9 @@ while getopts ":vgrh-:" opt; do
     g )
       use_opengl=true
       ;;
+    c )
+      use_cpu=true
+      ;;
     r )
       compile=false
       ;;
@@ -61,7 +67,9 @@ if $compile; then
 fi
 
 # Run the appropriate program
-if $use_opengl; then
+if $use_cpu; then
+  ./${BUILD_DIR}/${MAIN_PRGM_CPU}
+elif $use_opengl; then
   ./${BUILD_DIR}/${MAIN_PRGM_OPENGL}
 else
   ./${BUILD_DIR}/${MAIN_PRGM_VULKAN}
@@ -0,0 +1,77 @@
+#!/bin/bash
+
+BUILD_DIR=build
+NAMES_FILE=${BUILD_DIR}/benchmark_names.txt
+
+# Default values
+compile=true  # Default to compile before running
+names=()  # List of benchmarks to run, all by default
+
+# Function to display help message
+usage() {
+  echo "Usage: $0 [-r] [-b <benchmark>]... [-h|--help]"
+  echo "  -r              Run only, skip compilation"
+  echo "  -b <benchmark>  Add a benchmark to run (can be used multiple times)"
+  echo "  -h, --help      Display this help message"
+  echo ""
+  echo "Available benchmarks:"
+
+  # Read and display available benchmarks from the file
+  if [ -f "$NAMES_FILE" ]; then
+    sort -u "$NAMES_FILE" | grep -v '^$' | while read -r name; do
+      echo "  - $name"
+    done
+  else
+    echo "  No benchmarks found. Run CMake to generate the names file."
+  fi
+  exit 0
+}
+
+# Parse arguments
+while getopts ":rb:h-:" opt; do
+  case ${opt} in
+    r )
+      compile=false
+      ;;
+    b )
+      names+=("${OPTARG}")
+      ;;
+    h )
+      usage
+      ;;
+    - )
+      case "${OPTARG}" in
+        help)
+          usage
+          ;;
+        *)
+          echo "Invalid option: --${OPTARG}" 1>&2
+          exit 1
+          ;;
+      esac
+      ;;
+    \? )
+      echo "Invalid option: -$OPTARG" 1>&2
+      exit 1
+      ;;
+    : )
+      echo "Invalid option: -$OPTARG requires an argument" 1>&2
+      exit 1
+      ;;
+  esac
+done
+
+# Build the project if compile flag is true
+if $compile; then
+  make -C ${BUILD_DIR}
+fi
+
+# Run every benchmark by default
+if [ ${#names[@]} -eq 0 ]; then
+  mapfile -t names < <(grep -v '^$' "$NAMES_FILE")
+fi
+
+for name in "${names[@]}"; do
+  echo "=== ${name} ==="
+  ./${BUILD_DIR}/benchmarks/${name} || exit 1
+done
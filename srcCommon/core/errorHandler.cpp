@@ -3,9 +3,19 @@
 
 namespace cr{
 
+// the threads exit the program by default
+static thread_local bool IS_RECOVERABLE = false;
+
+FatalError::FatalError(const std::string& msg)
+    : std::runtime_error(msg){}
+
+void ErrorHandler::setRecoverable(bool isRecoverable){
+    IS_RECOVERABLE = isRecoverable;
+}
+
 /**
  * Default error handler
- * @note if level == FATAL, exit the program
+ * @note if level == FATAL, exit the program or throw if the thread is recoverable
  * @note if level == WARNING, print the warning
  * @param msg The error message to display
  * @param level The error level
@@ -13,6 +23,9 @@ namespace cr{
 void ErrorHandler::defaultCase(const std::string& fileName, int lineNumber, const std::string& msg, ErrorLevel level){
     switch(level){
         case FATAL:
+            if(IS_RECOVERABLE){
+                throw FatalError("Error triggered in " + fileName + ":" + std::to_string(lineNumber) + "\n\t" + msg);
+            }
             fprintf(stderr, "Error triggered in %s:%d\n\t", fileName.c_str(), lineNumber);
             fprintf(stderr, "%s", msg.c_str());
             fprintf(stderr, "Exiting the program!\n");
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdexcept>
 #include <string>
 
 namespace cr{
@@ -29,6 +30,14 @@ enum ErrorCode{
     INITIALIZATION_ERROR
 };
 
+/**
+ * A fatal error raised on a thread where the errors are recoverable
+*/
+class FatalError : public std::runtime_error {
+    public:
+        FatalError(const std::string& msg);
+};
+
 /**
  * The class to handle errors
 */
@@ -62,10 +71,17 @@ class ErrorHandler{
         */
         static void vulkanError(bool result, const std::string& fileName, int lineNumber, const std::string& msg, ErrorLevel level = FATAL);
 
+        /**
+         * Make the fatal errors of the calling thread throw a FatalError instead of exiting the program
+         * @note for the worker threads, which report their errors to the thread owning the program
+         * @param isRecoverable True to throw, false to exit
+        */
+        static void setRecoverable(bool isRecoverable);
+
     private:
         /**
          * Default error handler
-         * @note if level == FATAL, exit the program
+         * @note if level == FATAL, exit the program or throw if the thread is recoverable
          * @note if level == WARNING, print the warning
          * @param msg The error message to display
          * @param level The error level
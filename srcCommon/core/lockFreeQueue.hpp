@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace cr{
+
+/**
+ * Bounded queue for several producers and consumers without locks, after Dmitry Vyukov's one
+ * Each cell has a sequence number telling whether it is free for the push or full for the pop of a given turn,
+ * a thread claims a cell by moving the head or the tail with a compare and swap
+ * The capacity is rounded up to a power of two
+*/
+template <typename T>
+class LockFreeQueue {
+    private:
+        struct Cell {
+            std::atomic<size_t> _Sequence{0};
+            T _Value{};
+        };
+
+        // the head and the tail on their own cache lines, they are written by different threads
+        alignas(64) std::atomic<size_t> _Tail{0};
+        alignas(64) std::atomic<size_t> _Head{0};
+        alignas(64) std::unique_ptr<Cell[]> _Cells = nullptr;
+        size_t _Mask = 0;
+
+    public:
+        LockFreeQueue(size_t capacity){
+            size_t size = 1;
+            while(size < capacity){
+                size <<= 1;
+            }
+            _Cells = std::unique_ptr<Cell[]>(new Cell[size]);
+            for(size_t i=0; i<size; i++){
+                _Cells[i]._Sequence.store(i, std::memory_order_relaxed);
+            }
+            _Mask = size - 1;
+        }
+        LockFreeQueue(const LockFreeQueue&) = delete;
+        LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    public:
+        // false if the queue is full, the value is left as it is
+        bool tryPush(const T& value){
+            size_t position = _Tail.load(std::memory_order_relaxed);
+            while(true){
+                Cell& cell = _Cells[position & _Mask];
+                size_t sequence = cell._Sequence.load(std::memory_order_acquire);
+                intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if(difference == 0){
+                    if(_Tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                        cell._Value = value;
+                        cell._Sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if(difference < 0){
+                    return false;
+                } else {
+                    position = _Tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // false if the queue is empty
+        bool tryPop(T& value){
+            size_t position = _Head.load(std::memory_order_relaxed);
+            while(true){
+                Cell& cell = _Cells[position & _Mask];
+                size_t sequence = cell._Sequence.load(std::memory_order_acquire);
+                intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+                if(difference == 0){
+                    if(_Head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                        value = std::move(cell._Value);
+                        // the cell is free for the push of the next turn
+                        cell._Sequence.store(position + _Mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if(difference < 0){
+                    return false;
+                } else {
+                    position = _Head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        size_t getCapacity() const {
+            return _Mask + 1;
+        }
+};
+
+}
\ No newline at end of file
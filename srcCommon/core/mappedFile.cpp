@@ -0,0 +1,57 @@
+#include "mappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "errorHandler.hpp"
+
+namespace cr{
+
+MappedFile::MappedFile(const std::string& path){
+    _FileDescriptor = open(path.c_str(), O_RDONLY);
+    struct stat fileStat{};
+    if(_FileDescriptor < 0 || fstat(_FileDescriptor, &fileStat) < 0){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::IO_ERROR,
+            "Failed to open the file `" + path + "'!\n"
+        );
+    }
+    _Size = fileStat.st_size;
+    // an empty file can't be mapped
+    if(_Size == 0){
+        return;
+    }
+    void* data = mmap(nullptr, _Size, PROT_READ, MAP_PRIVATE, _FileDescriptor, 0);
+    if(data == MAP_FAILED){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::IO_ERROR,
+            "Failed to map the file `" + path + "'!\n"
+        );
+    }
+    // the files are mostly read from the beginning to the end
+    madvise(data, _Size, MADV_SEQUENTIAL);
+    _Data = static_cast<const char*>(data);
+}
+
+MappedFile::~MappedFile(){
+    if(_Data != nullptr){
+        munmap(const_cast<char*>(_Data), _Size);
+    }
+    if(_FileDescriptor >= 0){
+        close(_FileDescriptor);
+    }
+}
+
+const char* MappedFile::getData() const {
+    return _Data;
+}
+
+size_t MappedFile::getSize() const {
+    return _Size;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace cr{
+
+class MappedFile;
+using MappedFilePtr = std::shared_ptr<MappedFile>;
+
+/**
+ * Read only view of a whole file mapped in memory, the pages are loaded by the os when they are first read
+ * The view is valid as long as the object lives
+*/
+class MappedFile {
+    private:
+        int _FileDescriptor = -1;
+        const char* _Data = nullptr;
+        size_t _Size = 0;
+
+    public:
+        MappedFile(const std::string& path);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+    public:
+        const char* getData() const;
+        size_t getSize() const;
+};
+
+}
\ No newline at end of file
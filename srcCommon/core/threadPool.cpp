@@ -0,0 +1,55 @@
+#include "threadPool.hpp"
+
+#include <algorithm>
+
+namespace cr{
+
+ThreadPool::ThreadPool(uint32_t nbThreads){
+    if(nbThreads == 0){
+        nbThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for(uint32_t i=0; i<nbThreads; i++){
+        _Workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(_Mutex);
+        _IsStopped = true;
+    }
+    _HasJobs.notify_all();
+    for(std::thread& worker : _Workers){
+        worker.join();
+    }
+}
+
+void ThreadPool::work(){
+    while(true){
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_Mutex);
+            _HasJobs.wait(lock, [this](){return _IsStopped || !_Jobs.empty();});
+            if(_IsStopped){
+                return;
+            }
+            job = std::move(_Jobs.front());
+            _Jobs.pop_front();
+        }
+        job();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> job){
+    {
+        std::lock_guard<std::mutex> lock(_Mutex);
+        _Jobs.push_back(std::move(job));
+    }
+    _HasJobs.notify_one();
+}
+
+uint32_t ThreadPool::getNbThreads() const {
+    return _Workers.size();
+}
+
+}
\ No newline at end of file
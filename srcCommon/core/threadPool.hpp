@@ -0,0 +1,44 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cr{
+
+class ThreadPool;
+using ThreadPoolPtr = std::shared_ptr<ThreadPool>;
+
+/**
+ * Fixed number of worker threads running the submitted jobs in their order of submission
+ * The jobs not started yet are dropped when the pool is destroyed, the running ones are waited for
+*/
+class ThreadPool {
+    private:
+        std::vector<std::thread> _Workers{};
+        std::deque<std::function<void()>> _Jobs{};
+        std::mutex _Mutex{};
+        std::condition_variable _HasJobs{};
+        bool _IsStopped = false;
+
+    public:
+        // nbThreads = 0 uses all the hardware threads
+        ThreadPool(uint32_t nbThreads = 0);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+    private:
+        void work();
+
+    public:
+        void submit(std::function<void()> job);
+        uint32_t getNbThreads() const;
+};
+
+}
\ No newline at end of file
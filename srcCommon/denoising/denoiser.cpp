@@ -0,0 +1,182 @@
+#include "denoiser.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "adaptiveSampling.hpp"
+#include "errorHandler.hpp"
+
+namespace cr{
+
+Denoiser::Denoiser(uint32_t width, uint32_t height, const DenoiserParameters& parameters){
+    _Width = width;
+    _Height = height;
+    _Parameters = parameters;
+    _Illuminations[0] = std::vector<glm::vec4>(width * height);
+    _Illuminations[1] = std::vector<glm::vec4>(width * height);
+}
+
+size_t Denoiser::getIndex(uint32_t x, uint32_t y) const {
+    return static_cast<size_t>(y) * _Width + x;
+}
+
+float Denoiser::getKernelWeight(int32_t dx, int32_t dy){
+    const float WEIGHTS[3] = {3.f / 8.f, 1.f / 4.f, 1.f / 16.f};
+    return WEIGHTS[std::abs(dx)] * WEIGHTS[std::abs(dy)];
+}
+
+glm::vec2 Denoiser::getDepthGradient(const std::vector<DenoiserGuide>& guides, int32_t x, int32_t y) const {
+    float depth = guides[getIndex(x, y)]._Depth;
+    auto getDifference = [&](int32_t qx, int32_t qy){
+        if(qx < 0 || qy < 0 || qx >= static_cast<int32_t>(_Width) || qy >= static_cast<int32_t>(_Height)){
+            return INFINITY;
+        }
+        const DenoiserGuide& guide = guides[getIndex(qx, qy)];
+        return guide._Normal == glm::vec3(0.f) ? INFINITY : std::abs(guide._Depth - depth);
+    };
+    glm::vec2 gradient = glm::vec2(
+        std::min(getDifference(x - 1, y), getDifference(x + 1, y)),
+        std::min(getDifference(x, y - 1), getDifference(x, y + 1))
+    );
+    // a pixel with no neighbour on the surface only keeps itself
+    return glm::vec2(std::isinf(gradient.x) ? 0.f : gradient.x, std::isinf(gradient.y) ? 0.f : gradient.y);
+}
+
+float Denoiser::getGeometryWeight(const DenoiserGuide& p, const DenoiserGuide& q, const glm::vec2& depthGradient, const glm::vec2& offset) const {
+    // the misses have a null normal and are never mixed with the hits
+    float normalWeight = std::pow(std::max(glm::dot(p._Normal, q._Normal), 0.f), _Parameters._NormalPhi);
+    float depthTolerance = _Parameters._DepthPhi * glm::dot(depthGradient, glm::abs(offset)) + RELATIVE_DEPTH_EPSILON * p._Depth;
+    float depthWeight = std::exp(-std::abs(p._Depth - q._Depth) / std::max(depthTolerance, WEIGHT_EPSILON));
+    return normalWeight * depthWeight;
+}
+
+void Denoiser::estimateVariance(const std::vector<glm::vec4>& image, const std::vector<DenoiserGuide>& guides){
+    std::vector<glm::vec4>& illuminations = _Illuminations[0];
+    #pragma omp parallel for
+    for(size_t i=0; i<image.size(); i++){
+        glm::vec3 albedo = glm::max(guides[i]._Albedo, glm::vec3(MIN_ALBEDO));
+        illuminations[i] = glm::vec4(glm::vec3(image[i]) / albedo, 0.f);
+    }
+
+    #pragma omp parallel for
+    for(int32_t y=0; y<static_cast<int32_t>(_Height); y++){
+        for(int32_t x=0; x<static_cast<int32_t>(_Width); x++){
+            size_t index = getIndex(x, y);
+            const DenoiserGuide& guide = guides[index];
+            if(guide._Normal == glm::vec3(0.f)){
+                continue;
+            }
+            glm::vec2 depthGradient = getDepthGradient(guides, x, y);
+            // first two moments of the luminance over the same surface
+            float sumWeights = 0.f;
+            float sumMoment1 = 0.f;
+            float sumMoment2 = 0.f;
+            for(int32_t dy=-VARIANCE_RADIUS; dy<=VARIANCE_RADIUS; dy++){
+                for(int32_t dx=-VARIANCE_RADIUS; dx<=VARIANCE_RADIUS; dx++){
+                    int32_t qx = x + dx;
+                    int32_t qy = y + dy;
+                    if(qx < 0 || qy < 0 || qx >= static_cast<int32_t>(_Width) || qy >= static_cast<int32_t>(_Height)){
+                        continue;
+                    }
+                    size_t qIndex = getIndex(qx, qy);
+                    float weight = getGeometryWeight(guide, guides[qIndex], depthGradient, glm::vec2(dx, dy));
+                    float luminance = AdaptiveSampling::getLuminance(glm::vec3(illuminations[qIndex]));
+                    sumWeights += weight;
+                    sumMoment1 += weight * luminance;
+                    sumMoment2 += weight * luminance * luminance;
+                }
+            }
+            float mean = sumMoment1 / sumWeights;
+            illuminations[index].a = std::max(sumMoment2 / sumWeights - mean * mean, 0.f);
+        }
+    }
+}
+
+float Denoiser::getBlurredVariance(int32_t x, int32_t y) const {
+    const float WEIGHTS[3] = {1.f / 4.f, 1.f / 8.f, 1.f / 16.f};
+    const std::vector<glm::vec4>& illuminations = _Illuminations[0];
+    float sumWeights = 0.f;
+    float sumVariances = 0.f;
+    for(int32_t dy=-1; dy<=1; dy++){
+        for(int32_t dx=-1; dx<=1; dx++){
+            int32_t qx = x + dx;
+            int32_t qy = y + dy;
+            if(qx < 0 || qy < 0 || qx >= static_cast<int32_t>(_Width) || qy >= static_cast<int32_t>(_Height)){
+                continue;
+            }
+            float weight = WEIGHTS[std::abs(dx) + std::abs(dy)];
+            sumWeights += weight;
+            sumVariances += weight * illuminations[getIndex(qx, qy)].a;
+        }
+    }
+    return sumVariances / sumWeights;
+}
+
+void Denoiser::filter(const std::vector<DenoiserGuide>& guides, int32_t stepSize){
+    const std::vector<glm::vec4>& input = _Illuminations[0];
+    std::vector<glm::vec4>& output = _Illuminations[1];
+
+    #pragma omp parallel for
+    for(int32_t y=0; y<static_cast<int32_t>(_Height); y++){
+        for(int32_t x=0; x<static_cast<int32_t>(_Width); x++){
+            size_t index = getIndex(x, y);
+            const DenoiserGuide& guide = guides[index];
+            if(guide._Normal == glm::vec3(0.f)){
+                output[index] = input[index];
+                continue;
+            }
+            glm::vec2 depthGradient = getDepthGradient(guides, x, y);
+            float luminance = AdaptiveSampling::getLuminance(glm::vec3(input[index]));
+            float luminanceTolerance = _Parameters._LuminancePhi * std::sqrt(getBlurredVariance(x, y)) + WEIGHT_EPSILON;
+
+            float sumWeights = 0.f;
+            glm::vec4 sum = glm::vec4(0.f);
+            for(int32_t dy=-2; dy<=2; dy++){
+                for(int32_t dx=-2; dx<=2; dx++){
+                    int32_t qx = x + dx * stepSize;
+                    int32_t qy = y + dy * stepSize;
+                    if(qx < 0 || qy < 0 || qx >= static_cast<int32_t>(_Width) || qy >= static_cast<int32_t>(_Height)){
+                        continue;
+                    }
+                    size_t qIndex = getIndex(qx, qy);
+                    glm::vec4 illumination = input[qIndex];
+                    float luminanceWeight = std::exp(-std::abs(luminance - AdaptiveSampling::getLuminance(glm::vec3(illumination))) / luminanceTolerance);
+                    float weight = getKernelWeight(dx, dy)
+                        * getGeometryWeight(guide, guides[qIndex], depthGradient, glm::vec2(dx * stepSize, dy * stepSize))
+                        * luminanceWeight;
+                    // the variance of a weighted sum goes with the squared weights
+                    sumWeights += weight;
+                    sum += glm::vec4(glm::vec3(illumination) * weight, illumination.a * weight * weight);
+                }
+            }
+            output[index] = glm::vec4(glm::vec3(sum) / sumWeights, sum.a / (sumWeights * sumWeights));
+        }
+    }
+    std::swap(_Illuminations[0], _Illuminations[1]);
+}
+
+std::vector<glm::vec4> Denoiser::denoise(const std::vector<glm::vec4>& image, const std::vector<DenoiserGuide>& guides){
+    size_t nbPixels = static_cast<size_t>(_Width) * _Height;
+    if(image.size() != nbPixels || guides.size() != nbPixels){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "The denoised image and its guides must have the size of the denoiser!\n"
+        );
+    }
+
+    estimateVariance(image, guides);
+    for(uint32_t i=0; i<_Parameters._NbIterations; i++){
+        filter(guides, 1 << i);
+    }
+
+    // the albedo is put back
+    std::vector<glm::vec4> denoisedImage = std::vector<glm::vec4>(nbPixels);
+    for(size_t i=0; i<nbPixels; i++){
+        glm::vec3 albedo = glm::max(guides[i]._Albedo, glm::vec3(MIN_ALBEDO));
+        denoisedImage[i] = glm::vec4(glm::vec3(_Illuminations[0][i]) * albedo, image[i].a);
+    }
+    return denoisedImage;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace cr{
+
+class Denoiser;
+using DenoiserPtr = std::shared_ptr<Denoiser>;
+
+struct DenoiserParameters {
+    bool _IsOn = false;
+    // the step of the filter doubles at each iteration, 5 iterations cover 125x125 pixels
+    uint32_t _NbIterations = 5;
+    // tolerance to luminance differences, in standard deviations
+    float _LuminancePhi = 4.f;
+    // exponent of the cosine between the normals, the higher the sharper the creases
+    float _NormalPhi = 128.f;
+    // tolerance to depth differences, relative to the depth gradient
+    float _DepthPhi = 1.f;
+
+    bool operator==(const DenoiserParameters&) const = default;
+};
+
+// first hit of the primary ray of a pixel, mirrors the guide images of shaders/common/denoising.glsl
+struct DenoiserGuide {
+    // null if the ray missed
+    glm::vec3 _Normal = glm::vec3(0.f);
+    // distance along the ray
+    float _Depth = 0.f;
+    glm::vec3 _Albedo = glm::vec3(1.f);
+};
+
+/**
+ * Edge avoiding a-trous wavelet filter with the weights of SVGF, mirrors shaders/denoising
+ * The illumination, the color divided by the albedo, is filtered so the textures stay sharp
+ * The luminance weight follows the variance of the luminance, estimated in the neighbourhood and filtered along
+*/
+class Denoiser {
+    public:
+        // neighbourhood of the variance estimate, there is no history to get it from
+        static const int32_t VARIANCE_RADIUS = 3;
+        // the illumination of a black surface is unknown
+        static constexpr float MIN_ALBEDO = 1e-3f;
+        // depth differences tolerated on surfaces facing the camera, relative to the depth
+        static constexpr float RELATIVE_DEPTH_EPSILON = 1e-3f;
+        // keeps the weights finite on flat areas
+        static constexpr float WEIGHT_EPSILON = 1e-10f;
+
+    private:
+        uint32_t _Width = 0;
+        uint32_t _Height = 0;
+        // illumination and variance of its luminance, the iterations ping pong between the two
+        std::vector<glm::vec4> _Illuminations[2] = {};
+
+    public:
+        DenoiserParameters _Parameters{};
+
+    public:
+        Denoiser(uint32_t width, uint32_t height, const DenoiserParameters& parameters = {});
+
+    public:
+        // row major images of the same size, the pixels missed by the primary rays are left as they are
+        std::vector<glm::vec4> denoise(const std::vector<glm::vec4>& image, const std::vector<DenoiserGuide>& guides);
+
+        // separable 5x5 B3 spline, offsets in [-2, 2]
+        static float getKernelWeight(int32_t dx, int32_t dy);
+
+    private:
+        size_t getIndex(uint32_t x, uint32_t y) const;
+        void estimateVariance(const std::vector<glm::vec4>& image, const std::vector<DenoiserGuide>& guides);
+        void filter(const std::vector<DenoiserGuide>& guides, int32_t stepSize);
+        // 3x3 gaussian blur of the variance, steadier than the variance of the pixel alone
+        float getBlurredVariance(int32_t x, int32_t y) const;
+        // smallest one sided difference of the depths, the silhouettes do not count
+        glm::vec2 getDepthGradient(const std::vector<DenoiserGuide>& guides, int32_t x, int32_t y) const;
+        // normal and depth weight of q for p at the given offset in pixels
+        float getGeometryWeight(const DenoiserGuide& p, const DenoiserGuide& q, const glm::vec2& depthGradient, const glm::vec2& offset) const;
+};
+
+}
\ No newline at end of file
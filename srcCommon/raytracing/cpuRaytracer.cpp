@@ -0,0 +1,732 @@
+#include "cpuRaytracer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "errorHandler.hpp"
+
+namespace cr{
+
+const glm::vec4 CpuRaytracer::BVH_AABB_COLOR = glm::vec4(0.5f, 0.f, 0.5f, 0.1f);
+const glm::vec4 CpuRaytracer::BVH_AABB_LINE_COLOR = glm::vec4(0.7f, 0.f, 0.7f, 0.1f);
+
+double CpuRaytracerStatistics::getRaysPerSecond() const {
+    return _RenderTime > 0. ? static_cast<double>(_NbRays) / _RenderTime : 0.;
+}
+
+CpuRaytracer::CpuRaytracer(CpuScenePtr scene, const CpuRaytracerParameters& parameters){
+    if(scene == nullptr){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::NOT_INITIALIZED_ERROR,
+            "The cpu raytracer needs a scene!\n"
+        );
+    }
+    if(parameters._TileSize == 0){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "The tiles of the cpu raytracer can't be empty!\n"
+        );
+    }
+    _Scene = scene;
+    _Parameters = parameters;
+}
+
+Ray CpuRaytracer::getRay(const CameraGPU& camera, const glm::vec2& pos){
+    Ray ray{};
+    ray._Origin = glm::vec3(camera._Eye);
+    glm::vec3 posViewSpace = glm::vec3(pos - 0.5f, 1.f) * glm::vec3(camera._PlaneWidth, camera._PlaneHeight, camera._PlaneNear);
+    glm::vec4 posWorldSpace = camera._InvView * glm::vec4(posViewSpace, 1.f);
+    ray._Direction = glm::normalize(glm::vec3(posWorldSpace) - ray._Origin);
+    return ray;
+}
+
+Hit CpuRaytracer::traceClosest(const RaySetup& ray, float tMax) const {
+    Hit closestHit{};
+    closestHit._Coords.w = tMax;
+    if(!_Scene->getBVH_Nodes().empty()){
+        traceSubtree(ray, 0, NO_INSTANCE, closestHit);
+    }
+    return closestHit;
+}
+
+void CpuRaytracer::traceSubtree(const RaySetup& ray, uint32_t rootNode, uint32_t instanceIndex, Hit& closestHit) const {
+    const std::vector<BVH_NodeGPU>& nodes = _Scene->getBVH_Nodes();
+    // the ray in the space of the current instance
+    RaySetup curRay = ray;
+    uint32_t curInstance = instanceIndex;
+    uint32_t stack[TRAVERSAL_STACK_SIZE];
+    int stackIndex = 0;
+    stack[stackIndex++] = rootNode;
+    while(stackIndex > 0){
+        uint32_t nodeIndex = stack[--stackIndex];
+        if(nodeIndex == TRAVERSAL_INSTANCE_EXIT){
+            curRay = ray;
+            curInstance = NO_INSTANCE;
+            continue;
+        }
+        const BVH_NodeGPU& curNode = nodes[nodeIndex];
+        float tEntry = 0.f;
+        if(!Intersection::rayAABB(curRay, curNode._BoundingBox, closestHit._Coords.w, tEntry)){
+            continue;
+        }
+        if(curNode._LeftChild == 0 && curNode._RightChild == 0){
+            if(curInstance == NO_INSTANCE){
+                if(stackIndex + 2 > TRAVERSAL_STACK_SIZE){
+                    continue;
+                }
+                // the bvh of the mesh is traversed in model space
+                curInstance = curNode._TriangleId;
+                curRay = _Scene->getInstanceRay(ray, curInstance);
+                stack[stackIndex++] = TRAVERSAL_INSTANCE_EXIT;
+                stack[stackIndex++] = _Scene->getInstance(curInstance)._BVH_Root;
+                continue;
+            }
+            Hit hit = _Scene->rayTriangleIntersection(curRay, curNode._TriangleId, closestHit._Coords.w);
+            if(hit._DidHit){
+                hit._InstanceId = curInstance;
+                closestHit = hit;
+            }
+        } else {
+            // a node was just popped so there is room for one child
+            stack[stackIndex++] = curNode._LeftChild;
+            if(stackIndex < TRAVERSAL_STACK_SIZE){
+                stack[stackIndex++] = curNode._RightChild;
+            }
+        }
+    }
+}
+
+bool CpuRaytracer::traceAnyHit(const RaySetup& ray, float tMin, float tMax) const {
+    const std::vector<BVH_NodeGPU>& nodes = _Scene->getBVH_Nodes();
+    if(nodes.empty()){
+        return false;
+    }
+
+    RaySetup curRay = ray;
+    uint32_t curInstance = NO_INSTANCE;
+    uint32_t stack[TRAVERSAL_STACK_SIZE];
+    int stackIndex = 0;
+    stack[stackIndex++] = 0; // root
+    while(stackIndex > 0){
+        uint32_t nodeIndex = stack[--stackIndex];
+        if(nodeIndex == TRAVERSAL_INSTANCE_EXIT){
+            curRay = ray;
+            curInstance = NO_INSTANCE;
+            continue;
+        }
+        const BVH_NodeGPU& curNode = nodes[nodeIndex];
+        float tEntry = 0.f;
+        if(!Intersection::rayAABB(curRay, curNode._BoundingBox, tMax, tEntry)){
+            continue;
+        }
+        if(curNode._LeftChild == 0 && curNode._RightChild == 0){
+            if(curInstance == NO_INSTANCE){
+                if(stackIndex + 2 > TRAVERSAL_STACK_SIZE){
+                    continue;
+                }
+                curInstance = curNode._TriangleId;
+                curRay = _Scene->getInstanceRay(ray, curInstance);
+                stack[stackIndex++] = TRAVERSAL_INSTANCE_EXIT;
+                stack[stackIndex++] = _Scene->getInstance(curInstance)._BVH_Root;
+                continue;
+            }
+            if(_Scene->isTriangleOccluding(curRay, curNode._TriangleId, tMin, tMax)){
+                return true;
+            }
+        } else {
+            // the left child is the largest one, the most likely to block the ray
+            if(stackIndex + 2 <= TRAVERSAL_STACK_SIZE){
+                stack[stackIndex++] = curNode._RightChild;
+            }
+            stack[stackIndex++] = curNode._LeftChild;
+        }
+    }
+    return false;
+}
+
+std::vector<uint32_t> CpuRaytracer::getCoherentOrder(std::span<const Ray> rays) const {
+    std::vector<uint32_t> order = std::vector<uint32_t>(rays.size());
+    for(uint32_t i=0; i<order.size(); i++){
+        order[i] = i;
+    }
+    if(rays.size() < QUERY_SORT_THRESHOLD || _Scene->getBVH_Nodes().empty()){
+        return order;
+    }
+
+    // direction octant, then Morton code of the origin cell in the scene box as in shaders/wavefront/rayKeys.glsl,
+    // then Morton code of the direction so that rays sharing an origin, such as camera rays, are also grouped
+    const AABB_GPU& sceneBox = _Scene->getBVH_Nodes()[0]._BoundingBox;
+    glm::vec3 extent = glm::max(sceneBox._Max - sceneBox._Min, glm::vec3(1e-6f));
+    auto morton3D = [](glm::vec3 cell){
+        auto spread = [](uint32_t v){
+            v = (v | (v << 16)) & 0x030000ff;
+            v = (v | (v << 8)) & 0x0300f00f;
+            v = (v | (v << 4)) & 0x030c30c3;
+            v = (v | (v << 2)) & 0x09249249;
+            return v;
+        };
+        return spread(static_cast<uint32_t>(cell.x))
+            | (spread(static_cast<uint32_t>(cell.y)) << 1)
+            | (spread(static_cast<uint32_t>(cell.z)) << 2);
+    };
+    std::vector<uint32_t> keys = std::vector<uint32_t>(rays.size());
+    #pragma omp parallel for
+    for(size_t i=0; i<rays.size(); i++){
+        const Ray& ray = rays[i];
+        // origins outside of the scene share the border cells
+        uint32_t originCell = morton3D(glm::clamp((ray._Origin - sceneBox._Min) / extent, 0.f, 1.f) * 15.f);
+        glm::vec3 direction = glm::normalize(ray._Direction);
+        uint32_t directionCell = morton3D(glm::clamp(0.5f * direction + 0.5f, 0.f, 1.f) * 31.f);
+        uint32_t octant = (ray._Direction.x < 0.f ? 1 : 0)
+            | (ray._Direction.y < 0.f ? 2 : 0)
+            | (ray._Direction.z < 0.f ? 4 : 0);
+        keys[i] = (octant << 27) | (originCell << 15) | directionCell;
+    }
+
+    // least significant digit radix sort of the 30 bits keys, stable
+    const uint32_t NB_DIGIT_BITS = 10;
+    const uint32_t NB_BUCKETS = 1 << NB_DIGIT_BITS;
+    std::vector<uint32_t> sortedOrder = std::vector<uint32_t>(rays.size());
+    for(uint32_t shift=0; shift<30; shift+=NB_DIGIT_BITS){
+        std::vector<uint32_t> offsets = std::vector<uint32_t>(NB_BUCKETS + 1, 0);
+        for(uint32_t index : order){
+            offsets[((keys[index] >> shift) & (NB_BUCKETS - 1)) + 1]++;
+        }
+        for(uint32_t bucket=0; bucket<NB_BUCKETS; bucket++){
+            offsets[bucket + 1] += offsets[bucket];
+        }
+        for(uint32_t index : order){
+            sortedOrder[offsets[(keys[index] >> shift) & (NB_BUCKETS - 1)]++] = index;
+        }
+        std::swap(order, sortedOrder);
+    }
+    return order;
+}
+
+void CpuRaytracer::traceClosest(std::span<const Ray> rays, std::span<Hit> hits) const {
+    if(hits.size() < rays.size()){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "Not enough room for the hits of the rays!\n"
+        );
+    }
+    std::vector<uint32_t> order = getCoherentOrder(rays);
+    if(_Scene->getBVH_Nodes().empty()){
+        for(size_t i=0; i<rays.size(); i++){
+            hits[i] = Hit{};
+            hits[i]._Coords.w = rays[i]._TMax;
+        }
+        return;
+    }
+    int nbBatches = static_cast<int>((rays.size() + QUERY_BATCH_SIZE - 1) / QUERY_BATCH_SIZE);
+    #pragma omp parallel for schedule(dynamic)
+    for(int batch=0; batch<nbBatches; batch++){
+        size_t first = static_cast<size_t>(batch) * QUERY_BATCH_SIZE;
+        size_t nbRays = std::min(static_cast<size_t>(QUERY_BATCH_SIZE), rays.size() - first);
+        RaySetup batchRays[QUERY_BATCH_SIZE];
+        Hit batchHits[QUERY_BATCH_SIZE];
+        for(size_t i=0; i<nbRays; i++){
+            const Ray& ray = rays[order[first + i]];
+            batchRays[i] = Intersection::setupRay(ray);
+            batchHits[i] = Hit{};
+            batchHits[i]._Coords.w = ray._TMax;
+        }
+        // sorted rays of incoherent workloads can still diverge too much for a packet to pay off
+        bool isCoherent = true;
+        for(size_t i=1; i<nbRays && isCoherent; i++){
+            isCoherent = glm::dot(batchRays[i]._Direction, batchRays[0]._Direction)
+                >= QUERY_PACKET_MIN_COSINE * glm::length(batchRays[i]._Direction) * glm::length(batchRays[0]._Direction);
+        }
+        if(isCoherent){
+            tracePacket(std::span<const RaySetup>(batchRays, nbRays), std::span<Hit>(batchHits, nbRays));
+        } else {
+            for(size_t i=0; i<nbRays; i++){
+                traceSubtree(batchRays[i], 0, NO_INSTANCE, batchHits[i]);
+            }
+        }
+        for(size_t i=0; i<nbRays; i++){
+            hits[order[first + i]] = batchHits[i];
+        }
+    }
+}
+
+void CpuRaytracer::traceAnyHit(std::span<const Ray> rays, std::span<bool> areOccluded) const {
+    if(areOccluded.size() < rays.size()){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "Not enough room for the results of the rays!\n"
+        );
+    }
+    // the rays stop at their first hit, packets would only hold them back
+    std::vector<uint32_t> order = getCoherentOrder(rays);
+    #pragma omp parallel for schedule(dynamic, QUERY_BATCH_SIZE)
+    for(size_t i=0; i<rays.size(); i++){
+        const Ray& ray = rays[order[i]];
+        areOccluded[order[i]] = traceAnyHit(Intersection::setupRay(ray), 0.f, ray._TMax);
+    }
+}
+
+PacketFrustum PacketFrustum::build(std::span<const RaySetup> rays, std::span<const Hit> hits){
+    PacketFrustum frustum{};
+    if(rays.empty()){
+        return frustum;
+    }
+    for(size_t i=0; i<rays.size(); i++){
+        const RaySetup& ray = rays[i];
+        if(ray._Sign != rays[0]._Sign
+            || ray._Direction.x == 0.f || ray._Direction.y == 0.f || ray._Direction.z == 0.f){
+            return frustum;
+        }
+        frustum._OriginMin = glm::min(frustum._OriginMin, ray._Origin);
+        frustum._OriginMax = glm::max(frustum._OriginMax, ray._Origin);
+        frustum._InvDirectionMin = glm::min(frustum._InvDirectionMin, ray._InvDirection);
+        frustum._InvDirectionMax = glm::max(frustum._InvDirectionMax, ray._InvDirection);
+        frustum._TMax = std::max(frustum._TMax, hits[i]._Coords.w);
+    }
+    frustum._IsValid = true;
+    return frustum;
+}
+
+bool PacketFrustum::isCulled(const AABB_GPU& aabb) const {
+    // interval arithmetic on the slab distances, the rounding of each operation is monotonic
+    // so the bounds also hold for the distances computed by Intersection::rayAABB
+    // cf Boulos et al., "Geometric and Arithmetic Culling Methods for Entire Ray Packets", 2006
+    float tNear = 0.f;
+    float tFar = _TMax;
+    for(int axis=0; axis<3; axis++){
+        float minLow = aabb._Min[axis] - _OriginMax[axis];
+        float minHigh = aabb._Min[axis] - _OriginMin[axis];
+        float maxLow = aabb._Max[axis] - _OriginMax[axis];
+        float maxHigh = aabb._Max[axis] - _OriginMin[axis];
+        float invLow = _InvDirectionMin[axis];
+        float invHigh = _InvDirectionMax[axis];
+        // the near plane depends on the octant, shared by the whole packet
+        bool isNegative = invHigh < 0.f;
+        float nearLow = isNegative ? maxLow : minLow;
+        float nearHigh = isNegative ? maxHigh : minHigh;
+        float farLow = isNegative ? minLow : maxLow;
+        float farHigh = isNegative ? minHigh : maxHigh;
+
+        float tNearAxis = std::min(
+            std::min(nearLow * invLow, nearLow * invHigh),
+            std::min(nearHigh * invLow, nearHigh * invHigh)
+        );
+        float tFarAxis = std::max(
+            std::max(farLow * invLow, farLow * invHigh),
+            std::max(farHigh * invLow, farHigh * invHigh)
+        );
+        tNear = std::max(tNear, tNearAxis);
+        tFar = std::min(tFar, tFarAxis * (1.f + 2.f * Intersection::GAMMA_3));
+    }
+    return tNear > tFar;
+}
+
+void CpuRaytracer::tracePacket(std::span<const RaySetup> rays, std::span<Hit> hits) const {
+    if(_Scene->getBVH_Nodes().empty() || rays.empty()){
+        return;
+    }
+    tracePacketSubtree(rays, hits, 0, NO_INSTANCE);
+}
+
+void CpuRaytracer::tracePacketSubtree(std::span<const RaySetup> rays, std::span<Hit> hits, uint32_t rootNode, uint32_t instanceIndex) const {
+    const std::vector<BVH_NodeGPU>& nodes = _Scene->getBVH_Nodes();
+    PacketFrustum frustum = PacketFrustum::build(rays, hits);
+    if(!frustum._IsValid){
+        // incoherent packet
+        for(size_t i=0; i<rays.size(); i++){
+            traceSubtree(rays[i], rootNode, instanceIndex, hits[i]);
+        }
+        return;
+    }
+
+    // each node keeps the range of rays that may still hit it
+    // cf Wald et al., "Ray Tracing Deformable Scenes using Dynamic Bounding Volume Hierarchies", 2007
+    struct StackEntry {
+        uint32_t _Node;
+        uint32_t _FirstRay;
+        uint32_t _LastRay;
+    };
+    auto hitsBox = [&](uint32_t rayIndex, const AABB_GPU& aabb){
+        float tEntry = 0.f;
+        return Intersection::rayAABB(rays[rayIndex], aabb, hits[rayIndex]._Coords.w, tEntry);
+    };
+    const glm::vec3& origin = rays[0]._Origin;
+    const glm::vec3& direction = rays[rays.size() / 2]._Direction;
+
+    StackEntry stack[TRAVERSAL_STACK_SIZE];
+    int stackIndex = 0;
+    stack[stackIndex++] = {rootNode, 0, static_cast<uint32_t>(rays.size() - 1)};
+    while(stackIndex > 0){
+        StackEntry entry = stack[--stackIndex];
+        const BVH_NodeGPU& curNode = nodes[entry._Node];
+        if(frustum.isCulled(curNode._BoundingBox)){
+            continue;
+        }
+
+        // first and last active rays
+        uint32_t first = entry._FirstRay;
+        while(first <= entry._LastRay && !hitsBox(first, curNode._BoundingBox)){
+            first++;
+        }
+        if(first > entry._LastRay){
+            continue;
+        }
+        uint32_t last = entry._LastRay;
+        while(last > first && !hitsBox(last, curNode._BoundingBox)){
+            last--;
+        }
+
+        if(last - first + 1 <= DIVERGENT_PACKET_SIZE){
+            for(uint32_t i=first; i<=last; i++){
+                traceSubtree(rays[i], entry._Node, instanceIndex, hits[i]);
+            }
+            continue;
+        }
+
+        if(curNode._LeftChild == 0 && curNode._RightChild == 0 && instanceIndex == NO_INSTANCE){
+            // the active rays go on as a packet in the model space of the instance
+            uint32_t leafInstance = curNode._TriangleId;
+            std::vector<RaySetup> modelRays = std::vector<RaySetup>(last - first + 1);
+            for(uint32_t i=first; i<=last; i++){
+                modelRays[i - first] = _Scene->getInstanceRay(rays[i], leafInstance);
+            }
+            tracePacketSubtree(modelRays, hits.subspan(first, last - first + 1), _Scene->getInstance(leafInstance)._BVH_Root, leafInstance);
+        } else if(curNode._LeftChild == 0 && curNode._RightChild == 0){
+            for(uint32_t i=first; i<=last; i++){
+                // the box test is much cheaper than the watertight triangle test
+                if(i != first && i != last && !hitsBox(i, curNode._BoundingBox)){
+                    continue;
+                }
+                Hit hit = _Scene->rayTriangleIntersection(rays[i], curNode._TriangleId, hits[i]._Coords.w);
+                if(hit._DidHit){
+                    hit._InstanceId = instanceIndex;
+                    hits[i] = hit;
+                }
+            }
+        } else {
+            // the nearest child along the packet is visited first to shorten the rays early
+            auto distance = [&](uint32_t node){
+                const AABB_GPU& box = nodes[node]._BoundingBox;
+                return glm::dot(0.5f * (box._Min + box._Max) - origin, direction);
+            };
+            uint32_t nearChild = curNode._LeftChild;
+            uint32_t farChild = curNode._RightChild;
+            if(distance(farChild) < distance(nearChild)){
+                std::swap(nearChild, farChild);
+            }
+            // a full stack traces the rest of the subtree ray by ray
+            if(stackIndex + 2 > TRAVERSAL_STACK_SIZE){
+                for(uint32_t i=first; i<=last; i++){
+                    traceSubtree(rays[i], entry._Node, instanceIndex, hits[i]);
+                }
+                continue;
+            }
+            stack[stackIndex++] = {farChild, first, last};
+            stack[stackIndex++] = {nearChild, first, last};
+        }
+    }
+}
+
+uint32_t CpuRaytracer::intersectBVH(const RaySetup& ray, const BVH_NodeGPU& node, float tMax) const {
+    float tMin = 0.f;
+    if(!Intersection::rayAABB(ray, node._BoundingBox, tMax, tMin)){
+        return 0;
+    }
+
+    // check if border
+    float threshold = BVH_LINE_WIDTH / (_Parameters._DepthDisplayBVH + 1.f);
+    glm::vec3 enterPoint = ray._Origin + ray._Direction * tMin;
+    const AABB_GPU& box = node._BoundingBox;
+    bool closeToX = (std::abs(enterPoint.x - box._Min.x) < threshold)
+        || (std::abs(enterPoint.x - box._Max.x) < threshold);
+    bool closeToY = (std::abs(enterPoint.y - box._Min.y) < threshold)
+        || (std::abs(enterPoint.y - box._Max.y) < threshold);
+    bool closeToZ = (std::abs(enterPoint.z - box._Min.z) < threshold)
+        || (std::abs(enterPoint.z - box._Max.z) < threshold);
+    if((closeToX && closeToY) || (closeToX && closeToZ) || (closeToY && closeToZ)){
+        return 2;
+    }
+    return 1;
+}
+
+Hit CpuRaytracer::getClosestHitBVH(const RaySetup& ray, glm::vec4& bvhColor) const {
+    Hit closestHit{};
+    const std::vector<BVH_NodeGPU>& nodes = _Scene->getBVH_Nodes();
+    if(nodes.empty()){
+        return closestHit;
+    }
+
+    // the depth goes on in the bvh of the instances
+    RaySetup curRay = ray;
+    uint32_t curInstance = NO_INSTANCE;
+    uint32_t stack[TRAVERSAL_STACK_SIZE];
+    uint32_t depthStack[TRAVERSAL_STACK_SIZE];
+    int stackIndex = 0;
+    stack[stackIndex] = 0;
+    depthStack[stackIndex] = 0;
+    stackIndex++;
+    while(stackIndex > 0){
+        stackIndex--;
+        if(stack[stackIndex] == TRAVERSAL_INSTANCE_EXIT){
+            curRay = ray;
+            curInstance = NO_INSTANCE;
+            continue;
+        }
+        const BVH_NodeGPU& curNode = nodes[stack[stackIndex]];
+        uint32_t currentDepth = depthStack[stackIndex];
+        // nodes behind the closest hit are skipped unless the whole bvh is displayed
+        float tMax = (_Parameters._IsBVHDisplayed || !closestHit._DidHit) ? INFINITY : closestHit._Coords.w;
+        uint32_t intersectionBVH = intersectBVH(curRay, curNode, tMax);
+        if(intersectionBVH == 0){
+            continue;
+        }
+        if(currentDepth == _Parameters._DepthDisplayBVH){
+            bvhColor = intersectionBVH == 2 ? BVH_AABB_LINE_COLOR : BVH_AABB_COLOR;
+        }
+        if(curNode._LeftChild == 0 && curNode._RightChild == 0 && curInstance == NO_INSTANCE){
+            if(stackIndex + 2 > TRAVERSAL_STACK_SIZE){
+                continue;
+            }
+            curInstance = curNode._TriangleId;
+            curRay = _Scene->getInstanceRay(ray, curInstance);
+            stack[stackIndex] = TRAVERSAL_INSTANCE_EXIT;
+            stackIndex++;
+            stack[stackIndex] = _Scene->getInstance(curInstance)._BVH_Root;
+            depthStack[stackIndex] = currentDepth+1;
+            stackIndex++;
+        } else if(curNode._LeftChild == 0 && curNode._RightChild == 0){
+            float tMaxTriangle = closestHit._DidHit ? closestHit._Coords.w : INFINITY;
+            Hit hit = _Scene->rayTriangleIntersection(curRay, curNode._TriangleId, tMaxTriangle);
+            if(hit._DidHit){
+                hit._InstanceId = curInstance;
+                closestHit = hit;
+            }
+        } else {
+            stack[stackIndex] = curNode._LeftChild;
+            depthStack[stackIndex] = currentDepth+1;
+            stackIndex++;
+            if(stackIndex < TRAVERSAL_STACK_SIZE){
+                stack[stackIndex] = curNode._RightChild;
+                depthStack[stackIndex] = currentDepth+1;
+                stackIndex++;
+            }
+        }
+    }
+    return closestHit;
+}
+
+void CpuRaytracer::getColor(const Hit& hit, const glm::vec4& bvhColor, glm::vec4& color) const {
+    if(_Parameters._IsBVHDisplayed){
+        color = bvhColor;
+    }
+
+    if(!hit._DidHit) return;
+    color += _Scene->getInstanceMaterial(hit._InstanceId)._Color;
+
+    if(_Parameters._IsWireframeModeOn){
+        float threshold = WIREFRAME_LINE_WIDTH;
+        if(hit._Coords.x < threshold
+            || hit._Coords.y < threshold
+            || hit._Coords.z < threshold){
+            color = glm::vec4(0.f, 0.f, 0.f, 1.f);
+        }
+    }
+}
+
+glm::vec2 CpuRaytracer::getJitter(uint32_t x, uint32_t y, uint32_t sampleIndex) const {
+    if(_Sampler == nullptr){
+        return glm::vec2(0.5f);
+    }
+    return _Sampler->get2D(glm::uvec2(x, y), sampleIndex, JITTER_SAMPLING_DIMENSION);
+}
+
+glm::vec2 CpuRaytracer::getPixelPosition(uint32_t x, uint32_t y, const glm::vec2& jitter) const {
+    return glm::vec2(
+        (static_cast<float>(x) + 0.5f - jitter.x) / _Parameters._Width,
+        (static_cast<float>(y) + 0.5f - jitter.y) / _Parameters._Height
+    );
+}
+
+glm::vec4 CpuRaytracer::renderPixel(const CameraGPU& camera, uint32_t x, uint32_t y, const glm::vec2& jitter) const {
+    glm::vec4 value = glm::vec4(0.f, 0.f, 0.f, 1.f);
+    RaySetup ray = Intersection::setupRay(getRay(camera, getPixelPosition(x, y, jitter)));
+    glm::vec4 bvhColor = glm::vec4(0.f);
+    Hit closestHit = getClosestHitBVH(ray, bvhColor);
+    getColor(closestHit, bvhColor, value);
+    return value;
+}
+
+void CpuRaytracer::renderTilePacket(const CameraGPU& camera, const Tile& tile, uint32_t sampleIndex, AdaptiveSampling& pixels) const {
+    std::vector<RaySetup> rays{};
+    std::vector<glm::uvec2> rayPixels{};
+    rays.reserve((tile._X1 - tile._X0) * (tile._Y1 - tile._Y0));
+    rayPixels.reserve(rays.capacity());
+    for(uint32_t y=tile._Y0; y<tile._Y1; y++){
+        for(uint32_t x=tile._X0; x<tile._X1; x++){
+            if(pixels.isConverged(x, y)){
+                continue;
+            }
+            glm::vec2 position = getPixelPosition(x, y, getJitter(x, y, sampleIndex));
+            rays.push_back(Intersection::setupRay(getRay(camera, position)));
+            rayPixels.push_back(glm::uvec2(x, y));
+        }
+    }
+    std::vector<Hit> hits = std::vector<Hit>(rays.size());
+    tracePacket(rays, hits);
+
+    for(size_t i=0; i<rays.size(); i++){
+        glm::vec4 value = glm::vec4(0.f, 0.f, 0.f, 1.f);
+        getColor(hits[i], glm::vec4(0.f), value);
+        pixels.addSample(rayPixels[i].x, rayPixels[i].y, value);
+    }
+}
+
+void CpuRaytracer::renderTile(const CameraGPU& camera, const Tile& tile, uint32_t sampleIndex, AdaptiveSampling& pixels) const {
+    // the boxes of the debug display are found by the single ray traversal
+    if(_Parameters._IsPacketTracingOn && !_Parameters._IsBVHDisplayed){
+        renderTilePacket(camera, tile, sampleIndex, pixels);
+        return;
+    }
+    for(uint32_t y=tile._Y0; y<tile._Y1; y++){
+        for(uint32_t x=tile._X0; x<tile._X1; x++){
+            if(!pixels.isConverged(x, y)){
+                pixels.addSample(x, y, renderPixel(camera, x, y, getJitter(x, y, sampleIndex)));
+            }
+        }
+    }
+}
+
+std::vector<glm::vec4> CpuRaytracer::render(const CameraGPU& camera){
+    uint32_t width = _Parameters._Width;
+    uint32_t height = _Parameters._Height;
+    AdaptiveSampling pixels = AdaptiveSampling(width, height, _Parameters._Sampling);
+    if(_Parameters._Sampling._MaxNbSamples > 1 && _Sampler == nullptr){
+        _Sampler = SamplerPtr(new Sampler(SAMPLER_SOBOL));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    // the cost of a tile depends on the geometry it sees
+    TileScheduler scheduler = TileScheduler(_Parameters._NbThreads);
+    uint32_t tileSize = _Parameters._IsTileSizeAdaptive
+        ? scheduler.getAdaptiveTileSize(width, height, _Parameters._TileSize)
+        : _Parameters._TileSize;
+    std::vector<Tile> tiles = TileScheduler::getMortonOrderedTiles(width, height, tileSize);
+    _Statistics._Scheduler = {};
+    _Statistics._Scheduler._Threads = std::vector<TileSchedulerThreadStatistics>(scheduler.getNbThreads());
+    uint32_t nbPasses = 0;
+    // the converged tiles are dropped after each pass, the rest stays in Morton order
+    while(!tiles.empty()){
+        uint32_t sampleIndex = nbPasses++;
+        scheduler.run(tiles, [&](const Tile& tile){
+            renderTile(camera, tile, sampleIndex, pixels);
+        });
+        pixels.updateConvergence();
+        _Statistics._Scheduler._WallTime += scheduler._Statistics._WallTime;
+        for(size_t i=0; i<scheduler._Statistics._Threads.size(); i++){
+            TileSchedulerThreadStatistics& total = _Statistics._Scheduler._Threads[i];
+            const TileSchedulerThreadStatistics& pass = scheduler._Statistics._Threads[i];
+            total._BusyTime += pass._BusyTime;
+            total._IdleTime += pass._IdleTime;
+            total._NbTiles += pass._NbTiles;
+            total._NbStolenTiles += pass._NbStolenTiles;
+        }
+        std::erase_if(tiles, [&](const Tile& tile){return pixels.isConverged(tile);});
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    _Statistics._RenderTime = elapsed.count();
+    _Statistics._NbRays = pixels.getTotalNbSamples();
+    _Statistics._TileSize = tileSize;
+    _Statistics._NbPasses = nbPasses;
+    _Statistics._DenoisingTime = 0.;
+    if(_Parameters._IsHeatMapDisplayed){
+        return pixels.getHeatMap();
+    }
+    if(!_Parameters._Denoiser._IsOn){
+        return pixels.getImage();
+    }
+
+    start = std::chrono::steady_clock::now();
+    Denoiser denoiser = Denoiser(width, height, _Parameters._Denoiser);
+    std::vector<glm::vec4> image = denoiser.denoise(pixels.getImage(), renderGuides(camera));
+    elapsed = std::chrono::steady_clock::now() - start;
+    _Statistics._DenoisingTime = elapsed.count();
+    return image;
+}
+
+std::vector<DenoiserGuide> CpuRaytracer::renderGuides(const CameraGPU& camera) const {
+    uint32_t width = _Parameters._Width;
+    uint32_t height = _Parameters._Height;
+    std::vector<DenoiserGuide> guides = std::vector<DenoiserGuide>(static_cast<size_t>(width) * height);
+    #pragma omp parallel for
+    for(uint32_t y=0; y<height; y++){
+        for(uint32_t x=0; x<width; x++){
+            Ray ray = getRay(camera, getPixelPosition(x, y, glm::vec2(0.5f)));
+            Hit hit = traceClosest(Intersection::setupRay(ray), INFINITY);
+            if(!hit._DidHit){
+                continue;
+            }
+            // geometric normal facing the ray, as in shaders/wavefront/shading.glsl
+            glm::vec3 p0, p1, p2;
+            _Scene->getTriangleVertices(hit._InstanceId, hit._TriangleId, p0, p1, p2);
+            glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+            if(glm::dot(normal, ray._Direction) > 0.f){
+                normal = -normal;
+            }
+            DenoiserGuide& guide = guides[static_cast<size_t>(y) * width + x];
+            guide._Normal = normal;
+            guide._Depth = hit._Coords.w;
+            guide._Albedo = glm::vec3(_Scene->getInstanceMaterial(hit._InstanceId)._Color);
+        }
+    }
+    return guides;
+}
+
+void CpuRaytracer::writeImage(const std::string& path, const std::vector<glm::vec4>& image, uint32_t width, uint32_t height){
+    if(image.size() != static_cast<size_t>(width) * height){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "The image doesn't match the given size!\n"
+        );
+    }
+    FILE* file = fopen(path.c_str(), "wb");
+    if(file == nullptr){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::IO_ERROR,
+            "Failed to open the image file `" + path + "'!\n"
+        );
+        return;
+    }
+
+    fprintf(file, "P6\n%u %u\n255\n", width, height);
+    std::vector<unsigned char> row = std::vector<unsigned char>(3 * static_cast<size_t>(width));
+    // the ppm rows go from top to bottom
+    for(uint32_t y=height; y-->0;){
+        for(uint32_t x=0; x<width; x++){
+            const glm::vec4& color = image[static_cast<size_t>(y) * width + x];
+            for(int c=0; c<3; c++){
+                float channel = std::clamp(color[c], 0.f, 1.f);
+                row[3*x + c] = static_cast<unsigned char>(std::lround(channel * 255.f));
+            }
+        }
+        fwrite(row.data(), 1, row.size(), file);
+    }
+
+    if(fclose(file) != 0){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::IO_ERROR,
+            "Failed to write the image file `" + path + "'!\n"
+        );
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "adaptiveSampling.hpp"
+#include "camera.hpp"
+#include "cpuScene.hpp"
+#include "denoiser.hpp"
+#include "intersection.hpp"
+#include "sampler.hpp"
+#include "tileScheduler.hpp"
+
+namespace cr{
+
+class CpuRaytracer;
+using CpuRaytracerPtr = std::shared_ptr<CpuRaytracer>;
+
+struct CpuRaytracerParameters {
+    uint32_t _Width = 0;
+    uint32_t _Height = 0;
+    // pixels rendered by one task, the largest size if adaptive
+    uint32_t _TileSize = 16;
+    bool _IsTileSizeAdaptive = true;
+    // 0 uses as many threads as OpenMP
+    uint32_t _NbThreads = 0;
+    // the primary rays of a tile are traced as one packet
+    bool _IsPacketTracingOn = true;
+    // samples per pixel, jittered if there are more than one
+    AdaptiveSamplingParameters _Sampling = {._IsOn = false, ._MaxNbSamples = 1};
+    // the image shows the number of samples of each pixel instead
+    bool _IsHeatMapDisplayed = false;
+    // filters the image guided by the first hits of the pixel centres
+    DenoiserParameters _Denoiser{};
+    // same options as the frame data of the compute shader
+    bool _IsWireframeModeOn = false;
+    bool _IsBVHDisplayed = false;
+    uint32_t _DepthDisplayBVH = 0;
+};
+
+struct CpuRaytracerStatistics {
+    double _RenderTime = 0.; // in seconds
+    double _DenoisingTime = 0.; // in seconds, not part of _RenderTime
+    uint64_t _NbRays = 0;
+    uint32_t _TileSize = 0;
+    // passes of one sample over the pixels that are not converged
+    uint32_t _NbPasses = 0;
+    // summed over the passes
+    TileSchedulerStatistics _Scheduler{};
+
+    double getRaysPerSecond() const;
+};
+
+/**
+ * Conservative bounds of the rays of a packet, used to cull the boxes missed by all of them
+ * Only valid if every direction is in the same octant and has no null component
+*/
+struct PacketFrustum {
+    bool _IsValid = false;
+    glm::vec3 _OriginMin = glm::vec3(INFINITY);
+    glm::vec3 _OriginMax = glm::vec3(-INFINITY);
+    glm::vec3 _InvDirectionMin = glm::vec3(INFINITY);
+    glm::vec3 _InvDirectionMax = glm::vec3(-INFINITY);
+    float _TMax = -INFINITY;
+
+    static PacketFrustum build(std::span<const RaySetup> rays, std::span<const Hit> hits);
+    // true only if every ray misses the box
+    bool isCulled(const AABB_GPU& aabb) const;
+};
+
+/**
+ * Headless reference of shaders/raytracer.glsl
+ * Same rays, traversal order and colors, the tiles are rendered in parallel by a TileScheduler
+*/
+class CpuRaytracer {
+    public:
+        // a full stack drops the instances and the second children instead of overflowing, as on the gpu
+        static const int TRAVERSAL_STACK_SIZE = 1024;
+        // pushed under the bvh of an instance, the ray goes back to world space when it is popped
+        static const uint32_t TRAVERSAL_INSTANCE_EXIT = 0xFFFFFFFF;
+        // the traversal is still in the top level bvh
+        static const uint32_t NO_INSTANCE = 0xFFFFFFFF;
+        // dimensions of cr::Sampler used by the pixel jitter
+        static const uint32_t JITTER_SAMPLING_DIMENSION = 0;
+        // packets narrowed down to this many rays continue one ray at a time
+        static const uint32_t DIVERGENT_PACKET_SIZE = 4;
+        // rays traced together by the batched queries
+        static const uint32_t QUERY_BATCH_SIZE = 64;
+        // below this many rays the batched queries are not worth sorting
+        static const uint32_t QUERY_SORT_THRESHOLD = 4 * QUERY_BATCH_SIZE;
+        // the batches whose directions are further apart are traced one ray at a time
+        static constexpr float QUERY_PACKET_MIN_COSINE = 0.99f;
+        static constexpr float WIREFRAME_LINE_WIDTH = 0.02f;
+        static constexpr float BVH_LINE_WIDTH = 0.05f;
+        static const glm::vec4 BVH_AABB_COLOR;
+        static const glm::vec4 BVH_AABB_LINE_COLOR;
+
+    private:
+        CpuScenePtr _Scene = nullptr;
+        // only built once several samples are asked for
+        SamplerPtr _Sampler = nullptr;
+
+    public:
+        CpuRaytracerParameters _Parameters{};
+        CpuRaytracerStatistics _Statistics{};
+
+    public:
+        CpuRaytracer(CpuScenePtr scene, const CpuRaytracerParameters& parameters);
+
+    public:
+        // row major image, the first row is the bottom one as in the OpenGL texture
+        // the samples are taken in passes, each one over the tiles that still have noisy pixels
+        std::vector<glm::vec4> render(const CameraGPU& camera);
+        // first hits of the rays through the pixel centres, mirrors the guides written by the compute shaders
+        std::vector<DenoiserGuide> renderGuides(const CameraGPU& camera) const;
+
+        // closest hit in [0, tMax], mirrors shaders/common/traversal.glsl
+        Hit traceClosest(const RaySetup& ray, float tMax) const;
+
+        // any hit in [tMin, tMax] for shadow and occlusion rays, mirrors shaders/common/traversal.glsl
+        // stops at the first hit and visits the largest child first
+        bool traceAnyHit(const RaySetup& ray, float tMin, float tMax) const;
+
+        // batched queries of arbitrary rays, limited by their own _TMax
+        // the rays are sorted by origin and direction then traced in packets on every thread
+        void traceClosest(std::span<const Ray> rays, std::span<Hit> hits) const;
+        void traceAnyHit(std::span<const Ray> rays, std::span<bool> areOccluded) const;
+
+        // closest hits of coherent rays, such as the primary rays of a tile
+        // hits[i]._Coords.w is the maximum distance of rays[i] on input
+        void tracePacket(std::span<const RaySetup> rays, std::span<Hit> hits) const;
+
+        // pos between 0 and 1, mirrors getRay of shaders/common/camera.glsl
+        static Ray getRay(const CameraGPU& camera, const glm::vec2& pos);
+
+        // binary ppm, the colors are clamped to [0, 1]
+        static void writeImage(const std::string& path, const std::vector<glm::vec4>& image, uint32_t width, uint32_t height);
+
+    private:
+        std::vector<uint32_t> getCoherentOrder(std::span<const Ray> rays) const;
+        // the ray is in the space of the instance, world space if NO_INSTANCE
+        void traceSubtree(const RaySetup& ray, uint32_t rootNode, uint32_t instanceIndex, Hit& closestHit) const;
+        void tracePacketSubtree(std::span<const RaySetup> rays, std::span<Hit> hits, uint32_t rootNode, uint32_t instanceIndex) const;
+        // position of the sample in its pixel, the centre is the corner of the pixel as in shaders/common/camera.glsl
+        glm::vec2 getJitter(uint32_t x, uint32_t y, uint32_t sampleIndex) const;
+        glm::vec2 getPixelPosition(uint32_t x, uint32_t y, const glm::vec2& jitter) const;
+        glm::vec4 renderPixel(const CameraGPU& camera, uint32_t x, uint32_t y, const glm::vec2& jitter) const;
+        // adds one sample to the pixels of the tile that are not converged
+        void renderTile(const CameraGPU& camera, const Tile& tile, uint32_t sampleIndex, AdaptiveSampling& pixels) const;
+        void renderTilePacket(const CameraGPU& camera, const Tile& tile, uint32_t sampleIndex, AdaptiveSampling& pixels) const;
+        Hit getClosestHitBVH(const RaySetup& ray, glm::vec4& bvhColor) const;
+        uint32_t intersectBVH(const RaySetup& ray, const BVH_NodeGPU& node, float tMax) const;
+        void getColor(const Hit& hit, const glm::vec4& bvhColor, glm::vec4& color) const;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "cpuScene.hpp"
+
+#include <algorithm>
+
+#include "errorHandler.hpp"
+
+namespace cr{
+
+static std::vector<MeshInstance> getMeshInstances(const std::vector<MeshPtr>& meshes){
+    std::vector<MeshInstance> instances{};
+    for(const MeshPtr& mesh : meshes){
+        instances.push_back({mesh, mesh->_InternalStruct._ModelMatrix, mesh->_InternalStruct._MaterialId});
+    }
+    return instances;
+}
+
+CpuScene::CpuScene(const std::vector<MeshPtr>& meshes, const std::vector<Material>& materials)
+    : CpuScene(getMeshInstances(meshes), materials){}
+
+CpuScene::CpuScene(const std::vector<MeshInstance>& instances, const std::vector<Material>& materials){
+    if(instances.size() > Mesh::MAX_NB_INSTANCES){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "Too many instances in the scene, the last ones are ignored!\n",
+            ErrorLevel::WARNING
+        );
+    }
+
+    for(const Material& material : materials){
+        _Materials.push_back(material._InternalStruct);
+    }
+
+    // same order and limits as glr::Scene, each distinct mesh is stored once
+    std::vector<MeshPtr> meshes{};
+    std::vector<GeometryRange> meshRanges{};
+    std::vector<uint32_t> instanceMeshes{};
+    for(size_t i=0; i<std::min(instances.size(), Mesh::MAX_NB_INSTANCES); i++){
+        const MeshInstance& instance = instances[i];
+        if(instance._MaterialId >= _Materials.size()){
+            ErrorHandler::handle(
+                __FILE__, __LINE__,
+                ErrorCode::BAD_VALUE_ERROR,
+                "An instance refers to a material which is not in the scene!\n"
+            );
+        }
+        const MeshPtr& mesh = instance._Mesh;
+        uint32_t meshIndex = std::find(meshes.begin(), meshes.end(), mesh) - meshes.begin();
+        if(meshIndex == meshes.size()){
+            if(meshes.size() == Mesh::MAX_NB_MESHES || !_Geometry.canFit(*mesh)){
+                ErrorHandler::handle(
+                    __FILE__, __LINE__,
+                    ErrorCode::BAD_VALUE_ERROR,
+                    "Too many meshes, vertices or triangles in the scene, the mesh is ignored!\n",
+                    ErrorLevel::WARNING
+                );
+                continue;
+            }
+            meshRanges.push_back(_Geometry.append(*mesh, meshIndex));
+            meshes.push_back(mesh);
+        }
+        if(mesh->getNbTriangles() == 0){
+            continue;
+        }
+        MeshModelGPU model{};
+        model._ModelMatrix = instance._ModelMatrix;
+        model._InvModelMatrix = glm::inverse(instance._ModelMatrix);
+        model._MaterialId = instance._MaterialId;
+        model._FirstTriangle = meshRanges[meshIndex]._FirstTriangle;
+        model._NbTriangles = mesh->getNbTriangles();
+        _Models.push_back(model);
+        instanceMeshes.push_back(meshIndex);
+    }
+    _NbMeshes = meshes.size();
+    if(_Models.empty()){
+        return;
+    }
+
+    // the bottom level bvhs follow the 2n-1 nodes of the top level one
+    std::vector<BVH_NodeGPU> meshNodes{};
+    std::vector<uint32_t> meshRoots = std::vector<uint32_t>(_NbMeshes, 0);
+    std::vector<AABB_GPU> meshBoxes = std::vector<AABB_GPU>(_NbMeshes);
+    uint32_t firstNode = 2 * _Models.size() - 1;
+    for(uint32_t meshIndex=0; meshIndex<_NbMeshes; meshIndex++){
+        const GeometryRange& range = meshRanges[meshIndex];
+        if(range._NbTriangles == 0){
+            continue;
+        }
+        BVH_Ptr bvh = BVH::buildBottomLevel(_Geometry.getTriangles(), range._FirstTriangle, range._NbTriangles, _Geometry.getVertices());
+        meshRoots[meshIndex] = firstNode + meshNodes.size();
+        meshBoxes[meshIndex] = bvh->getRootAABB();
+        std::vector<BVH_NodeGPU> nodes = bvh->getFlattenedNodes(meshRoots[meshIndex], range._FirstTriangle);
+        meshNodes.insert(meshNodes.end(), nodes.begin(), nodes.end());
+    }
+
+    std::vector<AABB_GPU> modelBoxes = std::vector<AABB_GPU>(_Models.size());
+    for(size_t i=0; i<_Models.size(); i++){
+        _Models[i]._BVH_Root = meshRoots[instanceMeshes[i]];
+        modelBoxes[i] = meshBoxes[instanceMeshes[i]];
+    }
+    _BVH_Nodes = BVH::buildTopLevel(_Models, _Models.size(), modelBoxes)->getFlattenedNodes();
+    _BVH_Nodes.insert(_BVH_Nodes.end(), meshNodes.begin(), meshNodes.end());
+}
+
+uint32_t CpuScene::getNbTriangles() const {
+    return _Geometry.getNbTriangles();
+}
+
+uint32_t CpuScene::getNbVertices() const {
+    return _Geometry.getNbVertices();
+}
+
+uint32_t CpuScene::getNbMeshes() const {
+    return _NbMeshes;
+}
+
+uint32_t CpuScene::getNbInstances() const {
+    return _Models.size();
+}
+
+const std::vector<BVH_NodeGPU>& CpuScene::getBVH_Nodes() const {
+    return _BVH_Nodes;
+}
+
+const MeshModelGPU& CpuScene::getInstance(uint32_t instanceIndex) const {
+    return _Models[instanceIndex];
+}
+
+void CpuScene::getTriangleVertices(uint32_t instanceIndex, uint32_t triangleIndex, glm::vec3& p0, glm::vec3& p1, glm::vec3& p2) const {
+    Triangle::getVertices(_Geometry.getTriangles()[triangleIndex], _Geometry.getVertices(), _Models[instanceIndex]._ModelMatrix, p0, p1, p2);
+}
+
+const MaterialGPU& CpuScene::getInstanceMaterial(uint32_t instanceIndex) const {
+    return _Materials[_Models[instanceIndex]._MaterialId];
+}
+
+RaySetup CpuScene::getInstanceRay(const RaySetup& ray, uint32_t instanceIndex) const {
+    const glm::mat4& invModel = _Models[instanceIndex]._InvModelMatrix;
+    Ray modelRay{};
+    modelRay._Origin = glm::vec3(invModel * glm::vec4(ray._Origin, 1.f));
+    // not normalized, a distance along the ray is the same in both spaces
+    modelRay._Direction = glm::vec3(invModel * glm::vec4(ray._Direction, 0.f));
+    return Intersection::setupRay(modelRay);
+}
+
+Hit CpuScene::rayTriangleIntersection(const RaySetup& ray, uint32_t triangleIndex, float tMax) const {
+    Hit hit{};
+    const std::vector<glm::vec3>& vertices = _Geometry.getVertices();
+    const TriangleGPU& triangle = _Geometry.getTriangles()[triangleIndex];
+    if(Intersection::rayTriangle(ray,
+        vertices[triangle._Indices[0]], vertices[triangle._Indices[1]], vertices[triangle._Indices[2]],
+        tMax, hit)){
+        hit._TriangleId = triangleIndex;
+    }
+    return hit;
+}
+
+bool CpuScene::isTriangleOccluding(const RaySetup& ray, uint32_t triangleIndex, float tMin, float tMax) const {
+    const std::vector<glm::vec3>& vertices = _Geometry.getVertices();
+    const TriangleGPU& triangle = _Geometry.getTriangles()[triangleIndex];
+    return Intersection::rayTriangleOcclusion(ray,
+        vertices[triangle._Indices[0]], vertices[triangle._Indices[1]], vertices[triangle._Indices[2]],
+        tMin, tMax);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+#include "bvh.hpp"
+#include "geometryArena.hpp"
+#include "intersection.hpp"
+#include "material.hpp"
+#include "mesh.hpp"
+
+namespace cr{
+
+class CpuScene;
+using CpuScenePtr = std::shared_ptr<CpuScene>;
+
+/**
+ * Scene data laid out as in the buffers of glr::Scene
+ * Each distinct mesh is stored once, its triangles index its vertices in the vertices of the scene
+ * The instances place the meshes with their own transform and material
+ * The nodes start with the top level bvh over the instances, followed by the model space bvh of each mesh
+*/
+class CpuScene {
+    private:
+        GeometryArena _Geometry{};
+        std::vector<MeshModelGPU> _Models{};
+        std::vector<MaterialGPU> _Materials{};
+        std::vector<BVH_NodeGPU> _BVH_Nodes{};
+        uint32_t _NbMeshes = 0;
+
+    public:
+        // one instance per mesh with the model and material of the mesh
+        CpuScene(const std::vector<MeshPtr>& meshes, const std::vector<Material>& materials);
+        // the material ids of the instances index the given materials
+        CpuScene(const std::vector<MeshInstance>& instances, const std::vector<Material>& materials);
+
+    public:
+        uint32_t getNbTriangles() const;
+        uint32_t getNbVertices() const;
+        uint32_t getNbMeshes() const;
+        uint32_t getNbInstances() const;
+        const std::vector<BVH_NodeGPU>& getBVH_Nodes() const;
+        const MeshModelGPU& getInstance(uint32_t instanceIndex) const;
+
+        // positions in world space
+        void getTriangleVertices(uint32_t instanceIndex, uint32_t triangleIndex, glm::vec3& p0, glm::vec3& p1, glm::vec3& p2) const;
+        const MaterialGPU& getInstanceMaterial(uint32_t instanceIndex) const;
+        // the ray in the model space of the instance, the distances along it are the same
+        RaySetup getInstanceRay(const RaySetup& ray, uint32_t instanceIndex) const;
+        // the ray is in model space
+        Hit rayTriangleIntersection(const RaySetup& ray, uint32_t triangleIndex, float tMax) const;
+        bool isTriangleOccluding(const RaySetup& ray, uint32_t triangleIndex, float tMin, float tMax) const;
+};
+
+}
\ No newline at end of file
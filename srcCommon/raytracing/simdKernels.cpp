@@ -0,0 +1,87 @@
+#include "simdKernels.hpp"
+
+#include "errorHandler.hpp"
+
+namespace cr{
+
+uint32_t TrianglesSoA::size() const {
+    return _Size;
+}
+
+void TrianglesSoA::push(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2){
+    glm::vec3 edge1 = p1 - p0;
+    glm::vec3 edge2 = p2 - p0;
+    for(int axis=0; axis<3; axis++){
+        if(_Size % PADDING == 0){
+            // degenerate triangles in the padding never hit
+            _P0[axis].resize(_Size + PADDING, 0.f);
+            _Edge1[axis].resize(_Size + PADDING, 0.f);
+            _Edge2[axis].resize(_Size + PADDING, 0.f);
+        }
+        _P0[axis][_Size] = p0[axis];
+        _Edge1[axis][_Size] = edge1[axis];
+        _Edge2[axis][_Size] = edge2[axis];
+    }
+    _Size++;
+}
+
+uint32_t AABBsSoA::size() const {
+    return _Size;
+}
+
+void AABBsSoA::push(const AABB_GPU& aabb){
+    for(int axis=0; axis<3; axis++){
+        if(_Size % PADDING == 0){
+            _Min[axis].resize(_Size + PADDING, 0.f);
+            _Max[axis].resize(_Size + PADDING, 0.f);
+        }
+        _Min[axis][_Size] = aabb._Min[axis];
+        _Max[axis][_Size] = aabb._Max[axis];
+    }
+    _Size++;
+}
+
+bool SimdKernels::isSupported(SimdIsa isa){
+#if defined(__x86_64__) || defined(__i386__)
+    switch(isa){
+        case SIMD_SSE4:
+            return __builtin_cpu_supports("sse4.1");
+        case SIMD_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case SIMD_AVX512:
+            return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    // the kernels are only built for the generic vectors of the target
+    return isa == SIMD_SSE4;
+#endif
+}
+
+const SimdKernels& SimdKernels::get(){
+    // checked once, the cpu doesn't change
+    static const SimdKernels& best = isSupported(SIMD_AVX512) ? getAVX512()
+        : isSupported(SIMD_AVX2) ? getAVX2()
+        : getSSE4();
+    return best;
+}
+
+const SimdKernels& SimdKernels::get(SimdIsa isa){
+    if(!isSupported(isa)){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "This instruction set is not supported by the cpu!\n"
+        );
+    }
+    switch(isa){
+        case SIMD_AVX512:
+            return getAVX512();
+        case SIMD_AVX2:
+            return getAVX2();
+        default:
+            return getSSE4();
+    }
+}
+
+}
\ No newline at end of file
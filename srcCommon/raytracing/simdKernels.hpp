@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "bvh.hpp"
+#include "intersection.hpp"
+
+namespace cr{
+
+enum SimdIsa {
+    SIMD_SSE4,
+    SIMD_AVX2,
+    SIMD_AVX512,
+};
+
+/**
+ * Triangles in structure of arrays layout, stored as a vertex and two edges
+ * The arrays are padded so that the widest kernel can always load a full register
+*/
+class TrianglesSoA {
+    public:
+        static const uint32_t PADDING = 16;
+
+    public:
+        std::vector<float> _P0[3];
+        std::vector<float> _Edge1[3];
+        std::vector<float> _Edge2[3];
+
+    private:
+        uint32_t _Size = 0;
+
+    public:
+        uint32_t size() const;
+        void push(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2);
+};
+
+/**
+ * Boxes in structure of arrays layout, padded like TrianglesSoA
+*/
+class AABBsSoA {
+    public:
+        static const uint32_t PADDING = 16;
+
+    public:
+        std::vector<float> _Min[3];
+        std::vector<float> _Max[3];
+
+    private:
+        uint32_t _Size = 0;
+
+    public:
+        uint32_t size() const;
+        void push(const AABB_GPU& aabb);
+};
+
+// closest hit of the triangles [first, first+count) in ]0, tMax[, hit._TriangleId is the index in the array
+// matches Intersection::rayTriangleMollerTrumbore called on each triangle in order
+using ClosestTriangleKernel = bool (*)(const RaySetup& ray, const TrianglesSoA& triangles, uint32_t first, uint32_t count, float tMax, Hit& hit);
+// entry distance of each box [first, first+count) or -1 if missed, returns the number of boxes hit
+// matches Intersection::rayAABB
+using IntersectBoxesKernel = uint32_t (*)(const RaySetup& ray, const AABBsSoA& boxes, uint32_t first, uint32_t count, float tMax, float* tEntries);
+
+/**
+ * One ray against several triangles or boxes at once
+ * The kernels are compiled once per instruction set and chosen at runtime
+ * They are not used by CpuRaytracer yet: its binary bvh with a triangle per leaf never has more than two
+ * boxes or one triangle to test at once, and its triangle test is the watertight one, not Moller-Trumbore
+*/
+struct SimdKernels {
+    SimdIsa _Isa = SIMD_SSE4;
+    // number of primitives per register
+    uint32_t _Width = 4;
+    ClosestTriangleKernel _ClosestTriangle = nullptr;
+    IntersectBoxesKernel _IntersectBoxes = nullptr;
+
+    static bool isSupported(SimdIsa isa);
+    // widest supported kernels, sse4 is the fallback
+    static const SimdKernels& get();
+    static const SimdKernels& get(SimdIsa isa);
+
+    private:
+        // defined in the translation unit compiled for each instruction set
+        static const SimdKernels& getSSE4();
+        static const SimdKernels& getAVX2();
+        static const SimdKernels& getAVX512();
+};
+
+}
\ No newline at end of file
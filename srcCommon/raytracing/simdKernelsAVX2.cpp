@@ -0,0 +1,12 @@
+// the kernels are compiled for AVX2, see simdKernelsImpl.hpp
+#define SIMD_KERNELS_TARGET "avx2"
+#include "simdKernelsImpl.hpp"
+
+namespace cr{
+
+const SimdKernels& SimdKernels::getAVX2(){
+    static const SimdKernels kernels = getKernels<8>(SIMD_AVX2);
+    return kernels;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+// the kernels are compiled for AVX512F, see simdKernelsImpl.hpp
+#define SIMD_KERNELS_TARGET "avx512f"
+#include "simdKernelsImpl.hpp"
+
+namespace cr{
+
+const SimdKernels& SimdKernels::getAVX512(){
+    static const SimdKernels kernels = getKernels<16>(SIMD_AVX512);
+    return kernels;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#pragma once
+
+// kernels of simdKernels.hpp written once for any register width
+// only included by the translation units of each instruction set, which define SIMD_KERNELS_TARGET,
+// only the functions marked SIMD_TARGET are compiled for it: they have internal linkage and read raw arrays
+// so that no inline function shared with the rest of the program is emitted with the wider instructions
+
+#include <cstdint>
+#include <cstring>
+
+#include "simdKernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define SIMD_TARGET __attribute__((target(SIMD_KERNELS_TARGET)))
+#else
+    #define SIMD_TARGET
+#endif
+
+namespace cr{
+
+namespace {
+
+template<uint32_t W>
+struct Simd {
+    typedef float Float __attribute__((vector_size(W * sizeof(float))));
+    typedef int Mask __attribute__((vector_size(W * sizeof(int))));
+
+    SIMD_TARGET static Float load(const float* values){
+        Float result;
+        std::memcpy(&result, values, sizeof(Float));
+        return result;
+    }
+
+    SIMD_TARGET static Float broadcast(float value){
+        return Float{} + value;
+    }
+};
+
+// lanes of the register at start that are in [first, end), the others read the padding
+template<uint32_t W>
+SIMD_TARGET typename Simd<W>::Mask validLanes(uint32_t start, uint32_t first, uint32_t end){
+    typename Simd<W>::Mask result{};
+    for(uint32_t i=0; i<W; i++){
+        result[i] = start + i >= first && start + i < end ? -1 : 0;
+    }
+    return result;
+}
+
+// the loads start on a multiple of the width, the padding of the arrays covers the last register
+template<uint32_t W>
+SIMD_TARGET bool closestTriangleRange(const RaySetup& ray, const float* const* p0, const float* const* edge1, const float* const* edge2,
+                                      uint32_t first, uint32_t count, float tMax, Hit& hit){
+    using S = Simd<W>;
+    using Float = typename S::Float;
+    using Mask = typename S::Mask;
+
+    const Float dx = S::broadcast(ray._Direction.x);
+    const Float dy = S::broadcast(ray._Direction.y);
+    const Float dz = S::broadcast(ray._Direction.z);
+    const Float ox = S::broadcast(ray._Origin.x);
+    const Float oy = S::broadcast(ray._Origin.y);
+    const Float oz = S::broadcast(ray._Origin.z);
+    const Float zero = S::broadcast(0.f);
+    const Float one = S::broadcast(1.f);
+    const Float epsilon = S::broadcast(Intersection::MOLLER_TRUMBORE_EPSILON);
+
+    bool didHit = false;
+    uint32_t end = first + count;
+    for(uint32_t start=first-first%W; start<end; start+=W){
+        Mask active = validLanes<W>(start, first, end);
+
+        Float e1x = S::load(edge1[0] + start);
+        Float e1y = S::load(edge1[1] + start);
+        Float e1z = S::load(edge1[2] + start);
+        Float e2x = S::load(edge2[0] + start);
+        Float e2y = S::load(edge2[1] + start);
+        Float e2z = S::load(edge2[2] + start);
+
+        Float px = dy * e2z - dz * e2y;
+        Float py = dz * e2x - dx * e2z;
+        Float pz = dx * e2y - dy * e2x;
+        Float det = e1x * px + e1y * py + e1z * pz;
+        // the rejections are negated rather than inverted to treat NaN like the scalar test
+        active &= ~((det > -epsilon) & (det < epsilon));
+        Float inverseDet = one / det;
+
+        Float tx = ox - S::load(p0[0] + start);
+        Float ty = oy - S::load(p0[1] + start);
+        Float tz = oz - S::load(p0[2] + start);
+        Float u = (tx * px + ty * py + tz * pz) * inverseDet;
+        active &= ~((u < zero) | (u > one));
+
+        Float qx = ty * e1z - tz * e1y;
+        Float qy = tz * e1x - tx * e1z;
+        Float qz = tx * e1y - ty * e1x;
+        Float v = (dx * qx + dy * qy + dz * qz) * inverseDet;
+        active &= ~((v < zero) | (u + v > one));
+
+        Float t = (e2x * qx + e2y * qy + e2z * qz) * inverseDet;
+
+        // the distances are checked in order against the closest one, as in a sequential loop
+        int32_t closestLane = -1;
+        for(uint32_t i=0; i<W; i++){
+            if(active[i] != 0 && !(t[i] <= 0.f || t[i] >= tMax)){
+                tMax = t[i];
+                closestLane = i;
+            }
+        }
+        if(closestLane >= 0){
+            hit._Coords.x = 1.f - u[closestLane] - v[closestLane];
+            hit._Coords.y = u[closestLane];
+            hit._Coords.z = v[closestLane];
+            hit._Coords.w = t[closestLane];
+            hit._DidHit = true;
+            hit._TriangleId = start + closestLane;
+            didHit = true;
+        }
+    }
+    return didHit;
+}
+
+template<uint32_t W>
+SIMD_TARGET uint32_t intersectBoxesRange(const RaySetup& ray, const float* const* mins, const float* const* maxs,
+                                         uint32_t first, uint32_t count, float tMax, float* tEntries){
+    using S = Simd<W>;
+    using Float = typename S::Float;
+    using Mask = typename S::Mask;
+
+    const Float rounding = S::broadcast(1.f + 2.f * Intersection::GAMMA_3);
+    const Float zero = S::broadcast(0.f);
+    const Float tMaxes = S::broadcast(tMax);
+    const float origin[3] = {ray._Origin.x, ray._Origin.y, ray._Origin.z};
+    const float invDirection[3] = {ray._InvDirection.x, ray._InvDirection.y, ray._InvDirection.z};
+    const uint32_t sign[3] = {ray._Sign.x, ray._Sign.y, ray._Sign.z};
+
+    uint32_t nbHits = 0;
+    uint32_t end = first + count;
+    for(uint32_t start=first-first%W; start<end; start+=W){
+        Float tNears[3];
+        Float tFars[3];
+        for(int axis=0; axis<3; axis++){
+            const float* nearBounds = sign[axis] == 0 ? mins[axis] : maxs[axis];
+            const float* farBounds = sign[axis] == 0 ? maxs[axis] : mins[axis];
+            Float origins = S::broadcast(origin[axis]);
+            Float invDirections = S::broadcast(invDirection[axis]);
+            tNears[axis] = (S::load(nearBounds + start) - origins) * invDirections;
+            // conservative rounding so that the exit distance is never underestimated
+            tFars[axis] = (S::load(farBounds + start) - origins) * invDirections;
+            tFars[axis] *= rounding;
+        }
+
+        // same selections as the scalar test so that NaN never culls
+        Float tNear = tNears[0];
+        tNear = tNears[1] > tNear ? tNears[1] : tNear;
+        tNear = tNears[2] > tNear ? tNears[2] : tNear;
+        Float tFar = tFars[0];
+        tFar = tFars[1] < tFar ? tFars[1] : tFar;
+        tFar = tFars[2] < tFar ? tFars[2] : tFar;
+
+        tNear = tNear < zero ? zero : tNear;
+        tFar = tMaxes < tFar ? tMaxes : tFar;
+        Mask isHit = (tNear > tFar) == 0;
+        Float result = isHit ? tNear : S::broadcast(-1.f);
+
+        Mask isValid = validLanes<W>(start, first, end);
+        for(uint32_t i=0; i<W; i++){
+            if(isValid[i] != 0){
+                tEntries[start + i - first] = result[i];
+                nbHits += isHit[i] != 0 ? 1 : 0;
+            }
+        }
+    }
+    return nbHits;
+}
+
+// the arrays are taken out of the vectors outside of the target specific code
+template<uint32_t W>
+bool closestTriangle(const RaySetup& ray, const TrianglesSoA& triangles, uint32_t first, uint32_t count, float tMax, Hit& hit){
+    const float* p0[3] = {triangles._P0[0].data(), triangles._P0[1].data(), triangles._P0[2].data()};
+    const float* edge1[3] = {triangles._Edge1[0].data(), triangles._Edge1[1].data(), triangles._Edge1[2].data()};
+    const float* edge2[3] = {triangles._Edge2[0].data(), triangles._Edge2[1].data(), triangles._Edge2[2].data()};
+    return closestTriangleRange<W>(ray, p0, edge1, edge2, first, count, tMax, hit);
+}
+
+template<uint32_t W>
+uint32_t intersectBoxes(const RaySetup& ray, const AABBsSoA& boxes, uint32_t first, uint32_t count, float tMax, float* tEntries){
+    const float* mins[3] = {boxes._Min[0].data(), boxes._Min[1].data(), boxes._Min[2].data()};
+    const float* maxs[3] = {boxes._Max[0].data(), boxes._Max[1].data(), boxes._Max[2].data()};
+    return intersectBoxesRange<W>(ray, mins, maxs, first, count, tMax, tEntries);
+}
+
+template<uint32_t W>
+SimdKernels getKernels(SimdIsa isa){
+    SimdKernels kernels{};
+    kernels._Isa = isa;
+    kernels._Width = W;
+    kernels._ClosestTriangle = &closestTriangle<W>;
+    kernels._IntersectBoxes = &intersectBoxes<W>;
+    return kernels;
+}
+
+}
+
+}
\ No newline at end of file
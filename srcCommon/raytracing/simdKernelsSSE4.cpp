@@ -0,0 +1,12 @@
+// the kernels are compiled for SSE4.2, see simdKernelsImpl.hpp
+#define SIMD_KERNELS_TARGET "sse4.2"
+#include "simdKernelsImpl.hpp"
+
+namespace cr{
+
+const SimdKernels& SimdKernels::getSSE4(){
+    static const SimdKernels kernels = getKernels<4>(SIMD_SSE4);
+    return kernels;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "tileScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <omp.h>
+
+#include "errorHandler.hpp"
+
+namespace cr{
+
+double TileSchedulerStatistics::getEfficiency() const {
+    double busyTime = 0.;
+    for(const TileSchedulerThreadStatistics& thread : _Threads){
+        busyTime += thread._BusyTime;
+    }
+    double totalTime = _WallTime * _Threads.size();
+    return totalTime > 0. ? busyTime / totalTime : 0.;
+}
+
+TileScheduler::TileScheduler(uint32_t nbThreads){
+    _NbThreads = nbThreads == 0 ? static_cast<uint32_t>(omp_get_max_threads()) : nbThreads;
+}
+
+uint32_t TileScheduler::getNbThreads() const {
+    return _NbThreads;
+}
+
+uint32_t TileScheduler::getAdaptiveTileSize(uint32_t width, uint32_t height, uint32_t maxTileSize) const {
+    if(maxTileSize < MIN_TILE_SIZE){
+        return std::max(maxTileSize, 1u);
+    }
+    uint32_t tileSize = MIN_TILE_SIZE;
+    while(2 * tileSize <= maxTileSize){
+        uint32_t nbTiles = ((width + 2*tileSize - 1) / (2*tileSize)) * ((height + 2*tileSize - 1) / (2*tileSize));
+        if(nbTiles < TILES_PER_THREAD * _NbThreads){
+            break;
+        }
+        tileSize *= 2;
+    }
+    return tileSize;
+}
+
+uint32_t TileScheduler::morton2D(uint32_t x, uint32_t y){
+    // spread the lowest 16 bits
+    auto spread = [](uint32_t v){
+        v &= 0x0000ffff;
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1);
+}
+
+std::vector<Tile> TileScheduler::getMortonOrderedTiles(uint32_t width, uint32_t height, uint32_t tileSize){
+    if(tileSize == 0){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "The tiles can't be empty!\n"
+        );
+    }
+    uint32_t nbTilesX = (width + tileSize - 1) / tileSize;
+    uint32_t nbTilesY = (height + tileSize - 1) / tileSize;
+    std::vector<std::pair<uint32_t, Tile>> codedTiles{};
+    codedTiles.reserve(nbTilesX * nbTilesY);
+    for(uint32_t j=0; j<nbTilesY; j++){
+        for(uint32_t i=0; i<nbTilesX; i++){
+            Tile tile{};
+            tile._X0 = i * tileSize;
+            tile._Y0 = j * tileSize;
+            tile._X1 = std::min(tile._X0 + tileSize, width);
+            tile._Y1 = std::min(tile._Y0 + tileSize, height);
+            codedTiles.emplace_back(morton2D(i, j), tile);
+        }
+    }
+    std::sort(codedTiles.begin(), codedTiles.end(), [](const auto& a, const auto& b){
+        return a.first < b.first;
+    });
+
+    std::vector<Tile> tiles{};
+    tiles.reserve(codedTiles.size());
+    for(const auto& codedTile : codedTiles){
+        tiles.push_back(codedTile.second);
+    }
+    return tiles;
+}
+
+bool TileScheduler::popTile(WorkQueue& queue, Tile& tile){
+    std::lock_guard<std::mutex> lock(queue._Mutex);
+    if(queue._Tiles.empty()){
+        return false;
+    }
+    tile = queue._Tiles.front();
+    queue._Tiles.pop_front();
+    return true;
+}
+
+bool TileScheduler::stealTile(WorkQueue& queue, Tile& tile){
+    std::lock_guard<std::mutex> lock(queue._Mutex);
+    if(queue._Tiles.empty()){
+        return false;
+    }
+    // the far end of the range, away from the tiles the owner works on
+    tile = queue._Tiles.back();
+    queue._Tiles.pop_back();
+    return true;
+}
+
+void TileScheduler::run(const std::vector<Tile>& tiles, const std::function<void(const Tile&)>& renderTile){
+    std::vector<WorkQueue> queues = std::vector<WorkQueue>(_NbThreads);
+    // contiguous ranges of the Morton curve
+    for(uint32_t thread=0; thread<_NbThreads; thread++){
+        size_t begin = tiles.size() * thread / _NbThreads;
+        size_t end = tiles.size() * (thread + 1) / _NbThreads;
+        queues[thread]._Tiles.assign(tiles.begin() + begin, tiles.begin() + end);
+    }
+    _Statistics._Threads = std::vector<TileSchedulerThreadStatistics>(_NbThreads);
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    #pragma omp parallel num_threads(_NbThreads)
+    {
+        // OpenMP may give less threads than asked, their tiles are then stolen
+        uint32_t thread = static_cast<uint32_t>(omp_get_thread_num());
+        TileSchedulerThreadStatistics& statistics = _Statistics._Threads[thread];
+        Tile tile{};
+        while(true){
+            bool isStolen = false;
+            bool hasTile = popTile(queues[thread], tile);
+            for(uint32_t i=1; !hasTile && i<_NbThreads; i++){
+                hasTile = stealTile(queues[(thread + i) % _NbThreads], tile);
+                isStolen = hasTile;
+            }
+            // no tile is ever added, an empty pass means that everything is taken
+            if(!hasTile){
+                break;
+            }
+
+            auto tileStart = Clock::now();
+            renderTile(tile);
+            std::chrono::duration<double> tileTime = Clock::now() - tileStart;
+            statistics._BusyTime += tileTime.count();
+            statistics._NbTiles++;
+            statistics._NbStolenTiles += isStolen ? 1 : 0;
+        }
+    }
+    std::chrono::duration<double> wallTime = Clock::now() - start;
+
+    _Statistics._WallTime = wallTime.count();
+    for(TileSchedulerThreadStatistics& statistics : _Statistics._Threads){
+        statistics._IdleTime = std::max(0., _Statistics._WallTime - statistics._BusyTime);
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cr{
+
+class TileScheduler;
+using TileSchedulerPtr = std::shared_ptr<TileScheduler>;
+
+// pixels [x0, x1[ x [y0, y1[
+struct Tile {
+    uint32_t _X0 = 0;
+    uint32_t _Y0 = 0;
+    uint32_t _X1 = 0;
+    uint32_t _Y1 = 0;
+};
+
+struct TileSchedulerThreadStatistics {
+    double _BusyTime = 0.; // in seconds, spent rendering tiles
+    double _IdleTime = 0.; // in seconds, spent looking for tiles or waiting for the others
+    uint32_t _NbTiles = 0;
+    uint32_t _NbStolenTiles = 0;
+};
+
+struct TileSchedulerStatistics {
+    double _WallTime = 0.; // in seconds
+    std::vector<TileSchedulerThreadStatistics> _Threads{};
+
+    // busy time over the total time of the threads, 1 for a perfect load balance
+    double getEfficiency() const;
+};
+
+/**
+ * Work stealing scheduler of the tiles of an image
+ * The tiles are sorted along a Morton curve and split in contiguous ranges, one per thread,
+ * so that a thread renders neighbouring tiles while the idle ones steal from the far end of the others
+*/
+class TileScheduler {
+    public:
+        // the tiles are made smaller until each thread gets this many
+        static const uint32_t TILES_PER_THREAD = 16;
+        static const uint32_t MIN_TILE_SIZE = 4;
+
+    private:
+        struct WorkQueue {
+            std::mutex _Mutex;
+            std::deque<Tile> _Tiles{};
+        };
+
+        uint32_t _NbThreads = 1;
+
+    public:
+        TileSchedulerStatistics _Statistics{};
+
+    public:
+        // 0 uses as many threads as OpenMP
+        TileScheduler(uint32_t nbThreads = 0);
+
+    public:
+        uint32_t getNbThreads() const;
+
+        // largest power of two below maxTileSize giving every thread enough tiles to balance the load
+        uint32_t getAdaptiveTileSize(uint32_t width, uint32_t height, uint32_t maxTileSize) const;
+        static std::vector<Tile> getMortonOrderedTiles(uint32_t width, uint32_t height, uint32_t tileSize);
+
+        // renderTile is called once per tile, from any thread
+        void run(const std::vector<Tile>& tiles, const std::function<void(const Tile&)>& renderTile);
+
+    private:
+        static uint32_t morton2D(uint32_t x, uint32_t y);
+        static bool popTile(WorkQueue& queue, Tile& tile);
+        static bool stealTile(WorkQueue& queue, Tile& tile);
+};
+
+}
\ No newline at end of file
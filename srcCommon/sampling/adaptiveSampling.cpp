@@ -0,0 +1,138 @@
+#include "adaptiveSampling.hpp"
+
+#include <cmath>
+
+namespace cr{
+
+AdaptiveSampling::AdaptiveSampling(uint32_t width, uint32_t height, const AdaptiveSamplingParameters& parameters){
+    _Width = width;
+    _Height = height;
+    _Parameters = parameters;
+    reset();
+}
+
+void AdaptiveSampling::reset(){
+    size_t nbPixels = static_cast<size_t>(_Width) * _Height;
+    _Sums = std::vector<glm::vec4>(nbPixels, glm::vec4(0.f));
+    _SquaredLuminanceSums = std::vector<float>(nbPixels, 0.f);
+    _NbSamples = std::vector<uint32_t>(nbPixels, 0);
+    _AreErrorsBelowTarget = std::vector<uint8_t>(nbPixels, 0);
+    _AreConverged = std::vector<uint8_t>(nbPixels, 0);
+}
+
+size_t AdaptiveSampling::getIndex(uint32_t x, uint32_t y) const {
+    return static_cast<size_t>(y) * _Width + x;
+}
+
+float AdaptiveSampling::getLuminance(const glm::vec3& color){
+    return glm::dot(color, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+}
+
+bool AdaptiveSampling::isErrorBelowTarget(size_t index) const {
+    uint32_t nbSamples = _NbSamples[index];
+    if(nbSamples < 2){
+        return false;
+    }
+    // unbiased variance of the samples, then variance of their mean
+    float n = static_cast<float>(nbSamples);
+    float meanLuminance = getLuminance(glm::vec3(_Sums[index]) / n);
+    float variance = std::max(_SquaredLuminanceSums[index] / n - meanLuminance * meanLuminance, 0.f) * n / (n - 1.f);
+    float error = std::sqrt(variance / n);
+    return error <= _Parameters._ErrorTarget * std::max(meanLuminance, MIN_LUMINANCE);
+}
+
+void AdaptiveSampling::addSample(uint32_t x, uint32_t y, const glm::vec4& sample){
+    size_t index = getIndex(x, y);
+    float luminance = getLuminance(glm::vec3(sample));
+    _Sums[index] += sample;
+    _SquaredLuminanceSums[index] += luminance * luminance;
+    _NbSamples[index]++;
+    _AreErrorsBelowTarget[index] = isErrorBelowTarget(index) ? 1 : 0;
+}
+
+void AdaptiveSampling::updateConvergence(){
+    for(uint32_t y=0; y<_Height; y++){
+        for(uint32_t x=0; x<_Width; x++){
+            size_t index = getIndex(x, y);
+            if(_AreConverged[index] != 0 || _NbSamples[index] == 0){
+                continue;
+            }
+            uint32_t nbSamples = _NbSamples[index];
+            bool isConverged = nbSamples >= _Parameters._MaxNbSamples;
+            if(!isConverged && _Parameters._IsOn && nbSamples >= _Parameters._MinNbSamples){
+                // an edge missed by the first samples of a pixel is usually seen by one of its neighbours
+                isConverged = true;
+                for(uint32_t ny=(y > 0 ? y - 1 : 0); ny<=std::min(y + 1, _Height - 1); ny++){
+                    for(uint32_t nx=(x > 0 ? x - 1 : 0); nx<=std::min(x + 1, _Width - 1); nx++){
+                        isConverged &= _AreErrorsBelowTarget[getIndex(nx, ny)] != 0;
+                    }
+                }
+            }
+            _AreConverged[index] = isConverged ? 1 : 0;
+        }
+    }
+}
+
+bool AdaptiveSampling::isConverged(uint32_t x, uint32_t y) const {
+    return _AreConverged[getIndex(x, y)] != 0;
+}
+
+bool AdaptiveSampling::isConverged(const Tile& tile) const {
+    for(uint32_t y=tile._Y0; y<tile._Y1; y++){
+        for(uint32_t x=tile._X0; x<tile._X1; x++){
+            if(!isConverged(x, y)){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+uint32_t AdaptiveSampling::getNbSamples(uint32_t x, uint32_t y) const {
+    return _NbSamples[getIndex(x, y)];
+}
+
+uint64_t AdaptiveSampling::getTotalNbSamples() const {
+    uint64_t total = 0;
+    for(uint32_t nbSamples : _NbSamples){
+        total += nbSamples;
+    }
+    return total;
+}
+
+glm::vec4 AdaptiveSampling::getMean(uint32_t x, uint32_t y) const {
+    size_t index = getIndex(x, y);
+    return _NbSamples[index] == 0 ? glm::vec4(0.f) : _Sums[index] / static_cast<float>(_NbSamples[index]);
+}
+
+std::vector<glm::vec4> AdaptiveSampling::getImage() const {
+    std::vector<glm::vec4> image = std::vector<glm::vec4>(_Sums.size());
+    for(uint32_t y=0; y<_Height; y++){
+        for(uint32_t x=0; x<_Width; x++){
+            image[getIndex(x, y)] = getMean(x, y);
+        }
+    }
+    return image;
+}
+
+glm::vec3 AdaptiveSampling::getHeatMapColor(float t){
+    t = glm::clamp(t, 0.f, 1.f);
+    return glm::clamp(glm::vec3(
+        1.5f - std::abs(4.f * t - 3.f),
+        1.5f - std::abs(4.f * t - 2.f),
+        1.5f - std::abs(4.f * t - 1.f)
+    ), 0.f, 1.f);
+}
+
+std::vector<glm::vec4> AdaptiveSampling::getHeatMap() const {
+    // logarithmic scale from 1 to the maximum number of samples
+    float maxLog = std::log2(static_cast<float>(std::max(_Parameters._MaxNbSamples, 2u)));
+    std::vector<glm::vec4> heatMap = std::vector<glm::vec4>(_NbSamples.size());
+    for(size_t i=0; i<_NbSamples.size(); i++){
+        float t = std::log2(static_cast<float>(std::max(_NbSamples[i], 1u))) / maxLog;
+        heatMap[i] = glm::vec4(getHeatMapColor(t), 1.f);
+    }
+    return heatMap;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+#include "tileScheduler.hpp"
+
+namespace cr{
+
+class AdaptiveSampling;
+using AdaptiveSamplingPtr = std::shared_ptr<AdaptiveSampling>;
+
+struct AdaptiveSamplingParameters {
+    // if off, every pixel gets the maximum number of samples
+    bool _IsOn = true;
+    // relative standard error of the mean under which a pixel stops receiving samples
+    float _ErrorTarget = 0.01f;
+    // samples taken everywhere before the variance is trusted
+    uint32_t _MinNbSamples = 16;
+    uint32_t _MaxNbSamples = 256;
+};
+
+/**
+ * Running mean and variance of the samples of each pixel, mirrors shaders/accumulation.glsl
+ * A pixel is converged, and receives no more samples, once the standard error of its mean is under the target
+ * The pixels of different tiles can be updated concurrently
+*/
+class AdaptiveSampling {
+    public:
+        // dark pixels are compared to an absolute error instead
+        static constexpr float MIN_LUMINANCE = 1e-2f;
+
+    private:
+        uint32_t _Width = 0;
+        uint32_t _Height = 0;
+        std::vector<glm::vec4> _Sums{};
+        std::vector<float> _SquaredLuminanceSums{};
+        std::vector<uint32_t> _NbSamples{};
+        std::vector<uint8_t> _AreErrorsBelowTarget{};
+        std::vector<uint8_t> _AreConverged{};
+
+    public:
+        AdaptiveSamplingParameters _Parameters{};
+
+    public:
+        AdaptiveSampling(uint32_t width, uint32_t height, const AdaptiveSamplingParameters& parameters = {});
+
+    public:
+        void reset();
+        void addSample(uint32_t x, uint32_t y, const glm::vec4& sample);
+        // flags the converged pixels, once all the samples of a pass are added
+        void updateConvergence();
+
+        bool isConverged(uint32_t x, uint32_t y) const;
+        // true if no pixel of the tile needs more samples
+        bool isConverged(const Tile& tile) const;
+        uint32_t getNbSamples(uint32_t x, uint32_t y) const;
+        uint64_t getTotalNbSamples() const;
+        glm::vec4 getMean(uint32_t x, uint32_t y) const;
+
+        // row major images of the means and of the number of samples of each pixel
+        std::vector<glm::vec4> getImage() const;
+        std::vector<glm::vec4> getHeatMap() const;
+
+        static float getLuminance(const glm::vec3& color);
+        // t in [0, 1], from blue for the fewest samples to red for the most
+        static glm::vec3 getHeatMapColor(float t);
+
+    private:
+        size_t getIndex(uint32_t x, uint32_t y) const;
+        bool isErrorBelowTarget(size_t index) const;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "blueNoise.hpp"
+
+#include <cmath>
+#include <random>
+
+namespace cr{
+
+std::vector<float> BlueNoise::getFilter(){
+    // gaussian of the toroidal distance, indexed by the offset between two texels
+    std::vector<float> filter = std::vector<float>(NB_TEXELS);
+    for(uint32_t y=0; y<SIZE; y++){
+        for(uint32_t x=0; x<SIZE; x++){
+            float dx = static_cast<float>(std::min(x, SIZE - x));
+            float dy = static_cast<float>(std::min(y, SIZE - y));
+            filter[y * SIZE + x] = std::exp(-(dx * dx + dy * dy) / (2.f * FILTER_SIGMA * FILTER_SIGMA));
+        }
+    }
+    return filter;
+}
+
+void BlueNoise::updateEnergy(std::vector<float>& energy, const std::vector<float>& filter, uint32_t texel, float sign){
+    uint32_t texelX = texel % SIZE;
+    uint32_t texelY = texel / SIZE;
+    for(uint32_t y=0; y<SIZE; y++){
+        uint32_t dy = (y + SIZE - texelY) % SIZE;
+        for(uint32_t x=0; x<SIZE; x++){
+            uint32_t dx = (x + SIZE - texelX) % SIZE;
+            energy[y * SIZE + x] += sign * filter[dy * SIZE + dx];
+        }
+    }
+}
+
+uint32_t BlueNoise::getTightestCluster(const std::vector<float>& energy, const std::vector<bool>& pattern){
+    uint32_t tightest = 0;
+    float maxEnergy = -INFINITY;
+    for(uint32_t i=0; i<NB_TEXELS; i++){
+        if(pattern[i] && energy[i] > maxEnergy){
+            maxEnergy = energy[i];
+            tightest = i;
+        }
+    }
+    return tightest;
+}
+
+uint32_t BlueNoise::getLargestVoid(const std::vector<float>& energy, const std::vector<bool>& pattern){
+    uint32_t largest = 0;
+    float minEnergy = INFINITY;
+    for(uint32_t i=0; i<NB_TEXELS; i++){
+        if(!pattern[i] && energy[i] < minEnergy){
+            minEnergy = energy[i];
+            largest = i;
+        }
+    }
+    return largest;
+}
+
+std::vector<uint16_t> BlueNoise::generate(uint32_t seed){
+    std::vector<float> filter = getFilter();
+    std::vector<uint16_t> ranks = std::vector<uint16_t>(NB_TEXELS);
+
+    // random initial pattern
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> distrib(0, NB_TEXELS - 1);
+    uint32_t nbInitialTexels = static_cast<uint32_t>(INITIAL_DENSITY * NB_TEXELS);
+    std::vector<bool> pattern = std::vector<bool>(NB_TEXELS, false);
+    std::vector<float> energy = std::vector<float>(NB_TEXELS, 0.f);
+    for(uint32_t i=0; i<nbInitialTexels; ){
+        uint32_t texel = distrib(gen);
+        if(!pattern[texel]){
+            pattern[texel] = true;
+            updateEnergy(energy, filter, texel, 1.f);
+            i++;
+        }
+    }
+
+    // moves the tightest cluster to the largest void until the pattern is homogeneous
+    for(uint32_t i=0; i<NB_TEXELS; i++){
+        uint32_t cluster = getTightestCluster(energy, pattern);
+        pattern[cluster] = false;
+        updateEnergy(energy, filter, cluster, -1.f);
+        uint32_t largestVoid = getLargestVoid(energy, pattern);
+        pattern[largestVoid] = true;
+        updateEnergy(energy, filter, largestVoid, 1.f);
+        if(largestVoid == cluster){
+            break;
+        }
+    }
+
+    // the initial texels are ranked by removing the tightest clusters
+    std::vector<bool> initialPattern = pattern;
+    std::vector<float> initialEnergy = energy;
+    for(uint32_t rank=nbInitialTexels; rank-- > 0; ){
+        uint32_t cluster = getTightestCluster(energy, pattern);
+        pattern[cluster] = false;
+        updateEnergy(energy, filter, cluster, -1.f);
+        ranks[cluster] = static_cast<uint16_t>(rank);
+    }
+
+    // the others by filling the largest voids
+    // past half of the texels, the largest void among the set texels is the tightest cluster of the unset ones
+    pattern = initialPattern;
+    energy = initialEnergy;
+    for(uint32_t rank=nbInitialTexels; rank<NB_TEXELS; rank++){
+        uint32_t largestVoid = getLargestVoid(energy, pattern);
+        pattern[largestVoid] = true;
+        updateEnergy(energy, filter, largestVoid, 1.f);
+        ranks[largestVoid] = static_cast<uint16_t>(rank);
+    }
+    return ranks;
+}
+
+}
\ No newline at end of file
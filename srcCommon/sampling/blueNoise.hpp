@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace cr{
+
+/**
+ * Tileable blue noise dither arrays
+ * cf Ulichney, "The void-and-cluster method for dither array generation", 1993
+*/
+class BlueNoise {
+    public:
+        static const uint32_t SIZE = 64;
+        static const uint32_t NB_TEXELS = SIZE * SIZE;
+        static const uint32_t NB_RANK_BITS = 12;
+        static_assert(NB_TEXELS == 1u << NB_RANK_BITS);
+
+    private:
+        // standard deviation of the gaussian filter measuring the clusters, in texels
+        static constexpr float FILTER_SIGMA = 1.5f;
+        // proportion of the texels set in the initial pattern
+        static constexpr float INITIAL_DENSITY = 0.1f;
+
+    public:
+        // rank of each texel in [0, NB_TEXELS[, row major, every rank appears once
+        static std::vector<uint16_t> generate(uint32_t seed);
+
+    private:
+        static std::vector<float> getFilter();
+        static void updateEnergy(std::vector<float>& energy, const std::vector<float>& filter, uint32_t texel, float sign);
+        // tightest cluster among the set texels or largest void among the unset ones
+        static uint32_t getTightestCluster(const std::vector<float>& energy, const std::vector<bool>& pattern);
+        static uint32_t getLargestVoid(const std::vector<float>& energy, const std::vector<bool>& pattern);
+};
+
+}
\ No newline at end of file
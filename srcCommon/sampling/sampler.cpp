@@ -0,0 +1,202 @@
+#include "sampler.hpp"
+
+#include "blueNoise.hpp"
+#include "errorHandler.hpp"
+
+namespace cr{
+
+// primitive polynomials and initial direction numbers of the first Sobol dimensions
+// cf Joe and Kuo, "Constructing Sobol sequences with better two-dimensional projections", 2008
+struct SobolPolynomial {
+    uint32_t _Degree;
+    uint32_t _Coefficients;
+    uint32_t _InitialNumbers[3];
+};
+
+static const SobolPolynomial SOBOL_POLYNOMIALS[Sampler::NB_SOBOL_DIMENSIONS] = {
+    {0, 0, {}}, // van der Corput
+    {1, 0, {1}},
+};
+
+Sampler::Sampler(SamplerType type){
+    setSamplerType(type);
+    initSobolMatrices();
+    initBlueNoise();
+}
+
+void Sampler::initSobolMatrices(){
+    for(uint32_t dimension=0; dimension<NB_SOBOL_DIMENSIONS; dimension++){
+        uint32_t* directions = &_SobolMatrices[dimension * NB_SOBOL_BITS];
+        const SobolPolynomial& polynomial = SOBOL_POLYNOMIALS[dimension];
+        if(polynomial._Degree == 0){
+            for(uint32_t bit=0; bit<NB_SOBOL_BITS; bit++){
+                directions[bit] = 1u << (NB_SOBOL_BITS - 1 - bit);
+            }
+            continue;
+        }
+        uint32_t degree = polynomial._Degree;
+        for(uint32_t bit=0; bit<degree; bit++){
+            directions[bit] = polynomial._InitialNumbers[bit] << (NB_SOBOL_BITS - 1 - bit);
+        }
+        for(uint32_t bit=degree; bit<NB_SOBOL_BITS; bit++){
+            directions[bit] = directions[bit - degree] ^ (directions[bit - degree] >> degree);
+            for(uint32_t k=1; k<degree; k++){
+                if((polynomial._Coefficients >> (degree - 1 - k)) & 1){
+                    directions[bit] ^= directions[bit - k];
+                }
+            }
+        }
+    }
+}
+
+std::vector<uint32_t> Sampler::generateBlueNoise(){
+    std::vector<uint16_t> ranksX = BlueNoise::generate(1);
+    std::vector<uint16_t> ranksY = BlueNoise::generate(2);
+    std::vector<uint32_t> blueNoise = std::vector<uint32_t>(BlueNoise::NB_TEXELS);
+    for(uint32_t i=0; i<BlueNoise::NB_TEXELS; i++){
+        blueNoise[i] = static_cast<uint32_t>(ranksX[i]) | (static_cast<uint32_t>(ranksY[i]) << 16);
+    }
+    return blueNoise;
+}
+
+void Sampler::initBlueNoise(){
+    // the tiles only depend on their seeds, they are generated once for every sampler
+    static const std::vector<uint32_t> BLUE_NOISE = generateBlueNoise();
+    _BlueNoise = BLUE_NOISE;
+}
+
+void Sampler::setSamplerType(SamplerType type){
+    _DimensionSamplers.fill(type);
+}
+
+void Sampler::setSamplerType(uint32_t dimension, SamplerType type){
+    if(dimension >= MAX_NB_DIMENSIONS){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "The sampler only has " + std::to_string(MAX_NB_DIMENSIONS) + " dimensions!\n"
+        );
+    }
+    _DimensionSamplers[dimension] = type;
+}
+
+SamplerType Sampler::getSamplerType(uint32_t dimension) const {
+    return _DimensionSamplers[dimension % MAX_NB_DIMENSIONS];
+}
+
+uint32_t Sampler::hash(uint32_t value){
+    uint32_t state = value * 747796405u + 2891336453u;
+    uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+uint32_t Sampler::reverseBits(uint32_t value){
+    value = ((value >> 1) & 0x55555555u) | ((value & 0x55555555u) << 1);
+    value = ((value >> 2) & 0x33333333u) | ((value & 0x33333333u) << 2);
+    value = ((value >> 4) & 0x0F0F0F0Fu) | ((value & 0x0F0F0F0Fu) << 4);
+    value = ((value >> 8) & 0x00FF00FFu) | ((value & 0x00FF00FFu) << 8);
+    return (value >> 16) | (value << 16);
+}
+
+uint32_t Sampler::nestedUniformScramble(uint32_t value, uint32_t seed){
+    // Laine Karras permutation of the reversed bits, with the constants of Vegdahl
+    value = reverseBits(value);
+    value += seed;
+    value ^= value * 0x6c50b47cu;
+    value ^= value * 0xb82f1e52u;
+    value ^= value * 0xc7afe638u;
+    value ^= value * 0x8d22f6e6u;
+    return reverseBits(value);
+}
+
+uint32_t Sampler::sobol(uint32_t index, uint32_t dimension) const {
+    uint32_t result = 0;
+    const uint32_t* directions = &_SobolMatrices[dimension * NB_SOBOL_BITS];
+    for(uint32_t bit=0; index != 0; index >>= 1, bit++){
+        if(index & 1){
+            result ^= directions[bit];
+        }
+    }
+    return result;
+}
+
+uint32_t Sampler::getSeed(const glm::uvec2& pixel, uint32_t dimension){
+    return hash(pixel.x + hash(pixel.y + hash(dimension)));
+}
+
+glm::uvec2 Sampler::getBlueNoise(const glm::uvec2& pixel, uint32_t dimension) const {
+    // each dimension reads the tile at its own offset
+    uint32_t offset = hash(dimension);
+    uint32_t x = (pixel.x + offset) % BlueNoise::SIZE;
+    uint32_t y = (pixel.y + (offset >> 16)) % BlueNoise::SIZE;
+    uint32_t ranks = _BlueNoise[y * BlueNoise::SIZE + x];
+    return glm::uvec2(ranks & 0xFFFFu, ranks >> 16);
+}
+
+glm::uvec2 Sampler::getFixedPoint2D(const glm::uvec2& pixel, uint32_t sampleIndex, uint32_t dimension) const {
+    uint32_t seed = getSeed(pixel, dimension);
+    switch(getSamplerType(dimension)){
+        case SAMPLER_SOBOL: {
+            // shuffled and scrambled Sobol points, the shuffle decorrelates the dimensions
+            uint32_t index = nestedUniformScramble(sampleIndex, seed);
+            return glm::uvec2(
+                nestedUniformScramble(sobol(index, 0), hash(seed + 1)),
+                nestedUniformScramble(sobol(index, 1), hash(seed + 2))
+            );
+        }
+        case SAMPLER_RANK1_LATTICE: {
+            // the first 2^m points form the lattice of 2^m points, shifted modulo 1
+            uint32_t radicalInverse = reverseBits(sampleIndex);
+            return glm::uvec2(
+                radicalInverse + hash(seed + 1),
+                radicalInverse * LATTICE_GENERATOR + hash(seed + 2)
+            );
+        }
+        case SAMPLER_BLUE_NOISE: {
+            // centre of the rank interval, then moved along a low discrepancy sequence
+            glm::uvec2 ranks = getBlueNoise(pixel, dimension);
+            return glm::uvec2(
+                getRankCentre(ranks.x) + sampleIndex * R2_OFFSET_X,
+                getRankCentre(ranks.y) + sampleIndex * R2_OFFSET_Y
+            );
+        }
+        default: {
+            uint32_t x = hash(seed ^ hash(sampleIndex));
+            return glm::uvec2(x, hash(x));
+        }
+    }
+}
+
+uint32_t Sampler::getRankCentre(uint32_t rank){
+    return (2 * rank + 1) << (31 - BlueNoise::NB_RANK_BITS);
+}
+
+float Sampler::toFloat(uint32_t value){
+    // 24 bits so that the result is always below 1
+    return static_cast<float>(value >> 8) * (1.f / 16777216.f);
+}
+
+glm::vec2 Sampler::get2D(const glm::uvec2& pixel, uint32_t sampleIndex, uint32_t dimension) const {
+    glm::uvec2 value = getFixedPoint2D(pixel, sampleIndex, dimension);
+    return glm::vec2(toFloat(value.x), toFloat(value.y));
+}
+
+float Sampler::get1D(const glm::uvec2& pixel, uint32_t sampleIndex, uint32_t dimension) const {
+    // a blue noise value alone follows the golden ratio sequence instead of R2
+    if(getSamplerType(dimension) == SAMPLER_BLUE_NOISE){
+        uint32_t rank = getBlueNoise(pixel, dimension).x;
+        return toFloat(getRankCentre(rank) + sampleIndex * GOLDEN_RATIO_OFFSET);
+    }
+    return toFloat(getFixedPoint2D(pixel, sampleIndex, dimension).x);
+}
+
+std::vector<uint32_t> Sampler::getGpuData() const {
+    std::vector<uint32_t> data = std::vector<uint32_t>(_SobolMatrices.begin(), _SobolMatrices.end());
+    for(SamplerType type : _DimensionSamplers){
+        data.push_back(static_cast<uint32_t>(type));
+    }
+    data.insert(data.end(), _BlueNoise.begin(), _BlueNoise.end());
+    return data;
+}
+
+}
\ No newline at end of file
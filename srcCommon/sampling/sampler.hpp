@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace cr{
+
+class Sampler;
+using SamplerPtr = std::shared_ptr<Sampler>;
+
+// the values are read by shaders/common/sampling.glsl
+enum SamplerType {
+    SAMPLER_WHITE_NOISE = 0,
+    // Owen scrambled Sobol points, each dimension gets its own shuffle of the points
+    SAMPLER_SOBOL = 1,
+    // extensible rank-1 lattice with a random shift per pixel and dimension
+    SAMPLER_RANK1_LATTICE = 2,
+    // tiled blue noise moved along a golden ratio sequence at each sample
+    SAMPLER_BLUE_NOISE = 3,
+};
+
+/**
+ * Per pixel sample sequences, mirrors shaders/common/sampling.glsl
+ * Each dimension picks its sequence, a 2D sample uses the sequence of its first dimension
+ * The tables are built once by the constructor, getGpuData returns them as read by the shaders
+*/
+class Sampler {
+    public:
+        static const uint32_t MAX_NB_DIMENSIONS = 32;
+        static const uint32_t NB_SOBOL_DIMENSIONS = 2;
+        static const uint32_t NB_SOBOL_BITS = 32;
+        // second coordinate of the lattice generator, the first one is 1
+        // found offline as the best minimum distance between the points of all the lattices of 2^3 to 2^20 points
+        static const uint32_t LATTICE_GENERATOR = 17939;
+        // offsets of the blue noise between two samples, golden ratio and R2 sequence in 0.32 fixed point
+        // cf Roberts, "The Unreasonable Effectiveness of Quasirandom Sequences", 2018
+        static const uint32_t GOLDEN_RATIO_OFFSET = 2654435769u;
+        static const uint32_t R2_OFFSET_X = 3242174889u;
+        static const uint32_t R2_OFFSET_Y = 2447445414u;
+        // offset of the data in getGpuData
+        static const uint32_t GPU_DIMENSION_SAMPLERS_OFFSET = NB_SOBOL_DIMENSIONS * NB_SOBOL_BITS;
+        static const uint32_t GPU_BLUE_NOISE_OFFSET = GPU_DIMENSION_SAMPLERS_OFFSET + MAX_NB_DIMENSIONS;
+
+    private:
+        std::array<uint32_t, NB_SOBOL_DIMENSIONS * NB_SOBOL_BITS> _SobolMatrices{};
+        std::array<SamplerType, MAX_NB_DIMENSIONS> _DimensionSamplers{};
+        // two independent blue noise ranks per texel, the second one in the high bits
+        std::vector<uint32_t> _BlueNoise{};
+
+    public:
+        Sampler(SamplerType type = SAMPLER_SOBOL);
+
+    public:
+        void setSamplerType(SamplerType type);
+        void setSamplerType(uint32_t dimension, SamplerType type);
+        SamplerType getSamplerType(uint32_t dimension) const;
+
+        // values in [0, 1[
+        float get1D(const glm::uvec2& pixel, uint32_t sampleIndex, uint32_t dimension) const;
+        glm::vec2 get2D(const glm::uvec2& pixel, uint32_t sampleIndex, uint32_t dimension) const;
+
+        // sobol matrices, sampler of each dimension and blue noise
+        std::vector<uint32_t> getGpuData() const;
+
+    public:
+        // cf Jarzynski and Olano, "Hash Functions for GPU Rendering", JCGT 2020
+        static uint32_t hash(uint32_t value);
+        static uint32_t reverseBits(uint32_t value);
+        // cf Burley, "Practical Hash-based Owen Scrambling", JCGT 2020
+        static uint32_t nestedUniformScramble(uint32_t value, uint32_t seed);
+
+    private:
+        void initSobolMatrices();
+        void initBlueNoise();
+        static std::vector<uint32_t> generateBlueNoise();
+
+        uint32_t sobol(uint32_t index, uint32_t dimension) const;
+        glm::uvec2 getBlueNoise(const glm::uvec2& pixel, uint32_t dimension) const;
+        // 0.32 fixed point samples
+        glm::uvec2 getFixedPoint2D(const glm::uvec2& pixel, uint32_t sampleIndex, uint32_t dimension) const;
+
+        // centre of the interval of a blue noise rank
+        static uint32_t getRankCentre(uint32_t rank);
+        static uint32_t getSeed(const glm::uvec2& pixel, uint32_t dimension);
+        static float toFloat(uint32_t value);
+};
+
+}
\ No newline at end of file
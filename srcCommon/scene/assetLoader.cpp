@@ -0,0 +1,71 @@
+#include "assetLoader.hpp"
+
+#include <algorithm>
+#include <omp.h>
+#include <thread>
+
+#include "errorHandler.hpp"
+
+namespace cr{
+
+AssetLoader::AssetLoader(uint32_t nbThreads)
+    : _Pool(nbThreads){}
+
+AssetLoader::~AssetLoader(){
+    // the threads waiting for room in the queue give up
+    _IsStopped = true;
+}
+
+void AssetLoader::load(uint32_t requestId, const std::string& path, std::chrono::steady_clock::time_point requestTime){
+    // the loading threads share the cores instead of each starting a thread per core
+    omp_set_num_threads(std::max(1, omp_get_num_procs() / static_cast<int>(_Pool.getNbThreads())));
+    // an error must not exit the program while the render thread runs, it is reported with the mesh
+    ErrorHandler::setRecoverable(true);
+    LoadedMesh loadedMesh{};
+    loadedMesh._RequestId = requestId;
+    try {
+        loadedMesh._Mesh = Mesh::load(path);
+        loadedMesh._BVH = BVH::buildBottomLevel(*loadedMesh._Mesh);
+    } catch(const std::exception& error){
+        loadedMesh._Mesh = nullptr;
+        loadedMesh._BVH = nullptr;
+        loadedMesh._DidFail = true;
+        loadedMesh._Error = error.what();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - requestTime;
+    loadedMesh._LoadTime = elapsed.count();
+    while(!_LoadedMeshes.tryPush(loadedMesh)){
+        if(_IsStopped){
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+uint32_t AssetLoader::loadMesh(const std::string& path){
+    uint32_t requestId = _RequestIdGenerator++;
+    _NbPending++;
+    std::chrono::steady_clock::time_point requestTime = std::chrono::steady_clock::now();
+    _Pool.submit([this, requestId, path, requestTime](){
+        load(requestId, path, requestTime);
+    });
+    return requestId;
+}
+
+bool AssetLoader::tryPopMesh(LoadedMesh& loadedMesh){
+    if(!_LoadedMeshes.tryPop(loadedMesh)){
+        return false;
+    }
+    _NbPending--;
+    return true;
+}
+
+uint32_t AssetLoader::getNbPending() const {
+    return _NbPending;
+}
+
+bool AssetLoader::isIdle() const {
+    return _NbPending == 0;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "bvh.hpp"
+#include "lockFreeQueue.hpp"
+#include "mesh.hpp"
+#include "threadPool.hpp"
+
+namespace cr{
+
+class AssetLoader;
+using AssetLoaderPtr = std::shared_ptr<AssetLoader>;
+
+// a mesh ready to be added to a scene, or the error that stopped its loading
+struct LoadedMesh {
+    uint32_t _RequestId = 0;
+    // nullptr if the loading failed
+    MeshPtr _Mesh = nullptr;
+    // bottom level bvh over the triangles of the mesh
+    BVH_Ptr _BVH = nullptr;
+    // in milliseconds, from the request to the end of the bvh build
+    double _LoadTime = 0.;
+    bool _DidFail = false;
+    std::string _Error = "";
+};
+
+/**
+ * Loads the meshes and builds their bottom level bvh on a pool of threads
+ * The loaded meshes are published to the render thread through a lock free queue,
+ * which takes them when it wants without ever waiting for a loading thread
+ * The requests are made from the render thread, the loading errors are reported to it with the failed meshes
+ * Each loading thread runs the parallel loops of the loaders on its share of the cores
+*/
+class AssetLoader {
+    public:
+        // the loading threads wait when the render thread doesn't take the meshes fast enough
+        static const size_t QUEUE_CAPACITY = Mesh::MAX_NB_MESHES;
+        // few meshes are loaded at once, each of them in parallel
+        static const uint32_t DEFAULT_NB_THREADS = 2;
+
+    private:
+        LockFreeQueue<LoadedMesh> _LoadedMeshes{QUEUE_CAPACITY};
+        // requested and not taken yet
+        std::atomic<uint32_t> _NbPending = 0;
+        std::atomic<bool> _IsStopped = false;
+        uint32_t _RequestIdGenerator = 0;
+        // last, the threads are joined before the queue is destroyed
+        ThreadPool _Pool;
+
+    public:
+        // nbThreads = 0 uses all the hardware threads, each loading a mesh on a single core
+        AssetLoader(uint32_t nbThreads = DEFAULT_NB_THREADS);
+        ~AssetLoader();
+
+    private:
+        void load(uint32_t requestId, const std::string& path, std::chrono::steady_clock::time_point requestTime);
+
+    public:
+        // returns the id of the request, found again in the loaded mesh
+        uint32_t loadMesh(const std::string& path);
+        // false once all the meshes loaded so far have been taken
+        bool tryPopMesh(LoadedMesh& loadedMesh);
+        uint32_t getNbPending() const;
+        bool isIdle() const;
+};
+
+}
\ No newline at end of file
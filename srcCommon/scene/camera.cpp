@@ -89,6 +89,7 @@ void Camera::processKeyboard(CameraMovement direction, float deltaTime){
             _Eye -= _WorldUp * velocity;
             break;
     }
+    _Version++;
 }
 
 void Camera::ProcessMouseMovement(float xoffset, float yoffset, bool constrainPitch){
@@ -117,5 +118,10 @@ void Camera::updateCameraVectors(){
     // also re-calculate the Right and Up vector
     _Right = glm::normalize(glm::cross(_At, _WorldUp));
     _Up    = glm::normalize(glm::cross(_Right, _At));
+    _Version++;
+}
+
+uint32_t Camera::getVersion() const {
+    return _Version;
 }
 }
\ No newline at end of file
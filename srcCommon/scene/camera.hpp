@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
 
@@ -53,6 +54,9 @@ class Camera{
 
         float _Yaw = -90.f;
         float _Pitch = 0.f;
+
+        // incremented each time the view changes
+        uint32_t _Version = 0;
     
     public:
         bool _Accelerate = false;
@@ -90,6 +94,9 @@ class Camera{
 
         void ProcessMouseMovement(float xoffset, float yoffset, bool constrainPitch = true);
 
+        // compare two versions to know if the camera moved in between
+        uint32_t getVersion() const;
+
     private:
         void updateCameraVectors();
 };
@@ -8,40 +8,128 @@
 
 namespace cr{
 
-BVH::BVH(uint32_t nbTriangles,
-    const std::vector<TriangleGPU>& unsortedTriangles,
-    const std::vector<MeshModelGPU>& meshesInTheScene){
+BVH::BVH(const std::vector<AABB_GPU>& primitives){
     // init parameters
-    _InternalStruct._NbTriangles = nbTriangles;
-    _InternalStruct._UnsortedTriangles = unsortedTriangles;
-    _InternalStruct._MeshesInTheScene = meshesInTheScene;
+    _InternalStruct.resize(primitives.size());
+    _InternalStruct._Primitives = primitives;
     // fprintf(stdout, "test\n");
 
     // ploc algorithm
     // auto start = glfwGetTime();
-    ploc();
+    if(_InternalStruct._NbPrimitives > 0){
+        ploc();
+    }
     // fprintf(stdout, "\nploc: %f ms\n", 1000*(glfwGetTime()-start));
 }
 
+BVH_Ptr BVH::buildBottomLevel(const std::vector<TriangleGPU>& triangles, uint32_t firstTriangle, uint32_t nbTriangles,
+    const std::vector<glm::vec3>& vertices){
+    std::vector<AABB_GPU> primitives = std::vector<AABB_GPU>(nbTriangles);
+    for(uint32_t i=0; i<nbTriangles; i++){
+        primitives[i] = AABB::buildFromTriangle(triangles[firstTriangle + i], vertices);
+    }
+    return BVH_Ptr(new BVH(primitives));
+}
+
+BVH_Ptr BVH::buildBottomLevel(const Mesh& mesh){
+    std::span<const glm::vec3> vertices = mesh.getVertices();
+    std::span<const uint32_t> indices = mesh.getIndices();
+    std::vector<AABB_GPU> primitives = std::vector<AABB_GPU>(mesh.getNbTriangles());
+    for(size_t i=0; i<primitives.size(); i++){
+        const glm::vec3& p0 = vertices[indices[3 * i]];
+        const glm::vec3& p1 = vertices[indices[3 * i + 1]];
+        const glm::vec3& p2 = vertices[indices[3 * i + 2]];
+        primitives[i]._Min = glm::min(p0, glm::min(p1, p2));
+        primitives[i]._Max = glm::max(p0, glm::max(p1, p2));
+    }
+    return BVH_Ptr(new BVH(primitives));
+}
+
+BVH_Ptr BVH::buildTopLevel(const std::vector<MeshModelGPU>& instances, uint32_t nbInstances,
+    const std::vector<AABB_GPU>& modelBoxes){
+    std::vector<AABB_GPU> primitives = std::vector<AABB_GPU>(nbInstances);
+    for(uint32_t i=0; i<nbInstances; i++){
+        primitives[i] = AABB::transform(modelBoxes[i], instances[i]._ModelMatrix);
+    }
+    return BVH_Ptr(new BVH(primitives));
+}
+
+void BVH::flattenNode(std::vector<BVH_NodeGPU>& flattenedNodes, uint32_t nodeId, uint32_t firstNode, uint32_t firstPrimitive) const {
+    BVH_NodeGPU curNode = _InternalStruct._Clusters[nodeId].value();
+    uint32_t position = flattenedNodes.size();
+    flattenedNodes.push_back(curNode);
+    // only the leaves are flagged
+    if(!_InternalStruct._IsLeaf[nodeId].value_or(false)){
+        uint32_t leftChildId = _InternalStruct._LeftChild[nodeId].value();
+        uint32_t rightChildId = _InternalStruct._RightChild[nodeId].value();
+        // the largest child goes to the left, occlusion rays visit it first
+        if(AABB::getSurfaceArea(_InternalStruct._Clusters[leftChildId].value()._BoundingBox)
+            < AABB::getSurfaceArea(_InternalStruct._Clusters[rightChildId].value()._BoundingBox)){
+            std::swap(leftChildId, rightChildId);
+        }
+        flattenedNodes[position]._LeftChild = firstNode + flattenedNodes.size();
+        flattenNode(flattenedNodes, leftChildId, firstNode, firstPrimitive);
+        flattenedNodes[position]._RightChild = firstNode + flattenedNodes.size();
+        flattenNode(flattenedNodes, rightChildId, firstNode, firstPrimitive);
+    } else {
+        flattenedNodes[position]._TriangleId += firstPrimitive;
+    }
+}
+
+std::vector<BVH_NodeGPU> BVH::getFlattenedNodes(uint32_t firstNode, uint32_t firstPrimitive) const {
+    std::vector<BVH_NodeGPU> flattenedNodes = std::vector<BVH_NodeGPU>();
+    if(_InternalStruct._NbPrimitives == 0){
+        return flattenedNodes;
+    }
+    flattenedNodes.reserve(2*_InternalStruct._NbPrimitives - 1);
+    uint32_t rootId = 2*_InternalStruct._NbPrimitives - 2;
+    flattenNode(flattenedNodes, rootId, firstNode, firstPrimitive);
+    return flattenedNodes;
+}
+
+AABB_GPU BVH::getRootAABB() const {
+    if(_InternalStruct._NbPrimitives == 0){
+        return AABB_GPU{};
+    }
+    return _InternalStruct._Clusters[2*_InternalStruct._NbPrimitives - 2].value()._BoundingBox;
+}
+
+void BVH_Params::resize(size_t nbPrimitives){
+    size_t nbNodes = nbPrimitives == 0 ? 0 : 2 * nbPrimitives - 1;
+    _NbPrimitives = nbPrimitives;
+    _Primitives = std::vector<AABB_GPU>(nbPrimitives);
+    _Clusters = std::vector<std::optional<BVH_NodeGPU>>(nbNodes, std::nullopt);
+    _IsLeaf = std::vector<std::optional<bool>>(nbNodes, std::nullopt);
+    _Parent = std::vector<std::optional<uint32_t>>(nbNodes, std::nullopt);
+    _LeftChild = std::vector<std::optional<uint32_t>>(nbNodes, std::nullopt);
+    _RightChild = std::vector<std::optional<uint32_t>>(nbNodes, std::nullopt);
+    _PrimitiveIndices = std::vector<uint32_t>(nbPrimitives, 0);
+}
+
+void PlocParams::resize(size_t nbPrimitives){
+    _MortonCodes = std::vector<uint32_t>(nbPrimitives, 0);
+    _C_In = std::vector<std::optional<uint32_t>>(nbPrimitives, std::nullopt);
+    _C_Out = std::vector<std::optional<uint32_t>>(nbPrimitives, std::nullopt);
+    _NearestNeighborIndices = std::vector<uint32_t>(nbPrimitives);
+    _PrefixScan = std::vector<uint32_t>(nbPrimitives);
+}
+
 PlocParams BVH::plocPreprocessing(){
     PlocParams plocParams{};
-    sortMortonCodesAndTriangleIndices(_InternalStruct._TriangleIndices, plocParams._MortonCodes);
-    for(size_t i=0; i<_InternalStruct._NbTriangles; i++){
-        uint32_t triangleIndex = _InternalStruct._TriangleIndices[i];
+    plocParams.resize(_InternalStruct._NbPrimitives);
+    sortMortonCodesAndPrimitiveIndices(_InternalStruct._PrimitiveIndices, plocParams._MortonCodes);
+    for(size_t i=0; i<_InternalStruct._NbPrimitives; i++){
+        uint32_t primitiveIndex = _InternalStruct._PrimitiveIndices[i];
         BVH_NodeGPU leafCluster{};
-        leafCluster._TriangleId = triangleIndex;
-        TriangleGPU curTriangle = _InternalStruct._UnsortedTriangles[triangleIndex];
-        leafCluster._BoundingBox = AABB::buildFromTriangle(
-            curTriangle,
-            _InternalStruct._MeshesInTheScene[curTriangle._ModelId]
-        );
+        leafCluster._TriangleId = primitiveIndex;
+        leafCluster._BoundingBox = _InternalStruct._Primitives[primitiveIndex];
         _InternalStruct._Clusters[i] = leafCluster;
         plocParams._C_In[i] = i;
         plocParams._C_Out[i].reset();
         _InternalStruct._IsLeaf[i] = true;
     }
-    plocParams._Iteration = _InternalStruct._NbTriangles;
-    plocParams._NbTotalClusters = _InternalStruct._NbTriangles;
+    plocParams._Iteration = _InternalStruct._NbPrimitives;
+    plocParams._NbTotalClusters = _InternalStruct._NbPrimitives;
     return plocParams;
 }
 
@@ -52,7 +140,7 @@ void BVH::ploc(){
     PlocParams plocParams = plocPreprocessing();
     // fprintf(stdout, "preprocessing done\n");
     // plocParams.printMortonCodes();
-    // _InternalStruct.printTriangleIndices();
+    // _InternalStruct.printPrimitiveIndices();
     // _InternalStruct.printClusters();
 
     // debug
@@ -211,41 +299,31 @@ void BVH::plocNearestNeighborSearch(PlocParams& plocParams, uint32_t index){
 
 
 
-void BVH::sortMortonCodesAndTriangleIndices(
-            std::vector<uint32_t>& triangleIndices,
+void BVH::sortMortonCodesAndPrimitiveIndices(
+            std::vector<uint32_t>& primitiveIndices,
             std::vector<uint32_t>& mortonCodes
         ) const {
-    // generate triangle indices
-    std::iota(triangleIndices.begin(), triangleIndices.end(), 0);
+    // generate primitive indices
+    std::iota(primitiveIndices.begin(), primitiveIndices.end(), 0);
     // generate morton codes
     mortonCodes = getMortonCodes();
     // sort morton codes and the array of indices and put them in an array of pair
-    std::vector<std::pair<uint32_t, uint32_t>> mortonIndexPairs(_InternalStruct._NbTriangles);
-    for (size_t i = 0; i < _InternalStruct._NbTriangles; i++) {
-        mortonIndexPairs[i] = {mortonCodes[i], triangleIndices[i]};
+    std::vector<std::pair<uint32_t, uint32_t>> mortonIndexPairs(_InternalStruct._NbPrimitives);
+    for (size_t i = 0; i < _InternalStruct._NbPrimitives; i++) {
+        mortonIndexPairs[i] = {mortonCodes[i], primitiveIndices[i]};
     }
     std::sort(mortonIndexPairs.begin(), mortonIndexPairs.end());
-    for (size_t i = 0; i < _InternalStruct._NbTriangles; i++) {
+    for (size_t i = 0; i < _InternalStruct._NbPrimitives; i++) {
         mortonCodes[i] = mortonIndexPairs[i].first;
-        triangleIndices[i] = mortonIndexPairs[i].second;
+        primitiveIndices[i] = mortonIndexPairs[i].second;
     }
 }
 
 
 AABB_GPU BVH::getSceneAABB() const {
     AABB_GPU sceneBoundingBox{};
-    for(const TriangleGPU& triangle : _InternalStruct._UnsortedTriangles){
-        glm::vec4 p0 = _InternalStruct._MeshesInTheScene[triangle._ModelId]._ModelMatrix * triangle._P0;
-        glm::vec4 p1 = _InternalStruct._MeshesInTheScene[triangle._ModelId]._ModelMatrix * triangle._P1;
-        glm::vec4 p2 = _InternalStruct._MeshesInTheScene[triangle._ModelId]._ModelMatrix * triangle._P2;
-
-        sceneBoundingBox._Max.x = std::max(sceneBoundingBox._Max.x, std::max(p0.x, std::max(p1.x, p2.x)));
-        sceneBoundingBox._Max.y = std::max(sceneBoundingBox._Max.y, std::max(p0.y, std::max(p1.y, p2.y)));
-        sceneBoundingBox._Max.z = std::max(sceneBoundingBox._Max.z, std::max(p0.z, std::max(p1.z, p2.z)));
-
-        sceneBoundingBox._Min.x = std::min(sceneBoundingBox._Min.x, std::min(p0.x, std::min(p1.x, p2.x)));
-        sceneBoundingBox._Min.y = std::min(sceneBoundingBox._Min.y, std::min(p0.y, std::min(p1.y, p2.y)));
-        sceneBoundingBox._Min.z = std::min(sceneBoundingBox._Min.z, std::min(p0.z, std::min(p1.z, p2.z)));
+    for(size_t i=0; i<_InternalStruct._NbPrimitives; i++){
+        sceneBoundingBox = AABB::merge(sceneBoundingBox, _InternalStruct._Primitives[i]);
     }
     return sceneBoundingBox;
 }
@@ -302,11 +380,10 @@ AABB_GPU BVH::getCircumscribedCube(const AABB_GPU& sceneAABB) const {
     return circumscribedCube;
 }
 
-std::vector<glm::vec3> BVH::getTrianglesCentroids() const{
-    std::vector<glm::vec3> centroids = std::vector<glm::vec3>(Triangle::MAX_NB_TRIANGLES, glm::vec3(0.f));
-    for(size_t i=0; i<_InternalStruct._NbTriangles; i++){
-        TriangleGPU triangle = _InternalStruct._UnsortedTriangles[i];
-        centroids[i] = Triangle::getCentroid(triangle, _InternalStruct._MeshesInTheScene[triangle._ModelId]._ModelMatrix);
+std::vector<glm::vec3> BVH::getPrimitivesCentroids() const{
+    std::vector<glm::vec3> centroids = std::vector<glm::vec3>(_InternalStruct._NbPrimitives, glm::vec3(0.f));
+    for(size_t i=0; i<_InternalStruct._NbPrimitives; i++){
+        centroids[i] = AABB::getCentroid(_InternalStruct._Primitives[i]);
     }
     return centroids;
 }
@@ -314,8 +391,8 @@ std::vector<glm::vec3> BVH::getTrianglesCentroids() const{
 std::vector<glm::vec3> BVH::getNormalizedCentroids(
             const std::vector<glm::vec3>& centroids,
             const AABB_GPU& circumscribedCube) const {
-    std::vector<glm::vec3> normalizedCentroids = std::vector<glm::vec3>(Triangle::MAX_NB_TRIANGLES, glm::vec3(0.f));
-    for(size_t i=0; i<_InternalStruct._NbTriangles; i++){
+    std::vector<glm::vec3> normalizedCentroids = std::vector<glm::vec3>(_InternalStruct._NbPrimitives, glm::vec3(0.f));
+    for(size_t i=0; i<_InternalStruct._NbPrimitives; i++){
         float lengthX = (circumscribedCube._Max.x - circumscribedCube._Min.x);
         float lengthY = (circumscribedCube._Max.y - circumscribedCube._Min.y);
         float lengthZ = (circumscribedCube._Max.z - circumscribedCube._Min.z);
@@ -332,15 +409,15 @@ std::vector<uint32_t> BVH::getMortonCodes() const {
     AABB_GPU sceneBoundingBox = getSceneAABB();
     // build circumscribed cube
     AABB_GPU circumscribedCube = getCircumscribedCube(sceneBoundingBox);
-    // get the triangle centroids
-    std::vector<glm::vec3> trianglesCentroids = getTrianglesCentroids();
+    // get the primitive centroids
+    std::vector<glm::vec3> primitivesCentroids = getPrimitivesCentroids();
 
     // normalize the centroids
-    std::vector<glm::vec3> trianglesNormalizedCentroids = getNormalizedCentroids(trianglesCentroids, circumscribedCube);
+    std::vector<glm::vec3> primitivesNormalizedCentroids = getNormalizedCentroids(primitivesCentroids, circumscribedCube);
     // compute the morton codes
-    std::vector<uint32_t> mortonCodes = std::vector<uint32_t>(Triangle::MAX_NB_TRIANGLES, 0);
-    for(size_t i=0; i<_InternalStruct._NbTriangles; i++){
-        glm::vec3 centroid = trianglesNormalizedCentroids[i];
+    std::vector<uint32_t> mortonCodes = std::vector<uint32_t>(_InternalStruct._NbPrimitives, 0);
+    for(size_t i=0; i<_InternalStruct._NbPrimitives; i++){
+        glm::vec3 centroid = primitivesNormalizedCentroids[i];
         uint32_t code = morton3D(centroid);
         mortonCodes[i] = code;
     }
@@ -380,12 +457,11 @@ float AABB::getSurfaceArea(const AABB_GPU& aabb){
     return 2 * (diff.x * diff.y + diff.y * diff.z + diff.z * diff.x);
 }
 
-AABB_GPU AABB::buildFromTriangle(const TriangleGPU& triangle, const MeshModelGPU& model){
+AABB_GPU AABB::buildFromTriangle(const TriangleGPU& triangle, const std::vector<glm::vec3>& vertices, const glm::mat4& model){
     AABB_GPU aabb{};
 
-    glm::vec4 p0 = model._ModelMatrix * triangle._P0;
-    glm::vec4 p1 = model._ModelMatrix * triangle._P1;
-    glm::vec4 p2 = model._ModelMatrix * triangle._P2;
+    glm::vec3 p0, p1, p2;
+    Triangle::getVertices(triangle, vertices, model, p0, p1, p2);
 
     aabb._Min.x = std::min(p0.x, std::min(p1.x, p2.x));
     aabb._Min.y = std::min(p0.y, std::min(p1.y, p2.y));
@@ -412,6 +488,25 @@ AABB_GPU AABB::merge(const AABB_GPU& aabb1, const AABB_GPU& aabb2){
     return aabb;
 }
 
+AABB_GPU AABB::transform(const AABB_GPU& aabb, const glm::mat4& model){
+    AABB_GPU transformed{};
+    for(uint32_t corner=0; corner<8; corner++){
+        glm::vec3 point = glm::vec3(
+            (corner & 1) ? aabb._Max.x : aabb._Min.x,
+            (corner & 2) ? aabb._Max.y : aabb._Min.y,
+            (corner & 4) ? aabb._Max.z : aabb._Min.z
+        );
+        point = glm::vec3(model * glm::vec4(point, 1.f));
+        transformed._Min = glm::min(transformed._Min, point);
+        transformed._Max = glm::max(transformed._Max, point);
+    }
+    return transformed;
+}
+
+glm::vec3 AABB::getCentroid(const AABB_GPU& aabb){
+    return 0.5f * (aabb._Min + aabb._Max);
+}
+
 BVH_NodeGPU BVH::mergeBVH_Nodes(const BVH_NodeGPU& node1, const BVH_NodeGPU& node2){
     // TODO: rethink this
     BVH_NodeGPU mergedNode{};
@@ -422,13 +517,13 @@ BVH_NodeGPU BVH::mergeBVH_Nodes(const BVH_NodeGPU& node1, const BVH_NodeGPU& nod
 
 void BVH_Params::printParent() const {
     fprintf(stdout, "Parent Array:\n[ ");
-    for(size_t i = 0; i < (2 * Triangle::MAX_NB_TRIANGLES) - 1; i++) {
+    for(size_t i = 0; i < _Clusters.size(); i++) {
         if(_Parent[i].has_value()){
             fprintf(stdout, "%u", _Parent[i].value());
         } else {
             fprintf(stdout, "null");
         }
-        if (i < (2 * Triangle::MAX_NB_TRIANGLES) - 2) {
+        if (i + 1 < _Clusters.size()) {
             fprintf(stdout, ", ");
         }
     }
@@ -437,13 +532,13 @@ void BVH_Params::printParent() const {
 
 void BVH_Params::printLeftChild() const {
     fprintf(stdout, "LeftChild Array:\n[ ");
-    for(size_t i = 0; i < (2 * Triangle::MAX_NB_TRIANGLES) - 1; i++) {
+    for(size_t i = 0; i < _Clusters.size(); i++) {
         if(_LeftChild[i].has_value()){
             fprintf(stdout, "%u", _LeftChild[i].value());
         } else {
             fprintf(stdout, "null");
         }
-        if (i < (2 * Triangle::MAX_NB_TRIANGLES) - 2) {
+        if (i + 1 < _Clusters.size()) {
             fprintf(stdout, ", ");
         }
     }
@@ -452,13 +547,13 @@ void BVH_Params::printLeftChild() const {
 
 void BVH_Params::printRightChild() const {
     fprintf(stdout, "RightChild Array:\n[ ");
-    for(size_t i = 0; i < (2 * Triangle::MAX_NB_TRIANGLES) - 1; i++) {
+    for(size_t i = 0; i < _Clusters.size(); i++) {
         if(_RightChild[i].has_value()){
             fprintf(stdout, "%u", _RightChild[i].value());
         } else {
             fprintf(stdout, "null");
         }
-        if (i < (2 * Triangle::MAX_NB_TRIANGLES) - 2) {
+        if (i + 1 < _Clusters.size()) {
             fprintf(stdout, ", ");
         }
     }
@@ -467,13 +562,13 @@ void BVH_Params::printRightChild() const {
 
 void BVH_Params::printIsLeaf() const {
     fprintf(stdout, "IsLeaf Array:\n[ ");
-    for(size_t i = 0; i < (2 * Triangle::MAX_NB_TRIANGLES) - 1; i++) {
+    for(size_t i = 0; i < _Clusters.size(); i++) {
         if(_IsLeaf[i].has_value()){
             fprintf(stdout, "%s", _IsLeaf[i].value() ? "true" : "false");
         } else {
             fprintf(stdout, "null");
         }
-        if (i < (2 * Triangle::MAX_NB_TRIANGLES) - 2) {
+        if (i + 1 < _Clusters.size()) {
             fprintf(stdout, ", ");
         }
     }
@@ -482,7 +577,7 @@ void BVH_Params::printIsLeaf() const {
 
 void BVH_Params::printClusters() const {
     fprintf(stdout, "Clusters Array:\n[\n ");
-    for(size_t i = 0; i < (2 * Triangle::MAX_NB_TRIANGLES) - 1; i++) {
+    for(size_t i = 0; i < _Clusters.size(); i++) {
         if(!_Clusters[i].has_value()){
             fprintf(stdout, "null");
         } else {
@@ -496,18 +591,18 @@ void BVH_Params::printClusters() const {
                 glm::to_string(_Clusters[i]->_BoundingBox._Max).c_str()
             );
         }
-        if (i < (2 * Triangle::MAX_NB_TRIANGLES) - 2) {
+        if (i + 1 < _Clusters.size()) {
             fprintf(stdout, ",\n ");
         }
     }
     fprintf(stdout, "\n]\n");
 }
 
-void BVH_Params::printTriangleIndices() const {
-    fprintf(stdout, "Triangle indices Array:\n[ ");
-    for(size_t i = 0; i < Triangle::MAX_NB_TRIANGLES; i++) {
-        fprintf(stdout, "%u", _TriangleIndices[i]);
-        if (i < (Triangle::MAX_NB_TRIANGLES) - 1) {
+void BVH_Params::printPrimitiveIndices() const {
+    fprintf(stdout, "Primitive indices Array:\n[ ");
+    for(size_t i = 0; i < _PrimitiveIndices.size(); i++) {
+        fprintf(stdout, "%u", _PrimitiveIndices[i]);
+        if (i + 1 < _PrimitiveIndices.size()) {
             fprintf(stdout, ", ");
         }
     }
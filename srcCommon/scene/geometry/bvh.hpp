@@ -29,12 +29,16 @@ class AABB{
     public:
         static float getDiagonal(const AABB_GPU& aabb);
         static float getSurfaceArea(const AABB_GPU& aabb);
-        static AABB_GPU buildFromTriangle(const TriangleGPU& triangle, const MeshModelGPU& model);
+        static AABB_GPU buildFromTriangle(const TriangleGPU& triangle, const std::vector<glm::vec3>& vertices, const glm::mat4& model = glm::mat4(1.f));
         static AABB_GPU merge(const AABB_GPU& aabb1, const AABB_GPU& aabb2);
+        // box around the transformed corners
+        static AABB_GPU transform(const AABB_GPU& aabb, const glm::mat4& model);
+        static glm::vec3 getCentroid(const AABB_GPU& aabb);
 };
 
 struct BVH_NodeGPU {
     AABB_GPU _BoundingBox;
+    // in the leaves, the triangle or the instance for the top level bvh
     uint32_t _TriangleId;
     uint32_t _LeftChild;
     uint32_t _RightChild;
@@ -42,23 +46,25 @@ struct BVH_NodeGPU {
 };
 
 struct BVH_Params {
-    size_t _NbTriangles;
-    std::vector<TriangleGPU> _UnsortedTriangles = std::vector<TriangleGPU>(Triangle::MAX_NB_TRIANGLES);
-    std::vector<MeshModelGPU> _MeshesInTheScene = std::vector<MeshModelGPU>(Mesh::MAX_NB_MESHES);
+    size_t _NbPrimitives = 0;
+    // boxes of the triangles or of the instances, the leaves refer to them by their index
+    std::vector<AABB_GPU> _Primitives = {};
     
-    // bvh structure
-    std::vector<std::optional<BVH_NodeGPU>> _Clusters = std::vector<std::optional<BVH_NodeGPU>>((2*Triangle::MAX_NB_TRIANGLES)-1, std::nullopt);
-    std::vector<std::optional<bool>> _IsLeaf = std::vector<std::optional<bool>>((2*Triangle::MAX_NB_TRIANGLES)-1, std::nullopt);
-    std::vector<std::optional<uint32_t>> _Parent = std::vector<std::optional<uint32_t>>((2*Triangle::MAX_NB_TRIANGLES)-1, std::nullopt);
-    std::vector<std::optional<uint32_t>> _LeftChild = std::vector<std::optional<uint32_t>>((2*Triangle::MAX_NB_TRIANGLES)-1, std::nullopt);
-    std::vector<std::optional<uint32_t>> _RightChild = std::vector<std::optional<uint32_t>>((2*Triangle::MAX_NB_TRIANGLES)-1, std::nullopt);
-    std::vector<uint32_t> _TriangleIndices = std::vector<uint32_t>(Triangle::MAX_NB_TRIANGLES, 0);
+    // bvh structure, sized for the 2n-1 nodes of the primitives
+    std::vector<std::optional<BVH_NodeGPU>> _Clusters = {};
+    std::vector<std::optional<bool>> _IsLeaf = {};
+    std::vector<std::optional<uint32_t>> _Parent = {};
+    std::vector<std::optional<uint32_t>> _LeftChild = {};
+    std::vector<std::optional<uint32_t>> _RightChild = {};
+    std::vector<uint32_t> _PrimitiveIndices = {};
+
+    void resize(size_t nbPrimitives);
 
     void printParent() const;
     void printLeftChild() const;
     void printRightChild() const;
     void printIsLeaf() const;
-    void printTriangleIndices() const;
+    void printPrimitiveIndices() const;
     void printClusters() const;
 };
 
@@ -67,12 +73,14 @@ struct PlocParams {
     uint32_t _NbTotalClusters = 0;
 
     uint32_t _Iteration = 0;
-    std::vector<uint32_t> _MortonCodes = std::vector<uint32_t>(Triangle::MAX_NB_TRIANGLES, 0);
+    std::vector<uint32_t> _MortonCodes = {};
+
+    std::vector<std::optional<uint32_t>> _C_In = {};
+    std::vector<std::optional<uint32_t>> _C_Out = {};
+    std::vector<uint32_t> _NearestNeighborIndices = {};
+    std::vector<uint32_t> _PrefixScan = {};
 
-    std::vector<std::optional<uint32_t>> _C_In = std::vector<std::optional<uint32_t>>(Triangle::MAX_NB_TRIANGLES, std::nullopt);
-    std::vector<std::optional<uint32_t>> _C_Out = std::vector<std::optional<uint32_t>>(Triangle::MAX_NB_TRIANGLES, std::nullopt);
-    std::vector<uint32_t> _NearestNeighborIndices = std::vector<uint32_t>(Triangle::MAX_NB_TRIANGLES);
-    std::vector<uint32_t> _PrefixScan = std::vector<uint32_t>(Triangle::MAX_NB_TRIANGLES);
+    void resize(size_t nbPrimitives);
 
     void printMortonCodes() const;
     void printC_In() const;
@@ -86,9 +94,24 @@ class BVH {
         BVH_Params _InternalStruct = {};
 
     public:
-        BVH(uint32_t nbTriangles,
-            const std::vector<TriangleGPU>& unsortedTriangles,
-            const std::vector<MeshModelGPU>& meshesInTheScene);
+        // the leaves refer to the primitives by their index
+        BVH(const std::vector<AABB_GPU>& primitives);
+
+    public:
+        // bottom level bvh in model space over the triangles [firstTriangle, firstTriangle+nbTriangles) of a mesh
+        static BVH_Ptr buildBottomLevel(const std::vector<TriangleGPU>& triangles, uint32_t firstTriangle, uint32_t nbTriangles,
+            const std::vector<glm::vec3>& vertices);
+        // same over all the triangles of a mesh where it is stored, the leaves refer to its triangles by their index
+        static BVH_Ptr buildBottomLevel(const Mesh& mesh);
+        // top level bvh in world space, modelBoxes[i] is the box of the mesh of instances[i] in model space
+        static BVH_Ptr buildTopLevel(const std::vector<MeshModelGPU>& instances, uint32_t nbInstances,
+            const std::vector<AABB_GPU>& modelBoxes);
+
+        // depth first order with the root at index firstNode, as read by the shaders
+        // the left child of a node is never smaller than the right one
+        // the leaves keep null children and refer to their primitive offset by firstPrimitive
+        std::vector<BVH_NodeGPU> getFlattenedNodes(uint32_t firstNode = 0, uint32_t firstPrimitive = 0) const;
+        AABB_GPU getRootAABB() const;
 
     private:
         static BVH_NodeGPU mergeBVH_Nodes(const BVH_NodeGPU& node1, const BVH_NodeGPU& node2);
@@ -100,7 +123,7 @@ class BVH {
 
         AABB_GPU getCircumscribedCube(const AABB_GPU& sceneAABB) const;
 
-        std::vector<glm::vec3> getTrianglesCentroids() const;
+        std::vector<glm::vec3> getPrimitivesCentroids() const;
 
         std::vector<glm::vec3> getNormalizedCentroids(
             const std::vector<glm::vec3>& centroids,
@@ -109,8 +132,8 @@ class BVH {
         uint32_t expandBits(uint32_t value) const;
         uint32_t morton3D(const glm::vec3& point) const;
 
-        void sortMortonCodesAndTriangleIndices(
-            std::vector<uint32_t>& triangleIndices, // empty
+        void sortMortonCodesAndPrimitiveIndices(
+            std::vector<uint32_t>& primitiveIndices, // empty
             std::vector<uint32_t>& mortonCodes // empty
         ) const;
 
@@ -121,6 +144,8 @@ class BVH {
         void plocMerging(PlocParams& plocParams, uint32_t index);
         void plocCompaction(PlocParams& plocParams, uint32_t index);
         void plocPrefixScan(PlocParams& plocParams);
+
+        void flattenNode(std::vector<BVH_NodeGPU>& flattenedNodes, uint32_t nodeId, uint32_t firstNode, uint32_t firstPrimitive) const;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "geometryArena.hpp"
+
+#include "errorHandler.hpp"
+
+namespace cr{
+
+GeometryArena::GeometryArena(){
+    _Vertices.reserve(Triangle::MAX_NB_VERTICES);
+    _Triangles.reserve(Triangle::MAX_NB_TRIANGLES);
+}
+
+bool GeometryArena::canFit(const Mesh& mesh) const {
+    return _Vertices.size() + mesh.getNbVertices() <= Triangle::MAX_NB_VERTICES
+        && _Triangles.size() + mesh.getNbTriangles() <= Triangle::MAX_NB_TRIANGLES;
+}
+
+GeometryRange GeometryArena::append(const Mesh& mesh, uint32_t meshId){
+    if(!canFit(mesh)){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "The mesh doesn't fit in the geometry arena!\n"
+        );
+    }
+    GeometryRange range{};
+    range._FirstVertex = _Vertices.size();
+    range._NbVertices = mesh.getNbVertices();
+    range._FirstTriangle = _Triangles.size();
+    range._NbTriangles = mesh.getNbTriangles();
+    // within the reserved storage, nothing is moved
+    _Vertices.resize(range._FirstVertex + range._NbVertices);
+    _Triangles.resize(range._FirstTriangle + range._NbTriangles);
+
+    // straight from the mapped pages for cached meshes
+    glm::vec3* vertices = _Vertices.data() + range._FirstVertex;
+    const glm::vec3* meshVertices = mesh.getVertices().data();
+    #pragma omp parallel for
+    for(size_t v=0; v<range._NbVertices; v++){
+        vertices[v] = meshVertices[v];
+    }
+    TriangleGPU* triangles = _Triangles.data() + range._FirstTriangle;
+    const uint32_t* indices = mesh.getIndices().data();
+    #pragma omp parallel for
+    for(size_t t=0; t<range._NbTriangles; t++){
+        triangles[t]._Indices[0] = range._FirstVertex + indices[3 * t + 0];
+        triangles[t]._Indices[1] = range._FirstVertex + indices[3 * t + 1];
+        triangles[t]._Indices[2] = range._FirstVertex + indices[3 * t + 2];
+        triangles[t]._MeshId = meshId;
+    }
+    return range;
+}
+
+void GeometryArena::updateVertices(const GeometryRange& range, const Mesh& mesh){
+    if(mesh.getNbVertices() != range._NbVertices){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "The number of vertices of a mesh can't change!\n"
+        );
+    }
+    glm::vec3* vertices = _Vertices.data() + range._FirstVertex;
+    const glm::vec3* meshVertices = mesh.getVertices().data();
+    #pragma omp parallel for
+    for(size_t v=0; v<range._NbVertices; v++){
+        vertices[v] = meshVertices[v];
+    }
+}
+
+const std::vector<glm::vec3>& GeometryArena::getVertices() const {
+    return _Vertices;
+}
+
+const std::vector<TriangleGPU>& GeometryArena::getTriangles() const {
+    return _Triangles;
+}
+
+uint32_t GeometryArena::getNbVertices() const {
+    return _Vertices.size();
+}
+
+uint32_t GeometryArena::getNbTriangles() const {
+    return _Triangles.size();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "mesh.hpp"
+#include "triangle.hpp"
+
+namespace cr{
+
+// part of the arena written by one mesh
+struct GeometryRange {
+    uint32_t _FirstVertex = 0;
+    uint32_t _NbVertices = 0;
+    uint32_t _FirstTriangle = 0;
+    uint32_t _NbTriangles = 0;
+};
+
+/**
+ * Vertices and triangles of all the meshes of a scene, laid out as in the storage buffers
+ * The storage is allocated once for the limits of the buffers so it never moves,
+ * the meshes are written in place in parallel and the buffers are uploaded straight from it
+*/
+class GeometryArena {
+    private:
+        std::vector<glm::vec3> _Vertices{};
+        std::vector<TriangleGPU> _Triangles{};
+
+    public:
+        GeometryArena();
+
+    public:
+        bool canFit(const Mesh& mesh) const;
+        // the triangles index the vertices of the arena, the mesh must fit
+        GeometryRange append(const Mesh& mesh, uint32_t meshId);
+        // to call after moving the vertices of a mesh, their number must stay the same
+        void updateVertices(const GeometryRange& range, const Mesh& mesh);
+
+        const std::vector<glm::vec3>& getVertices() const;
+        const std::vector<TriangleGPU>& getTriangles() const;
+        uint32_t getNbVertices() const;
+        uint32_t getNbTriangles() const;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,461 @@
+#include "gltfLoader.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "errorHandler.hpp"
+#include "mappedFile.hpp"
+
+namespace cr{
+
+// only what the loader needs of json, the objects keep their keys in order
+struct JsonValue {
+    enum JsonType {
+        JSON_NULL, JSON_BOOLEAN, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT
+    };
+    JsonType _Type = JSON_NULL;
+    double _Number = 0.;
+    std::string _String = "";
+    // the items of an array or the values of an object
+    std::vector<JsonValue> _Values{};
+    std::vector<std::string> _Keys{};
+
+    const JsonValue* find(const std::string& key) const {
+        for(size_t i=0; i<_Keys.size(); i++){
+            if(_Keys[i] == key) return &_Values[i];
+        }
+        return nullptr;
+    }
+
+    const JsonValue* at(size_t index) const {
+        return _Type == JSON_ARRAY && index < _Values.size() ? &_Values[index] : nullptr;
+    }
+
+    double getNumber(const std::string& key, double defaultValue) const {
+        const JsonValue* value = find(key);
+        return value != nullptr && value->_Type == JSON_NUMBER ? value->_Number : defaultValue;
+    }
+};
+
+struct JsonReader {
+    static const uint32_t MAX_DEPTH = 64;
+    const char* _It = nullptr;
+    const char* _End = nullptr;
+
+    void skipSpaces(){
+        while(_It < _End && (*_It == ' ' || *_It == '\t' || *_It == '\n' || *_It == '\r')){
+            _It++;
+        }
+    }
+
+    bool readLiteral(const char* literal){
+        size_t length = std::strlen(literal);
+        if(static_cast<size_t>(_End - _It) < length || std::memcmp(_It, literal, length) != 0) return false;
+        _It += length;
+        return true;
+    }
+
+    // the non ascii characters of the escapes are replaced, the names read by the loader are ascii
+    bool readString(std::string& string){
+        if(_It >= _End || *_It != '"') return false;
+        for(_It++; _It < _End && *_It != '"'; _It++){
+            if(*_It != '\\'){
+                string.push_back(*_It);
+                continue;
+            }
+            if(++_It >= _End) return false;
+            switch(*_It){
+                case 'b': string.push_back('\b'); break;
+                case 'f': string.push_back('\f'); break;
+                case 'n': string.push_back('\n'); break;
+                case 'r': string.push_back('\r'); break;
+                case 't': string.push_back('\t'); break;
+                case 'u':
+                    if(_End - _It < 5) return false;
+                    string.push_back('?');
+                    _It += 4;
+                    break;
+                default: string.push_back(*_It); break;
+            }
+        }
+        if(_It >= _End) return false;
+        _It++;
+        return true;
+    }
+
+    bool readValue(JsonValue& value, uint32_t depth){
+        skipSpaces();
+        if(_It >= _End || depth > MAX_DEPTH) return false;
+        switch(*_It){
+            case '{': {
+                value._Type = JsonValue::JSON_OBJECT;
+                _It++;
+                skipSpaces();
+                if(_It < _End && *_It == '}'){
+                    _It++;
+                    return true;
+                }
+                while(true){
+                    skipSpaces();
+                    value._Keys.emplace_back();
+                    value._Values.emplace_back();
+                    if(!readString(value._Keys.back())) return false;
+                    skipSpaces();
+                    if(_It >= _End || *_It++ != ':') return false;
+                    if(!readValue(value._Values.back(), depth + 1)) return false;
+                    skipSpaces();
+                    if(_It >= _End) return false;
+                    if(*_It == '}'){
+                        _It++;
+                        return true;
+                    }
+                    if(*_It++ != ',') return false;
+                }
+            }
+            case '[': {
+                value._Type = JsonValue::JSON_ARRAY;
+                _It++;
+                skipSpaces();
+                if(_It < _End && *_It == ']'){
+                    _It++;
+                    return true;
+                }
+                while(true){
+                    value._Values.emplace_back();
+                    if(!readValue(value._Values.back(), depth + 1)) return false;
+                    skipSpaces();
+                    if(_It >= _End) return false;
+                    if(*_It == ']'){
+                        _It++;
+                        return true;
+                    }
+                    if(*_It++ != ',') return false;
+                }
+            }
+            case '"':
+                value._Type = JsonValue::JSON_STRING;
+                return readString(value._String);
+            case 't':
+                value._Type = JsonValue::JSON_BOOLEAN;
+                value._Number = 1.;
+                return readLiteral("true");
+            case 'f':
+                value._Type = JsonValue::JSON_BOOLEAN;
+                return readLiteral("false");
+            case 'n':
+                return readLiteral("null");
+            default: {
+                value._Type = JsonValue::JSON_NUMBER;
+                std::from_chars_result result = std::from_chars(_It, _End, value._Number);
+                if(result.ec != std::errc()) return false;
+                _It = result.ptr;
+                return true;
+            }
+        }
+    }
+};
+
+// elements of a buffer view of the binary chunk
+struct GltfAccessor {
+    const char* _Data = nullptr;
+    size_t _Count = 0;
+    size_t _Stride = 0;
+    uint32_t _ComponentType = 0;
+    uint32_t _NbComponents = 0;
+    bool _IsNormalized = false;
+};
+
+enum GltfComponentType {
+    GLTF_BYTE = 5120, GLTF_UNSIGNED_BYTE = 5121, GLTF_SHORT = 5122, GLTF_UNSIGNED_SHORT = 5123,
+    GLTF_UNSIGNED_INT = 5125, GLTF_FLOAT = 5126
+};
+
+static const uint32_t GLTF_TRIANGLES = 4;
+
+static void handleError(const std::string& path, const std::string& message){
+    ErrorHandler::handle(
+        __FILE__, __LINE__,
+        ErrorCode::BAD_VALUE_ERROR,
+        "Error loading object `" + path + "': " + message + "!\n"
+    );
+}
+
+static size_t getComponentSize(uint32_t componentType){
+    switch(componentType){
+        case GLTF_BYTE: case GLTF_UNSIGNED_BYTE: return 1;
+        case GLTF_SHORT: case GLTF_UNSIGNED_SHORT: return 2;
+        case GLTF_UNSIGNED_INT: case GLTF_FLOAT: return 4;
+        default: return 0;
+    }
+}
+
+static uint32_t getNbComponents(const std::string& type){
+    if(type == "SCALAR") return 1;
+    if(type == "VEC2") return 2;
+    if(type == "VEC3") return 3;
+    if(type == "VEC4") return 4;
+    return 0;
+}
+
+// false if the accessor is not in the binary chunk, is sparse or is not aligned on its components as required
+static bool getAccessor(const JsonValue& root, double index, const char* bin, size_t binSize, GltfAccessor& accessor){
+    const JsonValue* accessors = root.find("accessors");
+    const JsonValue* json = accessors != nullptr && index >= 0. ? accessors->at(static_cast<size_t>(index)) : nullptr;
+    if(json == nullptr || json->find("sparse") != nullptr || json->find("bufferView") == nullptr) return false;
+    const JsonValue* bufferViews = root.find("bufferViews");
+    double viewIndex = json->getNumber("bufferView", -1.);
+    const JsonValue* view = bufferViews != nullptr && viewIndex >= 0. ? bufferViews->at(static_cast<size_t>(viewIndex)) : nullptr;
+    const JsonValue* type = json->find("type");
+    if(view == nullptr || type == nullptr || view->getNumber("buffer", 0.) != 0.) return false;
+
+    accessor._ComponentType = static_cast<uint32_t>(json->getNumber("componentType", 0.));
+    accessor._NbComponents = getNbComponents(type->_String);
+    accessor._Count = static_cast<size_t>(std::max(0., json->getNumber("count", 0.)));
+    const JsonValue* normalized = json->find("normalized");
+    accessor._IsNormalized = normalized != nullptr && normalized->_Number != 0.;
+    size_t componentSize = getComponentSize(accessor._ComponentType);
+    size_t elementSize = componentSize * accessor._NbComponents;
+    accessor._Stride = static_cast<size_t>(view->getNumber("byteStride", static_cast<double>(elementSize)));
+    size_t viewOffset = static_cast<size_t>(std::max(0., view->getNumber("byteOffset", 0.)));
+    size_t viewLength = static_cast<size_t>(std::max(0., view->getNumber("byteLength", 0.)));
+    size_t offset = static_cast<size_t>(std::max(0., json->getNumber("byteOffset", 0.)));
+    if(elementSize == 0 || accessor._Stride < elementSize || viewOffset > binSize || viewLength > binSize - viewOffset){
+        return false;
+    }
+    size_t size = accessor._Count == 0 ? 0 : offset + accessor._Stride * (accessor._Count - 1) + elementSize;
+    if(accessor._Count > 0 && (accessor._Count - 1 > viewLength / accessor._Stride || size > viewLength)) return false;
+    accessor._Data = bin + viewOffset + offset;
+    return reinterpret_cast<uintptr_t>(accessor._Data) % componentSize == 0 && accessor._Stride % componentSize == 0;
+}
+
+static float readComponent(const char* data, uint32_t componentType, bool isNormalized){
+    switch(componentType){
+        case GLTF_BYTE: {
+            int8_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return isNormalized ? std::max(value / 127.f, -1.f) : value;
+        }
+        case GLTF_UNSIGNED_BYTE: {
+            uint8_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return isNormalized ? value / 255.f : value;
+        }
+        case GLTF_SHORT: {
+            int16_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return isNormalized ? std::max(value / 32767.f, -1.f) : value;
+        }
+        case GLTF_UNSIGNED_SHORT: {
+            uint16_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return isNormalized ? value / 65535.f : value;
+        }
+        case GLTF_UNSIGNED_INT: {
+            uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return static_cast<float>(value);
+        }
+        default: {
+            float value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+    }
+}
+
+static bool isPackedPositions(const GltfAccessor& positions){
+    return positions._ComponentType == GLTF_FLOAT && positions._Stride == sizeof(glm::vec3);
+}
+
+static void readPositions(const GltfAccessor& positions, glm::vec3* vertices){
+    if(isPackedPositions(positions)){
+        std::memcpy(vertices, positions._Data, sizeof(glm::vec3) * positions._Count);
+        return;
+    }
+    size_t componentSize = getComponentSize(positions._ComponentType);
+    #pragma omp parallel for
+    for(size_t v=0; v<positions._Count; v++){
+        const char* element = positions._Data + positions._Stride * v;
+        for(uint32_t axis=0; axis<3; axis++){
+            vertices[v][axis] = readComponent(element + componentSize * axis, positions._ComponentType, positions._IsNormalized);
+        }
+    }
+}
+
+// the accessor is aligned on its components and tightly packed, the loop is vectorized
+template <typename T>
+static void widenIndices(const GltfAccessor& accessor, uint32_t firstVertex, uint32_t* indices){
+    const T* source = reinterpret_cast<const T*>(accessor._Data);
+    #pragma omp parallel for simd
+    for(size_t i=0; i<accessor._Count; i++){
+        indices[i] = firstVertex + static_cast<uint32_t>(source[i]);
+    }
+}
+
+// true if all the indices are in [0, nbVertices)
+static bool areValidIndices(const uint32_t* indices, size_t nbIndices, uint32_t firstVertex, size_t nbVertices){
+    bool isValid = true;
+    #pragma omp parallel for simd reduction(&&:isValid)
+    for(size_t i=0; i<nbIndices; i++){
+        isValid = isValid && indices[i] - firstVertex < nbVertices;
+    }
+    return isValid;
+}
+
+// a triangle list with its positions and its indices if any
+struct GltfPrimitive {
+    GltfAccessor _Positions{};
+    GltfAccessor _Indices{};
+    bool _HasIndices = false;
+    size_t _FirstVertex = 0;
+    size_t _FirstIndex = 0;
+
+    size_t getNbIndices() const {
+        return _HasIndices ? _Indices._Count : _Positions._Count;
+    }
+};
+
+static std::vector<GltfPrimitive> getPrimitives(const std::string& path, const JsonValue& root, const char* bin, size_t binSize){
+    std::vector<GltfPrimitive> primitives{};
+    const JsonValue* meshes = root.find("meshes");
+    if(meshes == nullptr) return primitives;
+    for(const JsonValue& mesh : meshes->_Values){
+        const JsonValue* meshPrimitives = mesh.find("primitives");
+        if(meshPrimitives == nullptr) continue;
+        for(const JsonValue& json : meshPrimitives->_Values){
+            if(json.getNumber("mode", GLTF_TRIANGLES) != GLTF_TRIANGLES){
+                ErrorHandler::handle(
+                    __FILE__, __LINE__,
+                    ErrorCode::NOT_IMPLEMENTED_ERROR,
+                    "Only the triangle lists of `" + path + "' are loaded!\n",
+                    ErrorLevel::WARNING
+                );
+                continue;
+            }
+            const JsonValue* attributes = json.find("attributes");
+            GltfPrimitive primitive{};
+            bool isValid = attributes != nullptr
+                && getAccessor(root, attributes->getNumber("POSITION", -1.), bin, binSize, primitive._Positions)
+                && primitive._Positions._NbComponents == 3;
+            primitive._HasIndices = json.find("indices") != nullptr;
+            if(primitive._HasIndices){
+                isValid = isValid && getAccessor(root, json.getNumber("indices", -1.), bin, binSize, primitive._Indices)
+                    && primitive._Indices._NbComponents == 1 && primitive._Indices._Stride == getComponentSize(primitive._Indices._ComponentType)
+                    && (primitive._Indices._ComponentType == GLTF_UNSIGNED_BYTE || primitive._Indices._ComponentType == GLTF_UNSIGNED_SHORT
+                        || primitive._Indices._ComponentType == GLTF_UNSIGNED_INT);
+            }
+            if(!isValid){
+                handleError(path, "a primitive has invalid positions or indices");
+            }
+            primitives.push_back(primitive);
+        }
+    }
+    return primitives;
+}
+
+// the json and binary chunks of the file
+static void getChunks(const std::string& path, const MappedFile& file, std::string_view& json, const char*& bin, size_t& binSize){
+    const char* data = file.getData();
+    size_t size = file.getSize();
+    uint32_t header[5] = {0, 0, 0, 0, 0};
+    if(size >= sizeof(header)){
+        std::memcpy(header, data, sizeof(header));
+    }
+    if(size < sizeof(header) || header[0] != GltfLoader::GLB_MAGIC || header[1] != GltfLoader::GLB_VERSION){
+        handleError(path, "not a binary gltf 2.0 file");
+    }
+    if(header[4] != GltfLoader::JSON_CHUNK || header[3] > size - sizeof(header)){
+        handleError(path, "the json chunk is missing");
+    }
+    json = std::string_view(data + sizeof(header), header[3]);
+    // the binary chunk is optional
+    size_t binHeader = sizeof(header) + header[3];
+    uint32_t chunk[2] = {0, 0};
+    if(size - binHeader >= sizeof(chunk)){
+        std::memcpy(chunk, data + binHeader, sizeof(chunk));
+    }
+    if(chunk[1] == GltfLoader::BIN_CHUNK && chunk[0] <= size - binHeader - sizeof(chunk)){
+        bin = data + binHeader + sizeof(chunk);
+        binSize = chunk[0];
+    }
+}
+
+MeshPtr GltfLoader::load(const std::string& path){
+    MappedFilePtr file = MappedFilePtr(new MappedFile(path));
+    std::string_view jsonChunk{};
+    const char* bin = nullptr;
+    size_t binSize = 0;
+    getChunks(path, *file, jsonChunk, bin, binSize);
+    JsonValue root{};
+    JsonReader reader = {jsonChunk.data(), jsonChunk.data() + jsonChunk.size()};
+    if(!reader.readValue(root, 0) || root._Type != JsonValue::JSON_OBJECT){
+        handleError(path, "the json chunk is malformed");
+    }
+
+    std::vector<GltfPrimitive> primitives = getPrimitives(path, root, bin, binSize);
+    size_t nbVertices = 0;
+    size_t nbIndices = 0;
+    for(GltfPrimitive& primitive : primitives){
+        primitive._FirstVertex = nbVertices;
+        primitive._FirstIndex = nbIndices;
+        nbVertices += primitive._Positions._Count;
+        nbIndices += primitive.getNbIndices();
+    }
+    if(nbIndices % 3 != 0){
+        handleError(path, "the triangle lists are incomplete");
+    }
+
+    MeshPtr mesh = MeshPtr(new Mesh());
+    // a single primitive stored as the mesh is read from the pages
+    bool isMappedVertices = primitives.size() == 1 && isPackedPositions(primitives[0]._Positions);
+    bool isMappedIndices = primitives.size() == 1 && primitives[0]._HasIndices && primitives[0]._Indices._ComponentType == GLTF_UNSIGNED_INT;
+    if(!isMappedVertices){
+        mesh->_Vertices.resize(nbVertices);
+    }
+    if(!isMappedIndices){
+        mesh->_Indices.resize(nbIndices);
+    }
+    bool isValid = true;
+    for(const GltfPrimitive& primitive : primitives){
+        const GltfAccessor& indices = primitive._Indices;
+        uint32_t firstVertex = static_cast<uint32_t>(primitive._FirstVertex);
+        if(!isMappedVertices){
+            readPositions(primitive._Positions, mesh->_Vertices.data() + primitive._FirstVertex);
+        }
+        if(isMappedIndices){
+            isValid = isValid && areValidIndices(reinterpret_cast<const uint32_t*>(indices._Data), indices._Count, 0, nbVertices);
+            continue;
+        }
+        uint32_t* meshIndices = mesh->_Indices.data() + primitive._FirstIndex;
+        if(!primitive._HasIndices){
+            // the triangles follow each other
+            std::iota(meshIndices, meshIndices + primitive.getNbIndices(), firstVertex);
+            continue;
+        }
+        switch(indices._ComponentType){
+            case GLTF_UNSIGNED_BYTE: widenIndices<uint8_t>(indices, firstVertex, meshIndices); break;
+            case GLTF_UNSIGNED_SHORT: widenIndices<uint16_t>(indices, firstVertex, meshIndices); break;
+            default: widenIndices<uint32_t>(indices, firstVertex, meshIndices); break;
+        }
+        isValid = isValid && areValidIndices(meshIndices, indices._Count, firstVertex, primitive._Positions._Count);
+    }
+    if(!isValid){
+        handleError(path, "a triangle refers to a missing vertex");
+    }
+
+    std::span<const glm::vec3> mappedVertices = isMappedVertices
+        ? std::span<const glm::vec3>(reinterpret_cast<const glm::vec3*>(primitives[0]._Positions._Data), nbVertices)
+        : std::span<const glm::vec3>();
+    std::span<const uint32_t> mappedIndices = isMappedIndices
+        ? std::span<const uint32_t>(reinterpret_cast<const uint32_t*>(primitives[0]._Indices._Data), nbIndices)
+        : std::span<const uint32_t>();
+    if(isMappedVertices || isMappedIndices){
+        mesh->setMappedGeometry(file, mappedVertices, mappedIndices);
+    }
+    return mesh;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+#include "mesh.hpp"
+
+namespace cr{
+
+/**
+ * Reader of the triangles of binary gltf 2.0 files (.glb), the primitives of all the meshes are merged in model space
+ * The file is mapped in memory, a single primitive with float positions and 32 bits indices is read from the pages,
+ * the other accessors are converted in parallel
+ * The node transforms, the materials and the other attributes are skipped
+*/
+class GltfLoader {
+    public:
+        static const uint32_t GLB_MAGIC = 0x46546C67;
+        static const uint32_t GLB_VERSION = 2;
+        static const uint32_t JSON_CHUNK = 0x4E4F534A;
+        static const uint32_t BIN_CHUNK = 0x004E4942;
+
+    public:
+        static MeshPtr load(const std::string& path);
+};
+
+}
\ No newline at end of file
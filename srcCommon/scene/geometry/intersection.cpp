@@ -0,0 +1,216 @@
+#include "intersection.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace cr{
+
+RaySetup Intersection::setupRay(const Ray& ray){
+    RaySetup setup{};
+    setup._Origin = ray._Origin;
+    setup._Direction = ray._Direction;
+    // division by zero gives +-inf which the slab test handles
+    setup._InvDirection = glm::vec3(
+        1.f / ray._Direction.x,
+        1.f / ray._Direction.y,
+        1.f / ray._Direction.z
+    );
+    setup._Sign = glm::uvec3(
+        ray._Direction.x < 0.f ? 1 : 0,
+        ray._Direction.y < 0.f ? 1 : 0,
+        ray._Direction.z < 0.f ? 1 : 0
+    );
+
+    // the dominant axis of the direction becomes z
+    glm::vec3 absDirection = glm::abs(ray._Direction);
+    int kz = 0;
+    if(absDirection.y > absDirection[kz]) kz = 1;
+    if(absDirection.z > absDirection[kz]) kz = 2;
+    int kx = (kz + 1) % 3;
+    int ky = (kx + 1) % 3;
+    // keep the winding of the triangles
+    if(ray._Direction[kz] < 0.f) std::swap(kx, ky);
+    setup._Permutation = glm::ivec3(kx, ky, kz);
+
+    setup._Shear = glm::vec3(
+        ray._Direction[kx] / ray._Direction[kz],
+        ray._Direction[ky] / ray._Direction[kz],
+        1.f / ray._Direction[kz]
+    );
+    return setup;
+}
+
+bool Intersection::rayTriangleScaled(
+    const RaySetup& ray,
+    const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2,
+    float tMin, float tMax,
+    glm::vec4& scaledCoords,
+    float& det){
+    /// Watertight ray triangle intersection
+    /// cf Woop et al., "Watertight Ray/Triangle Intersection", JCGT 2013
+    int kx = ray._Permutation.x;
+    int ky = ray._Permutation.y;
+    int kz = ray._Permutation.z;
+
+    // vertices relative to the ray origin
+    glm::vec3 a = p0 - ray._Origin;
+    glm::vec3 b = p1 - ray._Origin;
+    glm::vec3 c = p2 - ray._Origin;
+
+    // shear and scale the vertices
+    float ax = a[kx] - ray._Shear.x * a[kz];
+    float ay = a[ky] - ray._Shear.y * a[kz];
+    float bx = b[kx] - ray._Shear.x * b[kz];
+    float by = b[ky] - ray._Shear.y * b[kz];
+    float cx = c[kx] - ray._Shear.x * c[kz];
+    float cy = c[ky] - ray._Shear.y * c[kz];
+
+    // scaled barycentric coordinates
+    float u = cx * by - cy * bx;
+    float v = ax * cy - ay * cx;
+    float w = bx * ay - by * ax;
+
+    // fall back to double precision on the edges
+    if(u == 0.f || v == 0.f || w == 0.f){
+        u = static_cast<float>(static_cast<double>(cx) * by - static_cast<double>(cy) * bx);
+        v = static_cast<float>(static_cast<double>(ax) * cy - static_cast<double>(ay) * cx);
+        w = static_cast<float>(static_cast<double>(bx) * ay - static_cast<double>(by) * ax);
+    }
+
+    // no back face culling, the signs only have to agree
+    if((u < 0.f || v < 0.f || w < 0.f) && (u > 0.f || v > 0.f || w > 0.f)){
+        return false;
+    }
+
+    det = u + v + w;
+    if(det == 0.f){
+        return false;
+    }
+
+    // scaled hit distance
+    float az = ray._Shear.z * a[kz];
+    float bz = ray._Shear.z * b[kz];
+    float cz = ray._Shear.z * c[kz];
+    float t = u * az + v * bz + w * cz;
+
+    // compare against [tMin, tMax] without dividing by the determinant
+    if(det < 0.f && (t >= tMin * det || t < tMax * det)){
+        return false;
+    }
+    if(det > 0.f && (t <= tMin * det || t > tMax * det)){
+        return false;
+    }
+
+    scaledCoords = glm::vec4(u, v, w, t);
+    return true;
+}
+
+bool Intersection::rayTriangle(
+    const RaySetup& ray,
+    const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2,
+    float tMax,
+    Hit& hit){
+    glm::vec4 scaledCoords;
+    float det = 0.f;
+    if(!rayTriangleScaled(ray, p0, p1, p2, 0.f, tMax, scaledCoords, det)){
+        return false;
+    }
+    float inverseDet = 1.f / det;
+    hit._Coords = scaledCoords * inverseDet;
+    hit._DidHit = true;
+    return true;
+}
+
+bool Intersection::rayTriangleOcclusion(
+    const RaySetup& ray,
+    const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2,
+    float tMin, float tMax){
+    glm::vec4 scaledCoords;
+    float det = 0.f;
+    return rayTriangleScaled(ray, p0, p1, p2, tMin, tMax, scaledCoords, det);
+}
+
+// cf Moller and Trumbore, "Fast, Minimum Storage Ray/Triangle Intersection", 1997
+bool Intersection::rayTriangleMollerTrumbore(
+    const RaySetup& ray,
+    const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2,
+    float tMax,
+    Hit& hit){
+    glm::vec3 edge1 = p1 - p0;
+    glm::vec3 edge2 = p2 - p0;
+    const glm::vec3& d = ray._Direction;
+
+    // no back face culling
+    glm::vec3 pvec = glm::vec3(
+        d.y * edge2.z - d.z * edge2.y,
+        d.z * edge2.x - d.x * edge2.z,
+        d.x * edge2.y - d.y * edge2.x
+    );
+    float det = edge1.x * pvec.x + edge1.y * pvec.y + edge1.z * pvec.z;
+    if(det > -MOLLER_TRUMBORE_EPSILON && det < MOLLER_TRUMBORE_EPSILON){
+        return false;
+    }
+    float inverseDet = 1.f / det;
+
+    glm::vec3 tvec = ray._Origin - p0;
+    float u = (tvec.x * pvec.x + tvec.y * pvec.y + tvec.z * pvec.z) * inverseDet;
+    if(u < 0.f || u > 1.f){
+        return false;
+    }
+
+    glm::vec3 qvec = glm::vec3(
+        tvec.y * edge1.z - tvec.z * edge1.y,
+        tvec.z * edge1.x - tvec.x * edge1.z,
+        tvec.x * edge1.y - tvec.y * edge1.x
+    );
+    float v = (d.x * qvec.x + d.y * qvec.y + d.z * qvec.z) * inverseDet;
+    if(v < 0.f || u + v > 1.f){
+        return false;
+    }
+
+    float t = (edge2.x * qvec.x + edge2.y * qvec.y + edge2.z * qvec.z) * inverseDet;
+    if(t <= 0.f || t >= tMax){
+        return false;
+    }
+
+    hit._Coords = glm::vec4(1.f - u - v, u, v, t);
+    hit._DidHit = true;
+    return true;
+}
+
+bool Intersection::rayAABB(
+    const RaySetup& ray,
+    const AABB_GPU& aabb,
+    float tMax,
+    float& tEntry){
+    const glm::vec3 bounds[2] = {aabb._Min, aabb._Max};
+
+    float tNear = (bounds[ray._Sign.x].x - ray._Origin.x) * ray._InvDirection.x;
+    float tFar = (bounds[1 - ray._Sign.x].x - ray._Origin.x) * ray._InvDirection.x;
+    float tNearY = (bounds[ray._Sign.y].y - ray._Origin.y) * ray._InvDirection.y;
+    float tFarY = (bounds[1 - ray._Sign.y].y - ray._Origin.y) * ray._InvDirection.y;
+    float tNearZ = (bounds[ray._Sign.z].z - ray._Origin.z) * ray._InvDirection.z;
+    float tFarZ = (bounds[1 - ray._Sign.z].z - ray._Origin.z) * ray._InvDirection.z;
+
+    // conservative rounding so that the exit distance is never underestimated
+    const float ROUNDING = 1.f + 2.f * GAMMA_3;
+    tFar *= ROUNDING;
+    tFarY *= ROUNDING;
+    tFarZ *= ROUNDING;
+
+    // written so that NaN (origin on a slab with a null direction) never culls
+    tNear = tNearY > tNear ? tNearY : tNear;
+    tNear = tNearZ > tNear ? tNearZ : tNear;
+    tFar = tFarY < tFar ? tFarY : tFar;
+    tFar = tFarZ < tFar ? tFarZ : tFar;
+
+    tNear = std::max(tNear, 0.f);
+    tFar = std::min(tFar, tMax);
+    if(tNear > tFar){
+        return false;
+    }
+    tEntry = tNear;
+    return true;
+}
+
+}
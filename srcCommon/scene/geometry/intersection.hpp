@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "bvh.hpp"
+
+namespace cr{
+
+struct Ray {
+    glm::vec3 _Origin = glm::vec3(0.f);
+    glm::vec3 _Direction = glm::vec3(0.f, 0.f, 1.f);
+    // only read by the batched queries of CpuRaytracer
+    float _TMax = INFINITY;
+};
+
+// data computed once per ray and reused by every box and triangle test
+struct RaySetup {
+    glm::vec3 _Origin;
+    glm::vec3 _Direction;
+    glm::vec3 _InvDirection;
+    // 1 if the direction is negative along the axis
+    glm::uvec3 _Sign;
+    // watertight permutation (kz is the dominant axis) and shear constants
+    glm::ivec3 _Permutation;
+    glm::vec3 _Shear;
+};
+
+struct Hit {
+    glm::vec4 _Coords = glm::vec4(0.f, 0.f, 0.f, INFINITY); // (b0, b1, b2, t)
+    bool _DidHit = false;
+    uint32_t _TriangleId = 0;
+    // instance of the mesh of the triangle
+    uint32_t _InstanceId = 0;
+};
+
+class Intersection {
+    public:
+        // see Ize, "Robust BVH Ray Traversal", JCGT 2013
+        static constexpr float GAMMA_3 = (3.f * 0.5f * 1.1920929e-7f) / (1.f - 3.f * 0.5f * 1.1920929e-7f);
+        // determinant under which the ray is considered parallel to the triangle
+        static constexpr float MOLLER_TRUMBORE_EPSILON = 1e-12f;
+
+    public:
+        static RaySetup setupRay(const Ray& ray);
+
+        static bool rayTriangle(
+            const RaySetup& ray,
+            const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2,
+            float tMax,
+            Hit& hit
+        );
+
+        // occlusion test in [tMin, tMax], the hit is never normalized
+        static bool rayTriangleOcclusion(
+            const RaySetup& ray,
+            const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2,
+            float tMin, float tMax
+        );
+
+        // reference of the simd kernels, the operations are written in the same order
+        static bool rayTriangleMollerTrumbore(
+            const RaySetup& ray,
+            const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2,
+            float tMax,
+            Hit& hit
+        );
+
+        static bool rayAABB(
+            const RaySetup& ray,
+            const AABB_GPU& aabb,
+            float tMax,
+            float& tEntry
+        );
+
+    private:
+        // barycentric coordinates and distance scaled by the determinant
+        static bool rayTriangleScaled(
+            const RaySetup& ray,
+            const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2,
+            float tMin, float tMax,
+            glm::vec4& scaledCoords,
+            float& det
+        );
+};
+
+}
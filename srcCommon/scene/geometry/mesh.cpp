@@ -1,12 +1,15 @@
 #include "mesh.hpp"
 
-#include <tiny_obj_loader.h>
+#include <filesystem>
 #include <glm/ext.hpp>
-#include "errorHandler.hpp"
+#include "gltfLoader.hpp"
+#include "meshCache.hpp"
+#include "objLoader.hpp"
+#include "plyLoader.hpp"
 
 namespace cr{
 
-uint32_t Mesh::_IdGenerator = 0;
+std::atomic<uint32_t> Mesh::_IdGenerator = 0;
 
 const std::string Mesh::MODELS_DIRECTORY = std::string(PROJECT_SOURCE_DIR) + "/resources/models/";
 
@@ -19,162 +22,122 @@ void Mesh::setPosition(const glm::vec3& position){
     _InternalStruct._ModelMatrix[3][0] = position.x;
     _InternalStruct._ModelMatrix[3][1] = position.y;
     _InternalStruct._ModelMatrix[3][2] = position.z;
+    updateInvModel();
 }
 
 void Mesh::setModel(const glm::mat4& model){
     _InternalStruct._ModelMatrix = model;
+    updateInvModel();
+}
+
+void Mesh::updateInvModel(){
+    _InternalStruct._InvModelMatrix = glm::inverse(_InternalStruct._ModelMatrix);
 }
 
 
 void Mesh::setScale(float scale){
-    glm::mat4 scaleMat = glm::mat4(1);
-    scaleMat[0][0] *= scale;
-    scaleMat[1][1] *= scale;
-    scaleMat[2][2] *= scale;
-    _InternalStruct._ModelMatrix = glm::transpose(scaleMat*glm::transpose(_InternalStruct._ModelMatrix));
+    _InternalStruct._ModelMatrix = _InternalStruct._ModelMatrix * glm::scale(glm::mat4(1.f), glm::vec3(scale));
+    updateInvModel();
 }
 
 void Mesh::setRotation(float thetaX, float thetaY, float thetaZ){
-    glm::mat4 rotationX = glm::mat4({
-        {1.f, 0.f, 0.f, 0.f},
-        {0.f, cos(thetaX), -sin(thetaX), 0.f},
-        {0.f, sin(thetaX), cos(thetaX), 0.f},
-        {0.f, 0.f, 0.f, 1.f}
-    });
-    glm::mat4 rotationY = glm::mat4({
-        {cos(thetaY), 0.f, sin(thetaY), 0.f},
-        {0.f, 1.f, 0.f, 0.f},
-        { -sin(thetaY), 0.f, cos(thetaY), 0.f},
-        {0.f, 0.f, 0.f, 1.f}
-    });
-    glm::mat4 rotationZ = glm::mat4({
-        {cos(thetaZ), -sin(thetaZ), 0.f, 0.f},
-        {sin(thetaZ), cos(thetaZ), 0.f, 0.f},
-        {0.f, 0.f, 1.f, 0.f},
-        {0.f, 0.f, 0.f, 1.f}
-    });
-
-    _InternalStruct._ModelMatrix = glm::transpose(rotationZ*rotationY*rotationX*glm::transpose(_InternalStruct._ModelMatrix));
+    glm::mat4 rotation = glm::rotate(glm::mat4(1.f), thetaX, glm::vec3(1.f, 0.f, 0.f));
+    rotation = glm::rotate(rotation, thetaY, glm::vec3(0.f, 1.f, 0.f));
+    rotation = glm::rotate(rotation, thetaZ, glm::vec3(0.f, 0.f, 1.f));
+    _InternalStruct._ModelMatrix = _InternalStruct._ModelMatrix * rotation;
+    updateInvModel();
 }
 
 void Mesh::setMaterial(uint32_t materialId){
     _InternalStruct._MaterialId = materialId;
 }
 
+size_t Mesh::getNbTriangles() const {
+    return getIndices().size() / 3;
+}
+
+size_t Mesh::getNbVertices() const {
+    return getVertices().size();
+}
+
+std::span<const glm::vec3> Mesh::getVertices() const {
+    return _MappedVertices.data() != nullptr ? _MappedVertices : std::span<const glm::vec3>(_Vertices);
+}
+
+std::span<const uint32_t> Mesh::getIndices() const {
+    return _MappedIndices.data() != nullptr ? _MappedIndices : std::span<const uint32_t>(_Indices);
+}
+
+void Mesh::setMappedGeometry(const MappedFilePtr& file, std::span<const glm::vec3> vertices, std::span<const uint32_t> indices){
+    _MappedFile = file;
+    _MappedVertices = vertices;
+    _MappedIndices = indices;
+    if(vertices.data() != nullptr){
+        _Vertices.clear();
+    }
+    if(indices.data() != nullptr){
+        _Indices.clear();
+    }
+}
+
 MeshPtr Mesh::primitiveTriangle(){
     MeshPtr newMesh = MeshPtr(new Mesh());
-    newMesh->_Triangles.emplace_back(
+    newMesh->_Vertices = {
         glm::vec3(0.f, 1.f, 0.f),
         glm::vec3(-1.f, -1.f, 0.f),
-        glm::vec3(1.f, -1.f, 0.f),
-        newMesh->_Id
-    );
+        glm::vec3(1.f, -1.f, 0.f)
+    };
+    newMesh->_Indices = {0, 1, 2};
     return newMesh;
 }
 
 MeshPtr Mesh::primitiveSquare(){
     MeshPtr newMesh = MeshPtr(new Mesh());
-    newMesh->_Triangles.emplace_back(
+    newMesh->_Vertices = {
         glm::vec3(-1.f, 1.f, 0.f),
         glm::vec3(-1.f, -1.f, 0.f),
         glm::vec3(1.f, -1.f, 0.f),
-        newMesh->_Id
-    );
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(-1.f, 1.f, 0.f),
-        glm::vec3(1.f, -1.f, 0.f),
-        glm::vec3(1.f, 1.f, 0.f),
-        newMesh->_Id
-    );
+        glm::vec3(1.f, 1.f, 0.f)
+    };
+    newMesh->_Indices = {
+        0, 1, 2,
+        0, 2, 3
+    };
     return newMesh;
 }
 
 MeshPtr Mesh::primitiveCube(){
     MeshPtr newMesh = MeshPtr(new Mesh());
-    // front face
-    newMesh->_Triangles.emplace_back(
+    newMesh->_Vertices = {
         glm::vec3(-1.f, 1.f, -1.f),
         glm::vec3(-1.f, -1.f, -1.f),
         glm::vec3(1.f, -1.f, -1.f),
-        newMesh->_Id
-    );
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(-1.f, 1.f, -1.f),
-        glm::vec3(1.f, -1.f, -1.f),
-        glm::vec3(1.f, 1.f, -1.f),
-        newMesh->_Id
-    );
-
-    // back face
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(-1.f, -1.f, 1.f),
-        glm::vec3(-1.f, 1.f, 1.f),
-        glm::vec3(1.f, -1.f, 1.f),
-        newMesh->_Id
-    );
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(1.f, -1.f, 1.f),
-        glm::vec3(-1.f, 1.f, 1.f),
-        glm::vec3(1.f, 1.f, 1.f),
-        newMesh->_Id
-    );
-
-    // right face
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(1.f, -1.f, 1.f),
-        glm::vec3(1.f, 1.f, 1.f),
-        glm::vec3(1.f, 1.f, -1.f),
-        newMesh->_Id
-    );
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(1.f, -1.f, 1.f),
         glm::vec3(1.f, 1.f, -1.f),
-        glm::vec3(1.f, -1.f, -1.f),
-        newMesh->_Id
-    );
-
-    // left face
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(-1.f, 1.f, 1.f),
         glm::vec3(-1.f, -1.f, 1.f),
-        glm::vec3(-1.f, 1.f, -1.f),
-        newMesh->_Id
-    );
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(-1.f, 1.f, -1.f),
-        glm::vec3(-1.f, -1.f, 1.f),
-        glm::vec3(-1.f, -1.f, -1.f),
-        newMesh->_Id
-    );
-
-    // top face
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(-1.f, 1.f, -1.f),
-        glm::vec3(1.f, 1.f, -1.f),
-        glm::vec3(1.f, 1.f, 1.f),
-        newMesh->_Id
-    );
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(-1.f, 1.f, -1.f),
-        glm::vec3(1.f, 1.f, 1.f),
         glm::vec3(-1.f, 1.f, 1.f),
-        newMesh->_Id
-    );
-
-    // bottom face
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(-1.f, -1.f, -1.f),
-        glm::vec3(1.f, -1.f, 1.f),
-        glm::vec3(1.f, -1.f, -1.f),
-        newMesh->_Id
-    );
-    newMesh->_Triangles.emplace_back(
-        glm::vec3(-1.f, -1.f, -1.f),
-        glm::vec3(-1.f, -1.f, 1.f),
         glm::vec3(1.f, -1.f, 1.f),
-        newMesh->_Id
-    );
-
+        glm::vec3(1.f, 1.f, 1.f)
+    };
+    newMesh->_Indices = {
+        // front face
+        0, 1, 2,
+        0, 2, 3,
+        // back face
+        4, 5, 6,
+        6, 5, 7,
+        // right face
+        6, 7, 3,
+        6, 3, 2,
+        // left face
+        5, 4, 0,
+        0, 4, 1,
+        // top face
+        0, 3, 7,
+        0, 7, 5,
+        // bottom face
+        1, 6, 2,
+        1, 4, 6
+    };
     return newMesh;
 }
 
@@ -184,82 +147,21 @@ MeshPtr Mesh::primitiveSphere(){
 }
 
 MeshPtr Mesh::load(const std::string& path){
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-
-    tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str());
-
-    if(!warn.empty()){
-        ErrorHandler::handle(
-            __FILE__, __LINE__,
-            ErrorCode::IO_ERROR,
-            "Warning loading object `" + path + "': " + warn + "\n",
-            ErrorLevel::WARNING 
-        );
+    // the binary formats are mapped directly
+    std::string extension = std::filesystem::path(path).extension().string();
+    if(extension == ".ply"){
+        return PlyLoader::load(path);
     }
-
-    if(!err.empty()){
-        ErrorHandler::handle(
-            __FILE__, __LINE__,
-            ErrorCode::IO_ERROR,
-            "Error loading object `" + path + "': " + warn + "\n"
-        );
+    if(extension == ".glb"){
+        return GltfLoader::load(path);
     }
-
-    MeshPtr loadedModel = MeshPtr(new Mesh());
-    
-    // Loop over shapes
-    for (const auto& shape : shapes) {
-        // Loop over faces(polygon)
-        size_t index_offset = 0;
-        for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); f++) {
-            size_t fv = shape.mesh.num_face_vertices[f];
-
-            // Check if the face is a triangle
-            if (fv != 3) {
-                ErrorHandler::handle(
-                    __FILE__, __LINE__,
-                    ErrorCode::BAD_VALUE_ERROR,
-                    "Error loading object `" + path + "': Mesh face with vertices other than 3 is not supported!\n"
-                );
-                continue;
-            }
-
-            glm::vec3 vertices[3];
-            for (size_t v = 0; v < fv; v++) {
-                tinyobj::index_t idx = shape.mesh.indices[index_offset + v];
-                tinyobj::real_t vx = attrib.vertices[3 * idx.vertex_index + 0];
-                tinyobj::real_t vy = attrib.vertices[3 * idx.vertex_index + 1];
-                tinyobj::real_t vz = attrib.vertices[3 * idx.vertex_index + 2];
-                vertices[v] = glm::vec3(vx, vy, vz);
-            }
-
-            // // check ccw order
-            // // Calculate the normal of the triangle
-            // glm::vec3 edge1 = vertices[1] - vertices[0];
-            // glm::vec3 edge2 = vertices[2] - vertices[0];
-            // glm::vec3 normal = glm::normalize(glm::cross(edge1, edge2));
-            // // Check if the normal points in the correct direction
-            // // Assuming positive z direction is the front face direction
-            // if (normal.z < 0.0f) {
-            //     // If the normal points in the wrong direction, swap vertices[1] and vertices[2]
-            //     std::swap(vertices[0], vertices[1]);
-            // }
-
-            // Create a triangle and add it to the mesh
-            loadedModel->_Triangles.emplace_back(
-                vertices[0], vertices[1], vertices[2], 
-                loadedModel->_Id
-            );
-
-            index_offset += fv;
-        }
+    // parsed once, the next loads map the cache
+    MeshPtr mesh = MeshCache::load(path);
+    if(mesh == nullptr){
+        mesh = ObjLoader::load(path);
+        MeshCache::write(path, *mesh);
     }
-
-    return loadedModel;
-
+    return mesh;
 }
 
 }
\ No newline at end of file
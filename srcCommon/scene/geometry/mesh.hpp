@@ -1,39 +1,79 @@
 #pragma once
 
 #include "triangle.hpp"
+#include <atomic>
 #include <vector>
 #include <memory>
+#include <span>
+
+#include "mappedFile.hpp"
 
 namespace cr{
 
 class Mesh;
 using MeshPtr = std::shared_ptr<Mesh>;
 
+// one instance of a mesh in the scene, the geometry is shared and the transform applied during the traversal
 struct MeshModelGPU {
+    glm::mat4 _ModelMatrix = glm::mat4(1);
+    // brings the rays in the model space of the mesh
+    glm::mat4 _InvModelMatrix = glm::mat4(1);
+    // overrides the material of the mesh
+    uint32_t _MaterialId = 0;
+    // root of the bvh of the mesh in the nodes of the scene
+    uint32_t _BVH_Root = 0;
+    // triangles of the mesh in the buffer of the scene
+    uint32_t _FirstTriangle = 0;
+    uint32_t _NbTriangles = 0;
+};
+
+// a shared mesh placed with its own transform and material
+struct MeshInstance {
+    MeshPtr _Mesh = nullptr;
     glm::mat4 _ModelMatrix = glm::mat4(1);
     uint32_t _MaterialId = 0;
 };
 
 class Mesh{
     private:
-        static uint32_t _IdGenerator;
+        // meshes and materials may be created by several loading threads
+        static std::atomic<uint32_t> _IdGenerator;
         uint32_t _Id = 0;
+        // keeps the pages alive when the geometry is read from a cache file
+        MappedFilePtr _MappedFile = nullptr;
+        std::span<const glm::vec3> _MappedVertices{};
+        std::span<const uint32_t> _MappedIndices{};
 
     public:
-        std::vector<Triangle> _Triangles{};
+        // positions in model space, shared by the triangles, empty if they are mapped
+        std::vector<glm::vec3> _Vertices{};
+        // three per triangle, in the vertices of the mesh, empty if they are mapped
+        std::vector<uint32_t> _Indices{};
         MeshModelGPU _InternalStruct;
         static const std::string MODELS_DIRECTORY;
+        // distinct meshes, each one stored once whatever its number of instances
         static const size_t MAX_NB_MESHES = 2<<5;
+        static constexpr size_t MAX_NB_INSTANCES = 2<<12;
 
     public:
         Mesh();
 
+    private:
+        void updateInvModel();
+
     public:
         void setModel(const glm::mat4& model);
         void setPosition(const glm::vec3& position);
         void setScale(float scale);
         void setRotation(float thetaX, float thetaY, float thetaZ);
         void setMaterial(uint32_t materialId);
+        size_t getNbTriangles() const;
+        size_t getNbVertices() const;
+        // the vectors or the mapped pages, whichever holds the geometry
+        std::span<const glm::vec3> getVertices() const;
+        std::span<const uint32_t> getIndices() const;
+        // the mapped blocks are read only and replace their vector, a block without data stays in its vector
+        void setMappedGeometry(const MappedFilePtr& file, std::span<const glm::vec3> vertices, std::span<const uint32_t> indices);
 
     public:
         static MeshPtr primitiveTriangle();
@@ -0,0 +1,175 @@
+#include "meshCache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "errorHandler.hpp"
+#include "mappedFile.hpp"
+
+namespace cr{
+
+const std::string MeshCache::EXTENSION = ".crmesh";
+
+static_assert(sizeof(MeshCacheHeader) % MeshCache::BLOCK_ALIGNMENT == 0);
+
+static const uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+static const uint64_t FNV_PRIME = 0x100000001b3ull;
+
+static uint64_t align(uint64_t offset){
+    return (offset + MeshCache::BLOCK_ALIGNMENT - 1) / MeshCache::BLOCK_ALIGNMENT * MeshCache::BLOCK_ALIGNMENT;
+}
+
+// fnv-1a over 8 bytes words
+static uint64_t hashBlock(const char* data, size_t size){
+    uint64_t hash = FNV_OFFSET;
+    size_t i = 0;
+    for(; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)){
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, sizeof(uint64_t));
+        hash = (hash ^ word) * FNV_PRIME;
+    }
+    for(; i < size; i++){
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// identifies the version of the source
+static bool getSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& time){
+    std::error_code error;
+    size = std::filesystem::file_size(sourcePath, error);
+    if(error){
+        return false;
+    }
+    time = std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count();
+    return !error;
+}
+
+std::string MeshCache::getPath(const std::string& sourcePath){
+    return sourcePath + EXTENSION;
+}
+
+uint64_t MeshCache::getChecksum(const char* data, size_t size){
+    size_t nbBlocks = (size + CHECKSUM_BLOCK_SIZE - 1) / CHECKSUM_BLOCK_SIZE;
+    std::vector<uint64_t> hashes(nbBlocks);
+    #pragma omp parallel for
+    for(size_t b=0; b<nbBlocks; b++){
+        size_t offset = b * CHECKSUM_BLOCK_SIZE;
+        hashes[b] = hashBlock(data + offset, std::min(CHECKSUM_BLOCK_SIZE, size - offset));
+    }
+    return hashBlock(reinterpret_cast<const char*>(hashes.data()), nbBlocks * sizeof(uint64_t));
+}
+
+// true if all the indices are in [0, nbVertices)
+static bool areValidIndices(const uint32_t* indices, size_t nbIndices, size_t nbVertices){
+    bool isValid = true;
+    #pragma omp parallel for simd reduction(&&:isValid)
+    for(size_t i=0; i<nbIndices; i++){
+        isValid = isValid && indices[i] < nbVertices;
+    }
+    return isValid;
+}
+
+MeshPtr MeshCache::load(const std::string& sourcePath){
+    std::string path = getPath(sourcePath);
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+    std::error_code error;
+    if(!std::filesystem::is_regular_file(path, error) || !getSourceStamp(sourcePath, sourceSize, sourceTime)){
+        return nullptr;
+    }
+
+    MappedFilePtr file = MappedFilePtr(new MappedFile(path));
+    if(file->getSize() < sizeof(MeshCacheHeader)){
+        return nullptr;
+    }
+    MeshCacheHeader header{};
+    std::memcpy(&header, file->getData(), sizeof(MeshCacheHeader));
+    // written by an other version of the format or from an older source
+    if(std::memcmp(header._Magic, MeshCacheHeader{}._Magic, sizeof(header._Magic)) != 0
+        || header._Version != VERSION
+        || header._BlockAlignment != BLOCK_ALIGNMENT
+        || header._SourceSize != sourceSize
+        || header._SourceTime != sourceTime){
+        return nullptr;
+    }
+    bool isValid = header._VerticesOffset == sizeof(MeshCacheHeader)
+        && header._NbVertices <= (file->getSize() - header._VerticesOffset) / sizeof(glm::vec3)
+        && header._IndicesOffset == align(header._VerticesOffset + header._NbVertices * sizeof(glm::vec3))
+        && header._IndicesOffset <= file->getSize()
+        && header._NbIndices <= (file->getSize() - header._IndicesOffset) / sizeof(uint32_t)
+        && header._NbIndices % 3 == 0;
+    const char* blocks = file->getData() + sizeof(MeshCacheHeader);
+    isValid = isValid && getChecksum(blocks, file->getSize() - sizeof(MeshCacheHeader)) == header._Checksum;
+    // a cache from another writer may have a right checksum and wrong triangles
+    isValid = isValid && areValidIndices(
+        reinterpret_cast<const uint32_t*>(file->getData() + header._IndicesOffset), header._NbIndices, header._NbVertices
+    );
+    if(!isValid){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::IO_ERROR,
+            "The mesh cache `" + path + "' is corrupted, the source is loaded again!\n",
+            ErrorLevel::WARNING
+        );
+        return nullptr;
+    }
+
+    // the blocks are aligned in the page aligned mapping
+    MeshPtr mesh = MeshPtr(new Mesh());
+    mesh->setMappedGeometry(
+        file,
+        std::span<const glm::vec3>(reinterpret_cast<const glm::vec3*>(file->getData() + header._VerticesOffset), header._NbVertices),
+        std::span<const uint32_t>(reinterpret_cast<const uint32_t*>(file->getData() + header._IndicesOffset), header._NbIndices)
+    );
+    return mesh;
+}
+
+void MeshCache::write(const std::string& sourcePath, const Mesh& mesh){
+    std::span<const glm::vec3> vertices = mesh.getVertices();
+    std::span<const uint32_t> indices = mesh.getIndices();
+    MeshCacheHeader header{};
+    header._Version = VERSION;
+    header._BlockAlignment = BLOCK_ALIGNMENT;
+    header._NbVertices = vertices.size();
+    header._NbIndices = indices.size();
+    header._VerticesOffset = sizeof(MeshCacheHeader);
+    header._IndicesOffset = align(header._VerticesOffset + vertices.size_bytes());
+    if(!getSourceStamp(sourcePath, header._SourceSize, header._SourceTime)){
+        return;
+    }
+
+    // the padding is zeroed so the checksum doesn't depend on it
+    std::vector<char> content(align(header._IndicesOffset + indices.size_bytes()), 0);
+    std::memcpy(content.data() + header._VerticesOffset, vertices.data(), vertices.size_bytes());
+    std::memcpy(content.data() + header._IndicesOffset, indices.data(), indices.size_bytes());
+    header._Checksum = getChecksum(content.data() + sizeof(MeshCacheHeader), content.size() - sizeof(MeshCacheHeader));
+    std::memcpy(content.data(), &header, sizeof(MeshCacheHeader));
+
+    // written aside and renamed so a reader never sees half a file, nor two loading threads the same temporary file
+    std::string path = getPath(sourcePath);
+    std::string temporaryPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    FILE* file = fopen(temporaryPath.c_str(), "wb");
+    bool isWritten = file != nullptr && fwrite(content.data(), 1, content.size(), file) == content.size();
+    isWritten = file != nullptr && fclose(file) == 0 && isWritten;
+    std::error_code error;
+    if(isWritten){
+        std::filesystem::rename(temporaryPath, path, error);
+    }
+    if(!isWritten || error){
+        std::filesystem::remove(temporaryPath, error);
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::IO_ERROR,
+            "Failed to write the mesh cache `" + path + "'!\n",
+            ErrorLevel::WARNING
+        );
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "mesh.hpp"
+
+namespace cr{
+
+// first bytes of a cache file, the blocks follow at the given offsets
+struct alignas(64) MeshCacheHeader {
+    char _Magic[8] = {'C', 'R', 'M', 'E', 'S', 'H', '\0', '\0'};
+    uint32_t _Version = 0;
+    uint32_t _BlockAlignment = 0;
+    // the source the cache was made from, it is stale once they change
+    uint64_t _SourceSize = 0;
+    int64_t _SourceTime = 0;
+    uint64_t _NbVertices = 0;
+    uint64_t _NbIndices = 0;
+    uint64_t _VerticesOffset = 0;
+    uint64_t _IndicesOffset = 0;
+    // of everything after the header
+    uint64_t _Checksum = 0;
+};
+
+/**
+ * Binary copy of a loaded mesh written beside its source, `model.obj` gives `model.obj.crmesh`
+ * The vertex and index blocks are stored as in memory and aligned on 64 bytes,
+ * so a cached mesh maps the file and reads its geometry from the pages without parsing nor copying
+*/
+class MeshCache {
+    public:
+        static const uint32_t VERSION = 1;
+        static const size_t BLOCK_ALIGNMENT = 64;
+        // the checksum is computed in parallel over blocks of this size
+        static constexpr size_t CHECKSUM_BLOCK_SIZE = 1<<20;
+        static const std::string EXTENSION;
+
+    public:
+        static std::string getPath(const std::string& sourcePath);
+        // nullptr if there is no valid cache for the current source
+        static MeshPtr load(const std::string& sourcePath);
+        // only warns on failure, the mesh is then parsed again next time
+        static void write(const std::string& sourcePath, const Mesh& mesh);
+        static uint64_t getChecksum(const char* data, size_t size);
+};
+
+}
\ No newline at end of file
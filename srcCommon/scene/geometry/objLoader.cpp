@@ -0,0 +1,210 @@
+#include "objLoader.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <omp.h>
+#include <vector>
+
+#include "errorHandler.hpp"
+#include "mappedFile.hpp"
+
+namespace cr{
+
+// lines [_Begin, _End) of the file
+struct ObjChunk {
+    const char* _Begin = nullptr;
+    const char* _End = nullptr;
+    size_t _NbVertices = 0;
+    size_t _NbTriangles = 0;
+    // where the chunk writes in the mesh
+    size_t _FirstVertex = 0;
+    size_t _FirstTriangle = 0;
+    bool _IsValid = true;
+};
+
+static bool isBlank(char c){
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char* skipBlanks(const char* it, const char* end){
+    while(it < end && isBlank(*it)){
+        it++;
+    }
+    return it;
+}
+
+static const char* skipToken(const char* it, const char* end){
+    while(it < end && !isBlank(*it)){
+        it++;
+    }
+    return it;
+}
+
+static const char* getLineEnd(const char* it, const char* end){
+    const char* lineEnd = static_cast<const char*>(std::memchr(it, '\n', end - it));
+    return lineEnd == nullptr ? end : lineEnd;
+}
+
+// true if the line is the element `v` or `f`, it is then moved after the keyword
+static bool isElement(const char*& it, const char* lineEnd, char element){
+    if(lineEnd - it < 2 || it[0] != element || !isBlank(it[1])){
+        return false;
+    }
+    it += 2;
+    return true;
+}
+
+static size_t countTokens(const char* it, const char* lineEnd){
+    size_t nbTokens = 0;
+    for(it = skipBlanks(it, lineEnd); it < lineEnd; it = skipBlanks(it, lineEnd)){
+        it = skipToken(it, lineEnd);
+        nbTokens++;
+    }
+    return nbTokens;
+}
+
+static const char* parseFloat(const char* it, const char* lineEnd, float& value, bool& isValid){
+    it = skipBlanks(it, lineEnd);
+    // from_chars doesn't take the sign +
+    if(it < lineEnd && *it == '+'){
+        it++;
+    }
+    std::from_chars_result result = std::from_chars(it, lineEnd, value);
+    if(result.ec == std::errc::result_out_of_range){
+        value = 0.f;
+    } else if(result.ec != std::errc()){
+        isValid = false;
+        return lineEnd;
+    }
+    return result.ptr;
+}
+
+// the position index of a corner `v`, `v/vt`, `v//vn` or `v/vt/vn`, the negative ones count back from the last vertex
+static const char* parseCorner(const char* it, const char* lineEnd, size_t nbPreviousVertices, uint32_t& index, bool& isValid){
+    int64_t value = 0;
+    std::from_chars_result result = std::from_chars(it, lineEnd, value);
+    if(result.ec != std::errc() || value == 0){
+        isValid = false;
+        return lineEnd;
+    }
+    int64_t resolved = value > 0 ? value - 1 : static_cast<int64_t>(nbPreviousVertices) + value;
+    // out of range rather than wrapped into a valid index
+    if(resolved < 0 || resolved > static_cast<int64_t>(UINT32_MAX)){
+        isValid = false;
+    }
+    index = static_cast<uint32_t>(resolved);
+    return skipToken(result.ptr, lineEnd);
+}
+
+static void countElements(ObjChunk& chunk){
+    for(const char* it = chunk._Begin; it < chunk._End;){
+        const char* lineEnd = getLineEnd(it, chunk._End);
+        const char* element = skipBlanks(it, lineEnd);
+        if(isElement(element, lineEnd, 'v')){
+            chunk._NbVertices++;
+        } else if(isElement(element, lineEnd, 'f')){
+            size_t nbCorners = countTokens(element, lineEnd);
+            chunk._NbTriangles += nbCorners >= 3 ? nbCorners - 2 : 0;
+        }
+        it = lineEnd + 1;
+    }
+}
+
+static void parseElements(ObjChunk& chunk, glm::vec3* vertices, uint32_t* indices){
+    size_t nbVertices = 0;
+    size_t nbTriangles = 0;
+    for(const char* it = chunk._Begin; it < chunk._End;){
+        const char* lineEnd = getLineEnd(it, chunk._End);
+        const char* element = skipBlanks(it, lineEnd);
+        if(isElement(element, lineEnd, 'v')){
+            glm::vec3& vertex = vertices[chunk._FirstVertex + nbVertices];
+            element = parseFloat(element, lineEnd, vertex.x, chunk._IsValid);
+            element = parseFloat(element, lineEnd, vertex.y, chunk._IsValid);
+            parseFloat(element, lineEnd, vertex.z, chunk._IsValid);
+            nbVertices++;
+        } else if(isElement(element, lineEnd, 'f')){
+            // fan around the first corner
+            size_t nbPreviousVertices = chunk._FirstVertex + nbVertices;
+            uint32_t first = 0, previous = 0, current = 0;
+            size_t nbCorners = 0;
+            for(element = skipBlanks(element, lineEnd); element < lineEnd; element = skipBlanks(element, lineEnd)){
+                element = parseCorner(element, lineEnd, nbPreviousVertices, current, chunk._IsValid);
+                if(nbCorners == 0){
+                    first = current;
+                } else if(nbCorners >= 2){
+                    uint32_t* triangle = indices + 3 * (chunk._FirstTriangle + nbTriangles);
+                    triangle[0] = first;
+                    triangle[1] = previous;
+                    triangle[2] = current;
+                    nbTriangles++;
+                }
+                previous = current;
+                nbCorners++;
+            }
+        }
+        it = lineEnd + 1;
+    }
+}
+
+static std::vector<ObjChunk> getChunks(const char* data, size_t size, uint32_t nbChunks){
+    std::vector<ObjChunk> chunks(nbChunks);
+    const char* end = data + size;
+    const char* begin = data;
+    for(uint32_t i=0; i<nbChunks; i++){
+        // the chunks end after a line break
+        const char* chunkEnd = i + 1 == nbChunks ? end : std::max(begin, data + size * (i + 1) / nbChunks);
+        if(chunkEnd < end){
+            chunkEnd = std::min(getLineEnd(chunkEnd, end) + 1, end);
+        }
+        chunks[i]._Begin = begin;
+        chunks[i]._End = chunkEnd;
+        begin = chunkEnd;
+    }
+    return chunks;
+}
+
+MeshPtr ObjLoader::load(const std::string& path, uint32_t nbChunks){
+    MappedFile file = MappedFile(path);
+    if(nbChunks == 0){
+        size_t maxNbChunks = NB_CHUNKS_PER_THREAD * static_cast<size_t>(omp_get_max_threads());
+        nbChunks = static_cast<uint32_t>(std::clamp<size_t>(file.getSize() / MIN_CHUNK_SIZE, 1, maxNbChunks));
+    }
+    std::vector<ObjChunk> chunks = getChunks(file.getData(), file.getSize(), nbChunks);
+
+    #pragma omp parallel for schedule(dynamic)
+    for(size_t i=0; i<chunks.size(); i++){
+        countElements(chunks[i]);
+    }
+    // the chunks write one after the other
+    size_t nbVertices = 0;
+    size_t nbTriangles = 0;
+    for(ObjChunk& chunk : chunks){
+        chunk._FirstVertex = nbVertices;
+        chunk._FirstTriangle = nbTriangles;
+        nbVertices += chunk._NbVertices;
+        nbTriangles += chunk._NbTriangles;
+    }
+
+    MeshPtr mesh = MeshPtr(new Mesh());
+    mesh->_Vertices.resize(nbVertices);
+    mesh->_Indices.resize(3 * nbTriangles);
+    #pragma omp parallel for schedule(dynamic)
+    for(size_t i=0; i<chunks.size(); i++){
+        parseElements(chunks[i], mesh->_Vertices.data(), mesh->_Indices.data());
+    }
+
+    bool isValid = std::all_of(chunks.begin(), chunks.end(), [](const ObjChunk& chunk){return chunk._IsValid;});
+    isValid = isValid && std::all_of(mesh->_Indices.begin(), mesh->_Indices.end(), [&](uint32_t index){return index < nbVertices;});
+    if(!isValid){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "Error loading object `" + path + "': malformed vertex or face!\n"
+        );
+    }
+    return mesh;
+}
+
+}
\ No newline at end of file
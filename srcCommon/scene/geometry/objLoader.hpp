@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "mesh.hpp"
+
+namespace cr{
+
+/**
+ * Reader of the positions and faces of obj files, the other elements are skipped
+ * The file is mapped in memory and cut into chunks at line boundaries, the chunks are parsed in parallel
+ * A first pass counts the vertices and triangles of each chunk, their prefix sums give where each chunk writes in the mesh
+ * The polygons are split in fans of triangles
+*/
+class ObjLoader {
+    public:
+        // the chunks are not made smaller than this, except if their number is given
+        static const size_t MIN_CHUNK_SIZE = 1<<20;
+        static const uint32_t NB_CHUNKS_PER_THREAD = 8;
+
+    public:
+        // nbChunks = 0 picks it from the size of the file and the number of threads
+        static MeshPtr load(const std::string& path, uint32_t nbChunks = 0);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "plyLoader.hpp"
+
+#include <cstring>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include "errorHandler.hpp"
+#include "mappedFile.hpp"
+
+namespace cr{
+
+enum PlyType {
+    PLY_INT8, PLY_UINT8, PLY_INT16, PLY_UINT16, PLY_INT32, PLY_UINT32, PLY_FLOAT32, PLY_FLOAT64, PLY_INVALID
+};
+
+struct PlyProperty {
+    std::string _Name = "";
+    PlyType _Type = PLY_INVALID;
+    // lists store their number of items before them
+    bool _IsList = false;
+    PlyType _CountType = PLY_INVALID;
+};
+
+struct PlyElement {
+    std::string _Name = "";
+    size_t _Count = 0;
+    std::vector<PlyProperty> _Properties{};
+    // where the records are in the file
+    const char* _Begin = nullptr;
+    const char* _End = nullptr;
+};
+
+static PlyType getType(const std::string& name){
+    if(name == "char" || name == "int8") return PLY_INT8;
+    if(name == "uchar" || name == "uint8") return PLY_UINT8;
+    if(name == "short" || name == "int16") return PLY_INT16;
+    if(name == "ushort" || name == "uint16") return PLY_UINT16;
+    if(name == "int" || name == "int32") return PLY_INT32;
+    if(name == "uint" || name == "uint32") return PLY_UINT32;
+    if(name == "float" || name == "float32") return PLY_FLOAT32;
+    if(name == "double" || name == "float64") return PLY_FLOAT64;
+    return PLY_INVALID;
+}
+
+static size_t getSize(PlyType type){
+    static const size_t SIZES[] = {1, 1, 2, 2, 4, 4, 4, 8, 0};
+    return SIZES[type];
+}
+
+// the data is not aligned
+template <typename T>
+static T read(const char* data){
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+static double readScalar(const char* data, PlyType type){
+    switch(type){
+        case PLY_INT8: return read<int8_t>(data);
+        case PLY_UINT8: return read<uint8_t>(data);
+        case PLY_INT16: return read<int16_t>(data);
+        case PLY_UINT16: return read<uint16_t>(data);
+        case PLY_INT32: return read<int32_t>(data);
+        case PLY_UINT32: return read<uint32_t>(data);
+        case PLY_FLOAT32: return read<float>(data);
+        case PLY_FLOAT64: return read<double>(data);
+        default: return 0.;
+    }
+}
+
+static void handleError(const std::string& path, const std::string& message){
+    ErrorHandler::handle(
+        __FILE__, __LINE__,
+        ErrorCode::BAD_VALUE_ERROR,
+        "Error loading object `" + path + "': " + message + "!\n"
+    );
+}
+
+// returns the beginning of the data
+static const char* parseHeader(const std::string& path, const char* data, size_t size, std::vector<PlyElement>& elements){
+    static const std::string_view HEADER_END = "end_header";
+    std::string_view file = std::string_view(data, size);
+    size_t headerEnd = file.find(HEADER_END);
+    size_t dataBegin = headerEnd == std::string_view::npos ? headerEnd : file.find('\n', headerEnd);
+    if(file.substr(0, 3) != "ply" || dataBegin == std::string_view::npos){
+        handleError(path, "not a ply file");
+    }
+
+    std::istringstream header = std::istringstream(std::string(file.substr(0, headerEnd)));
+    std::string line;
+    while(std::getline(header, line)){
+        std::istringstream words = std::istringstream(line);
+        std::string keyword;
+        words >> keyword;
+        if(keyword == "format"){
+            std::string format;
+            words >> format;
+            if(format != "binary_little_endian"){
+                handleError(path, "only the binary little endian ply files are supported");
+            }
+        } else if(keyword == "element"){
+            PlyElement element{};
+            words >> element._Name >> element._Count;
+            elements.push_back(element);
+        } else if(keyword == "property" && !elements.empty()){
+            PlyProperty property{};
+            std::string type;
+            words >> type;
+            if(type == "list"){
+                std::string countType;
+                words >> countType >> type;
+                property._IsList = true;
+                property._CountType = getType(countType);
+            }
+            words >> property._Name;
+            property._Type = getType(type);
+            if(property._Type == PLY_INVALID || (property._IsList && property._CountType == PLY_INVALID)){
+                handleError(path, "unknown property type in `" + line + "'");
+            }
+            elements.back()._Properties.push_back(property);
+        }
+    }
+    return data + dataBegin + 1;
+}
+
+// size of a record without lists, 0 if it has some
+static size_t getFixedStride(const PlyElement& element){
+    size_t stride = 0;
+    for(const PlyProperty& property : element._Properties){
+        if(property._IsList){
+            return 0;
+        }
+        stride += getSize(property._Type);
+    }
+    return stride;
+}
+
+// skips a record, nullptr if it goes past the end
+static const char* skipRecord(const PlyElement& element, const char* it, const char* end){
+    for(const PlyProperty& property : element._Properties){
+        size_t size = getSize(property._Type);
+        if(property._IsList){
+            if(getSize(property._CountType) > static_cast<size_t>(end - it)) return nullptr;
+            double nbItems = readScalar(it, property._CountType);
+            if(nbItems < 0.) return nullptr;
+            size *= static_cast<size_t>(nbItems);
+            it += getSize(property._CountType);
+        }
+        if(size > static_cast<size_t>(end - it)) return nullptr;
+        it += size;
+    }
+    return it;
+}
+
+// finds where the records of each element are
+static void locateElements(const std::string& path, std::vector<PlyElement>& elements, const char* it, const char* end){
+    for(PlyElement& element : elements){
+        element._Begin = it;
+        size_t stride = getFixedStride(element);
+        if(stride > 0){
+            if(element._Count > static_cast<size_t>(end - it) / stride){
+                handleError(path, "the element `" + element._Name + "' goes past the end of the file");
+            }
+            it += stride * element._Count;
+        } else {
+            for(size_t i=0; i<element._Count && it != nullptr; i++){
+                it = skipRecord(element, it, end);
+            }
+            if(it == nullptr){
+                handleError(path, "the element `" + element._Name + "' goes past the end of the file");
+            }
+        }
+        element._End = it;
+    }
+}
+
+static void loadVertices(const std::string& path, const MappedFilePtr& file, const PlyElement& vertices, MeshPtr& mesh){
+    size_t stride = getFixedStride(vertices);
+    // offsets of x, y and z in the records
+    size_t offsets[3] = {0, 0, 0};
+    PlyType types[3] = {PLY_INVALID, PLY_INVALID, PLY_INVALID};
+    size_t offset = 0;
+    for(const PlyProperty& property : vertices._Properties){
+        for(uint32_t axis=0; axis<3; axis++){
+            if(property._Name == std::string(1, 'x' + axis)){
+                offsets[axis] = offset;
+                types[axis] = property._Type;
+            }
+        }
+        offset += getSize(property._Type);
+    }
+    if(stride == 0 || types[0] == PLY_INVALID || types[1] == PLY_INVALID || types[2] == PLY_INVALID){
+        handleError(path, "the vertices need fixed size x, y and z properties");
+    }
+
+    // read from the pages as they are
+    bool isPacked = stride == sizeof(glm::vec3) && offsets[0] == 0 && offsets[1] == 4 && offsets[2] == 8
+        && types[0] == PLY_FLOAT32 && types[1] == PLY_FLOAT32 && types[2] == PLY_FLOAT32
+        && reinterpret_cast<uintptr_t>(vertices._Begin) % alignof(glm::vec3) == 0;
+    if(isPacked){
+        mesh->setMappedGeometry(file, std::span<const glm::vec3>(reinterpret_cast<const glm::vec3*>(vertices._Begin), vertices._Count), {});
+        return;
+    }
+    mesh->_Vertices.resize(vertices._Count);
+    glm::vec3* positions = mesh->_Vertices.data();
+    const char* records = vertices._Begin;
+    #pragma omp parallel for
+    for(size_t v=0; v<vertices._Count; v++){
+        const char* record = records + stride * v;
+        for(uint32_t axis=0; axis<3; axis++){
+            positions[v][axis] = static_cast<float>(readScalar(record + offsets[axis], types[axis]));
+        }
+    }
+}
+
+static void loadFaces(const std::string& path, const PlyElement& faces, size_t nbVertices, MeshPtr& mesh){
+    const PlyProperty* indices = nullptr;
+    for(const PlyProperty& property : faces._Properties){
+        if(property._IsList && (property._Name == "vertex_indices" || property._Name == "vertex_index")){
+            indices = &property;
+        }
+    }
+    if(indices == nullptr || indices->_Type == PLY_FLOAT32 || indices->_Type == PLY_FLOAT64){
+        handleError(path, "the faces need an integer vertex_indices list");
+    }
+
+    // the usual triangles, a byte for the count and three 32 bits indices, are decoded in parallel
+    const size_t TRIANGLE_STRIDE = 1 + 3 * sizeof(uint32_t);
+    bool isValid = true;
+    if(faces._Properties.size() == 1 && indices->_CountType <= PLY_UINT8 && getSize(indices->_Type) == sizeof(uint32_t)
+        && static_cast<size_t>(faces._End - faces._Begin) == TRIANGLE_STRIDE * faces._Count){
+        mesh->_Indices.resize(3 * faces._Count);
+        uint32_t* triangles = mesh->_Indices.data();
+        const char* records = faces._Begin;
+        bool isTriangle = true;
+        #pragma omp parallel for reduction(&&:isTriangle, isValid)
+        for(size_t f=0; f<faces._Count; f++){
+            const char* record = records + TRIANGLE_STRIDE * f;
+            isTriangle = isTriangle && record[0] == 3;
+            for(uint32_t c=0; c<3; c++){
+                // a negative int becomes too large
+                triangles[3 * f + c] = read<uint32_t>(record + 1 + sizeof(uint32_t) * c);
+                isValid = isValid && triangles[3 * f + c] < nbVertices;
+            }
+        }
+        if(isTriangle){
+            if(!isValid){
+                handleError(path, "a face refers to a missing vertex");
+            }
+            return;
+        }
+        mesh->_Indices.clear();
+        isValid = true;
+    }
+
+    // fans around the first corner, the faces were checked while locating them
+    mesh->_Indices.reserve(3 * faces._Count);
+    const char* it = faces._Begin;
+    for(size_t f=0; f<faces._Count; f++){
+        for(const PlyProperty& property : faces._Properties){
+            size_t nbItems = 1;
+            if(property._IsList){
+                nbItems = static_cast<size_t>(readScalar(it, property._CountType));
+                it += getSize(property._CountType);
+            }
+            if(&property == indices){
+                size_t size = getSize(property._Type);
+                for(size_t corner=2; corner<nbItems; corner++){
+                    for(size_t c : {size_t(0), corner - 1, corner}){
+                        int64_t index = static_cast<int64_t>(readScalar(it + size * c, property._Type));
+                        isValid = isValid && index >= 0 && static_cast<size_t>(index) < nbVertices;
+                        mesh->_Indices.push_back(static_cast<uint32_t>(index));
+                    }
+                }
+            }
+            it += getSize(property._Type) * nbItems;
+        }
+    }
+    if(!isValid){
+        handleError(path, "a face refers to a missing vertex");
+    }
+}
+
+MeshPtr PlyLoader::load(const std::string& path){
+    MappedFilePtr file = MappedFilePtr(new MappedFile(path));
+    std::vector<PlyElement> elements{};
+    const char* data = parseHeader(path, file->getData(), file->getSize(), elements);
+    locateElements(path, elements, data, file->getData() + file->getSize());
+
+    MeshPtr mesh = MeshPtr(new Mesh());
+    const PlyElement* vertices = nullptr;
+    const PlyElement* faces = nullptr;
+    for(const PlyElement& element : elements){
+        vertices = element._Name == "vertex" ? &element : vertices;
+        faces = element._Name == "face" ? &element : faces;
+    }
+    if(vertices == nullptr){
+        handleError(path, "no vertex element");
+    }
+    loadVertices(path, file, *vertices, mesh);
+    if(faces != nullptr){
+        loadFaces(path, *faces, vertices->_Count, mesh);
+    }
+    return mesh;
+}
+
+}
\ No newline at end of file
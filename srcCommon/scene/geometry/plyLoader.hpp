@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+
+#include "mesh.hpp"
+
+namespace cr{
+
+/**
+ * Reader of the positions and faces of binary little endian ply files, the other properties and elements are skipped
+ * The file is mapped in memory, when the vertices are only three aligned floats the mesh reads them from the pages,
+ * otherwise they are converted in parallel
+ * The faces are lists of indices, the polygons are split in fans of triangles
+*/
+class PlyLoader {
+    public:
+        static MeshPtr load(const std::string& path);
+};
+
+}
\ No newline at end of file
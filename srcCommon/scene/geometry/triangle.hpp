@@ -2,35 +2,30 @@
 
 #include <cstdint>
 #include <glm/glm.hpp>
+#include <vector>
 
 namespace cr{
 
 
+// three indices in the vertex buffer of the scene, one 16 bytes load on the gpu
+// stored once per mesh, the instances refer to the triangles of their mesh
 struct TriangleGPU{
-    glm::vec4 _P0;
-    glm::vec4 _P1;
-    glm::vec4 _P2;
-    alignas(16) uint32_t _ModelId;
+    uint32_t _Indices[3] = {0, 0, 0};
+    uint32_t _MeshId = 0;
 };
 
 class Triangle{
-    private:
-        static uint32_t _IdGenerator;
-
     public:
         static const size_t MAX_NB_TRIANGLES = 2<<15;
         // static const uint32_t MAX_NB_TRIANGLES = 2<<3;
+        // closed meshes have about half as many vertices as triangles
+        static const size_t MAX_NB_VERTICES = MAX_NB_TRIANGLES;
 
     public:
-        TriangleGPU _InternalStruct{};
-
-    public:
-        Triangle(const glm::vec4& p0, const glm::vec4& p1, const glm::vec4& p2, uint32_t modelId);
-        Triangle(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, uint32_t modelId);
-
-    public:
-        static glm::vec3 getCentroid(const TriangleGPU& triangle);
-        static glm::vec3 getCentroid(const TriangleGPU& triangle, const glm::mat4& model);
+        // positions in the space given by the model matrix
+        static void getVertices(const TriangleGPU& triangle, const std::vector<glm::vec3>& vertices, const glm::mat4& model,
+            glm::vec3& p0, glm::vec3& p1, glm::vec3& p2);
+        static glm::vec3 getCentroid(const TriangleGPU& triangle, const std::vector<glm::vec3>& vertices, const glm::mat4& model);
 
 };
 
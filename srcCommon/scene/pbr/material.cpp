@@ -4,7 +4,7 @@
 
 namespace cr{
 
-uint32_t Material::_IdGenerator = 0;
+std::atomic<uint32_t> Material::_IdGenerator = 0;
 
 
 Material::Material(const glm::vec4& color){
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <glm/glm.hpp>
 
@@ -12,7 +13,7 @@ struct MaterialGPU{
 
 class Material{
     private:
-        static uint32_t _IdGenerator;
+        static std::atomic<uint32_t> _IdGenerator;
         uint32_t _Id = 0;
 
     public:
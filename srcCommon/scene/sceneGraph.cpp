@@ -0,0 +1,85 @@
+#include "sceneGraph.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "errorHandler.hpp"
+
+namespace cr{
+
+void SceneGraph::checkNode(uint32_t node) const {
+    if(node >= _Parents.size()){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::BAD_VALUE_ERROR,
+            "The node " + std::to_string(node) + " is not in the scene graph!\n"
+        );
+    }
+}
+
+uint32_t SceneGraph::addNode(const glm::mat4& localMatrix, uint32_t parent){
+    if(parent != NO_PARENT){
+        checkNode(parent);
+    }
+    uint32_t node = _Parents.size();
+    _Parents.push_back(parent);
+    _LocalMatrices.push_back(localMatrix);
+    _WorldMatrices.push_back(glm::mat4(1.f));
+    _IsDirty.push_back(1);
+    _FirstDirtyNode = std::min(_FirstDirtyNode, node);
+    return node;
+}
+
+void SceneGraph::setLocalMatrix(uint32_t node, const glm::mat4& localMatrix){
+    checkNode(node);
+    _LocalMatrices[node] = localMatrix;
+    _IsDirty[node] = 1;
+    _FirstDirtyNode = std::min(_FirstDirtyNode, node);
+}
+
+uint32_t SceneGraph::getNbNodes() const {
+    return _Parents.size();
+}
+
+uint32_t SceneGraph::getParent(uint32_t node) const {
+    checkNode(node);
+    return _Parents[node];
+}
+
+const glm::mat4& SceneGraph::getLocalMatrix(uint32_t node) const {
+    checkNode(node);
+    return _LocalMatrices[node];
+}
+
+const glm::mat4& SceneGraph::getWorldMatrix(uint32_t node) const {
+    checkNode(node);
+    return _WorldMatrices[node];
+}
+
+bool SceneGraph::isDirty() const {
+    return _FirstDirtyNode < _Parents.size();
+}
+
+const std::vector<uint32_t>& SceneGraph::updateWorldMatrices(){
+    _UpdatedNodes.clear();
+    uint32_t nbNodes = _Parents.size();
+    for(uint32_t node=_FirstDirtyNode; node<nbNodes; node++){
+        uint32_t parent = _Parents[node];
+        // the flags of the parents are still set, the whole subtree follows
+        if(parent != NO_PARENT && _IsDirty[parent]){
+            _IsDirty[node] = 1;
+        }
+        if(!_IsDirty[node]){
+            continue;
+        }
+        _WorldMatrices[node] = parent == NO_PARENT ? _LocalMatrices[node] : _WorldMatrices[parent] * _LocalMatrices[node];
+        _UpdatedNodes.push_back(node);
+    }
+    for(uint32_t node : _UpdatedNodes){
+        _IsDirty[node] = 0;
+    }
+    _FirstDirtyNode = nbNodes;
+    return _UpdatedNodes;
+}
+
+}
\ No newline at end of file
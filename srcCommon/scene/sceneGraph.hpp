@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace cr{
+
+class SceneGraph;
+using SceneGraphPtr = std::shared_ptr<SceneGraph>;
+
+/**
+ * Transform hierarchy stored as flat arrays indexed by the nodes
+ * A parent always comes before its children, so the world matrices are computed in a single pass in index order
+ * Only the dirty nodes and their descendants are computed again
+*/
+class SceneGraph {
+    public:
+        static const uint32_t NO_PARENT = 0xFFFFFFFF;
+
+    private:
+        std::vector<uint32_t> _Parents{};
+        std::vector<glm::mat4> _LocalMatrices{};
+        std::vector<glm::mat4> _WorldMatrices{};
+        std::vector<uint8_t> _IsDirty{};
+        // the nodes before it are up to date
+        uint32_t _FirstDirtyNode = 0;
+        // nodes whose world matrix changed during the last update, in increasing order
+        std::vector<uint32_t> _UpdatedNodes{};
+
+    public:
+        SceneGraph() = default;
+
+    public:
+        // the parent must already be in the graph
+        uint32_t addNode(const glm::mat4& localMatrix, uint32_t parent = NO_PARENT);
+        void setLocalMatrix(uint32_t node, const glm::mat4& localMatrix);
+
+        uint32_t getNbNodes() const;
+        uint32_t getParent(uint32_t node) const;
+        const glm::mat4& getLocalMatrix(uint32_t node) const;
+        // as of the last update
+        const glm::mat4& getWorldMatrix(uint32_t node) const;
+        bool isDirty() const;
+
+        // computes the world matrices of the dirty subtrees, returns the nodes that changed
+        const std::vector<uint32_t>& updateWorldMatrices();
+
+    private:
+        void checkNode(uint32_t node) const;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#version 460 core
+
+// progressive accumulation of the traced samples, cf glr::AccumulationBuffer
+
+#include "common/accumulation.glsl"
+
+// output
+// holds the new sample on input and the mean of all the samples on output
+layout(rgba32f, binding = 0) uniform image2D oImage;
+// rgb is the sum of the samples and a the sum of their squared luminance
+layout(rgba32f, binding = 2) uniform image2D uAccumulation;
+
+layout (binding = 17, std430) buffer uConvergenceSSBO {
+    uint uNbNonConvergedPixels;
+};
+
+// input
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+uniform uvec2 uImageSize;
+// number of samples including the new one
+uniform uint uNbSamples;
+// relative standard error of the mean under which a pixel is converged
+uniform float uErrorTarget;
+uniform bool uIsConvergenceChecked;
+
+// dark pixels are compared to an absolute error instead
+const float MIN_LUMINANCE = 1e-2f;
+
+// code
+float getLuminance(vec3 color){
+    return dot(color, vec3(0.2126f, 0.7152f, 0.0722f));
+}
+
+// main
+void main(){
+    ivec2 texelCoord = ivec2(gl_GlobalInvocationID.xy);
+    if(texelCoord.x >= uImageSize.x || texelCoord.y >= uImageSize.y){
+        return;
+    }
+
+    // the counts are cleared on a reset
+    uint state = imageLoad(uSampleCounts, texelCoord).x;
+    // nothing was traced for a converged pixel, the image still holds its mean
+    if((state & CONVERGED_PIXEL_FLAG) != 0u){
+        return;
+    }
+    uint nbSamples = (state & SAMPLE_COUNT_MASK) + 1;
+
+    vec3 newSample = imageLoad(oImage, texelCoord).rgb;
+    float luminance = getLuminance(newSample);
+    // the first sample overwrites the previous accumulation
+    vec4 sum = nbSamples == 1 ? vec4(0.f) : imageLoad(uAccumulation, texelCoord);
+    sum += vec4(newSample, luminance * luminance);
+    imageStore(uAccumulation, texelCoord, sum);
+
+    float n = float(nbSamples);
+    vec3 mean = sum.rgb / n;
+    imageStore(oImage, texelCoord, vec4(mean, 1.f));
+
+    bool isErrorBelowTarget = false;
+    if(nbSamples > 1){
+        // unbiased variance of the samples, then variance of their mean
+        float meanLuminance = getLuminance(mean);
+        float variance = max(sum.a / n - meanLuminance * meanLuminance, 0.f) * n / (n - 1.f);
+        float error = sqrt(variance / n);
+        isErrorBelowTarget = error <= uErrorTarget * max(meanLuminance, MIN_LUMINANCE);
+    }
+    if(uIsConvergenceChecked && !isErrorBelowTarget){
+        atomicAdd(uNbNonConvergedPixels, 1);
+    }
+    // the pixels are flagged as converged by shaders/adaptiveSampling.glsl
+    imageStore(uSampleCounts, texelCoord, uvec4(nbSamples | (isErrorBelowTarget ? LOW_ERROR_PIXEL_FLAG : 0u)));
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#version 460 core
+
+// flags the converged pixels of the progressive accumulation, cf glr::AccumulationBuffer
+// the tracers skip them until the next reset
+
+#include "common/accumulation.glsl"
+
+// input
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+uniform uvec2 uImageSize;
+// samples taken everywhere before the variance is trusted
+uniform uint uMinNbSamples;
+
+// main
+void main(){
+    ivec2 texelCoord = ivec2(gl_GlobalInvocationID.xy);
+    if(texelCoord.x >= uImageSize.x || texelCoord.y >= uImageSize.y){
+        return;
+    }
+    uint state = imageLoad(uSampleCounts, texelCoord).x;
+    if((state & CONVERGED_PIXEL_FLAG) != 0u || (state & SAMPLE_COUNT_MASK) < uMinNbSamples){
+        return;
+    }
+
+    // an edge missed by the first samples of a pixel is usually seen by one of its neighbours
+    // only the flags of the neighbours are read, they don't change during this pass
+    ivec2 minCoord = max(texelCoord - 1, ivec2(0));
+    ivec2 maxCoord = min(texelCoord + 1, ivec2(uImageSize) - 1);
+    for(int y=minCoord.y; y<=maxCoord.y; y++){
+        for(int x=minCoord.x; x<=maxCoord.x; x++){
+            if((imageLoad(uSampleCounts, ivec2(x, y)).x & LOW_ERROR_PIXEL_FLAG) == 0u){
+                return;
+            }
+        }
+    }
+    imageStore(uSampleCounts, texelCoord, uvec4(state | CONVERGED_PIXEL_FLAG));
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#version 460 core
+
+#include "common/accumulation.glsl"
+#include "common/bvhOverlay.glsl"
+#include "common/camera.glsl"
+
+// output
+layout(rgba32f, binding = 0) uniform image2D oImage;
+
+// input
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+uniform uvec2 uImageSize;
+
+// main
+void main() {
+    // draws the BVH over an image produced by another pass
+    ivec2 texelCoord = ivec2(gl_GlobalInvocationID.xy);
+    // the converged pixels were not traced again
+    if(texelCoord.x >= uImageSize.x || texelCoord.y >= uImageSize.y || isPixelConverged(texelCoord)){
+        return;
+    }
+    RaySetup ray = setupRay(getPixelRay(texelCoord, vec2(uImageSize)));
+    vec4 bvhColor = getBVHOverlayColor(ray, 0);
+    vec4 value = imageLoad(oImage, texelCoord);
+    imageStore(oImage, texelCoord, vec4(value.rgb + bvhColor.rgb, value.a));
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+// per pixel state of the progressive accumulation, cf glr::AccumulationBuffer
+
+// number of samples of each pixel and flags of its error
+// the converged pixels get no more samples
+layout(r32ui, binding = 3) uniform uimage2D uSampleCounts;
+
+const uint CONVERGED_PIXEL_FLAG = 0x80000000u;
+// the error of the pixel alone is below the target
+const uint LOW_ERROR_PIXEL_FLAG = 0x40000000u;
+const uint SAMPLE_COUNT_MASK = 0x3FFFFFFFu;
+
+// code
+bool isPixelConverged(ivec2 texelCoord){
+    return (imageLoad(uSampleCounts, texelCoord).x & CONVERGED_PIXEL_FLAG) != 0u;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+// debug display of the bounding boxes of one level of the BVH
+
+#include "common/frame.glsl"
+#include "common/scene.glsl"
+
+// constants
+const vec4 BVH_AABB_COLOR = vec4(0.5f, 0.f, 0.5f, 0.1f);
+const vec4 BVH_AABB_LINE_COLOR = vec4(0.7f, 0.f, 0.7f, 0.1f);
+const float BVH_LINE_WIDTH = 0.05f;
+const uint BVH_OVERLAY_STACK_SIZE = 1024;
+// pushed under the bvh of an instance, the ray goes back to world space when it is popped
+const uint BVH_OVERLAY_INSTANCE_EXIT = 0xFFFFFFFFu;
+const uint BVH_OVERLAY_NO_INSTANCE = 0xFFFFFFFFu;
+
+// code
+// 0 if missed, 2 if the ray enters close to an edge of the box, 1 otherwise
+uint intersectBVH(RaySetup ray, BVH_Node node, float tMax){
+    float tMin = rayAABB(ray, node._BoundingBox, tMax);
+    if(tMin < 0.f){
+        return 0;
+    }
+
+    // check if border
+    float threshold = BVH_LINE_WIDTH / (uDepthDisplayBVH + 1.f);
+    vec3 enterPoint = ray._Origin + ray._Direction * tMin;
+    bool closeToX = (abs(enterPoint.x - node._BoundingBox._Min.x) < threshold) 
+        || (abs(enterPoint.x - node._BoundingBox._Max.x) < threshold);
+    bool closeToY = (abs(enterPoint.y - node._BoundingBox._Min.y) < threshold) 
+        || (abs(enterPoint.y - node._BoundingBox._Max.y) < threshold);
+    bool closeToZ = (abs(enterPoint.z - node._BoundingBox._Min.z) < threshold) 
+        || (abs(enterPoint.z - node._BoundingBox._Max.z) < threshold);
+    if((closeToX && closeToY) || (closeToX && closeToZ) || (closeToY && closeToZ)){
+        return 2;
+    }
+    return 1;
+}
+
+vec4 getBVHColor(uint intersectionBVH){
+    return intersectionBVH == 2 ? BVH_AABB_LINE_COLOR : BVH_AABB_COLOR;
+}
+
+// same order as the traversal of the raytracer, without going below the displayed depth
+vec4 getBVHOverlayColor(RaySetup worldRay, uint rootBvh){
+    vec4 bvhColor = vec4(0.f);
+    RaySetup ray = worldRay;
+    uint instanceIndex = BVH_OVERLAY_NO_INSTANCE;
+    uint stack[BVH_OVERLAY_STACK_SIZE];
+    uint depthStack[BVH_OVERLAY_STACK_SIZE];
+    int stackIndex = 0;
+    stack[stackIndex] = rootBvh;
+    depthStack[stackIndex] = 0;
+    stackIndex++;
+    while(stackIndex > 0){
+        stackIndex--;
+        uint currentNodeIndex = stack[stackIndex];
+        if(currentNodeIndex == BVH_OVERLAY_INSTANCE_EXIT){
+            ray = worldRay;
+            instanceIndex = BVH_OVERLAY_NO_INSTANCE;
+            continue;
+        }
+        uint currentDepth = depthStack[stackIndex];
+        BVH_Node curNode = uBVH_Nodes[currentNodeIndex];
+        uint intersectionBVH = intersectBVH(ray, curNode, INFINITY);
+        if(intersectionBVH == 0){
+            continue;
+        }
+        if(currentDepth == uDepthDisplayBVH){
+            bvhColor = getBVHColor(intersectionBVH);
+            continue;
+        }
+        if(isLeafBVH(curNode) == 1 && instanceIndex == BVH_OVERLAY_NO_INSTANCE){
+            instanceIndex = curNode._TriangleId;
+            ray = getInstanceRay(worldRay, instanceIndex);
+            stack[stackIndex] = BVH_OVERLAY_INSTANCE_EXIT;
+            stackIndex++;
+            stack[stackIndex] = uModels[instanceIndex]._BVH_Root;
+            depthStack[stackIndex] = currentDepth+1;
+            stackIndex++;
+        } else if(isLeafBVH(curNode) == 0){
+            stack[stackIndex] = curNode._LeftChild;
+            depthStack[stackIndex] = currentDepth+1;
+            stackIndex++;
+            stack[stackIndex] = curNode._RightChild;
+            depthStack[stackIndex] = currentDepth+1;
+            stackIndex++;
+        }
+    }
+    return bvhColor;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+// primary rays
+
+#include "common/frame.glsl"
+#include "common/intersection.glsl"
+
+// constants
+const float RASTER_FAR_PLANE = 1e4f;
+
+// code
+Ray getRay(vec2 pos){ // pos between 0 and 1
+    Ray ray;
+    ray._Origin = uCamera._Eye;
+    vec3 posViewSpace =  vec3(pos - 0.5f, 1.f) * vec3(uCamera._PlaneWidth, uCamera._PlaneHeight, uCamera._PlaneNear);
+    vec4 posWorldSpace = uCamera._InvView * vec4(posViewSpace, 1.f);
+    ray._Direction = normalize(posWorldSpace - ray._Origin);
+    ray._Direction.w = 0.;
+    return ray;
+}
+
+// primary ray of a pixel, moved inside of it by the accumulation jitter
+Ray getPixelRay(ivec2 pixel, vec2 imageSize){
+    return getRay((vec2(pixel) + uJitter) / imageSize);
+}
+
+
+// inverse of getRay, used to rasterise the primary visibility
+// the ray of a pixel goes through its jittered corner, the projection is shifted so that it goes through the rasterised sample
+vec4 getClipPosition(vec3 worldPosition, vec2 imageSize){
+    vec3 posViewSpace = (uCamera._View * vec4(worldPosition, 1.f)).xyz;
+    float depth = posViewSpace.z;
+    float near = uCamera._PlaneNear;
+    float far = RASTER_FAR_PLANE;
+    vec4 clipPosition;
+    clipPosition.xy = 2.f * near * posViewSpace.xy / vec2(uCamera._PlaneWidth, uCamera._PlaneHeight) 
+        + depth * (1.f - 2.f * uJitter) / imageSize;
+    clipPosition.z = depth * (far + near) / (far - near) - 2.f * far * near / (far - near);
+    clipPosition.w = depth;
+    return clipPosition;
+}
\ No newline at end of file
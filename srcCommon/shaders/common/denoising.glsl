@@ -0,0 +1,16 @@
+// guides of the denoiser written by the tracers, cf glr::Denoiser
+
+// first hit of the primary ray of each pixel
+// xyz is the normal facing the ray, null if the ray missed, and w the distance along the ray
+layout(rgba32f, binding = 4) uniform image2D uNormalDepthGuide;
+layout(rgba32f, binding = 5) uniform image2D uAlbedoGuide;
+
+// code
+void storeGuides(ivec2 texelCoord, vec3 normal, float depth, vec3 albedo){
+    imageStore(uNormalDepthGuide, texelCoord, vec4(normal, depth));
+    imageStore(uAlbedoGuide, texelCoord, vec4(albedo, 1.f));
+}
+
+void storeMissGuides(ivec2 texelCoord){
+    storeGuides(texelCoord, vec3(0.f), 0.f, vec3(1.f));
+}
\ No newline at end of file
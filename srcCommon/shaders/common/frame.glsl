@@ -0,0 +1,27 @@
+// per frame data, updated once per frame by the application
+// mirrors glr::FrameDataGPU (std140)
+
+struct Camera {
+    mat4 _View;
+    mat4 _Proj;
+    mat4 _InvView;
+    mat4 _InvProj;
+    vec4 _Eye;
+    float _PlaneWidth;
+    float _PlaneHeight;
+    float _PlaneNear;
+};
+
+layout(std140, binding = 0) uniform uFrameUBO {
+    Camera uCamera;
+    float uTime;
+    bool uIsWireframeModeOn;
+    bool uIsBVHDisplayed;
+    int uDepthDisplayBVH;
+    // primary hits are read from the visibility buffer instead of being traced
+    bool uIsPrimaryRasterized;
+    // position of the primary rays in their pixel, cf glr::AccumulationBuffer
+    vec2 uJitter;
+    // index of the sample in the per pixel sequences, cf cr::Sampler
+    uint uSampleIndex;
+};
@@ -0,0 +1,170 @@
+// shared ray, box and triangle intersection kernels
+// mirrors srcCommon/scene/geometry/intersection.cpp
+
+// structures
+struct Ray {
+    vec4 _Origin;
+    vec4 _Direction;
+};
+
+// data computed once per ray and reused by every box and triangle test
+struct RaySetup {
+    vec3 _Origin;
+    vec3 _Direction;
+    vec3 _InvDirection;
+    // 1 if the direction is negative along the axis
+    uvec3 _Sign;
+    // watertight permutation (kz is the dominant axis) and shear constants
+    ivec3 _Permutation;
+    vec3 _Shear;
+};
+
+struct Hit {
+    vec4 _Coords; // (b0, b1, b2, t)
+    uint _DidHit;
+    uint _TriangleId;
+    // instance of the mesh of the triangle
+    uint _InstanceId;
+};
+
+struct AABB {
+    vec3 _Min;
+    vec3 _Max;
+};
+
+// see Ize, "Robust BVH Ray Traversal", JCGT 2013
+const float GAMMA_3 = (3.f * 0.5f * 1.1920929e-7f) / (1.f - 3.f * 0.5f * 1.1920929e-7f);
+const float INFINITY = uintBitsToFloat(0x7F800000u);
+
+// code
+RaySetup setupRay(Ray ray){
+    RaySetup setup;
+    setup._Origin = ray._Origin.xyz;
+    setup._Direction = ray._Direction.xyz;
+    // division by zero gives +-inf which the slab test handles
+    setup._InvDirection = 1.f / ray._Direction.xyz;
+    setup._Sign = uvec3(lessThan(ray._Direction.xyz, vec3(0.f)));
+
+    // the dominant axis of the direction becomes z
+    vec3 absDirection = abs(ray._Direction.xyz);
+    int kz = 0;
+    if(absDirection.y > absDirection[kz]) kz = 1;
+    if(absDirection.z > absDirection[kz]) kz = 2;
+    int kx = (kz + 1) % 3;
+    int ky = (kx + 1) % 3;
+    // keep the winding of the triangles
+    if(ray._Direction[kz] < 0.f){
+        int tmp = kx;
+        kx = ky;
+        ky = tmp;
+    }
+    setup._Permutation = ivec3(kx, ky, kz);
+
+    setup._Shear = vec3(
+        ray._Direction[kx] / ray._Direction[kz],
+        ray._Direction[ky] / ray._Direction[kz],
+        1.f / ray._Direction[kz]
+    );
+    return setup;
+}
+
+// Watertight ray triangle intersection
+// cf Woop et al., "Watertight Ray/Triangle Intersection", JCGT 2013
+// outputs the barycentric coordinates and the distance scaled by the determinant
+bool rayTriangleScaled(RaySetup ray, vec3 p0, vec3 p1, vec3 p2, float tMin, float tMax, out vec4 scaledCoords, out float det){
+    int kx = ray._Permutation.x;
+    int ky = ray._Permutation.y;
+    int kz = ray._Permutation.z;
+
+    // vertices relative to the ray origin
+    vec3 a = p0 - ray._Origin;
+    vec3 b = p1 - ray._Origin;
+    vec3 c = p2 - ray._Origin;
+
+    // shear and scale the vertices
+    float ax = a[kx] - ray._Shear.x * a[kz];
+    float ay = a[ky] - ray._Shear.y * a[kz];
+    float bx = b[kx] - ray._Shear.x * b[kz];
+    float by = b[ky] - ray._Shear.y * b[kz];
+    float cx = c[kx] - ray._Shear.x * c[kz];
+    float cy = c[ky] - ray._Shear.y * c[kz];
+
+    // scaled barycentric coordinates
+    float u = cx * by - cy * bx;
+    float v = ax * cy - ay * cx;
+    float w = bx * ay - by * ax;
+
+    // fall back to double precision on the edges
+    if(u == 0.f || v == 0.f || w == 0.f){
+        u = float(double(cx) * double(by) - double(cy) * double(bx));
+        v = float(double(ax) * double(cy) - double(ay) * double(cx));
+        w = float(double(bx) * double(ay) - double(by) * double(ax));
+    }
+
+    // no back face culling, the signs only have to agree
+    if((u < 0.f || v < 0.f || w < 0.f) && (u > 0.f || v > 0.f || w > 0.f)){
+        return false;
+    }
+
+    det = u + v + w;
+    if(det == 0.f){
+        return false;
+    }
+
+    // scaled hit distance
+    float az = ray._Shear.z * a[kz];
+    float bz = ray._Shear.z * b[kz];
+    float cz = ray._Shear.z * c[kz];
+    float t = u * az + v * bz + w * cz;
+
+    // compare against [tMin, tMax] without dividing by the determinant
+    if(det < 0.f && (t >= tMin * det || t < tMax * det)){
+        return false;
+    }
+    if(det > 0.f && (t <= tMin * det || t > tMax * det)){
+        return false;
+    }
+
+    scaledCoords = vec4(u, v, w, t);
+    return true;
+}
+
+bool rayTriangle(RaySetup ray, vec3 p0, vec3 p1, vec3 p2, float tMax, inout Hit hit){
+    vec4 scaledCoords;
+    float det;
+    if(!rayTriangleScaled(ray, p0, p1, p2, 0.f, tMax, scaledCoords, det)){
+        return false;
+    }
+    hit._Coords = scaledCoords * (1.f / det);
+    hit._DidHit = 1;
+    return true;
+}
+
+// occlusion test, the hit is never normalized
+bool rayTriangleOcclusion(RaySetup ray, vec3 p0, vec3 p1, vec3 p2, float tMin, float tMax){
+    vec4 scaledCoords;
+    float det;
+    return rayTriangleScaled(ray, p0, p1, p2, tMin, tMax, scaledCoords, det);
+}
+
+// Robust slab test, returns the entry distance or -1 on a miss
+float rayAABB(RaySetup ray, AABB aabb, float tMax){
+    vec3 nearBounds = mix(aabb._Min, aabb._Max, bvec3(ray._Sign));
+    vec3 farBounds = mix(aabb._Max, aabb._Min, bvec3(ray._Sign));
+
+    vec3 tNearSlabs = (nearBounds - ray._Origin) * ray._InvDirection;
+    // conservative rounding so that the exit distance is never underestimated
+    vec3 tFarSlabs = (farBounds - ray._Origin) * ray._InvDirection * (1.f + 2.f * GAMMA_3);
+
+    // written so that NaN (origin on a slab with a null direction) never culls
+    float tNear = tNearSlabs.x;
+    tNear = tNearSlabs.y > tNear ? tNearSlabs.y : tNear;
+    tNear = tNearSlabs.z > tNear ? tNearSlabs.z : tNear;
+    float tFar = tFarSlabs.x;
+    tFar = tFarSlabs.y < tFar ? tFarSlabs.y : tFar;
+    tFar = tFarSlabs.z < tFar ? tFarSlabs.z : tFar;
+
+    tNear = max(tNear, 0.f);
+    tFar = min(tFar, tMax);
+    return tNear <= tFar ? tNear : -1.f;
+}
@@ -0,0 +1,14 @@
+// hash based random numbers
+
+// cf Jarzynski and Olano, "Hash Functions for GPU Rendering", JCGT 2020
+uint pcgHash(uint value){
+    uint state = value * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+// returns a float in [0, 1) and advances the seed
+float randomFloat(inout uint seed){
+    seed = pcgHash(seed);
+    return float(seed >> 8) * (1.f / 16777216.f);
+}
@@ -0,0 +1,116 @@
+// per pixel sample sequences, mirrors cr::Sampler
+
+#include "common/random.glsl"
+
+// mirrors cr::SamplerType
+const uint SAMPLER_WHITE_NOISE = 0u;
+const uint SAMPLER_SOBOL = 1u;
+const uint SAMPLER_RANK1_LATTICE = 2u;
+const uint SAMPLER_BLUE_NOISE = 3u;
+
+const uint SAMPLING_NB_SOBOL_BITS = 32u;
+const uint SAMPLING_MAX_NB_DIMENSIONS = 32u;
+const uint SAMPLING_BLUE_NOISE_SIZE = 64u;
+const uint SAMPLING_BLUE_NOISE_NB_RANK_BITS = 12u;
+const uint SAMPLING_LATTICE_GENERATOR = 17939u;
+const uint SAMPLING_GOLDEN_RATIO_OFFSET = 2654435769u;
+const uvec2 SAMPLING_R2_OFFSET = uvec2(3242174889u, 2447445414u);
+
+// dimensions used by the kernels, a 2D sample takes two dimensions
+const uint SAMPLING_DIMENSION_BOUNCE = 0u;
+
+// tables built by cr::Sampler, cf glr::SamplerBuffer
+layout (binding = 18, std430) readonly buffer uSamplingSSBO {
+    uint uSobolMatrices[2 * SAMPLING_NB_SOBOL_BITS];
+    uint uDimensionSamplers[SAMPLING_MAX_NB_DIMENSIONS];
+    // two blue noise ranks per texel, the second one in the high bits
+    uint uBlueNoise[SAMPLING_BLUE_NOISE_SIZE * SAMPLING_BLUE_NOISE_SIZE];
+};
+
+// cf Burley, "Practical Hash-based Owen Scrambling", JCGT 2020
+uint nestedUniformScramble(uint value, uint seed){
+    value = bitfieldReverse(value);
+    value += seed;
+    value ^= value * 0x6c50b47cu;
+    value ^= value * 0xb82f1e52u;
+    value ^= value * 0xc7afe638u;
+    value ^= value * 0x8d22f6e6u;
+    return bitfieldReverse(value);
+}
+
+uint sobol(uint index, uint dimension){
+    uint result = 0u;
+    for(uint bit=0u; index != 0u; index >>= 1u, bit++){
+        if((index & 1u) != 0u){
+            result ^= uSobolMatrices[dimension * SAMPLING_NB_SOBOL_BITS + bit];
+        }
+    }
+    return result;
+}
+
+uint getSamplingSeed(uvec2 pixel, uint dimension){
+    return pcgHash(pixel.x + pcgHash(pixel.y + pcgHash(dimension)));
+}
+
+uvec2 getBlueNoise(uvec2 pixel, uint dimension){
+    // each dimension reads the tile at its own offset
+    uint offset = pcgHash(dimension);
+    uvec2 texel = (pixel + uvec2(offset, offset >> 16u)) % SAMPLING_BLUE_NOISE_SIZE;
+    uint ranks = uBlueNoise[texel.y * SAMPLING_BLUE_NOISE_SIZE + texel.x];
+    return uvec2(ranks & 0xFFFFu, ranks >> 16u);
+}
+
+// centre of the interval of a blue noise rank
+uvec2 getRankCentre(uvec2 rank){
+    return (2u * rank + 1u) << (31u - SAMPLING_BLUE_NOISE_NB_RANK_BITS);
+}
+
+// 0.32 fixed point samples
+uvec2 getFixedPointSample2D(uvec2 pixel, uint sampleIndex, uint dimension){
+    uint seed = getSamplingSeed(pixel, dimension);
+    switch(uDimensionSamplers[dimension % SAMPLING_MAX_NB_DIMENSIONS]){
+        case SAMPLER_SOBOL: {
+            // shuffled and scrambled Sobol points, the shuffle decorrelates the dimensions
+            uint index = nestedUniformScramble(sampleIndex, seed);
+            return uvec2(
+                nestedUniformScramble(sobol(index, 0u), pcgHash(seed + 1u)),
+                nestedUniformScramble(sobol(index, 1u), pcgHash(seed + 2u))
+            );
+        }
+        case SAMPLER_RANK1_LATTICE: {
+            // the first 2^m points form the lattice of 2^m points, shifted modulo 1
+            uint radicalInverse = bitfieldReverse(sampleIndex);
+            return uvec2(
+                radicalInverse + pcgHash(seed + 1u),
+                radicalInverse * SAMPLING_LATTICE_GENERATOR + pcgHash(seed + 2u)
+            );
+        }
+        case SAMPLER_BLUE_NOISE: {
+            // centre of the rank interval, then moved along a low discrepancy sequence
+            return getRankCentre(getBlueNoise(pixel, dimension)) + sampleIndex * SAMPLING_R2_OFFSET;
+        }
+        default: {
+            uint x = pcgHash(seed ^ pcgHash(sampleIndex));
+            return uvec2(x, pcgHash(x));
+        }
+    }
+}
+
+vec2 toUnitFloat(uvec2 value){
+    // 24 bits so that the result is always below 1
+    return vec2(value >> 8u) * (1.f / 16777216.f);
+}
+
+// values in [0, 1)
+vec2 getSample2D(uvec2 pixel, uint sampleIndex, uint dimension){
+    return toUnitFloat(getFixedPointSample2D(pixel, sampleIndex, dimension));
+}
+
+float getSample1D(uvec2 pixel, uint sampleIndex, uint dimension){
+    // a blue noise value alone follows the golden ratio sequence instead of R2
+    if(uDimensionSamplers[dimension % SAMPLING_MAX_NB_DIMENSIONS] == SAMPLER_BLUE_NOISE){
+        uint rank = getBlueNoise(pixel, dimension).x;
+        return toUnitFloat(getRankCentre(uvec2(rank)) + sampleIndex * SAMPLING_GOLDEN_RATIO_OFFSET).x;
+    }
+    return toUnitFloat(getFixedPointSample2D(pixel, sampleIndex, dimension)).x;
+}
\ No newline at end of file
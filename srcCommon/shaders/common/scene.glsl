@@ -0,0 +1,115 @@
+// scene structures and buffers, mirrors glr::Scene
+
+#include "common/intersection.glsl"
+
+// structures
+// three indices in uVertices, stored once per mesh
+struct Triangle {
+    uint _Indices[3];
+    uint _MeshId;
+};
+
+struct Material {
+    vec4 _Color;
+};
+
+// one instance of a mesh
+struct Model {
+    mat4 _ModelMatrix;
+    mat4 _InvModelMatrix;
+    uint _MaterialId;
+    // root of the model space bvh of the mesh
+    uint _BVH_Root;
+    uint _FirstTriangle;
+    uint _NbTriangles;
+};
+
+// the top level bvh over the instances starts at 0, the leaves refer to the instances
+// the bvh of each mesh follows, the leaves refer to the triangles
+struct BVH_Node {
+    AABB _BoundingBox;
+    uint _TriangleId;
+    uint _LeftChild;
+    uint _RightChild;
+};
+
+// input
+uniform uint uNbMaterials;
+uniform uint uNbTriangles;
+uniform uint uNbModels;
+
+layout (binding = 2, std430) readonly buffer uMaterialsSSBO {
+    Material uMaterials[];
+};
+
+// tightly packed positions in model space, three floats per vertex
+layout (binding = 1, std430) readonly buffer uVerticesSSBO {
+    float uVertices[];
+};
+
+layout (binding = 3, std430) readonly buffer uTrianglesSSBO {
+    Triangle uTriangles[];
+};
+
+layout (binding = 4, std430) readonly buffer uModelsSSBO {
+    Model uModels[];
+};
+
+layout (binding = 5, std430) readonly buffer uBVH_SSBO {
+    BVH_Node uBVH_Nodes[];
+};
+
+// code
+vec4 getVertex(uint vertexIndex){
+    return vec4(uVertices[3 * vertexIndex], uVertices[3 * vertexIndex + 1], uVertices[3 * vertexIndex + 2], 1.f);
+}
+
+void getModelTriangleVertices(uint triangleIndex, out vec3 p0, out vec3 p1, out vec3 p2){
+    Triangle triangle = uTriangles[triangleIndex];
+    p0 = getVertex(triangle._Indices[0]).xyz;
+    p1 = getVertex(triangle._Indices[1]).xyz;
+    p2 = getVertex(triangle._Indices[2]).xyz;
+}
+
+// positions in world space
+void getTriangleVertices(uint instanceIndex, uint triangleIndex, out vec3 p0, out vec3 p1, out vec3 p2){
+    Triangle triangle = uTriangles[triangleIndex];
+    mat4 model = uModels[instanceIndex]._ModelMatrix;
+    p0 = (model * getVertex(triangle._Indices[0])).xyz;
+    p1 = (model * getVertex(triangle._Indices[1])).xyz;
+    p2 = (model * getVertex(triangle._Indices[2])).xyz;
+}
+
+Material getInstanceMaterial(uint instanceIndex){
+    return uMaterials[uModels[instanceIndex]._MaterialId];
+}
+
+// the ray in the model space of the instance, not normalized so that the distances stay the same
+RaySetup getInstanceRay(RaySetup ray, uint instanceIndex){
+    mat4 invModel = uModels[instanceIndex]._InvModelMatrix;
+    Ray modelRay;
+    modelRay._Origin = invModel * vec4(ray._Origin, 1.f);
+    modelRay._Direction = invModel * vec4(ray._Direction, 0.f);
+    return setupRay(modelRay);
+}
+
+// the ray is in model space, the caller sets the instance of the hit
+Hit rayTriangleIntersection(RaySetup ray, uint triangleIndex, float tMax){
+    Hit hit;
+    hit._DidHit = 0;
+
+    vec3 p0, p1, p2;
+    getModelTriangleVertices(triangleIndex, p0, p1, p2);
+
+    if(rayTriangle(ray, p0, p1, p2, tMax, hit)){
+        hit._TriangleId = triangleIndex;
+    }
+    return hit;
+}
+
+uint isLeafBVH(BVH_Node node){
+    return 
+        node._LeftChild == 0
+        && node._RightChild == 0
+        ? 1 : 0;
+}
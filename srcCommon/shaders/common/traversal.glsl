@@ -0,0 +1,103 @@
+// bvh traversal without debug output
+
+#include "common/scene.glsl"
+
+// a full stack drops the instances and the second children instead of overflowing,
+// degenerate trees may then miss some triangles
+const int TRAVERSAL_STACK_SIZE = 128;
+// pushed under the bvh of an instance, the ray goes back to world space when it is popped
+const uint TRAVERSAL_INSTANCE_EXIT = 0xFFFFFFFFu;
+// the traversal is still in the top level bvh
+const uint NO_INSTANCE = 0xFFFFFFFFu;
+
+// code
+Hit traceClosest(RaySetup worldRay, float tMax){
+    Hit closestHit;
+    closestHit._DidHit = 0;
+    closestHit._Coords.w = tMax;
+
+    RaySetup ray = worldRay;
+    uint instanceIndex = NO_INSTANCE;
+    uint stack[TRAVERSAL_STACK_SIZE];
+    int stackIndex = 0;
+    stack[stackIndex++] = 0; // root
+    while(stackIndex > 0){
+        uint nodeIndex = stack[--stackIndex];
+        if(nodeIndex == TRAVERSAL_INSTANCE_EXIT){
+            ray = worldRay;
+            instanceIndex = NO_INSTANCE;
+            continue;
+        }
+        BVH_Node curNode = uBVH_Nodes[nodeIndex];
+        if(rayAABB(ray, curNode._BoundingBox, closestHit._Coords.w) < 0.f){
+            continue;
+        }
+        if(isLeafBVH(curNode) == 1 && instanceIndex == NO_INSTANCE){
+            if(stackIndex + 2 > TRAVERSAL_STACK_SIZE){
+                continue;
+            }
+            // the bvh of the mesh is traversed in model space
+            instanceIndex = curNode._TriangleId;
+            ray = getInstanceRay(worldRay, instanceIndex);
+            stack[stackIndex++] = TRAVERSAL_INSTANCE_EXIT;
+            stack[stackIndex++] = uModels[instanceIndex]._BVH_Root;
+        } else if(isLeafBVH(curNode) == 1){
+            Hit hit = rayTriangleIntersection(ray, curNode._TriangleId, closestHit._Coords.w);
+            if(hit._DidHit == 1){
+                hit._InstanceId = instanceIndex;
+                closestHit = hit;
+            }
+        } else {
+            // a node was just popped so there is room for one child
+            stack[stackIndex++] = curNode._LeftChild;
+            if(stackIndex < TRAVERSAL_STACK_SIZE){
+                stack[stackIndex++] = curNode._RightChild;
+            }
+        }
+    }
+    return closestHit;
+}
+
+
+// any hit in [tMin, tMax], for shadow and occlusion rays
+bool traceAnyHit(RaySetup worldRay, float tMin, float tMax){
+    RaySetup ray = worldRay;
+    uint instanceIndex = NO_INSTANCE;
+    uint stack[TRAVERSAL_STACK_SIZE];
+    int stackIndex = 0;
+    stack[stackIndex++] = 0; // root
+    while(stackIndex > 0){
+        uint nodeIndex = stack[--stackIndex];
+        if(nodeIndex == TRAVERSAL_INSTANCE_EXIT){
+            ray = worldRay;
+            instanceIndex = NO_INSTANCE;
+            continue;
+        }
+        BVH_Node curNode = uBVH_Nodes[nodeIndex];
+        if(rayAABB(ray, curNode._BoundingBox, tMax) < 0.f){
+            continue;
+        }
+        if(isLeafBVH(curNode) == 1 && instanceIndex == NO_INSTANCE){
+            if(stackIndex + 2 > TRAVERSAL_STACK_SIZE){
+                continue;
+            }
+            instanceIndex = curNode._TriangleId;
+            ray = getInstanceRay(worldRay, instanceIndex);
+            stack[stackIndex++] = TRAVERSAL_INSTANCE_EXIT;
+            stack[stackIndex++] = uModels[instanceIndex]._BVH_Root;
+        } else if(isLeafBVH(curNode) == 1){
+            vec3 p0, p1, p2;
+            getModelTriangleVertices(curNode._TriangleId, p0, p1, p2);
+            if(rayTriangleOcclusion(ray, p0, p1, p2, tMin, tMax)){
+                return true;
+            }
+        } else {
+            // the left child is the largest one, the most likely to block the ray
+            if(stackIndex + 2 <= TRAVERSAL_STACK_SIZE){
+                stack[stackIndex++] = curNode._RightChild;
+            }
+            stack[stackIndex++] = curNode._LeftChild;
+        }
+    }
+    return false;
+}
\ No newline at end of file
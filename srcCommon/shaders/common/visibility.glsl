@@ -0,0 +1,32 @@
+// primary hits rasterised by glr::VisibilityBuffer
+
+#include "common/scene.glsl"
+
+// input
+// x is the triangle index + 1 (0 if nothing is visible), y and z are the barycentrics of p1 and p2, w is the instance
+layout(rgba32ui, binding = 1) readonly uniform uimage2D uVisibilityBuffer;
+
+// code
+Hit getVisibleHit(ivec2 texelCoord, Ray ray){
+    uvec4 visibility = imageLoad(uVisibilityBuffer, texelCoord);
+    Hit hit;
+    hit._Coords = vec4(0.f, 0.f, 0.f, INFINITY);
+    hit._DidHit = visibility.x == 0 ? 0 : 1;
+    hit._TriangleId = 0;
+    hit._InstanceId = 0;
+    if(hit._DidHit == 0){
+        return hit;
+    }
+
+    hit._TriangleId = visibility.x - 1;
+    hit._InstanceId = visibility.w;
+    float b1 = uintBitsToFloat(visibility.y);
+    float b2 = uintBitsToFloat(visibility.z);
+    float b0 = 1.f - b1 - b2;
+    vec3 p0, p1, p2;
+    getTriangleVertices(hit._InstanceId, hit._TriangleId, p0, p1, p2);
+    vec3 point = b0 * p0 + b1 * p1 + b2 * p2;
+    // the camera rays are normalized
+    hit._Coords = vec4(b0, b1, b2, dot(point - ray._Origin.xyz, ray._Direction.xyz));
+    return hit;
+}
\ No newline at end of file
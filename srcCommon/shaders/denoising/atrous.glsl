@@ -0,0 +1,86 @@
+#version 460 core
+
+// one iteration of glr::Denoiser, the taps of the 5x5 kernel are uStepSize pixels apart
+
+#include "denoising/denoising.glsl"
+
+// input
+// traced image, only its alpha is read
+layout(rgba32f, binding = 0) readonly uniform image2D uImage;
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+uniform int uStepSize;
+// the last iteration writes the color, the illumination times the albedo
+uniform bool uIsLastIteration;
+
+// code
+// separable 5x5 B3 spline
+float getKernelWeight(ivec2 offset){
+    const float WEIGHTS[3] = float[3](3.f / 8.f, 1.f / 4.f, 1.f / 16.f);
+    return WEIGHTS[abs(offset.x)] * WEIGHTS[abs(offset.y)];
+}
+
+// 3x3 gaussian blur of the variance, steadier than the variance of the pixel alone
+float getBlurredVariance(ivec2 texelCoord){
+    const float WEIGHTS[3] = float[3](1.f / 4.f, 1.f / 8.f, 1.f / 16.f);
+    float sumWeights = 0.f;
+    float sumVariances = 0.f;
+    for(int dy=-1; dy<=1; dy++){
+        for(int dx=-1; dx<=1; dx++){
+            ivec2 neighbour = texelCoord + ivec2(dx, dy);
+            if(!isInImage(neighbour)){
+                continue;
+            }
+            float weight = WEIGHTS[abs(dx) + abs(dy)];
+            sumWeights += weight;
+            sumVariances += weight * imageLoad(uIllumination, neighbour).a;
+        }
+    }
+    return sumVariances / sumWeights;
+}
+
+vec4 filterIllumination(ivec2 texelCoord, vec4 illumination){
+    vec4 normalDepth = imageLoad(uNormalDepthGuide, texelCoord);
+    // the misses are left as they are
+    if(isMiss(normalDepth)){
+        return illumination;
+    }
+    vec2 depthGradient = getDepthGradient(texelCoord, normalDepth.w);
+    float luminance = getLuminance(illumination.rgb);
+    float luminanceTolerance = uLuminancePhi * sqrt(getBlurredVariance(texelCoord)) + WEIGHT_EPSILON;
+
+    float sumWeights = 0.f;
+    vec4 sum = vec4(0.f);
+    for(int dy=-2; dy<=2; dy++){
+        for(int dx=-2; dx<=2; dx++){
+            ivec2 offset = ivec2(dx, dy) * uStepSize;
+            ivec2 neighbour = texelCoord + offset;
+            if(!isInImage(neighbour)){
+                continue;
+            }
+            vec4 neighbourIllumination = imageLoad(uIllumination, neighbour);
+            float luminanceWeight = exp(-abs(luminance - getLuminance(neighbourIllumination.rgb)) / luminanceTolerance);
+            float weight = getKernelWeight(ivec2(dx, dy))
+                * getGeometryWeight(normalDepth, imageLoad(uNormalDepthGuide, neighbour), depthGradient, vec2(offset))
+                * luminanceWeight;
+            // the variance of a weighted sum goes with the squared weights
+            sumWeights += weight;
+            sum += vec4(neighbourIllumination.rgb * weight, neighbourIllumination.a * weight * weight);
+        }
+    }
+    return vec4(sum.rgb / sumWeights, sum.a / (sumWeights * sumWeights));
+}
+
+// main
+void main(){
+    ivec2 texelCoord = ivec2(gl_GlobalInvocationID.xy);
+    if(!isInImage(texelCoord)){
+        return;
+    }
+    vec4 illumination = filterIllumination(texelCoord, imageLoad(uIllumination, texelCoord));
+    if(uIsLastIteration){
+        // the albedo is put back
+        illumination = vec4(illumination.rgb * getAlbedo(texelCoord), imageLoad(uImage, texelCoord).a);
+    }
+    imageStore(oIllumination, texelCoord, illumination);
+}
\ No newline at end of file
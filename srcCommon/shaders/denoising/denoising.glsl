@@ -0,0 +1,70 @@
+// edge avoiding a-trous wavelet filter with the weights of SVGF, mirrors cr::Denoiser
+
+#include "common/denoising.glsl"
+#include "common/intersection.glsl"
+
+// illumination and variance of its luminance, the iterations ping pong between the two
+layout(rgba32f, binding = 6) readonly uniform image2D uIllumination;
+layout(rgba32f, binding = 7) writeonly uniform image2D oIllumination;
+
+uniform uvec2 uImageSize;
+uniform float uLuminancePhi;
+uniform float uNormalPhi;
+uniform float uDepthPhi;
+
+// the illumination of a black surface is unknown
+const float MIN_ALBEDO = 1e-3f;
+// depth differences tolerated on surfaces facing the camera, relative to the depth
+const float RELATIVE_DEPTH_EPSILON = 1e-3f;
+// keeps the weights finite on flat areas
+const float WEIGHT_EPSILON = 1e-10f;
+
+// code
+float getLuminance(vec3 color){
+    return dot(color, vec3(0.2126f, 0.7152f, 0.0722f));
+}
+
+bool isInImage(ivec2 texelCoord){
+    return all(greaterThanEqual(texelCoord, ivec2(0))) && all(lessThan(texelCoord, ivec2(uImageSize)));
+}
+
+bool isMiss(vec4 normalDepth){
+    return normalDepth.xyz == vec3(0.f);
+}
+
+vec3 getAlbedo(ivec2 texelCoord){
+    return max(imageLoad(uAlbedoGuide, texelCoord).rgb, vec3(MIN_ALBEDO));
+}
+
+// smallest one sided difference of the depths, the silhouettes do not count
+vec2 getDepthGradient(ivec2 texelCoord, float depth){
+    vec2 gradient = vec2(INFINITY);
+    const ivec2 OFFSETS[4] = ivec2[4](ivec2(-1, 0), ivec2(1, 0), ivec2(0, -1), ivec2(0, 1));
+    for(int i=0; i<4; i++){
+        ivec2 neighbour = texelCoord + OFFSETS[i];
+        if(!isInImage(neighbour)){
+            continue;
+        }
+        vec4 normalDepth = imageLoad(uNormalDepthGuide, neighbour);
+        if(isMiss(normalDepth)){
+            continue;
+        }
+        float difference = abs(normalDepth.w - depth);
+        if(i < 2){
+            gradient.x = min(gradient.x, difference);
+        } else {
+            gradient.y = min(gradient.y, difference);
+        }
+    }
+    // a pixel with no neighbour on the surface only keeps itself
+    return vec2(isinf(gradient.x) ? 0.f : gradient.x, isinf(gradient.y) ? 0.f : gradient.y);
+}
+
+// normal and depth weight of q for p at the given offset in pixels
+float getGeometryWeight(vec4 p, vec4 q, vec2 depthGradient, vec2 offset){
+    // the misses have a null normal and are never mixed with the hits
+    float normalWeight = pow(max(dot(p.xyz, q.xyz), 0.f), uNormalPhi);
+    float depthTolerance = uDepthPhi * dot(depthGradient, abs(offset)) + RELATIVE_DEPTH_EPSILON * p.w;
+    float depthWeight = exp(-abs(p.w - q.w) / max(depthTolerance, WEIGHT_EPSILON));
+    return normalWeight * depthWeight;
+}
\ No newline at end of file
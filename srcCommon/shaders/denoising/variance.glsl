@@ -0,0 +1,51 @@
+#version 460 core
+
+// first stage of glr::Denoiser, the illumination and the variance of its luminance
+// there is no history, the variance is estimated over the neighbours on the same surface
+
+#include "denoising/denoising.glsl"
+
+// input
+// traced image, cf glr::AccumulationBuffer
+layout(rgba32f, binding = 0) readonly uniform image2D uImage;
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+const int VARIANCE_RADIUS = 3;
+
+// code
+vec3 getIllumination(ivec2 texelCoord){
+    return imageLoad(uImage, texelCoord).rgb / getAlbedo(texelCoord);
+}
+
+// main
+void main(){
+    ivec2 texelCoord = ivec2(gl_GlobalInvocationID.xy);
+    if(!isInImage(texelCoord)){
+        return;
+    }
+    vec3 illumination = getIllumination(texelCoord);
+    vec4 normalDepth = imageLoad(uNormalDepthGuide, texelCoord);
+    if(isMiss(normalDepth)){
+        imageStore(oIllumination, texelCoord, vec4(illumination, 0.f));
+        return;
+    }
+
+    // first two moments of the luminance over the same surface
+    vec2 depthGradient = getDepthGradient(texelCoord, normalDepth.w);
+    float sumWeights = 0.f;
+    vec2 sumMoments = vec2(0.f);
+    for(int dy=-VARIANCE_RADIUS; dy<=VARIANCE_RADIUS; dy++){
+        for(int dx=-VARIANCE_RADIUS; dx<=VARIANCE_RADIUS; dx++){
+            ivec2 neighbour = texelCoord + ivec2(dx, dy);
+            if(!isInImage(neighbour)){
+                continue;
+            }
+            float weight = getGeometryWeight(normalDepth, imageLoad(uNormalDepthGuide, neighbour), depthGradient, vec2(dx, dy));
+            float luminance = getLuminance(getIllumination(neighbour));
+            sumWeights += weight;
+            sumMoments += weight * vec2(luminance, luminance * luminance);
+        }
+    }
+    vec2 moments = sumMoments / sumWeights;
+    imageStore(oIllumination, texelCoord, vec4(illumination, max(moments.y - moments.x * moments.x, 0.f)));
+}
\ No newline at end of file
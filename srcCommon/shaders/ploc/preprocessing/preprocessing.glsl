@@ -8,10 +8,12 @@ uniform vec3 uCircumscribedCubeMax;
 uniform uint uNbTriangles;
 
 struct Triangle {
-    vec4 _P0;
-    vec4 _P2;
-    vec4 _P1;
-    uint _ModelId;
+    uint _Indices[3];
+    uint _MeshId;
+};
+
+layout (binding = 1, std430) readonly buffer uVerticesSSBO {
+    float uVertices[];
 };
 
 layout (binding = 3, std430) readonly buffer uTrianglesSSBO {
@@ -6,9 +6,18 @@ const uint NB_DIGIT = 4; // d = 4
 const uint NB_DIGIT_PLACE = 8; // p = sup(k/d)
 const uint NB_ITEMS_PER_THREAD = 8;
 
+// status of a partition in the look back, the count is stored in the low bits
+const uint FLAG_NOT_READY = 0u;
+const uint FLAG_AGGREGATE = 1u << 30;
+const uint FLAG_INCLUSIVE = 2u << 30;
+const uint FLAG_MASK = 3u << 30;
+const uint VALUE_MASK = ~FLAG_MASK;
+
 // inputs
 const uint LOCAL_SIZE_X = 16;
 const uint LOCAL_SIZE_Y = 16;
+const uint NB_THREADS = LOCAL_SIZE_X * LOCAL_SIZE_Y;
+const uint PARTITION_SIZE = NB_THREADS * NB_ITEMS_PER_THREAD;
 layout(local_size_x = LOCAL_SIZE_X, local_size_y = LOCAL_SIZE_Y) in;
 
 layout (binding = 2, std430) readonly buffer uValuesToSortSSBO {
@@ -16,18 +25,142 @@ layout (binding = 2, std430) readonly buffer uValuesToSortSSBO {
 };
 
 uniform uint uNbValuesToSort;
+// one bit is sorted per pass, the counts of the global histogram are the ones of each bit
+uniform uint uBitPosition;
+// sort every partition on its own instead of the whole array
+uniform bool uIsPartitionLocal;
+
+layout (binding = 3, std430) readonly buffer uGlobalHistogramSSBO {
+    uint uGlobalHistogram[];
+};
+
+layout (binding = 4, std430) readonly buffer uPayloadsSSBO {
+    uint uPayloads[];
+};
 
 
 // outputs
-layout (binding = 3, std430) buffer uGlobalHistogramSSBO {
-    uint uGlobalHistogram[];
+layout (binding = 5, std430) writeonly buffer uSortedValuesSSBO {
+    uint uSortedValues[];
+};
+
+layout (binding = 6, std430) writeonly buffer uSortedPayloadsSSBO {
+    uint uSortedPayloads[];
+};
+
+// cleared before each pass
+layout (binding = 7, std430) coherent buffer uPartitionsSSBO {
+    uint uPartitionCounter;
+    uint uPartitionStatus[];
 };
 
 
 // shared items
-shared uint sHistogramTile[NB_DIGIT*NB_DIGIT_PLACE];
+shared uint sPartitionIndex;
+shared uint sThreadZeros[NB_THREADS];
+shared uint sPrefixZeros;
 
 // functions
+uint isOne(uint value){
+    return (value >> uBitPosition) & 1u;
+}
+
+uint lookBack(uint partitionIndex, uint partitionZeros){
+    // decoupled look back
+    // cf Merrill and Garland, "Single-pass Parallel Prefix Scan with Decoupled Look-back", 2016
+    if(partitionIndex == 0){
+        atomicExchange(uPartitionStatus[0], FLAG_INCLUSIVE | partitionZeros);
+        return 0;
+    }
+    atomicExchange(uPartitionStatus[partitionIndex], FLAG_AGGREGATE | partitionZeros);
+
+    uint prefix = 0;
+    int lookBackIndex = int(partitionIndex) - 1;
+    while(lookBackIndex >= 0){
+        uint status = atomicOr(uPartitionStatus[lookBackIndex], 0u);
+        uint flag = status & FLAG_MASK;
+        if(flag == FLAG_NOT_READY){
+            continue;
+        }
+        prefix += status & VALUE_MASK;
+        if(flag == FLAG_INCLUSIVE){
+            break;
+        }
+        lookBackIndex--;
+    }
+    atomicExchange(uPartitionStatus[partitionIndex], FLAG_INCLUSIVE | (prefix + partitionZeros));
+    return prefix;
+}
+
 void main(){
-    
+    // partitions are numbered in launch order so that the look back
+    // only ever waits for work groups that already started
+    if(gl_LocalInvocationIndex == 0){
+        sPartitionIndex = atomicAdd(uPartitionCounter, 1);
+    }
+    barrier();
+    memoryBarrierShared();
+
+    uint partitionIndex = sPartitionIndex;
+    uint partitionStart = partitionIndex * PARTITION_SIZE;
+    uint threadOffset = gl_LocalInvocationIndex * NB_ITEMS_PER_THREAD;
+    uint threadStart = partitionStart + threadOffset;
+
+    // each thread owns consecutive values to keep the sort stable
+    uint values[NB_ITEMS_PER_THREAD];
+    uint nbZeros = 0;
+    for(uint i=0; i<NB_ITEMS_PER_THREAD; i++){
+        uint index = threadStart + i;
+        values[i] = index < uNbValuesToSort ? uValuesToSort[index] : 0;
+        if(index < uNbValuesToSort && isOne(values[i]) == 0){
+            nbZeros++;
+        }
+    }
+
+    // inclusive scan of the zeros in the partition
+    sThreadZeros[gl_LocalInvocationIndex] = nbZeros;
+    barrier();
+    memoryBarrierShared();
+    for(uint offset=1; offset<NB_THREADS; offset<<=1){
+        uint previous = gl_LocalInvocationIndex >= offset ? sThreadZeros[gl_LocalInvocationIndex - offset] : 0;
+        barrier();
+        memoryBarrierShared();
+        sThreadZeros[gl_LocalInvocationIndex] += previous;
+        barrier();
+        memoryBarrierShared();
+    }
+    uint partitionZeros = sThreadZeros[NB_THREADS - 1];
+
+    // zeros of the previous partitions
+    if(gl_LocalInvocationIndex == 0){
+        sPrefixZeros = uIsPartitionLocal ? 0 : lookBack(partitionIndex, partitionZeros);
+    }
+    barrier();
+    memoryBarrierShared();
+
+    uint zerosStart = partitionStart;
+    uint onesStart = partitionStart + partitionZeros;
+    if(!uIsPartitionLocal){
+        uint totalZeros = uNbValuesToSort - uGlobalHistogram[uBitPosition];
+        zerosStart = sPrefixZeros;
+        onesStart = totalZeros + (partitionStart - sPrefixZeros);
+    }
+
+    // scatter
+    uint zeroRank = sThreadZeros[gl_LocalInvocationIndex] - nbZeros;
+    uint oneRank = threadOffset - zeroRank;
+    for(uint i=0; i<NB_ITEMS_PER_THREAD; i++){
+        uint index = threadStart + i;
+        if(index >= uNbValuesToSort){break;}
+        uint destination = 0;
+        if(isOne(values[i]) == 0){
+            destination = zerosStart + zeroRank;
+            zeroRank++;
+        } else {
+            destination = onesStart + oneRank;
+            oneRank++;
+        }
+        uSortedValues[destination] = values[i];
+        uSortedPayloads[destination] = uPayloads[index];
+    }
 }
\ No newline at end of file
@@ -29,6 +29,13 @@ shared uint sHistogramTile[NB_DIGIT*NB_DIGIT_PLACE];
 
 // functions
 void main(){
+    // shared memory is not initialized
+    if(gl_LocalInvocationIndex < NB_DIGIT*NB_DIGIT_PLACE){
+        sHistogramTile[gl_LocalInvocationIndex] = 0;
+    }
+    barrier();
+    memoryBarrierShared();
+
     uint instanceIndex = gl_GlobalInvocationID.x * NB_ITEMS_PER_THREAD 
         + gl_GlobalInvocationID.y * (gl_NumWorkGroups.x * gl_WorkGroupSize.x * NB_ITEMS_PER_THREAD);
 
@@ -1,11 +1,36 @@
 #version 460 core
 
+#include "common/accumulation.glsl"
+
 layout(location = 0) in vec2 iTexCoord;
 
 layout(location = 0) out vec4 oColor;
 
 layout(binding = 0) uniform sampler2D uRaytracedTexture;
 
+// the number of samples of each pixel is shown instead, cf glr::AccumulationBuffer
+uniform bool uIsHeatMapDisplayed;
+uniform uint uMaxNbSamples;
+
+// from blue for the fewest samples to red for the most, mirrors cr::AdaptiveSampling
+vec3 getHeatMapColor(float t){
+    t = clamp(t, 0.f, 1.f);
+    return clamp(vec3(
+        1.5f - abs(4.f * t - 3.f),
+        1.5f - abs(4.f * t - 2.f),
+        1.5f - abs(4.f * t - 1.f)
+    ), 0.f, 1.f);
+}
+
 void main(){
+    if(uIsHeatMapDisplayed){
+        ivec2 size = imageSize(uSampleCounts);
+        ivec2 texelCoord = min(ivec2(iTexCoord * vec2(size)), size - 1);
+        uint nbSamples = imageLoad(uSampleCounts, texelCoord).x & SAMPLE_COUNT_MASK;
+        // logarithmic scale
+        float t = log2(float(max(nbSamples, 1u))) / log2(float(max(uMaxNbSamples, 2u)));
+        oColor = vec4(getHeatMapColor(t), 1.f);
+        return;
+    }
     oColor = vec4(texture(uRaytracedTexture, iTexCoord).rgb, 1.f);
 }
\ No newline at end of file
@@ -1,55 +1,11 @@
 #version 460 core
 
-// structures
-struct Camera {
-    mat4 _View;
-    mat4 _Proj;
-    mat4 _InvView;
-    mat4 _InvProj;
-    vec4 _Eye;
-    float _PlaneWidth;
-    float _PlaneHeight;
-    float _PlaneNear;
-};
-
-struct Ray {
-    vec4 _Origin;
-    vec4 _Direction;
-};
-
-struct Triangle {
-    vec4 _P0;
-    vec4 _P2;
-    vec4 _P1;
-    uint _ModelId;
-};
-
-struct Material {
-    vec4 _Color;
-};
-
-struct Model {
-    mat4 _ModelMatrix;
-    uint _MaterialId;
-};
-
-struct Hit {
-    vec4 _Coords; // (b0, b1, b2, t)
-    uint _DidHit;
-    uint _TriangleId;
-};
-
-struct AABB {
-    vec3 _Min;
-    vec3 _Max;
-};
-
-struct BVH_Node {
-    AABB _BoundingBox;
-    uint _TriangleId;
-    uint _LeftChild;
-    uint _RightChild;
-};
+#include "common/accumulation.glsl"
+#include "common/bvhOverlay.glsl"
+#include "common/camera.glsl"
+#include "common/denoising.glsl"
+#include "common/scene.glsl"
+#include "common/visibility.glsl"
 
 // output
 layout(rgba32f, binding = 0) uniform image2D oImage;
@@ -57,100 +13,18 @@ layout(rgba32f, binding = 0) uniform image2D oImage;
 // input
 layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
 
-uniform float uTime;
-uniform Camera uCamera;
-uniform uint uNbMaterials;
-uniform uint uNbTriangles;
-uniform uint uNbModels;
-uniform int uDepthDisplayBVH;
-uniform bool uIsBVHDisplayed;
-uniform bool uIsWireframeModeOn; 
-
-const vec4 BVH_AABB_COLOR = vec4(0.5f, 0.f, 0.5f, 0.1f);
-const vec4 BVH_AABB_LINE_COLOR = vec4(0.7f, 0.f, 0.7f, 0.1f);
 const float WIREFRAME_LINE_WIDTH = 0.02f;
-const float BVH_LINE_WIDTH = 0.05f;
-
-layout (binding = 2, std430) readonly buffer uMaterialsSSBO {
-    Material uMaterials[];
-};
-
-layout (binding = 3, std430) readonly buffer uTrianglesSSBO {
-    Triangle uTriangles[];
-};
-
-layout (binding = 4, std430) readonly buffer uModelsSSBO {
-    Model uModels[];
-};
-
-layout (binding = 5, std430) readonly buffer uBVH_SSBO {
-    BVH_Node uBVH_Nodes[];
-};
-
 
 // code
-Ray getRay(vec2 pos){ // pos between 0 and 1
-    Ray ray;
-    ray._Origin = uCamera._Eye;
-    vec3 posViewSpace =  vec3(pos - 0.5f, 1.f) * vec3(uCamera._PlaneWidth, uCamera._PlaneHeight, uCamera._PlaneNear);
-    vec4 posWorldSpace = uCamera._InvView * vec4(posViewSpace, 1.f);
-    ray._Direction = normalize(posWorldSpace - ray._Origin);
-    ray._Direction.w = 0.;
-    return ray;
-}
-
-Hit rayTriangleIntersection(Ray ray, uint triangleIndex){
-    Hit hit;
-
-    Triangle triangle = uTriangles[triangleIndex];
-
-    vec3 p0 = (uModels[triangle._ModelId]._ModelMatrix * triangle._P0).xyz;
-    vec3 p1 = (uModels[triangle._ModelId]._ModelMatrix * triangle._P1).xyz;
-    vec3 p2 = (uModels[triangle._ModelId]._ModelMatrix * triangle._P2).xyz;
-
-    vec3 triEdge0 = p1 - p0;
-    vec3 triEdge1 = p2 - p0;
-    vec3 triNormale = normalize(cross(triEdge1, triEdge0));
-
-    vec3 q = cross(ray._Direction.xyz, triEdge1);
-    float a = dot(triEdge0, q);
-    float epsilon = 1e-4;
-
-    if(dot(triNormale, ray._Direction.xyz) >= 0 || abs(a) < epsilon){
-        hit._DidHit = 0;
-        return hit;
-    }
-
-    vec4 s = (ray._Origin - vec4(p0, 1.f)) / a;
-    vec3 r = cross(s.xyz, triEdge0);
-
-    hit._Coords.x = dot(s.xyz, q);
-    hit._Coords.y = dot(r, ray._Direction.xyz);
-    hit._Coords.z = 1 - hit._Coords.x - hit._Coords.y;
-
-    if(hit._Coords.x < 0 || hit._Coords.y < 0 || hit._Coords.z < 0){
-        hit._DidHit = 0;
-        return hit;
-    }
-    
-    float t = dot(triEdge1, r);
-    if(t < 0){
-        hit._DidHit = 0;
-        return hit;
-    }
-
-    hit._DidHit = 1;
-    hit._Coords.w = t;
-    hit._TriangleId = triangleIndex;
-
-    return hit;
-}
-
-void getAllHits(Ray ray, uint nbTriangles, inout Hit closestHit){
-    for(uint i=0; i<nbTriangles; i++){
-        Hit curHit = rayTriangleIntersection(ray, i);
-        if(curHit._DidHit == 0) continue;
-        if(closestHit._DidHit == 0 || curHit._Coords.w < closestHit._Coords.w){
+void getAllHits(RaySetup ray, uint nbInstances, inout Hit closestHit){
+    for(uint instanceIndex=0; instanceIndex<nbInstances; instanceIndex++){
+        RaySetup modelRay = getInstanceRay(ray, instanceIndex);
+        Model model = uModels[instanceIndex];
+        for(uint i=model._FirstTriangle; i<model._FirstTriangle+model._NbTriangles; i++){
+            float tMax = closestHit._DidHit == 0 ? INFINITY : closestHit._Coords.w;
+            Hit curHit = rayTriangleIntersection(modelRay, i, tMax);
+            if(curHit._DidHit == 0) continue;
+            curHit._InstanceId = instanceIndex;
             closestHit = curHit;
         }
     }
@@ -163,8 +37,7 @@ void getColor(Hit hit, vec4 bvhColor, inout vec4 color){
     }
 
     if(hit._DidHit == 0) return;
-    Triangle hitTriangle = uTriangles[hit._TriangleId];
-    color += uMaterials[uModels[hitTriangle._ModelId]._MaterialId]._Color;
+    color += getInstanceMaterial(hit._InstanceId)._Color;
 
     // wireframe color
     if(uIsWireframeModeOn){
@@ -179,73 +52,12 @@ void getColor(Hit hit, vec4 bvhColor, inout vec4 color){
 }
 
 
-uint intersectBVH(Ray ray, BVH_Node node){
-    float tMin = 0.f;
-    float tMax = -1.f;
-
-    // Check intersection with X-slabs
-    float inverseRayDirX = 1.0f / ray._Direction.x;
-    float tx1 = (node._BoundingBox._Min.x - ray._Origin.x) * inverseRayDirX;
-    float tx2 = (node._BoundingBox._Max.x - ray._Origin.x) * inverseRayDirX;
-
-    tMin = min(tx1, tx2);
-    tMax = max(tx1, tx2);
-
-    // Check for early exit
-    if(tMax < 0.f || tMin > tMax) {
-        return 0;
-    }
-
-    // Check intersection with Y-slabs
-    float inverseRayDirY = 1.0f / ray._Direction.y;
-    float ty1 = (node._BoundingBox._Min.y - ray._Origin.y) * inverseRayDirY;
-    float ty2 = (node._BoundingBox._Max.y - ray._Origin.y) * inverseRayDirY;
-
-    tMin = max(tMin, min(ty1, ty2));
-    tMax = min(tMax, max(ty1, ty2));
-
-    // Check for early exit
-    if(tMax < 0.f || tMin > tMax) {
-        return 0;
-    }
-
-    // Check intersection with Z-slabs
-    float inverseRayDirZ = 1.0f / ray._Direction.z;
-    float tz1 = (node._BoundingBox._Min.z - ray._Origin.z) * inverseRayDirZ;
-    float tz2 = (node._BoundingBox._Max.z - ray._Origin.z) * inverseRayDirZ;
-
-    tMin = max(tMin, min(tz1, tz2));
-    tMax = min(tMax, max(tz1, tz2));
-
-    // Check for intersection
-    if(tMax >= 0.f && tMin <= tMax){
-        // check if border
-        float threshold = BVH_LINE_WIDTH / (uDepthDisplayBVH + 1.f);
-        vec3 enterPoint = ray._Origin.xyz + ray._Direction.xyz * tMin;
-        bool closeToX = (abs(enterPoint.x - node._BoundingBox._Min.x) < threshold) 
-            || (abs(enterPoint.x - node._BoundingBox._Max.x) < threshold);
-        bool closeToY = (abs(enterPoint.y - node._BoundingBox._Min.y) < threshold) 
-            || (abs(enterPoint.y - node._BoundingBox._Max.y) < threshold);
-        bool closeToZ = (abs(enterPoint.z - node._BoundingBox._Min.z) < threshold) 
-            || (abs(enterPoint.z - node._BoundingBox._Max.z) < threshold);
-        if((closeToX && closeToY) || (closeToX && closeToZ) || (closeToY && closeToZ)){
-            return 2;
-        }
-        return 1;
-    }
-    return 0;
-}
-
-uint isLeafBVH(BVH_Node node){
-    return 
-        node._LeftChild == 0
-        && node._RightChild == 0
-        ? 1 : 0;
-}
-
-Hit getClosestHitBVH(Ray ray, uint rootBvh, inout vec4 bvhColor){
+Hit getClosestHitBVH(RaySetup worldRay, uint rootBvh, inout vec4 bvhColor){
     Hit closestHit;
     closestHit._DidHit = 0;
+    // the depth goes on in the bvh of the instances
+    RaySetup ray = worldRay;
+    uint instanceIndex = BVH_OVERLAY_NO_INSTANCE;
 
     // Create a stack for the node indices
     const uint STACK_SIZE = 1024;
@@ -261,22 +73,36 @@ Hit getClosestHitBVH(Ray ray, uint rootBvh, inout vec4 bvhColor){
         // Pop the current node
         stackIndex--;
         uint currentNodeIndex = stack[stackIndex];
+        if(currentNodeIndex == BVH_OVERLAY_INSTANCE_EXIT){
+            ray = worldRay;
+            instanceIndex = BVH_OVERLAY_NO_INSTANCE;
+            continue;
+        }
         uint currentDepth = depthStack[stackIndex];
         BVH_Node curNode = uBVH_Nodes[currentNodeIndex];
+        // nodes behind the closest hit are skipped unless the whole bvh is displayed
+        float tMax = (uIsBVHDisplayed || closestHit._DidHit == 0) ? INFINITY : closestHit._Coords.w;
         // Check if the ray intersects the current BVH node's bounding box
-        uint intersectionBVH = intersectBVH(ray, curNode);
+        uint intersectionBVH = intersectBVH(ray, curNode, tMax);
         if(intersectionBVH != 0) {
             if(currentDepth == uDepthDisplayBVH){
-                if(intersectionBVH == 2){
-                    bvhColor = BVH_AABB_LINE_COLOR;
-                } else {
-                    bvhColor = BVH_AABB_COLOR;
-                }
+                bvhColor = getBVHColor(intersectionBVH);
             }
             // Check if the current node is a leaf
-            if(isLeafBVH(curNode) == 1) {
-                Hit hit = rayTriangleIntersection(ray, curNode._TriangleId);
-                if(closestHit._DidHit == 0 || hit._Coords.w < closestHit._Coords.w){
+            if(isLeafBVH(curNode) == 1 && instanceIndex == BVH_OVERLAY_NO_INSTANCE) {
+                // Go down in the bvh of the instance in model space
+                instanceIndex = curNode._TriangleId;
+                ray = getInstanceRay(worldRay, instanceIndex);
+                stack[stackIndex] = BVH_OVERLAY_INSTANCE_EXIT;
+                stackIndex++;
+                stack[stackIndex] = uModels[instanceIndex]._BVH_Root;
+                depthStack[stackIndex] = currentDepth+1;
+                stackIndex++;
+            } else if(isLeafBVH(curNode) == 1) {
+                float tMaxTriangle = closestHit._DidHit == 0 ? INFINITY : closestHit._Coords.w;
+                Hit hit = rayTriangleIntersection(ray, curNode._TriangleId, tMaxTriangle);
+                if(hit._DidHit == 1){
+                    hit._InstanceId = instanceIndex;
                     closestHit = hit;
                 }
             } else {
@@ -294,29 +120,56 @@ Hit getClosestHitBVH(Ray ray, uint rootBvh, inout vec4 bvhColor){
     return closestHit;
 }
 
+void storePrimaryGuides(ivec2 texelCoord, Ray primaryRay, Hit hit){
+    if(hit._DidHit == 0){
+        storeMissGuides(texelCoord);
+        return;
+    }
+    // geometric normal facing the ray
+    vec3 p0, p1, p2;
+    getTriangleVertices(hit._InstanceId, hit._TriangleId, p0, p1, p2);
+    vec3 normal = normalize(cross(p1 - p0, p2 - p0));
+    if(dot(normal, primaryRay._Direction.xyz) > 0.f){
+        normal = -normal;
+    }
+    storeGuides(texelCoord, normal, hit._Coords.w, getInstanceMaterial(hit._InstanceId)._Color.rgb);
+}
+
 
 // main
 void main() {
     vec4 value = vec4(0.f, 0.f, 0.f, 1.f);
     ivec2 texelCoord = ivec2(gl_GlobalInvocationID.xy);
+    // the image already holds the mean of a converged pixel
+    if(isPixelConverged(texelCoord)){
+        return;
+    }
 
-    vec2 pixelPos = vec2(0.f);
-    pixelPos.x = float(texelCoord.x) / (gl_NumWorkGroups.x * gl_WorkGroupSize.x);
-    pixelPos.y = float(texelCoord.y) / (gl_NumWorkGroups.y * gl_WorkGroupSize.y);
-
-    Ray ray = getRay(pixelPos);
+    vec2 imageSize = vec2(gl_NumWorkGroups.xy * gl_WorkGroupSize.xy);
+    Ray primaryRay = getPixelRay(texelCoord, imageSize);
+    RaySetup ray = setupRay(primaryRay);
 
     // // no bvh
     // Hit closestHit;
     // closestHit._DidHit = 0;
-    // getAllHits(ray, uNbTriangles, closestHit);
+    // getAllHits(ray, uNbModels, closestHit);
 
     // bvh
     uint rootBvh = 0;
     vec4 bvhColor = vec4(0.f, 0.f, 0.f, 0.f);
-    Hit closestHit = getClosestHitBVH(ray, rootBvh, bvhColor);
+    Hit closestHit;
+    if(uIsPrimaryRasterized){
+        // the boxes are only traversed for the debug display
+        closestHit = getVisibleHit(texelCoord, primaryRay);
+        if(uIsBVHDisplayed){
+            bvhColor = getBVHOverlayColor(ray, rootBvh);
+        }
+    } else {
+        closestHit = getClosestHitBVH(ray, rootBvh, bvhColor);
+    }
 
     getColor(closestHit, bvhColor, value);
+    storePrimaryGuides(texelCoord, primaryRay, closestHit);
 
     // BVH_Node root = uBVH_Nodes[rootBvh];
     // uint nbClusters = 2*uNbTriangles-1;
@@ -0,0 +1,19 @@
+#version 460 core
+
+// input
+layout(location = 0) in vec2 iBarycentrics;
+layout(location = 1) flat in uint iTriangle;
+layout(location = 2) flat in uint iInstance;
+
+// output
+layout(location = 0) out uvec4 oVisibility;
+
+void main() {
+    // the triangles are shared by the instances, gl_PrimitiveID can't tell them apart
+    oVisibility = uvec4(
+        iTriangle + 1, 
+        floatBitsToUint(iBarycentrics.x), 
+        floatBitsToUint(iBarycentrics.y), 
+        iInstance
+    );
+}
\ No newline at end of file
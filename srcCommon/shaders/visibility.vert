@@ -0,0 +1,29 @@
+#version 460 core
+
+#include "common/camera.glsl"
+#include "common/scene.glsl"
+
+// input
+// the vertices are pulled from the triangles buffer, three per triangle
+// each instance is drawn on its own with its index as base instance
+uniform uvec2 uImageSize;
+
+// output
+layout(location = 0) out vec2 oBarycentrics;
+layout(location = 1) flat out uint oTriangle;
+layout(location = 2) flat out uint oInstance;
+
+void main() {
+    uint instanceIndex = uint(gl_BaseInstance + gl_InstanceID);
+    uint triangleIndex = uint(gl_VertexID) / 3;
+    uint corner = uint(gl_VertexID) % 3;
+    vec3 p0, p1, p2;
+    getTriangleVertices(instanceIndex, triangleIndex, p0, p1, p2);
+    vec3 position = corner == 0 ? p0 : (corner == 1 ? p1 : p2);
+
+    // barycentrics of p1 and p2, the interpolation is perspective correct
+    oBarycentrics = vec2(corner == 1 ? 1.f : 0.f, corner == 2 ? 1.f : 0.f);
+    oTriangle = triangleIndex;
+    oInstance = instanceIndex;
+    gl_Position = getClipPosition(position, vec2(uImageSize));
+}
\ No newline at end of file
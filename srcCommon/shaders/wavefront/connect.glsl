@@ -0,0 +1,31 @@
+#version 460 core
+
+#include "common/traversal.glsl"
+#include "wavefront/wavefront.glsl"
+
+// output
+layout(rgba32f, binding = 0) uniform image2D oImage;
+
+// input
+layout(local_size_x = WAVEFRONT_GROUP_SIZE) in;
+
+// main
+void main(){
+    uint index = gl_GlobalInvocationID.x;
+    if(index >= uShadowCount){
+        return;
+    }
+    ShadowRay shadowRay = uShadowQueue[index];
+    Ray ray;
+    ray._Origin = vec4(shadowRay._Origin.xyz, 1.f);
+    ray._Direction = shadowRay._Direction;
+    // the origin is already offset from the surface
+    if(traceAnyHit(setupRay(ray), 0.f, shadowRay._Origin.w)){
+        return;
+    }
+
+    // a pixel has at most one shadow ray per bounce so there is no race
+    ivec2 texelCoord = getTexelCoord(shadowRay._PixelIndex);
+    vec4 color = imageLoad(oImage, texelCoord);
+    imageStore(oImage, texelCoord, vec4(color.rgb + shadowRay._Contribution.rgb, 1.f));
+}
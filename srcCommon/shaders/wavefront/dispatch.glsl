@@ -0,0 +1,35 @@
+#version 460 core
+
+#include "wavefront/wavefront.glsl"
+
+// input
+layout(local_size_x = 1) in;
+
+uniform uint uStage;
+
+// code
+uint getNbGroups(uint nbItems){
+    return (nbItems + WAVEFRONT_GROUP_SIZE - 1) / WAVEFRONT_GROUP_SIZE;
+}
+
+// main
+void main(){
+    switch(uStage){
+        case STAGE_SHADING:
+            uShadingDispatch[0] = getNbGroups(uExtensionCount);
+            uShadingDispatch[1] = 1;
+            uShadingDispatch[2] = 1;
+            break;
+        case STAGE_CONNECT:
+            uConnectDispatch[0] = getNbGroups(uShadowCount);
+            uConnectDispatch[1] = 1;
+            uConnectDispatch[2] = 1;
+            break;
+        case STAGE_NEXT_BOUNCE:
+            uExtensionCount = uNextExtensionCount;
+            uNextExtensionCount = 0;
+            uShadowCount = 0;
+            uExtensionHead = 0;
+            break;
+    }
+}
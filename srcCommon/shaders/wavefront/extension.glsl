@@ -0,0 +1,25 @@
+#version 460 core
+
+#include "common/traversal.glsl"
+#include "wavefront/wavefront.glsl"
+
+// input
+layout(local_size_x = WAVEFRONT_GROUP_SIZE) in;
+
+// main
+void main(){
+    // persistent threads: only enough groups to fill the GPU are launched
+    // and each thread keeps pulling rays from the global queue
+    // cf Aila and Laine, "Understanding the Efficiency of Ray Traversal on GPUs", HPG 2009
+    while(true){
+        uint index = atomicAdd(uExtensionHead, 1);
+        if(index >= uExtensionCount){
+            return;
+        }
+        QueuedRay queuedRay = uRayQueue[index];
+        Ray ray;
+        ray._Origin = queuedRay._Origin;
+        ray._Direction = queuedRay._Direction;
+        uHits[index] = traceClosest(setupRay(ray), INFINITY);
+    }
+}
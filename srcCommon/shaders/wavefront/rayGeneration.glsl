@@ -0,0 +1,56 @@
+#version 460 core
+
+#include "common/accumulation.glsl"
+#include "common/camera.glsl"
+#include "common/visibility.glsl"
+#include "wavefront/wavefront.glsl"
+
+// output
+layout(rgba32f, binding = 0) uniform image2D oImage;
+
+// input
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+// rays of the work group, they are added to the queue together
+shared uint sNbGroupRays;
+shared uint sGroupOffset;
+
+// main
+void main(){
+    if(gl_LocalInvocationIndex == 0){
+        sNbGroupRays = 0;
+    }
+    barrier();
+
+    // the converged pixels get no ray, the image already holds their mean
+    uvec2 pixel = gl_GlobalInvocationID.xy;
+    bool isTraced = pixel.x < uImageSize.x && pixel.y < uImageSize.y && !isPixelConverged(ivec2(pixel));
+    uint groupIndex = isTraced ? atomicAdd(sNbGroupRays, 1) : 0;
+    barrier();
+
+    // the rays of a group stay next to each other in the queue
+    if(gl_LocalInvocationIndex == 0){
+        sGroupOffset = atomicAdd(uExtensionCount, sNbGroupRays);
+    }
+    barrier();
+    if(!isTraced){
+        return;
+    }
+    uint queueIndex = sGroupOffset + groupIndex;
+
+    Ray ray = getPixelRay(ivec2(pixel), vec2(uImageSize));
+    QueuedRay queuedRay;
+    queuedRay._Origin = ray._Origin;
+    queuedRay._Direction = ray._Direction;
+    queuedRay._Throughput = vec4(1.f);
+    queuedRay._PixelIndex = pixel.y * uImageSize.x + pixel.x;
+    queuedRay._Depth = 0;
+    uRayQueue[queueIndex] = queuedRay;
+
+    // the extension of the primary rays is skipped, cf glr::VisibilityBuffer
+    if(uIsPrimaryRasterized){
+        uHits[queueIndex] = getVisibleHit(ivec2(pixel), ray);
+    }
+
+    imageStore(oImage, ivec2(pixel), vec4(0.f, 0.f, 0.f, 1.f));
+}
\ No newline at end of file
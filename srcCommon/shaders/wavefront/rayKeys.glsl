@@ -0,0 +1,61 @@
+#version 460 core
+
+#include "common/scene.glsl"
+#include "wavefront/wavefront.glsl"
+
+// constants
+// cells per axis of the scene bounds are 2^CELL_BITS
+const uint CELL_BITS = 3;
+const uint OCTANT_SHIFT = 3 * CELL_BITS;
+// empty slots of the queue sort after every ray
+const uint INVALID_KEY = 1u << (OCTANT_SHIFT + 3);
+
+// input
+layout(local_size_x = WAVEFRONT_GROUP_SIZE) in;
+
+uniform uint uQueueCapacity;
+
+// output
+layout (binding = 11, std430) writeonly buffer uRayKeysSSBO {
+    uint uRayKeys[];
+};
+
+layout (binding = 12, std430) writeonly buffer uRayIndicesSSBO {
+    uint uRayIndices[];
+};
+
+// code
+uint interleaveBits(uvec3 cell){
+    uint morton = 0;
+    for(uint i=0; i<CELL_BITS; i++){
+        morton |= ((cell.x >> i) & 1u) << (3*i);
+        morton |= ((cell.y >> i) & 1u) << (3*i + 1);
+        morton |= ((cell.z >> i) & 1u) << (3*i + 2);
+    }
+    return morton;
+}
+
+uint getRayKey(QueuedRay ray){
+    // the direction octant dominates, rays of one octant are then ordered along a Morton curve
+    uint octant = (ray._Direction.x < 0.f ? 1u : 0u)
+        | (ray._Direction.y < 0.f ? 2u : 0u)
+        | (ray._Direction.z < 0.f ? 4u : 0u);
+
+    AABB bounds = uBVH_Nodes[0]._BoundingBox;
+    vec3 extent = max(bounds._Max - bounds._Min, vec3(1e-6f));
+    vec3 relative = clamp((ray._Origin.xyz - bounds._Min) / extent, 0.f, 1.f);
+    uint nbCells = 1u << CELL_BITS;
+    uvec3 cell = min(uvec3(relative * float(nbCells)), uvec3(nbCells - 1));
+
+    return (octant << OCTANT_SHIFT) | interleaveBits(cell);
+}
+
+// main
+void main(){
+    uint index = gl_GlobalInvocationID.x;
+    if(index >= uQueueCapacity){
+        return;
+    }
+    uRayKeys[index] = index < uExtensionCount ? getRayKey(uRayQueue[index]) : INVALID_KEY;
+    uRayIndices[index] = index;
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 460 core
+
+#include "wavefront/wavefront.glsl"
+
+// input
+layout(local_size_x = WAVEFRONT_GROUP_SIZE) in;
+
+// sorted by the radix sort
+layout (binding = 12, std430) readonly buffer uRayIndicesSSBO {
+    uint uRayIndices[];
+};
+
+// main
+void main(){
+    // the sorted rays are written to the other queue which becomes the current one
+    uint index = gl_GlobalInvocationID.x;
+    if(index >= uExtensionCount){
+        return;
+    }
+    uNextRayQueue[index] = uRayQueue[uRayIndices[index]];
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#version 460 core
+
+#include "common/denoising.glsl"
+#include "common/frame.glsl"
+#include "common/sampling.glsl"
+#include "common/scene.glsl"
+#include "wavefront/wavefront.glsl"
+
+// output
+layout(rgba32f, binding = 0) uniform image2D oImage;
+
+// input
+layout(local_size_x = WAVEFRONT_GROUP_SIZE) in;
+
+uniform uint uMaxDepth;
+
+// the scene has no lights yet, the wavefront paths are lit by a fixed sky and sun
+const vec3 SKY_COLOR = vec3(0.2f, 0.3f, 0.3f);
+const vec3 SUN_DIRECTION = normalize(vec3(0.3f, 1.f, -0.5f));
+const vec3 SUN_COLOR = vec3(1.f, 0.95f, 0.9f);
+const float RAY_OFFSET = 1e-4f;
+const float PI = 3.14159265f;
+
+// code
+void addRadiance(uint pixelIndex, vec3 radiance){
+    // a pixel has at most one ray in a queue so there is no race
+    ivec2 texelCoord = getTexelCoord(pixelIndex);
+    vec4 color = imageLoad(oImage, texelCoord);
+    imageStore(oImage, texelCoord, vec4(color.rgb + radiance, 1.f));
+}
+
+vec3 sampleCosineHemisphere(vec3 normal, vec2 u){
+    float r = sqrt(u.x);
+    float phi = 2.f * PI * u.y;
+    vec3 tangent = normalize(abs(normal.x) > 0.5f ? cross(normal, vec3(0.f, 1.f, 0.f)) : cross(normal, vec3(1.f, 0.f, 0.f)));
+    vec3 bitangent = cross(normal, tangent);
+    return normalize(r * cos(phi) * tangent + r * sin(phi) * bitangent + sqrt(max(0.f, 1.f - r * r)) * normal);
+}
+
+// main
+void main(){
+    uint index = gl_GlobalInvocationID.x;
+    if(index >= uExtensionCount){
+        return;
+    }
+    QueuedRay queuedRay = uRayQueue[index];
+    Hit hit = uHits[index];
+    vec3 throughput = queuedRay._Throughput.rgb;
+
+    bool isPrimary = queuedRay._Depth == 0;
+    if(hit._DidHit == 0){
+        if(isPrimary){
+            storeMissGuides(getTexelCoord(queuedRay._PixelIndex));
+        }
+        addRadiance(queuedRay._PixelIndex, throughput * SKY_COLOR);
+        return;
+    }
+
+    // geometric normal facing the ray
+    vec3 p0, p1, p2;
+    getTriangleVertices(hit._InstanceId, hit._TriangleId, p0, p1, p2);
+    vec3 normal = normalize(cross(p1 - p0, p2 - p0));
+    if(dot(normal, queuedRay._Direction.xyz) > 0.f){
+        normal = -normal;
+    }
+    vec3 albedo = getInstanceMaterial(hit._InstanceId)._Color.rgb;
+    if(isPrimary){
+        storeGuides(getTexelCoord(queuedRay._PixelIndex), normal, hit._Coords.w, albedo);
+    }
+    vec3 position = queuedRay._Origin.xyz + queuedRay._Direction.xyz * hit._Coords.w;
+    // offset scaled with the magnitude of the position
+    vec3 origin = position + normal * RAY_OFFSET * max(1.f, max(abs(position.x), max(abs(position.y), abs(position.z))));
+
+    // direct lighting, resolved by the connect kernel
+    float cosTheta = dot(normal, SUN_DIRECTION);
+    if(cosTheta > 0.f){
+        ShadowRay shadowRay;
+        shadowRay._Origin = vec4(origin, INFINITY);
+        shadowRay._Direction = vec4(SUN_DIRECTION, 0.f);
+        shadowRay._Contribution = vec4(throughput * albedo * SUN_COLOR * cosTheta, 0.f);
+        shadowRay._PixelIndex = queuedRay._PixelIndex;
+        uShadowQueue[atomicAdd(uShadowCount, 1)] = shadowRay;
+    }
+
+    // diffuse bounce, the cosine weighted pdf cancels out with the lambertian brdf
+    if(queuedRay._Depth < uMaxDepth){
+        // each bounce uses its own dimensions of the pixel sequence
+        uvec2 pixel = uvec2(getTexelCoord(queuedRay._PixelIndex));
+        vec2 u = getSample2D(pixel, uSampleIndex, SAMPLING_DIMENSION_BOUNCE + 2u * queuedRay._Depth);
+        QueuedRay bounceRay;
+        bounceRay._Origin = vec4(origin, 1.f);
+        bounceRay._Direction = vec4(sampleCosineHemisphere(normal, u), 0.f);
+        bounceRay._Throughput = vec4(throughput * albedo, 0.f);
+        bounceRay._PixelIndex = queuedRay._PixelIndex;
+        bounceRay._Depth = queuedRay._Depth + 1;
+        uNextRayQueue[atomicAdd(uNextExtensionCount, 1)] = bounceRay;
+    }
+}
@@ -0,0 +1,61 @@
+// queues shared by the wavefront kernels, mirrors glr::WavefrontTracer
+
+#include "common/intersection.glsl"
+
+// structures
+struct QueuedRay {
+    vec4 _Origin;
+    vec4 _Direction;
+    vec4 _Throughput; // rgb path throughput
+    uint _PixelIndex;
+    uint _Depth;
+};
+
+struct ShadowRay {
+    vec4 _Origin; // w is the maximum distance
+    vec4 _Direction;
+    vec4 _Contribution; // rgb radiance added if the ray is not occluded
+    uint _PixelIndex;
+};
+
+// constants
+const uint WAVEFRONT_GROUP_SIZE = 64;
+
+const uint STAGE_SHADING = 0;
+const uint STAGE_CONNECT = 1;
+const uint STAGE_NEXT_BOUNCE = 2;
+
+// input
+uniform uvec2 uImageSize;
+
+layout (binding = 6, std430) coherent buffer uWavefrontCountersSSBO {
+    uint uExtensionCount;
+    uint uNextExtensionCount;
+    uint uShadowCount;
+    // next ray fetched by the persistent threads
+    uint uExtensionHead;
+    // indirect dispatch arguments
+    uint uShadingDispatch[3];
+    uint uConnectDispatch[3];
+};
+
+layout (binding = 7, std430) buffer uRayQueueSSBO {
+    QueuedRay uRayQueue[];
+};
+
+layout (binding = 8, std430) buffer uNextRayQueueSSBO {
+    QueuedRay uNextRayQueue[];
+};
+
+layout (binding = 9, std430) buffer uHitsSSBO {
+    Hit uHits[];
+};
+
+layout (binding = 10, std430) buffer uShadowQueueSSBO {
+    ShadowRay uShadowQueue[];
+};
+
+// code
+ivec2 getTexelCoord(uint pixelIndex){
+    return ivec2(pixelIndex % uImageSize.x, pixelIndex / uImageSize.x);
+}
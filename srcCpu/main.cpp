@@ -0,0 +1,63 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "camera.hpp"
+#include "cpuRaytracer.hpp"
+#include "cpuScene.hpp"
+#include "errorHandler.hpp"
+
+using namespace cr;
+
+// same scene and camera as glr::Application
+CpuScenePtr initScene(){
+    // the default material of glr::Scene comes first
+    std::vector<Material> materials = {Material(), Material({0.2, 0.3, 0.1, 1.})};
+
+    MeshPtr model = Mesh::load(Mesh::MODELS_DIRECTORY + "teapot.obj");
+    model->setMaterial(1);
+
+    return CpuScenePtr(new CpuScene({model}, materials));
+}
+
+int main(int argc, char** argv){
+    // usage: appVersionCpu [output.ppm] [width height]
+    std::string output = argc > 1 ? argv[1] : "render.ppm";
+    CpuRaytracerParameters parameters{};
+    parameters._Width = argc > 3 ? std::stoul(argv[2]) : 1280;
+    parameters._Height = argc > 3 ? std::stoul(argv[3]) : 720;
+    if(parameters._Width == 0 || parameters._Height == 0){
+        ErrorHandler::handle(
+            __FILE__, __LINE__,
+            ErrorCode::USAGE_ERROR,
+            "The image can't be empty!\n"
+        );
+    }
+
+    float aspectRatio = static_cast<float>(parameters._Width) / static_cast<float>(parameters._Height);
+    Camera camera = Camera(glm::vec3(0.f, 0.f, -5.f), aspectRatio);
+
+    CpuRaytracer raytracer = CpuRaytracer(initScene(), parameters);
+    std::vector<glm::vec4> image = raytracer.render(camera.getGpuData());
+    fprintf(stdout, "Rendered %ux%u in %f ms, %f Mrays/s\n",
+        parameters._Width, parameters._Height,
+        1000. * raytracer._Statistics._RenderTime,
+        raytracer._Statistics.getRaysPerSecond() / 1e6
+    );
+    const TileSchedulerStatistics& scheduler = raytracer._Statistics._Scheduler;
+    fprintf(stdout, "%zu threads, %ux%u tiles, %.1f%% efficiency\n",
+        scheduler._Threads.size(),
+        raytracer._Statistics._TileSize, raytracer._Statistics._TileSize,
+        100. * scheduler.getEfficiency()
+    );
+    for(size_t i=0; i<scheduler._Threads.size(); i++){
+        const TileSchedulerThreadStatistics& thread = scheduler._Threads[i];
+        fprintf(stdout, "\tthread %zu: busy %f ms, idle %f ms, %u tiles (%u stolen)\n",
+            i, 1000. * thread._BusyTime, 1000. * thread._IdleTime, thread._NbTiles, thread._NbStolenTiles
+        );
+    }
+
+    CpuRaytracer::writeImage(output, image, parameters._Width, parameters._Height);
+    fprintf(stdout, "Image written to `%s'\n", output.c_str());
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "accumulationBuffer.hpp"
+
+#include "errorHandler.hpp"
+#include "shader.hpp"
+
+namespace glr{
+
+AccumulationBuffer::AccumulationBuffer(uint32_t width, uint32_t height){
+    _Width = width;
+    _Height = height;
+    initProgram();
+    initBuffers();
+}
+
+AccumulationBuffer::~AccumulationBuffer(){
+    glDeleteTextures(1, &_AccumulationTexture);
+    glDeleteTextures(1, &_SampleCountsTexture);
+    glDeleteBuffers(1, &_ConvergenceSSBO);
+}
+
+void AccumulationBuffer::initProgram(){
+    ShaderPtr computeShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "accumulation.glsl", COMPUTE_SHADER));
+    _AccumulationProgram = ProgramPtr(new Program(computeShader));
+    glProgramUniform2ui(_AccumulationProgram->getId(), _AccumulationProgram->getLocation("uImageSize"), _Width, _Height);
+    ShaderPtr adaptiveShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "adaptiveSampling.glsl", COMPUTE_SHADER));
+    _AdaptiveSamplingProgram = ProgramPtr(new Program(adaptiveShader));
+    glProgramUniform2ui(_AdaptiveSamplingProgram->getId(), _AdaptiveSamplingProgram->getLocation("uImageSize"), _Width, _Height);
+}
+
+void AccumulationBuffer::initBuffers(){
+    glCreateTextures(GL_TEXTURE_2D, 1, &_AccumulationTexture);
+    glCreateTextures(GL_TEXTURE_2D, 1, &_SampleCountsTexture);
+    glCreateBuffers(1, &_ConvergenceSSBO);
+    if(_AccumulationTexture == 0 || _SampleCountsTexture == 0 || _ConvergenceSSBO == 0){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to create the accumulation buffers!\n"
+        );
+    }
+    glTextureStorage2D(_AccumulationTexture, 1, GL_RGBA32F, _Width, _Height);
+    glTextureStorage2D(_SampleCountsTexture, 1, GL_R32UI, _Width, _Height);
+    glClearTexImage(_SampleCountsTexture, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    // read by the tracers before each sample
+    glBindImageTexture(SAMPLE_COUNTS_IMAGE_UNIT, _SampleCountsTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+    glNamedBufferStorage(_ConvergenceSSBO, sizeof(uint32_t), nullptr, GL_DYNAMIC_STORAGE_BIT);
+}
+
+void AccumulationBuffer::reset(){
+    // no pixel is converged anymore, the counts are only cleared if there is something to clear
+    if(_NbSamples > 0){
+        glClearTexImage(_SampleCountsTexture, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+    _NbSamples = 0;
+    _NbNonConvergedPixels = 0;
+    _IsConverged = false;
+}
+
+void AccumulationBuffer::accumulate(){
+    _NbSamples++;
+    bool isConvergenceChecked = _NbSamples % CONVERGENCE_CHECK_PERIOD == 0;
+    if(isConvergenceChecked){
+        glClearNamedBufferData(_ConvergenceSSBO, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    }
+
+    glBindImageTexture(IMAGE_UNIT, _AccumulationTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    glBindImageTexture(SAMPLE_COUNTS_IMAGE_UNIT, _SampleCountsTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CONVERGENCE_BINDING, _ConvergenceSSBO);
+    _AccumulationProgram->use();
+    _AccumulationProgram->setUInt("uNbSamples", _NbSamples);
+    _AccumulationProgram->setFloat("uErrorTarget", _Parameters._ErrorTarget);
+    _AccumulationProgram->setBool("uIsConvergenceChecked", isConvergenceChecked);
+    glDispatchCompute((_Width + 15) / 16, (_Height + 15) / 16, 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    if(_Parameters._IsAdaptive){
+        _AdaptiveSamplingProgram->use();
+        _AdaptiveSamplingProgram->setUInt("uMinNbSamples", static_cast<uint32_t>(_Parameters._MinNbSamples));
+        glDispatchCompute((_Width + 15) / 16, (_Height + 15) / 16, 1);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+
+    if(isConvergenceChecked){
+        glGetNamedBufferSubData(_ConvergenceSSBO, 0, sizeof(uint32_t), &_NbNonConvergedPixels);
+        uint32_t maxNbNonConvergedPixels = static_cast<uint32_t>(MAX_NON_CONVERGED_RATIO * _Width * _Height);
+        _IsConverged = _NbNonConvergedPixels <= maxNbNonConvergedPixels;
+    }
+    if(_NbSamples >= static_cast<uint32_t>(_Parameters._MaxNbSamples)){
+        _IsConverged = true;
+    }
+}
+
+float AccumulationBuffer::radicalInverse(uint32_t index, uint32_t base){
+    float inverseBase = 1.f / static_cast<float>(base);
+    float factor = inverseBase;
+    float result = 0.f;
+    while(index > 0){
+        result += static_cast<float>(index % base) * factor;
+        index /= base;
+        factor *= inverseBase;
+    }
+    return result;
+}
+
+glm::vec2 AccumulationBuffer::getJitter() const {
+    // Halton sequence, the first sample is the corner of the pixel as without accumulation
+    return glm::vec2(radicalInverse(_NbSamples, 2), radicalInverse(_NbSamples, 3));
+}
+
+uint32_t AccumulationBuffer::getNbSamples() const {
+    return _NbSamples;
+}
+
+uint32_t AccumulationBuffer::getNbNonConvergedPixels() const {
+    return _NbNonConvergedPixels;
+}
+
+GLuint AccumulationBuffer::getSampleCountsTexture() const {
+    return _SampleCountsTexture;
+}
+
+bool AccumulationBuffer::isConverged() const {
+    return _Parameters._IsOn && _IsConverged;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+#include <memory>
+
+#include "program.hpp"
+
+namespace glr{
+
+class AccumulationBuffer;
+using AccumulationBufferPtr = std::shared_ptr<AccumulationBuffer>;
+
+struct AccumulationParameters {
+    bool _IsOn = true;
+    // relative standard error of the mean under which a pixel is converged
+    float _ErrorTarget = 0.01f;
+    // the accumulation stops after this many samples even if the image is still noisy
+    int _MaxNbSamples = 4096;
+    // the converged pixels get no more samples once they have at least _MinNbSamples
+    bool _IsAdaptive = true;
+    int _MinNbSamples = 16;
+    // debug view of the number of samples of each pixel
+    bool _IsHeatMapDisplayed = false;
+};
+
+/**
+ * Progressive accumulation of jittered samples in a 32 bits float image
+ * The image bound to image unit 0 is replaced by the mean of the samples since the last reset
+ * The per pixel variance of the luminance tells when the image has converged
+ * If adaptive, a pixel is flagged once it and its neighbours are converged and the tracers skip it, cf shaders/common/accumulation.glsl
+*/
+class AccumulationBuffer {
+    public:
+        AccumulationParameters _Parameters = {};
+
+    private:
+        static const GLuint IMAGE_UNIT = 2;
+        static const GLuint SAMPLE_COUNTS_IMAGE_UNIT = 3;
+        static const GLuint CONVERGENCE_BINDING = 17;
+        // reading the counter back stalls the pipeline, it is not done every sample
+        static const uint32_t CONVERGENCE_CHECK_PERIOD = 16;
+        // proportion of noisy pixels under which the image is considered converged
+        static constexpr float MAX_NON_CONVERGED_RATIO = 1e-3f;
+
+        uint32_t _Width = 0;
+        uint32_t _Height = 0;
+
+        ProgramPtr _AccumulationProgram = nullptr;
+        ProgramPtr _AdaptiveSamplingProgram = nullptr;
+        GLuint _AccumulationTexture = 0;
+        GLuint _SampleCountsTexture = 0;
+        GLuint _ConvergenceSSBO = 0;
+
+        uint32_t _NbSamples = 0;
+        uint32_t _NbNonConvergedPixels = 0;
+        bool _IsConverged = false;
+
+    public:
+        AccumulationBuffer(uint32_t width, uint32_t height);
+        ~AccumulationBuffer();
+
+    public:
+        // the next sample restarts the accumulation in every pixel
+        void reset();
+        // adds the image of image unit 0 and replaces it by the mean
+        void accumulate();
+
+        // position of the next sample in its pixel, in [0, 1)
+        glm::vec2 getJitter() const;
+        uint32_t getNbSamples() const;
+        uint32_t getNbNonConvergedPixels() const;
+        // r32ui number of samples of each pixel, the highest bit flags the converged pixels
+        GLuint getSampleCountsTexture() const;
+        // nothing needs to be traced anymore
+        bool isConverged() const;
+
+    private:
+        void initProgram();
+        void initBuffers();
+
+        static float radicalInverse(uint32_t index, uint32_t base);
+};
+
+}
\ No newline at end of file
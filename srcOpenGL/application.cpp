@@ -175,14 +175,26 @@ void Application::initRectangleVAO() {
 
 void Application::initScene() {
     _Scene = ScenePtr(new Scene());
+    _AssetLoader = cr::AssetLoaderPtr(new cr::AssetLoader());
 
     _Scene->addMaterial({0.2, 0.3, 0.1, 1.});
 
-    // load model
-    cr::MeshPtr model = cr::Mesh::load(cr::Mesh::MODELS_DIRECTORY + "teapot.obj");
-    // MeshPtr model = Mesh::load(Mesh::MODELS_DIRECTORY + "suzanne.obj");
-    model->setMaterial(1);
-    _Scene->addMesh(model);
+    // load model, it is added to the scene once loaded
+    uint32_t model = _AssetLoader->loadMesh(cr::Mesh::MODELS_DIRECTORY + "teapot.obj");
+    // uint32_t model = _AssetLoader->loadMesh(cr::Mesh::MODELS_DIRECTORY + "suzanne.obj");
+    _PendingMeshes[model] = {1, {glm::mat4(1.f)}};
+
+    // // forest of teapots sharing the same geometry, moved as a whole by its group
+    // uint32_t forest = _Scene->addGroup(glm::mat4(1.f));
+    // PendingMesh& trees = _PendingMeshes[model];
+    // trees._ParentNode = forest;
+    // for(int x=-4; x<=4; x++){
+    //     for(int z=1; z<=8; z++){
+    //         glm::mat4 instanceModel = glm::mat4(1.f);
+    //         instanceModel[3] = glm::vec4(2.f*x, 0.f, 2.f*z, 1.f);
+    //         trees._Models.push_back(instanceModel);
+    //     }
+    // }
 
     // // first triangle
     // MeshPtr basicTri = Mesh::primitiveCube();
@@ -204,6 +216,33 @@ void Application::initScene() {
     // _Scene->addMesh(randTri);
 }
 
+void Application::insertLoadedMeshes(){
+    cr::LoadedMesh loadedMesh{};
+    while(_AssetLoader->tryPopMesh(loadedMesh)){
+        auto it = _PendingMeshes.find(loadedMesh._RequestId);
+        if(it == _PendingMeshes.end()){
+            continue;
+        }
+        // the scene goes on without the meshes that failed to load
+        if(loadedMesh._DidFail){
+            cr::ErrorHandler::handle(
+                __FILE__,
+                __LINE__,
+                cr::ErrorCode::IO_ERROR,
+                "Failed to load a mesh, it is not added to the scene:\n" + loadedMesh._Error,
+                cr::ErrorLevel::WARNING
+            );
+            _PendingMeshes.erase(it);
+            continue;
+        }
+        // the bvh is already built, the scene only uploads it
+        for(const glm::mat4& model : it->second._Models){
+            _Scene->addInstance(loadedMesh._Mesh, loadedMesh._BVH, model, it->second._MaterialId, it->second._ParentNode);
+        }
+        _PendingMeshes.erase(it);
+    }
+}
+
 cr::CameraPtr Application::getCamera() const{
     if(!_Camera){
         cr::ErrorHandler::handle(
@@ -217,53 +256,131 @@ cr::CameraPtr Application::getCamera() const{
 }
 
 
-void Application::drawOneFrame() const {
-    // use the compute shader
-    assert(_ComputeProgram->isInit());
-    _ComputeProgram->use();
-    // _Scene->sendDataToGpu(_ComputeProgram);
-    uint32_t nbGroupsX = _Parameters._ViewportWidth / 16.f;
-    uint32_t nbGroupsY = _Parameters._ViewportHeight / 16.f;
-    uint32_t nbGroupsZ = 1;
-    float uniformTimeValue = _FPS._LastFrame;
-    _ComputeProgram->setFloat("uTime", uniformTimeValue);
-    _ComputeProgram->setBool("uIsWireframeModeOn", _Options._IsWireframeModeOn);
-    _ComputeProgram->setBool("uIsBVHDisplayed", _Options._IsBVHDisplayed);
-    _ComputeProgram->setInt("uDepthDisplayBVH", _Options._DepthDisplayBVH);
-    // send camera data
+void Application::initFrameUBO() {
+    GLuint frameBinding = 0;
+    _FrameRingBuffer = RingBufferPtr(new RingBuffer(sizeof(FrameDataGPU)));
+    FrameDataGPU frameData{};
+    RingBufferAllocation allocation = _FrameRingBuffer->write(&frameData, sizeof(FrameDataGPU));
+    _FrameRingBuffer->bind(GL_UNIFORM_BUFFER, frameBinding, allocation);
+}
+
+void Application::updateFrameUBO() const {
     assert(_Camera);
-    cr::CameraGPU cameraDataToSend = _Camera->getGpuData();
-    _ComputeProgram->setMat4("uCamera._View", cameraDataToSend._View);
-    _ComputeProgram->setMat4("uCamera._Proj", cameraDataToSend._Proj);
-    _ComputeProgram->setMat4("uCamera._InvView", cameraDataToSend._InvView);
-    _ComputeProgram->setMat4("uCamera._InvProj", cameraDataToSend._InvProj);
-    _ComputeProgram->setVec4("uCamera._Eye", cameraDataToSend._Eye);
-    _ComputeProgram->setFloat("uCamera._PlaneWidth", cameraDataToSend._PlaneWidth);
-    _ComputeProgram->setFloat("uCamera._PlaneHeight", cameraDataToSend._PlaneHeight);
-    _ComputeProgram->setFloat("uCamera._PlaneNear", cameraDataToSend._PlaneNear);
-
-    glDispatchCompute(nbGroupsX, nbGroupsY, nbGroupsZ);
-    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    assert(_FrameRingBuffer);
+    assert(_AccumulationBuffer);
+    FrameDataGPU frameData{};
+    frameData._Camera = _Camera->getGpuData();
+    frameData._Time = _FPS._LastFrame;
+    frameData._IsWireframeModeOn = _Options._IsWireframeModeOn ? 1 : 0;
+    frameData._IsBVHDisplayed = _Options._IsBVHDisplayed ? 1 : 0;
+    frameData._DepthDisplayBVH = _Options._DepthDisplayBVH;
+    frameData._IsPrimaryRasterized = _Options._IsHybridOn ? 1 : 0;
+    frameData._Jitter = _AccumulationBuffer->_Parameters._IsOn ? _AccumulationBuffer->getJitter() : glm::vec2(0.f);
+    // the accumulated samples follow the per pixel sequences from their start
+    frameData._SampleIndex = _AccumulationBuffer->_Parameters._IsOn ? _AccumulationBuffer->getNbSamples() : _FrameIndex;
+    // written straight into the slice of this frame
+    RingBufferAllocation allocation = _FrameRingBuffer->write(&frameData, sizeof(FrameDataGPU));
+    GLuint frameBinding = 0;
+    _FrameRingBuffer->bind(GL_UNIFORM_BUFFER, frameBinding, allocation);
+}
 
+void Application::drawOneFrame() const {
+    // the converged image stays in the texture, it only has to be displayed
+    if(_AccumulationBuffer->isConverged()){
+        if(_DenoisingPass->_Parameters._IsOn && !_DenoisingPass->isUpToDate()){
+            _DenoisingPass->denoise();
+        }
+        drawTexture();
+        return;
+    }
+
+    // send the frame data in one write
+    updateFrameUBO();
+
+    // primary visibility for free from the rasterizer
+    if(_Options._IsHybridOn){
+        assert(_VisibilityBuffer);
+        _VisibilityBuffer->render(_Scene->getMeshModelToGPUData());
+    }
+
+    if(_Options._IsWavefrontOn){
+        assert(_WavefrontTracer);
+        _WavefrontTracer->_Parameters._IsPrimaryRasterized = _Options._IsHybridOn;
+        _WavefrontTracer->render();
+        // the megakernel draws the boxes itself
+        if(_Options._IsBVHDisplayed){
+            _BVHOverlayProgram->use();
+            glDispatchCompute((_Parameters._ViewportWidth + 15) / 16, (_Parameters._ViewportHeight + 15) / 16, 1);
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        }
+    } else {
+        // use the compute shader
+        assert(_ComputeProgram->isInit());
+        _ComputeProgram->use();
+        uint32_t nbGroupsX = _Parameters._ViewportWidth / 16.f;
+        uint32_t nbGroupsY = _Parameters._ViewportHeight / 16.f;
+        uint32_t nbGroupsZ = 1;
+
+        glDispatchCompute(nbGroupsX, nbGroupsY, nbGroupsZ);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+
+    if(_AccumulationBuffer->_Parameters._IsOn){
+        _AccumulationBuffer->accumulate();
+    }
+    // the mean of the samples is filtered, the accumulation only sees the traced samples
+    if(_DenoisingPass->_Parameters._IsOn){
+        _DenoisingPass->denoise();
+    } else {
+        _DenoisingPass->invalidate();
+    }
+    drawTexture();
+}
+
+void Application::drawTexture() const {
     // use the graphics shadersdt
     assert(_RenderingProgram->isInit());
     _RenderingProgram->use(); 
+    _RenderingProgram->setBool("uIsHeatMapDisplayed", _AccumulationBuffer->_Parameters._IsHeatMapDisplayed);
+    _RenderingProgram->setUInt("uMaxNbSamples", static_cast<uint32_t>(_AccumulationBuffer->_Parameters._MaxNbSamples));
     assert(_RectangleVao != 0);
     glBindVertexArray(_RectangleVao);
     glActiveTexture(GL_TEXTURE0);
     assert(_ImageTextureId != 0);
-    glBindTexture(GL_TEXTURE_2D, _ImageTextureId);
-    GLint uniformTextureValue = 0; // 0 for GL_TEXTURE0
-    _RenderingProgram->setInt("uRaytracedTexture", uniformTextureValue);
+    glBindTexture(GL_TEXTURE_2D, _DenoisingPass->_Parameters._IsOn ? _DenoisingPass->getTexture() : _ImageTextureId);
     GLint firstIndex = 0;
     GLsizei numberOfIndices = 4;
     glDrawArrays(GL_TRIANGLE_STRIP, firstIndex, numberOfIndices);
     glBindVertexArray(0);
 }
 
+void Application::updateAccumulation() {
+    assert(_AccumulationBuffer);
+    bool hasFrameChanged = _Camera->getVersion() != _AccumulatedCameraVersion
+        || _Scene->getVersion() != _AccumulatedSceneVersion
+        || _Options != _AccumulatedOptions
+        || _WavefrontTracer->_Parameters != _AccumulatedWavefrontParameters;
+    if(hasFrameChanged || !_AccumulationBuffer->_Parameters._IsOn){
+        _AccumulationBuffer->reset();
+    }
+    _AccumulatedCameraVersion = _Camera->getVersion();
+    _AccumulatedSceneVersion = _Scene->getVersion();
+    _AccumulatedOptions = _Options;
+    _AccumulatedWavefrontParameters = _WavefrontTracer->_Parameters;
+}
+
 void Application::render() {
+    insertLoadedMeshes();
+    // the edits and the arrivals of the last frame, only the changed parts are uploaded
+    if(_Scene->isDirty()){
+        _Scene->sendDataToGpu(_ComputeProgram);
+    }
+    updateAccumulation();
+    // the slice of this frame is free once the gpu is done with the frame before last
+    _FrameRingBuffer->beginFrame();
     clearScreen();
     drawOneFrame();
+    _FrameIndex++;
     _FPS.increment();
     // _FPS.display();
     drawImgui();
@@ -276,6 +393,47 @@ void Application::initShaders(){
     _RenderingProgram = ProgramPtr(new Program(vertexShader, fragmentShader));
     ShaderPtr computeShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "raytracer.glsl", COMPUTE_SHADER));
     _ComputeProgram = ProgramPtr(new Program(computeShader));
+
+    ShaderPtr overlayShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "bvhOverlay.glsl", COMPUTE_SHADER));
+    _BVHOverlayProgram = ProgramPtr(new Program(overlayShader));
+
+    GLint uniformTextureValue = 0; // 0 for GL_TEXTURE0
+    _RenderingProgram->setInt("uRaytracedTexture", uniformTextureValue);
+    glProgramUniform2ui(_BVHOverlayProgram->getId(), _BVHOverlayProgram->getLocation("uImageSize"), 
+        _Parameters._ViewportWidth, _Parameters._ViewportHeight);
+}
+
+void Application::initWavefrontTracer(){
+    _WavefrontTracer = WavefrontTracerPtr(new WavefrontTracer(
+        _Parameters._ViewportWidth, 
+        _Parameters._ViewportHeight
+    ));
+}
+
+void Application::initVisibilityBuffer(){
+    _VisibilityBuffer = VisibilityBufferPtr(new VisibilityBuffer(
+        _Parameters._ViewportWidth, 
+        _Parameters._ViewportHeight
+    ));
+}
+
+void Application::initAccumulationBuffer(){
+    _AccumulationBuffer = AccumulationBufferPtr(new AccumulationBuffer(
+        _Parameters._ViewportWidth, 
+        _Parameters._ViewportHeight
+    ));
+}
+
+void Application::initSamplerBuffer(){
+    cr::SamplerPtr sampler = cr::SamplerPtr(new cr::Sampler(_Options._SamplerType));
+    _SamplerBuffer = SamplerBufferPtr(new SamplerBuffer(sampler));
+}
+
+void Application::initDenoisingPass(){
+    _DenoisingPass = DenoisingPassPtr(new DenoisingPass(
+        _Parameters._ViewportWidth, 
+        _Parameters._ViewportHeight
+    ));
 }
 
 void Application::init(){
@@ -284,13 +442,19 @@ void Application::init(){
     initGLAD();
     initViewport();
     initShaders();
+    initWavefrontTracer();
+    initVisibilityBuffer();
+    initAccumulationBuffer();
+    initSamplerBuffer();
+    initDenoisingPass();
+    initFrameUBO();
     initRectangleVAO();
     initTexture();
     initCamera();
     initCallbacks();
     initScene();
     initImgui();
-    // static scene
+    // the scene is empty until the first meshes arrive, the window shows up without waiting for them
     _Scene->sendDataToGpu(_ComputeProgram);
 }
 
@@ -308,7 +472,12 @@ void Application::mainLoop(){
     while(!glfwWindowShouldClose(_Window)){
         processInput();
         render();
-        glfwPollEvents();
+        // nothing is traced once converged, the loop sleeps until the next event unless meshes are still loading
+        if(_AccumulationBuffer->isConverged() && _AssetLoader->isIdle()){
+            glfwWaitEventsTimeout(IDLE_EVENTS_TIMEOUT);
+        } else {
+            glfwPollEvents();
+        }
     }
 }
 
@@ -337,7 +506,7 @@ void Application::initTexture(){
     GLint imageIndex = 0;
     GLboolean isTextureLayered = GL_FALSE;
     GLint textureLayer = 0; // no layer
-    GLenum access = GL_READ_ONLY;
+    GLenum access = GL_READ_WRITE;
     glBindImageTexture(imageIndex, _ImageTextureId, mipmapLevel, isTextureLayered, textureLayer, access, GL_RGBA32F);
 }
 
@@ -400,6 +569,78 @@ void Application::drawImgui() {
     ImGui::Checkbox("Display triangle", &_Options._IsWireframeModeOn);
     ImGui::Checkbox("Display BVH", &_Options._IsBVHDisplayed);
     ImGui::SliderInt("BVH depth to display", &_Options._DepthDisplayBVH, 0, 10);
+    ImGui::Checkbox("Rasterized primary visibility", &_Options._IsHybridOn);
+    ImGui::Checkbox("Wavefront path tracer", &_Options._IsWavefrontOn);
+    if(_Options._IsWavefrontOn){
+        WavefrontParameters& parameters = _WavefrontTracer->_Parameters;
+        ImGui::SliderInt("Number of bounces", &parameters._MaxDepth, 0, 8);
+        int raySorting = parameters._RaySorting;
+        ImGui::Combo("Ray sorting", &raySorting, "None\0Global\0Tiles\0");
+        parameters._RaySorting = static_cast<RaySortingMode>(raySorting);
+        ImGui::SliderInt("First sorted bounce", &parameters._MinSortedDepth, 0, 8);
+        int samplerType = _Options._SamplerType;
+        if(ImGui::Combo("Sampler", &samplerType, "White noise\0Sobol\0Rank-1 lattice\0Blue noise\0")){
+            _Options._SamplerType = static_cast<cr::SamplerType>(samplerType);
+            _SamplerBuffer->getSampler()->setSamplerType(_Options._SamplerType);
+            _SamplerBuffer->update();
+        }
+        ImGui::Checkbox("Profile stages", &parameters._IsProfilingOn);
+        if(parameters._IsProfilingOn){
+            const WavefrontStatistics& statistics = _WavefrontTracer->_Statistics;
+            ImGui::Text("Ray generation: %.3f ms", statistics._RayGenerationTime);
+            ImGui::Text("Sort: %.3f ms", statistics._SortTime);
+            ImGui::Text("Extension: %.3f ms", statistics._ExtensionTime);
+            ImGui::Text("Shading: %.3f ms", statistics._ShadingTime);
+            ImGui::Text("Connect: %.3f ms", statistics._ConnectTime);
+        }
+    }
+    AccumulationParameters& accumulation = _AccumulationBuffer->_Parameters;
+    ImGui::Checkbox("Progressive accumulation", &accumulation._IsOn);
+    if(accumulation._IsOn){
+        bool hasTargetChanged = ImGui::SliderFloat("Error target", &accumulation._ErrorTarget, 1e-3f, 1e-1f, "%.3f", ImGuiSliderFlags_Logarithmic);
+        hasTargetChanged |= ImGui::SliderInt("Max samples", &accumulation._MaxNbSamples, 1, 65536, "%d", ImGuiSliderFlags_Logarithmic);
+        hasTargetChanged |= ImGui::Checkbox("Adaptive sampling", &accumulation._IsAdaptive);
+        if(accumulation._IsAdaptive){
+            hasTargetChanged |= ImGui::SliderInt("Min samples", &accumulation._MinNbSamples, 2, 256, "%d", ImGuiSliderFlags_Logarithmic);
+        }
+        ImGui::Checkbox("Samples heat map", &accumulation._IsHeatMapDisplayed);
+        if(hasTargetChanged){
+            _AccumulationBuffer->reset();
+        }
+        ImGui::Text("Samples: %u", _AccumulationBuffer->getNbSamples());
+        ImGui::Text("Noisy pixels: %u%s", _AccumulationBuffer->getNbNonConvergedPixels(), 
+            _AccumulationBuffer->isConverged() ? " (converged)" : "");
+    }
+    cr::DenoiserParameters& denoiser = _DenoisingPass->_Parameters;
+    ImGui::Checkbox("Denoiser", &denoiser._IsOn);
+    if(denoiser._IsOn){
+        int nbIterations = denoiser._NbIterations;
+        ImGui::SliderInt("Filter iterations", &nbIterations, 1, 8);
+        denoiser._NbIterations = nbIterations;
+        ImGui::SliderFloat("Luminance phi", &denoiser._LuminancePhi, 0.1f, 64.f, "%.1f", ImGuiSliderFlags_Logarithmic);
+        ImGui::SliderFloat("Normal phi", &denoiser._NormalPhi, 1.f, 512.f, "%.0f", ImGuiSliderFlags_Logarithmic);
+        ImGui::SliderFloat("Depth phi", &denoiser._DepthPhi, 0.1f, 16.f, "%.1f", ImGuiSliderFlags_Logarithmic);
+        ImGui::Text("Denoising: %.3f ms", _DenoisingPass->getDenoisingTime());
+    }
+    if(ImGui::CollapsingHeader("Scene")){
+        // the default material is left as it is
+        for(uint32_t i=1; i<_Scene->getNbMaterials(); i++){
+            glm::vec4 color = _Scene->getMaterialColor(i);
+            if(ImGui::ColorEdit3(("Material " + std::to_string(i)).c_str(), &color[0])){
+                _Scene->setMaterialColor(i, color);
+            }
+        }
+        for(uint32_t i=0; i<_Scene->getNbInstances(); i++){
+            glm::mat4 model = _Scene->getGraph().getLocalMatrix(_Scene->getInstanceNode(i));
+            if(ImGui::DragFloat3(("Instance " + std::to_string(i) + " position").c_str(), &model[3][0], 0.01f)){
+                _Scene->setInstanceModel(i, model);
+            }
+        }
+        ImGui::Text("Last upload: %zu bytes in %.3f ms", _Scene->_Statistics._UploadedBytes, _Scene->_Statistics._UploadTime);
+        ImGui::Text("%u meshes, %u instances", _Scene->getNbMeshes(), _Scene->getNbInstances());
+        ImGui::Text("%u meshes loading", _AssetLoader->getNbPending());
+        ImGui::Text("BVH builds: %u bottom level, %u top level", _Scene->_Statistics._NbBLAS_Builds, _Scene->_Statistics._NbTLAS_Builds);
+    }
     ImGui::End();
 
     _FPS.display();
@@ -1,14 +1,25 @@
 #pragma once
 
 #include "program.hpp"
+#include "uniformBuffer.hpp"
+#include "ringBuffer.hpp"
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
+#include <cstddef>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 
+#include "accumulationBuffer.hpp"
+#include "assetLoader.hpp"
 #include "camera.hpp"
+#include "denoisingPass.hpp"
+#include "samplerBuffer.hpp"
 #include "scene.hpp"
+#include "visibilityBuffer.hpp"
+#include "wavefrontTracer.hpp"
 
 namespace glr{
 
@@ -52,10 +63,40 @@ struct ApplicationOptions {
     bool _IsWireframeModeOn = false;
     bool _IsBVHDisplayed = false;
     int _DepthDisplayBVH = 0;
+    bool _IsWavefrontOn = false;
+    bool _IsHybridOn = false;
+    cr::SamplerType _SamplerType = cr::SAMPLER_SOBOL;
+
+    bool operator==(const ApplicationOptions&) const = default;
+};
+
+// std140 layout of the per frame uniform block, cf shaders/common/frame.glsl
+struct FrameDataGPU {
+    cr::CameraGPU _Camera;
+    alignas(16) float _Time = 0.f;
+    uint32_t _IsWireframeModeOn = 0;
+    uint32_t _IsBVHDisplayed = 0;
+    int32_t _DepthDisplayBVH = 0;
+    uint32_t _IsPrimaryRasterized = 0;
+    alignas(8) glm::vec2 _Jitter = glm::vec2(0.f);
+    uint32_t _SampleIndex = 0;
+};
+static_assert(offsetof(FrameDataGPU, _Time) == 288, "FrameDataGPU does not match the std140 layout");
+static_assert(offsetof(FrameDataGPU, _Jitter) == 312, "FrameDataGPU does not match the std140 layout");
+static_assert(offsetof(FrameDataGPU, _SampleIndex) == 320, "FrameDataGPU does not match the std140 layout");
+
+// instances of a mesh being loaded, added to the scene once it has arrived
+struct PendingMesh {
+    uint32_t _MaterialId = 0;
+    std::vector<glm::mat4> _Models = {};
+    uint32_t _ParentNode = cr::SceneGraph::NO_PARENT;
 };
 
 class Application {
     private:
+        // once the image has converged, the window only wakes up for the events or at this period in seconds
+        static constexpr double IDLE_EVENTS_TIMEOUT = 0.1;
+
         ApplicationParameters _Parameters = {};
         ApplicationFPS _FPS = {};
         ApplicationOptions _Options = {};
@@ -63,10 +104,29 @@ class Application {
         GLFWwindow* _Window = nullptr;
         ProgramPtr _RenderingProgram = nullptr;
         ProgramPtr _ComputeProgram = nullptr;
+        ProgramPtr _BVHOverlayProgram = nullptr;
+        WavefrontTracerPtr _WavefrontTracer = nullptr;
+        VisibilityBufferPtr _VisibilityBuffer = nullptr;
+        AccumulationBufferPtr _AccumulationBuffer = nullptr;
+        SamplerBufferPtr _SamplerBuffer = nullptr;
+        DenoisingPassPtr _DenoisingPass = nullptr;
+        // the frame data of the frames in flight, bound to the uniform block 0
+        RingBufferPtr _FrameRingBuffer = nullptr;
         GLuint _RectangleVao = 0;
         GLuint _ImageTextureId = 0;
         cr::CameraPtr _Camera = nullptr;
         ScenePtr _Scene = nullptr;
+        // the meshes are loaded in the background, the scene shows the ones already there
+        cr::AssetLoaderPtr _AssetLoader = nullptr;
+        std::unordered_map<uint32_t, PendingMesh> _PendingMeshes = {};
+
+        // state of the accumulated samples, any change restarts the accumulation
+        uint32_t _AccumulatedCameraVersion = 0;
+        uint32_t _AccumulatedSceneVersion = 0;
+        ApplicationOptions _AccumulatedOptions = {};
+        WavefrontParameters _AccumulatedWavefrontParameters = {};
+        // sample index of the frames rendered without accumulation
+        uint32_t _FrameIndex = 0;
 
     private:
         void initGLFW() const;
@@ -80,8 +140,17 @@ class Application {
         void initCamera();
 
         void initShaders();
+        void initWavefrontTracer();
+        void initVisibilityBuffer();
+        void initAccumulationBuffer();
+        void initSamplerBuffer();
+        void initDenoisingPass();
+        void initFrameUBO();
+        void updateFrameUBO() const;
         void initCallbacks();
         void initScene();
+        // adds the meshes loaded since the last frame
+        void insertLoadedMeshes();
 
         void initImgui();
 
@@ -92,9 +161,11 @@ class Application {
         void processInput() const;
 
         void drawOneFrame() const;
+        void drawTexture() const;
         void initRectangleVAO();
         void initTexture();
 
+        void updateAccumulation();
         void render();
         void drawImgui();
 
@@ -0,0 +1,119 @@
+#include "ringBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "errorHandler.hpp"
+
+namespace glr{
+
+RingBuffer::RingBuffer(GLsizeiptr sliceSize, uint32_t nbSlices){
+    GLint uniformAlignment = 0;
+    GLint storageAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+    _Alignment = std::max(std::max(uniformAlignment, storageAlignment), 1);
+    // each slice starts on an aligned offset
+    _SliceSize = (sliceSize + _Alignment - 1) / _Alignment * _Alignment;
+    _NbSlices = nbSlices;
+    _Fences = std::vector<GLsync>(nbSlices, nullptr);
+
+    glCreateBuffers(1, &_Id);
+    if(_Id == 0){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__, 
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to create the ring buffer!\n"
+        );
+    }
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glNamedBufferStorage(_Id, _SliceSize * _NbSlices, nullptr, flags);
+    _MappedData = static_cast<char*>(glMapNamedBufferRange(_Id, 0, _SliceSize * _NbSlices, flags));
+    if(_MappedData == nullptr){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__, 
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to map the ring buffer!\n"
+        );
+    }
+}
+
+RingBuffer::~RingBuffer(){
+    for(GLsync fence : _Fences){
+        if(fence != nullptr){
+            glDeleteSync(fence);
+        }
+    }
+    glUnmapNamedBuffer(_Id);
+    glDeleteBuffers(1, &_Id);
+}
+
+void RingBuffer::beginFrame(){
+    // the commands issued so far are the last ones to read the current slice
+    if(_Fences[_CurrentSlice] != nullptr){
+        glDeleteSync(_Fences[_CurrentSlice]);
+    }
+    _Fences[_CurrentSlice] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    _CurrentSlice = (_CurrentSlice + 1) % _NbSlices;
+    _CurrentOffset = 0;
+    GLsync fence = _Fences[_CurrentSlice];
+    if(fence == nullptr){
+        return;
+    }
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if(status == GL_TIMEOUT_EXPIRED){
+        _NbStalls++;
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+        } while(status == GL_TIMEOUT_EXPIRED);
+    }
+    if(status == GL_WAIT_FAILED){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__, 
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to wait for the ring buffer fence!\n"
+        );
+    }
+    glDeleteSync(fence);
+    _Fences[_CurrentSlice] = nullptr;
+}
+
+RingBufferAllocation RingBuffer::allocate(GLsizeiptr size){
+    GLsizeiptr offset = (_CurrentOffset + _Alignment - 1) / _Alignment * _Alignment;
+    if(offset + size > _SliceSize){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__, 
+            cr::ErrorCode::BAD_VALUE_ERROR,
+            "Ring buffer slice overflow!\n"
+        );
+    }
+    _CurrentOffset = offset + size;
+    GLintptr bufferOffset = _SliceSize * _CurrentSlice + offset;
+    return {_MappedData + bufferOffset, bufferOffset, size};
+}
+
+RingBufferAllocation RingBuffer::write(const void* data, GLsizeiptr size){
+    RingBufferAllocation allocation = allocate(size);
+    // coherent memory, the commands issued after this copy see it
+    std::memcpy(allocation._Data, data, size);
+    return allocation;
+}
+
+void RingBuffer::bind(GLenum target, GLuint binding, const RingBufferAllocation& allocation) const {
+    glBindBufferRange(target, binding, _Id, allocation._Offset, allocation._Size);
+}
+
+GLuint RingBuffer::getId() const {
+    return _Id;
+}
+
+uint32_t RingBuffer::getCurrentSlice() const {
+    return _CurrentSlice;
+}
+
+uint32_t RingBuffer::getNbStalls() const {
+    return _NbStalls;
+}
+
+}
\ No newline at end of file
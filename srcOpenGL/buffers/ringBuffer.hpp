@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <memory>
+#include <vector>
+
+namespace glr{
+
+class RingBuffer;
+using RingBufferPtr = std::shared_ptr<RingBuffer>;
+
+// part of the current slice, written by the cpu and read by the gpu
+struct RingBufferAllocation {
+    void* _Data = nullptr;
+    GLintptr _Offset = 0;
+    GLsizeiptr _Size = 0;
+};
+
+/**
+ * Buffer mapped once for good, split into slices used in turn, usually one per frame
+ * The cpu writes in the current slice while the gpu reads the previous ones, no copy and no implicit synchronisation
+ * A fence is put behind the commands of a slice when it is left, the slice is only written again once the fence is signaled
+*/
+class RingBuffer {
+    public:
+        // one slice written, one in flight and one being read by the gpu
+        static const uint32_t DEFAULT_NB_SLICES = 3;
+        // in nanoseconds, between two checks of a fence
+        static const GLuint64 FENCE_TIMEOUT = 1000000;
+
+    private:
+        GLuint _Id = 0;
+        char* _MappedData = nullptr;
+        GLsizeiptr _SliceSize = 0;
+        // offsets of the allocations fit both the uniform and the storage buffers
+        GLint _Alignment = 0;
+        uint32_t _NbSlices = 0;
+
+        uint32_t _CurrentSlice = 0;
+        GLsizeiptr _CurrentOffset = 0;
+        std::vector<GLsync> _Fences = {};
+
+        // number of slices the gpu was still reading when they were needed
+        uint32_t _NbStalls = 0;
+
+    public:
+        RingBuffer(GLsizeiptr sliceSize, uint32_t nbSlices = DEFAULT_NB_SLICES);
+        ~RingBuffer();
+
+    public:
+        // leaves the current slice and waits for the gpu to be done with the next one
+        void beginFrame();
+        // aligned part of the current slice, fails if the slice is full
+        RingBufferAllocation allocate(GLsizeiptr size);
+        // allocates and copies the data
+        RingBufferAllocation write(const void* data, GLsizeiptr size);
+        // target is GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER
+        void bind(GLenum target, GLuint binding, const RingBufferAllocation& allocation) const;
+
+        GLuint getId() const;
+        uint32_t getCurrentSlice() const;
+        uint32_t getNbStalls() const;
+};
+
+}
\ No newline at end of file
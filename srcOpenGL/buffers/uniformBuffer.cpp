@@ -0,0 +1,45 @@
+#include "uniformBuffer.hpp"
+
+#include "errorHandler.hpp"
+
+namespace glr{
+
+UniformBuffer::UniformBuffer(GLsizeiptr size, GLuint binding){
+    _Size = size;
+    _Binding = binding;
+    glCreateBuffers(1, &_Id);
+    if(_Id == 0){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__, 
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to create the uniform buffer!\n"
+        );
+    }
+    glNamedBufferStorage(_Id, _Size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    bind();
+}
+
+UniformBuffer::~UniformBuffer(){
+    glDeleteBuffers(1, &_Id);
+}
+
+void UniformBuffer::update(const void* data, GLsizeiptr size, GLintptr offset) const {
+    if(offset + size > _Size){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__, 
+            cr::ErrorCode::BAD_VALUE_ERROR,
+            "Uniform buffer update out of range!\n"
+        );
+    }
+    glNamedBufferSubData(_Id, offset, size, data);
+}
+
+void UniformBuffer::bind() const {
+    glBindBufferBase(GL_UNIFORM_BUFFER, _Binding, _Id);
+}
+
+GLuint UniformBuffer::getId() const {
+    return _Id;
+}
+
+}
\ No newline at end of file
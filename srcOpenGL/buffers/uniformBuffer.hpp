@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <memory>
+
+namespace glr{
+
+class UniformBuffer;
+using UniformBufferPtr = std::shared_ptr<UniformBuffer>;
+
+class UniformBuffer{
+    private:
+        GLuint _Id = 0;
+        GLuint _Binding = 0;
+        GLsizeiptr _Size = 0;
+
+    public:
+        UniformBuffer(GLsizeiptr size, GLuint binding);
+        ~UniformBuffer();
+
+    public:
+        void update(const void* data, GLsizeiptr size, GLintptr offset = 0) const;
+        void bind() const;
+        GLuint getId() const;
+};
+
+}
\ No newline at end of file
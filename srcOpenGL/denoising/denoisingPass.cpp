@@ -0,0 +1,150 @@
+#include "denoisingPass.hpp"
+
+#include "errorHandler.hpp"
+#include "shader.hpp"
+
+namespace glr{
+
+DenoisingPass::DenoisingPass(uint32_t width, uint32_t height){
+    _Width = width;
+    _Height = height;
+    initPrograms();
+    initTextures();
+}
+
+DenoisingPass::~DenoisingPass(){
+    glDeleteTextures(1, &_NormalDepthTexture);
+    glDeleteTextures(1, &_AlbedoTexture);
+    glDeleteTextures(2, _IlluminationTextures);
+    glDeleteQueries(1, &_TimerQuery);
+}
+
+void DenoisingPass::initPrograms(){
+    auto loadProgram = [&](const std::string& fileName){
+        ShaderPtr computeShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "denoising/" + fileName, COMPUTE_SHADER));
+        ProgramPtr program = ProgramPtr(new Program(computeShader));
+        glProgramUniform2ui(program->getId(), program->getLocation("uImageSize"), _Width, _Height);
+        return program;
+    };
+    _VarianceProgram = loadProgram("variance.glsl");
+    _FilterProgram = loadProgram("atrous.glsl");
+}
+
+void DenoisingPass::initTextures(){
+    glCreateTextures(GL_TEXTURE_2D, 1, &_NormalDepthTexture);
+    glCreateTextures(GL_TEXTURE_2D, 1, &_AlbedoTexture);
+    glCreateTextures(GL_TEXTURE_2D, 2, _IlluminationTextures);
+    glCreateQueries(GL_TIME_ELAPSED, 1, &_TimerQuery);
+    if(_NormalDepthTexture == 0 || _AlbedoTexture == 0
+        || _IlluminationTextures[0] == 0 || _IlluminationTextures[1] == 0 || _TimerQuery == 0){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to create the denoiser textures!\n"
+        );
+    }
+
+    glTextureStorage2D(_NormalDepthTexture, 1, GL_RGBA32F, _Width, _Height);
+    glTextureStorage2D(_AlbedoTexture, 1, GL_RGBA32F, _Width, _Height);
+    for(int i=0; i<2; i++){
+        glTextureStorage2D(_IlluminationTextures[i], 1, GL_RGBA32F, _Width, _Height);
+        // displayed as the traced image
+        glTextureParameteri(_IlluminationTextures[i], GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(_IlluminationTextures[i], GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(_IlluminationTextures[i], GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(_IlluminationTextures[i], GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    // written by the tracers for each sample
+    glBindImageTexture(NORMAL_DEPTH_IMAGE_UNIT, _NormalDepthTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    glBindImageTexture(ALBEDO_IMAGE_UNIT, _AlbedoTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+}
+
+void DenoisingPass::setUniforms(const ProgramPtr& program) const {
+    program->use();
+    program->setFloat("uLuminancePhi", _Parameters._LuminancePhi);
+    program->setFloat("uNormalPhi", _Parameters._NormalPhi);
+    program->setFloat("uDepthPhi", _Parameters._DepthPhi);
+}
+
+void DenoisingPass::swapIlluminations(){
+    // the last filtered texture is read and the other one written
+    glBindImageTexture(ILLUMINATION_IMAGE_UNIT, _IlluminationTextures[_Current], 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA32F);
+    glBindImageTexture(FILTERED_ILLUMINATION_IMAGE_UNIT, _IlluminationTextures[1 - _Current], 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+    _Current = 1 - _Current;
+}
+
+void DenoisingPass::readTimerQuery(){
+    if(!_IsTimerQueryPending){
+        return;
+    }
+    GLint isAvailable = GL_FALSE;
+    glGetQueryObjectiv(_TimerQuery, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+    if(isAvailable == GL_TRUE){
+        GLuint64 elapsedTime = 0;
+        glGetQueryObjectui64v(_TimerQuery, GL_QUERY_RESULT, &elapsedTime);
+        _DenoisingTime = static_cast<double>(elapsedTime) * 1e-6;
+        _IsTimerQueryPending = false;
+    }
+}
+
+void DenoisingPass::denoise(){
+    readTimerQuery();
+    bool isTimed = !_IsTimerQueryPending;
+    if(isTimed){
+        glBeginQuery(GL_TIME_ELAPSED, _TimerQuery);
+    }
+
+    uint32_t nbGroupsX = (_Width + 15) / 16;
+    uint32_t nbGroupsY = (_Height + 15) / 16;
+    glBindImageTexture(NORMAL_DEPTH_IMAGE_UNIT, _NormalDepthTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    glBindImageTexture(ALBEDO_IMAGE_UNIT, _AlbedoTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+
+    // the variance stage writes the first illumination texture, the last iteration puts the albedo back
+    _Current = 1;
+    swapIlluminations();
+    setUniforms(_VarianceProgram);
+    glDispatchCompute(nbGroupsX, nbGroupsY, 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    setUniforms(_FilterProgram);
+    for(uint32_t i=0; i<_Parameters._NbIterations; i++){
+        swapIlluminations();
+        _FilterProgram->setInt("uStepSize", 1 << i);
+        _FilterProgram->setBool("uIsLastIteration", i + 1 == _Parameters._NbIterations);
+        glDispatchCompute(nbGroupsX, nbGroupsY, 1);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+
+    if(isTimed){
+        glEndQuery(GL_TIME_ELAPSED);
+        _IsTimerQueryPending = true;
+    }
+    _IsUpToDate = true;
+    _DenoisedParameters = _Parameters;
+}
+
+void DenoisingPass::invalidate(){
+    _IsUpToDate = false;
+}
+
+bool DenoisingPass::isUpToDate() const {
+    return _IsUpToDate && _DenoisedParameters == _Parameters;
+}
+
+GLuint DenoisingPass::getTexture() const {
+    return _IlluminationTextures[_Current];
+}
+
+GLuint DenoisingPass::getNormalDepthTexture() const {
+    return _NormalDepthTexture;
+}
+
+GLuint DenoisingPass::getAlbedoTexture() const {
+    return _AlbedoTexture;
+}
+
+double DenoisingPass::getDenoisingTime() const {
+    return _DenoisingTime;
+}
+
+}
\ No newline at end of file
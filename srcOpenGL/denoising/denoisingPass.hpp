@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <glad/gl.h>
+#include <memory>
+
+#include "denoiser.hpp"
+#include "program.hpp"
+
+namespace glr{
+
+class DenoisingPass;
+using DenoisingPassPtr = std::shared_ptr<DenoisingPass>;
+
+/**
+ * Edge avoiding a-trous wavelet filter of the traced image, mirrors cr::Denoiser
+ * The tracers write the normal, depth and albedo of their primary hits in the guide images, cf shaders/common/denoising.glsl
+ * The image of image unit 0 is left as it is, the filtered one is another texture
+*/
+class DenoisingPass {
+    public:
+        cr::DenoiserParameters _Parameters = {._IsOn = true};
+
+    private:
+        static const GLuint NORMAL_DEPTH_IMAGE_UNIT = 4;
+        static const GLuint ALBEDO_IMAGE_UNIT = 5;
+        static const GLuint ILLUMINATION_IMAGE_UNIT = 6;
+        static const GLuint FILTERED_ILLUMINATION_IMAGE_UNIT = 7;
+
+        uint32_t _Width = 0;
+        uint32_t _Height = 0;
+
+        ProgramPtr _VarianceProgram = nullptr;
+        ProgramPtr _FilterProgram = nullptr;
+        GLuint _NormalDepthTexture = 0;
+        GLuint _AlbedoTexture = 0;
+        // ping pong textures of the iterations
+        GLuint _IlluminationTextures[2] = {0, 0};
+        uint32_t _Current = 0;
+
+        // the filtered texture matches the traced image and these parameters
+        bool _IsUpToDate = false;
+        cr::DenoiserParameters _DenoisedParameters = {};
+
+        // the time of a call is read back once available, the pipeline is never stalled
+        GLuint _TimerQuery = 0;
+        bool _IsTimerQueryPending = false;
+        double _DenoisingTime = 0.; // in milliseconds
+
+    public:
+        DenoisingPass(uint32_t width, uint32_t height);
+        ~DenoisingPass();
+
+    public:
+        // filters the image of image unit 0 with the guides of the last traced frame
+        void denoise();
+        // the traced image changed without being denoised
+        void invalidate();
+        bool isUpToDate() const;
+
+        // rgba32f filtered image, only a color after at least one iteration
+        GLuint getTexture() const;
+        GLuint getNormalDepthTexture() const;
+        GLuint getAlbedoTexture() const;
+        // GPU time of a recent call
+        double getDenoisingTime() const;
+
+    private:
+        void initPrograms();
+        void initTextures();
+        void setUniforms(const ProgramPtr& program) const;
+        void swapIlluminations();
+        void readTimerQuery();
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "visibilityBuffer.hpp"
+
+#include "errorHandler.hpp"
+#include "shader.hpp"
+
+namespace glr{
+
+VisibilityBuffer::VisibilityBuffer(uint32_t width, uint32_t height){
+    _Width = width;
+    _Height = height;
+    initProgram();
+    initFramebuffer();
+}
+
+VisibilityBuffer::~VisibilityBuffer(){
+    glDeleteFramebuffers(1, &_Framebuffer);
+    glDeleteTextures(1, &_VisibilityTexture);
+    glDeleteRenderbuffers(1, &_DepthRenderbuffer);
+    glDeleteVertexArrays(1, &_EmptyVao);
+}
+
+void VisibilityBuffer::initProgram(){
+    ShaderPtr vertexShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "visibility.vert", VERTEX_SHADER));
+    ShaderPtr fragmentShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "visibility.frag", FRAGMENT_SHADER));
+    _RasterProgram = ProgramPtr(new Program(vertexShader, fragmentShader));
+    glProgramUniform2ui(_RasterProgram->getId(), _RasterProgram->getLocation("uImageSize"), _Width, _Height);
+}
+
+void VisibilityBuffer::initFramebuffer(){
+    glCreateFramebuffers(1, &_Framebuffer);
+    glCreateTextures(GL_TEXTURE_2D, 1, &_VisibilityTexture);
+    glCreateRenderbuffers(1, &_DepthRenderbuffer);
+    glCreateVertexArrays(1, &_EmptyVao);
+    if(_Framebuffer == 0 || _VisibilityTexture == 0 || _DepthRenderbuffer == 0 || _EmptyVao == 0){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to create the visibility buffer!\n"
+        );
+    }
+
+    glTextureStorage2D(_VisibilityTexture, 1, GL_RGBA32UI, _Width, _Height);
+    glNamedRenderbufferStorage(_DepthRenderbuffer, GL_DEPTH_COMPONENT32F, _Width, _Height);
+    glNamedFramebufferTexture(_Framebuffer, GL_COLOR_ATTACHMENT0, _VisibilityTexture, 0);
+    glNamedFramebufferRenderbuffer(_Framebuffer, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _DepthRenderbuffer);
+
+    if(glCheckNamedFramebufferStatus(_Framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::OPENGL_ERROR,
+            "The visibility framebuffer is incomplete!\n"
+        );
+    }
+}
+
+void VisibilityBuffer::render(const std::vector<cr::MeshModelGPU>& instances) const {
+    // 0 means that no triangle is visible
+    const GLuint CLEAR_VISIBILITY[4] = {0, 0, 0, 0};
+    const GLfloat CLEAR_DEPTH = 1.f;
+    glClearNamedFramebufferuiv(_Framebuffer, GL_COLOR, 0, CLEAR_VISIBILITY);
+    glClearNamedFramebufferfv(_Framebuffer, GL_DEPTH, 0, &CLEAR_DEPTH);
+
+    GLint viewport[4] = {0, 0, 0, 0};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, _Framebuffer);
+    glViewport(0, 0, _Width, _Height);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    // the traced triangles are double sided
+    glDisable(GL_CULL_FACE);
+
+    _RasterProgram->use();
+    glBindVertexArray(_EmptyVao);
+    // one draw per instance over the triangles of its mesh, the base instance tells the shader which one it is
+    for(size_t i=0; i<instances.size(); i++){
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 3 * instances[i]._FirstTriangle, 3 * instances[i]._NbTriangles, 1, i);
+    }
+    glBindVertexArray(0);
+
+    glDisable(GL_DEPTH_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    glBindImageTexture(IMAGE_UNIT, _VisibilityTexture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA32UI);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+}
+
+GLuint VisibilityBuffer::getTexture() const {
+    return _VisibilityTexture;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <glad/gl.h>
+#include <memory>
+#include <vector>
+
+#include "program.hpp"
+#include "mesh.hpp"
+
+namespace glr{
+
+class VisibilityBuffer;
+using VisibilityBufferPtr = std::shared_ptr<VisibilityBuffer>;
+
+/**
+ * Primary visibility rasterised from the scene buffers
+ * Each texel stores the visible triangle, its barycentrics and its instance, cf shaders/common/visibility.glsl
+*/
+class VisibilityBuffer {
+    public:
+        static const GLuint IMAGE_UNIT = 1;
+
+    private:
+        uint32_t _Width = 0;
+        uint32_t _Height = 0;
+
+        ProgramPtr _RasterProgram = nullptr;
+
+        GLuint _Framebuffer = 0;
+        GLuint _VisibilityTexture = 0;
+        GLuint _DepthRenderbuffer = 0;
+        // the vertices are pulled from the storage buffers
+        GLuint _EmptyVao = 0;
+
+    public:
+        VisibilityBuffer(uint32_t width, uint32_t height);
+        ~VisibilityBuffer();
+
+    public:
+        // rasterises the triangles of each instance of the scene storage buffers and binds the result to IMAGE_UNIT
+        void render(const std::vector<cr::MeshModelGPU>& instances) const;
+        GLuint getTexture() const;
+
+    private:
+        void initProgram();
+        void initFramebuffer();
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "samplerBuffer.hpp"
+
+#include <vector>
+
+#include "errorHandler.hpp"
+
+namespace glr{
+
+SamplerBuffer::SamplerBuffer(cr::SamplerPtr sampler){
+    _Sampler = sampler;
+    glCreateBuffers(1, &_SSBO);
+    if(_SSBO == 0){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to create the sampler buffer!\n"
+        );
+    }
+    std::vector<uint32_t> data = _Sampler->getGpuData();
+    glNamedBufferStorage(_SSBO, sizeof(uint32_t) * data.size(), data.data(), GL_DYNAMIC_STORAGE_BIT);
+    bind();
+}
+
+SamplerBuffer::~SamplerBuffer(){
+    glDeleteBuffers(1, &_SSBO);
+}
+
+void SamplerBuffer::update() const {
+    uint32_t samplers[cr::Sampler::MAX_NB_DIMENSIONS];
+    for(uint32_t dimension=0; dimension<cr::Sampler::MAX_NB_DIMENSIONS; dimension++){
+        samplers[dimension] = static_cast<uint32_t>(_Sampler->getSamplerType(dimension));
+    }
+    GLintptr offset = sizeof(uint32_t) * cr::Sampler::GPU_DIMENSION_SAMPLERS_OFFSET;
+    glNamedBufferSubData(_SSBO, offset, sizeof(samplers), samplers);
+}
+
+void SamplerBuffer::bind() const {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING, _SSBO);
+}
+
+cr::SamplerPtr SamplerBuffer::getSampler() const {
+    return _Sampler;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <memory>
+
+#include "sampler.hpp"
+
+namespace glr{
+
+class SamplerBuffer;
+using SamplerBufferPtr = std::shared_ptr<SamplerBuffer>;
+
+/**
+ * Tables of a cr::Sampler read by shaders/common/sampling.glsl
+ * They are uploaded once, only the sampler of each dimension can change afterwards
+*/
+class SamplerBuffer {
+    private:
+        // out of the range used by the other kernels
+        static const GLuint BINDING = 18;
+
+        cr::SamplerPtr _Sampler = nullptr;
+        GLuint _SSBO = 0;
+
+    public:
+        SamplerBuffer(cr::SamplerPtr sampler);
+        ~SamplerBuffer();
+
+    public:
+        // sends the sampler of each dimension again
+        void update() const;
+        void bind() const;
+        cr::SamplerPtr getSampler() const;
+};
+
+}
\ No newline at end of file
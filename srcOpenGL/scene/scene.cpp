@@ -1,6 +1,7 @@
 #include "scene.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 
 #define GLM_ENABLE_EXPERIMENTAL
@@ -14,73 +15,276 @@ Scene::Scene(){
     createSSBO();
 }
 
-std::vector<cr::MeshModelGPU> Scene::getMeshModelToGPUData() const {
-    std::vector<cr::MeshModelGPU> modelsGPU = std::vector<cr::MeshModelGPU>(cr::Mesh::MAX_NB_MESHES);
-    for(size_t i=0; i<std::min(_Meshes.size(), cr::Mesh::MAX_NB_MESHES); i++){
-        modelsGPU[i] = _Meshes[i]->_InternalStruct;
+bool DirtyRange::isEmpty() const {
+    return _Begin >= _End;
+}
+
+void DirtyRange::add(size_t begin, size_t end){
+    if(isEmpty()){
+        _Begin = begin;
+        _End = end;
+        return;
     }
-    return modelsGPU;
+    _Begin = std::min(_Begin, begin);
+    _End = std::max(_End, end);
 }
 
+void DirtyRange::clear(){
+    _Begin = 0;
+    _End = 0;
+}
 
-std::vector<cr::TriangleGPU> Scene::getTriangleToGPUData() const {
-    std::vector<cr::TriangleGPU> trianglesGPU = std::vector<cr::TriangleGPU>(cr::Triangle::MAX_NB_TRIANGLES);
-    uint32_t i = 0;
-    for(cr::MeshPtr mesh : _Meshes){
-        for(cr::Triangle triangle : mesh->_Triangles){
-            if(i == cr::Triangle::MAX_NB_TRIANGLES){
-                break;
-            }
-            trianglesGPU[i] = triangle._InternalStruct;
-            i++;
-        }  
-    }
-    
-    return trianglesGPU;
+const std::vector<cr::MeshModelGPU>& Scene::getMeshModelToGPUData() const {
+    return _MeshModelsGPU;
 }
 
-std::vector<cr::MaterialGPU> Scene::getMaterialToGPUData() const {
-    std::vector<cr::MaterialGPU> materialGPU = std::vector<cr::MaterialGPU>(cr::Material::MAX_NB_MATERIALS);
-    for(size_t i=0; i<std::min(_Materials.size(), cr::Material::MAX_NB_MATERIALS); i++){
-        materialGPU[i] = _Materials[i]._InternalStruct;
-    }
-    return materialGPU;
+const std::vector<cr::TriangleGPU>& Scene::getTriangleToGPUData() const {
+    return _Geometry.getTriangles();
+}
+
+const std::vector<glm::vec3>& Scene::getVertexToGPUData() const {
+    return _Geometry.getVertices();
+}
+
+const std::vector<cr::MaterialGPU>& Scene::getMaterialToGPUData() const {
+    return _MaterialsGPU;
 }
 
 void Scene::addMesh(cr::MeshPtr mesh){
-    if(_Meshes.size() == cr::Mesh::MAX_NB_MESHES) return;
+    addInstance(mesh, mesh->_InternalStruct._ModelMatrix, mesh->_InternalStruct._MaterialId);
+}
+
+int32_t Scene::addMeshGeometry(cr::MeshPtr mesh, cr::BVH_Ptr meshBVH){
+    if(_Meshes.size() == cr::Mesh::MAX_NB_MESHES || mesh->getNbTriangles() == 0) return -1;
+    if(!_Geometry.canFit(*mesh)){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::BAD_VALUE_ERROR,
+            "Too many vertices or triangles in the scene, the mesh is ignored!\n",
+            cr::ErrorLevel::WARNING
+        );
+        return -1;
+    }
+    uint32_t meshIndex = _NbMeshes;
+    cr::GeometryRange range = _Geometry.append(*mesh, meshIndex);
     _Meshes.push_back(mesh);
+    _MeshRanges.push_back(range);
     _NbMeshes++;
-    _NbTriangles += std::min(mesh->_Triangles.size(), cr::Triangle::MAX_NB_TRIANGLES);
+    _DirtyVertices.add(range._FirstVertex, range._FirstVertex + range._NbVertices);
+    _DirtyTriangles.add(range._FirstTriangle, range._FirstTriangle + range._NbTriangles);
+
+    // the bottom level bvh has 2n-1 nodes, its place in the buffer never changes
+    _MeshFirstNodes.push_back(_BLAS_NodesGPU.size());
+    _BLAS_NodesGPU.resize(_BLAS_NodesGPU.size() + 2 * range._NbTriangles - 1);
+    _MeshBoxes.push_back(cr::AABB_GPU());
+    if(meshBVH != nullptr){
+        setMeshBVH(meshIndex, meshBVH);
+    } else {
+        _DirtyMeshBVHs.push_back(meshIndex);
+    }
+    return meshIndex;
+}
+
+void Scene::addInstance(cr::MeshPtr mesh, const glm::mat4& model, uint32_t materialId, uint32_t parentNode){
+    addInstance(mesh, nullptr, model, materialId, parentNode);
+}
+
+void Scene::addInstance(cr::MeshPtr mesh, cr::BVH_Ptr meshBVH, const glm::mat4& model, uint32_t materialId, uint32_t parentNode){
+    if(_NbInstances == cr::Mesh::MAX_NB_INSTANCES) return;
+    auto it = std::find(_Meshes.begin(), _Meshes.end(), mesh);
+    int32_t meshIndex = it != _Meshes.end() ? it - _Meshes.begin() : addMeshGeometry(mesh, meshBVH);
+    if(meshIndex < 0) return;
+
+    // the model matrices are written from the graph at the next upload
+    uint32_t node = _Graph.addNode(model, parentNode);
+    _NodeInstances.push_back(_NbInstances);
+    _InstanceNodes.push_back(node);
+    cr::MeshModelGPU instance{};
+    instance._MaterialId = materialId;
+    instance._BVH_Root = TLAS_NB_NODES + _MeshFirstNodes[meshIndex];
+    instance._FirstTriangle = _MeshRanges[meshIndex]._FirstTriangle;
+    instance._NbTriangles = _MeshRanges[meshIndex]._NbTriangles;
+    _MeshModelsGPU.push_back(instance);
+    _InstanceMeshes.push_back(meshIndex);
+    _NbInstances++;
+    _AreMeshModelsDirty = true;
+    _IsTLAS_Dirty = true;
+    _Version++;
+}
+
+uint32_t Scene::addGroup(const glm::mat4& model, uint32_t parentNode){
+    uint32_t node = _Graph.addNode(model, parentNode);
+    _NodeInstances.push_back(NO_INSTANCE);
+    _Version++;
+    return node;
 }
 
 void Scene::addMaterial(const glm::vec4& color){
     if(_Materials.size() == cr::Material::MAX_NB_MATERIALS) return;
     _Materials.emplace_back(color);
+    _MaterialsGPU.push_back(_Materials.back()._InternalStruct);
+    _DirtyMaterials.add(_NbMaterials, _NbMaterials + 1);
     _NbMaterials++;
+    _Version++;
 }
 
 void Scene::addRandomMaterial(){
     if(_Materials.size() == cr::Material::MAX_NB_MATERIALS) return;
     _Materials.emplace_back();
+    _MaterialsGPU.push_back(_Materials.back()._InternalStruct);
+    _DirtyMaterials.add(_NbMaterials, _NbMaterials + 1);
     _NbMaterials++;
+    _Version++;
+}
+
+void Scene::checkMeshIndex(uint32_t meshIndex) const {
+    if(meshIndex >= _NbMeshes){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::BAD_VALUE_ERROR,
+            "The mesh " + std::to_string(meshIndex) + " is not in the scene!\n"
+        );
+    }
+}
+
+void Scene::checkInstanceIndex(uint32_t instanceIndex) const {
+    if(instanceIndex >= _NbInstances){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::BAD_VALUE_ERROR,
+            "The instance " + std::to_string(instanceIndex) + " is not in the scene!\n"
+        );
+    }
+}
+
+void Scene::checkMaterialId(uint32_t materialId) const {
+    if(materialId >= _NbMaterials){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::BAD_VALUE_ERROR,
+            "The material " + std::to_string(materialId) + " is not in the scene!\n"
+        );
+    }
+}
+
+cr::MeshPtr Scene::getMesh(uint32_t meshIndex) const {
+    checkMeshIndex(meshIndex);
+    return _Meshes[meshIndex];
+}
+
+const glm::vec4& Scene::getMaterialColor(uint32_t materialId) const {
+    checkMaterialId(materialId);
+    return _MaterialsGPU[materialId]._Color;
+}
+
+void Scene::setMaterialColor(uint32_t materialId, const glm::vec4& color){
+    checkMaterialId(materialId);
+    _Materials[materialId]._InternalStruct._Color = color;
+    _MaterialsGPU[materialId]._Color = color;
+    _DirtyMaterials.add(materialId, materialId + 1);
+    _Version++;
+}
+
+void Scene::setNodeModel(uint32_t node, const glm::mat4& model){
+    // the instances below are updated at the next upload
+    _Graph.setLocalMatrix(node, model);
+    _Version++;
+}
+
+void Scene::setInstanceModel(uint32_t instanceIndex, const glm::mat4& model){
+    checkInstanceIndex(instanceIndex);
+    setNodeModel(_InstanceNodes[instanceIndex], model);
+}
+
+void Scene::updateInstanceModels(){
+    if(!_Graph.isDirty()){
+        return;
+    }
+    for(uint32_t node : _Graph.updateWorldMatrices()){
+        uint32_t instanceIndex = _NodeInstances[node];
+        if(instanceIndex == NO_INSTANCE){
+            continue;
+        }
+        const glm::mat4& model = _Graph.getWorldMatrix(node);
+        _MeshModelsGPU[instanceIndex]._ModelMatrix = model;
+        _MeshModelsGPU[instanceIndex]._InvModelMatrix = glm::inverse(model);
+        _AreMeshModelsDirty = true;
+        // only the top level bvh is in world space
+        _IsTLAS_Dirty = true;
+    }
+}
+
+void Scene::setInstanceMaterial(uint32_t instanceIndex, uint32_t materialId){
+    checkInstanceIndex(instanceIndex);
+    checkMaterialId(materialId);
+    _MeshModelsGPU[instanceIndex]._MaterialId = materialId;
+    _AreMeshModelsDirty = true;
+    _Version++;
+}
+
+void Scene::updateMeshVertices(uint32_t meshIndex){
+    checkMeshIndex(meshIndex);
+    const cr::GeometryRange& range = _MeshRanges[meshIndex];
+    _Geometry.updateVertices(range, *_Meshes[meshIndex]);
+    _DirtyVertices.add(range._FirstVertex, range._FirstVertex + range._NbVertices);
+    if(std::find(_DirtyMeshBVHs.begin(), _DirtyMeshBVHs.end(), meshIndex) == _DirtyMeshBVHs.end()){
+        _DirtyMeshBVHs.push_back(meshIndex);
+    }
+    // the box of the mesh may have changed
+    _IsTLAS_Dirty = true;
+    _Version++;
+}
+
+void Scene::buildBLAS(uint32_t meshIndex){
+    const cr::GeometryRange& range = _MeshRanges[meshIndex];
+    cr::BVH_Ptr bvh = cr::BVH::buildBottomLevel(_Geometry.getTriangles(), range._FirstTriangle, range._NbTriangles, _Geometry.getVertices());
+    setMeshBVH(meshIndex, bvh);
+    _Statistics._NbBLAS_Builds++;
+}
+
+void Scene::setMeshBVH(uint32_t meshIndex, const cr::BVH_Ptr& bvh){
+    // the leaves of the mesh refer to its triangles from the first one
+    const cr::GeometryRange& range = _MeshRanges[meshIndex];
+    _MeshBoxes[meshIndex] = bvh->getRootAABB();
+    uint32_t firstNode = _MeshFirstNodes[meshIndex];
+    std::vector<cr::BVH_NodeGPU> nodes = bvh->getFlattenedNodes(TLAS_NB_NODES + firstNode, range._FirstTriangle);
+    std::copy(nodes.begin(), nodes.end(), _BLAS_NodesGPU.begin() + firstNode);
+    _DirtyBLAS_Nodes.add(firstNode, firstNode + nodes.size());
+}
+
+void Scene::buildTLAS(){
+    std::vector<cr::AABB_GPU> modelBoxes(_NbInstances);
+    for(uint32_t i=0; i<_NbInstances; i++){
+        modelBoxes[i] = _MeshBoxes[_InstanceMeshes[i]];
+    }
+    _TLAS_NodesGPU = cr::BVH::buildTopLevel(_MeshModelsGPU, _NbInstances, modelBoxes)->getFlattenedNodes();
+    _Statistics._NbTLAS_Builds++;
+}
+
+uint32_t Scene::getVersion() const {
+    return _Version;
+}
+
+bool Scene::isDirty() const {
+    return !_DirtyVertices.isEmpty() || !_DirtyTriangles.isEmpty() || !_DirtyMaterials.isEmpty() 
+        || _AreMeshModelsDirty || !_DirtyMeshBVHs.empty() || _IsTLAS_Dirty || _Graph.isDirty();
 }
 
 void Scene::createSSBO(){
     glCreateBuffers(1, &_MaterialsSSBO);
     glCreateBuffers(1, &_TrianglesSSBO);
-    glCreateBuffers(1, &_MeshModelsSSBO);
+    glCreateBuffers(1, &_VerticesSSBO);
     glCreateBuffers(1, &_BVH_SSBO);
     assert(_MaterialsSSBO != 0);
     assert(_TrianglesSSBO != 0);
-    assert(_MeshModelsSSBO != 0);
+    assert(_VerticesSSBO != 0);
     assert(_BVH_SSBO != 0);
 
     // Calculate the total size of the buffer
     size_t materialsSize = sizeof(cr::MaterialGPU) * cr::Material::MAX_NB_MATERIALS;
     size_t trianglesSize = sizeof(cr::TriangleGPU) * cr::Triangle::MAX_NB_TRIANGLES;
-    size_t modelsSize = sizeof(cr::MeshModelGPU) * cr::Mesh::MAX_NB_MESHES;
-    size_t bvhSize = (sizeof(cr::BVH_NodeGPU) * ((2*cr::Triangle::MAX_NB_TRIANGLES)-1)) + (sizeof(uint32_t) * cr::Triangle::MAX_NB_TRIANGLES);
+    size_t verticesSize = sizeof(glm::vec3) * cr::Triangle::MAX_NB_VERTICES;
+    size_t bvhSize = sizeof(cr::BVH_NodeGPU) * (TLAS_NB_NODES + (2*cr::Triangle::MAX_NB_TRIANGLES)-1);
 
     glNamedBufferStorage(_MaterialsSSBO, 
                     materialsSize, 
@@ -94,12 +298,15 @@ void Scene::createSSBO(){
                     GL_DYNAMIC_STORAGE_BIT
     );
 
-    glNamedBufferStorage(_MeshModelsSSBO, 
-                    modelsSize, 
+    glNamedBufferStorage(_VerticesSSBO, 
+                    verticesSize, 
                     nullptr, 
                     GL_DYNAMIC_STORAGE_BIT
     );
 
+    // the models are written whole in each slice
+    _MeshModelsRingBuffer = RingBufferPtr(new RingBuffer(sizeof(cr::MeshModelGPU) * cr::Mesh::MAX_NB_INSTANCES));
+
     glNamedBufferStorage(_BVH_SSBO,
                     bvhSize,
                     nullptr,
@@ -107,72 +314,78 @@ void Scene::createSSBO(){
     );
 }
 
+size_t Scene::updateSSBO(){
+    size_t uploadedBytes = 0;
+    auto upload = [&](GLuint ssbo, DirtyRange& range, const void* data, size_t elementSize){
+        if(range.isEmpty()){
+            return;
+        }
+        GLintptr offset = elementSize * range._Begin;
+        GLsizeiptr size = elementSize * (range._End - range._Begin);
+        glNamedBufferSubData(ssbo,
+            offset,
+            size,
+            static_cast<const char*>(data) + offset
+        );
+        uploadedBytes += size;
+        range.clear();
+    };
+    upload(_MaterialsSSBO, _DirtyMaterials, _MaterialsGPU.data(), sizeof(cr::MaterialGPU));
+    upload(_TrianglesSSBO, _DirtyTriangles, _Geometry.getTriangles().data(), sizeof(cr::TriangleGPU));
+    upload(_VerticesSSBO, _DirtyVertices, _Geometry.getVertices().data(), sizeof(glm::vec3));
+
+    // the slices still read by the gpu are left as they are
+    updateInstanceModels();
+    if(_AreMeshModelsDirty){
+        _MeshModelsRingBuffer->beginFrame();
+        _MeshModelsAllocation = _MeshModelsRingBuffer->write(_MeshModelsGPU.data(), sizeof(cr::MeshModelGPU) * _NbInstances);
+        uploadedBytes += _MeshModelsAllocation._Size;
+        _AreMeshModelsDirty = false;
+    }
+
+    // bottom level bvh of the meshes whose geometry changed, at their place after the top level one
+    for(uint32_t meshIndex : _DirtyMeshBVHs){
+        buildBLAS(meshIndex);
+    }
+    _DirtyMeshBVHs.clear();
+    if(!_DirtyBLAS_Nodes.isEmpty()){
+        GLsizeiptr size = sizeof(cr::BVH_NodeGPU) * (_DirtyBLAS_Nodes._End - _DirtyBLAS_Nodes._Begin);
+        glNamedBufferSubData(_BVH_SSBO,
+            sizeof(cr::BVH_NodeGPU) * (TLAS_NB_NODES + _DirtyBLAS_Nodes._Begin),
+            size,
+            _BLAS_NodesGPU.data() + _DirtyBLAS_Nodes._Begin
+        );
+        uploadedBytes += size;
+        _DirtyBLAS_Nodes.clear();
+    }
+
+    // top level bvh, the only one to build when the instances move
+    if(_IsTLAS_Dirty && _NbInstances > 0){
+        buildTLAS();
+        GLsizeiptr size = sizeof(cr::BVH_NodeGPU) * _TLAS_NodesGPU.size();
+        glNamedBufferSubData(_BVH_SSBO, 
+            0, 
+            size, 
+            _TLAS_NodesGPU.data()
+        );
+        uploadedBytes += size;
+    }
+    _IsTLAS_Dirty = false;
+    return uploadedBytes;
+}
+
 void Scene::bindSSBO(){
-    // materials
+    GLuint verticesBinding = 1;
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, verticesBinding, _VerticesSSBO);
     GLuint materialsBinding = 2;
-    auto materialGPU = getMaterialToGPUData();
-    GLsizeiptr materialsSize = sizeof(cr::MaterialGPU) * _NbMaterials;
-    // update the materials
-    glNamedBufferSubData(_MaterialsSSBO,
-        0,
-        materialsSize,
-        materialGPU.data()
-    );
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, materialsBinding, _MaterialsSSBO);
-
-    // triangles
     GLuint trianglesBinding = 3;
-    auto triangleGPU = getTriangleToGPUData();
-    GLsizeiptr trianglesSize = sizeof(cr::TriangleGPU) * _NbTriangles;
-    // update the materials
-    glNamedBufferSubData(_TrianglesSSBO,
-        0,
-        trianglesSize,
-        triangleGPU.data()
-    );
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, trianglesBinding, _TrianglesSSBO);
-
-    // models
     GLuint modelsBinding = 4;
-    auto modelsGPU = getMeshModelToGPUData();
-    GLsizeiptr modelsSize = sizeof(cr::MeshModelGPU) * _NbMeshes;
-    // update the materials
-    glNamedBufferSubData(_MeshModelsSSBO,
-        0,
-        modelsSize,
-        modelsGPU.data()
-    );
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, modelsBinding, _MeshModelsSSBO);
-
-    // bvh
-    _BVH = cr::BVH_Ptr(new cr::BVH(_NbTriangles, triangleGPU, modelsGPU));
-    // _BVH->_InternalStruct.printIsLeaf();
-    // _BVH->_InternalStruct.printLeftChild();
-    // _BVH->_InternalStruct.printRightChild();
-    // _BVH->_InternalStruct.printParent();
-    // _BVH->_InternalStruct.printTriangleIndices();
-    // _BVH->_InternalStruct.printClusters();
+    if(_MeshModelsAllocation._Size > 0){
+        _MeshModelsRingBuffer->bind(GL_SHADER_STORAGE_BUFFER, modelsBinding, _MeshModelsAllocation);
+    }
     GLuint bvhBinding = 5;
-    auto bvhNodesGPU = getBVH_NodesToGPUData(_BVH);
-    // fprintf(stdout, "to send to the GPU:\n");
-    // for(auto node : bvhNodesGPU){
-    //     fprintf(
-    //         stdout,
-    //         "{leftChild: %u, rightChild: %u, triId: %u, aabb: (%s, %s)}\n",
-    //         node._LeftChild,
-    //         node._RightChild,
-    //         node._TriangleId,
-    //         glm::to_string(node._BoundingBox._Min).c_str(),
-    //         glm::to_string(node._BoundingBox._Max).c_str()
-    //     );
-    // }
-    // exit(EXIT_SUCCESS);
-    GLsizeiptr bvhNodesSize = sizeof(cr::BVH_NodeGPU) * bvhNodesGPU.size();
-    glNamedBufferSubData(_BVH_SSBO, 
-        0, 
-        bvhNodesSize, 
-        bvhNodesGPU.data()
-    );
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bvhBinding, _BVH_SSBO);
 
     // tests
@@ -186,37 +399,45 @@ void Scene::bindSSBO(){
     }
 }
 
-void Scene::recursiveTopDownTraversalBVH(std::vector<cr::BVH_NodeGPU>& bvhNodesGPU, cr::BVH_Ptr bvh, uint32_t nodeId) const {
-    cr::BVH_NodeGPU curNode = bvh->_InternalStruct._Clusters[nodeId].value();
-    uint32_t position = bvhNodesGPU.size();
-    bvhNodesGPU.push_back(curNode);
-    if(!bvh->_InternalStruct._IsLeaf[nodeId]){
-        uint32_t leftChildId = bvh->_InternalStruct._LeftChild[nodeId].value();
-        bvhNodesGPU[position]._LeftChild = bvhNodesGPU.size();
-        recursiveTopDownTraversalBVH(bvhNodesGPU, bvh, leftChildId);
-        uint32_t rightChildId = bvh->_InternalStruct._RightChild[nodeId].value();
-        bvhNodesGPU[position]._RightChild = bvhNodesGPU.size();
-        recursiveTopDownTraversalBVH(bvhNodesGPU, bvh, rightChildId);
-    }
+uint32_t Scene::getNbTriangles() const {
+    return _Geometry.getNbTriangles();
+}
+
+uint32_t Scene::getNbMaterials() const {
+    return _NbMaterials;
+}
+
+uint32_t Scene::getNbMeshes() const {
+    return _NbMeshes;
+}
+
+uint32_t Scene::getNbInstances() const {
+    return _NbInstances;
+}
+
+uint32_t Scene::getInstanceNode(uint32_t instanceIndex) const {
+    checkInstanceIndex(instanceIndex);
+    return _InstanceNodes[instanceIndex];
 }
 
-std::vector<cr::BVH_NodeGPU> Scene::getBVH_NodesToGPUData(cr::BVH_Ptr bvh) const{
-    std::vector<cr::BVH_NodeGPU> bvhNodesGPU = std::vector<cr::BVH_NodeGPU>();
-    uint32_t rootId = 2*_NbTriangles - 2;
-    recursiveTopDownTraversalBVH(bvhNodesGPU, bvh, rootId);
-    return bvhNodesGPU;
+const cr::SceneGraph& Scene::getGraph() const {
+    return _Graph;
 }
 
 void Scene::sendDataToGpu(ProgramPtr program){
+    auto start = std::chrono::steady_clock::now();
     program->use();
-    // bind the SSBOs
+    // only the changes since the last call are sent
+    _Statistics._UploadedBytes = updateSSBO();
     bindSSBO();
     // Set the number of elements
-    program->setUInt("uNbTriangles", _NbTriangles);
+    program->setUInt("uNbTriangles", _Geometry.getNbTriangles());
     program->setUInt("uNbMaterials", _NbMaterials);
-    program->setUInt("uNbModels", _NbMeshes);
+    program->setUInt("uNbModels", _NbInstances);
 
     glUseProgram(0);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    _Statistics._UploadTime = elapsed.count();
 }
 
 }
\ No newline at end of file
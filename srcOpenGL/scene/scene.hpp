@@ -4,11 +4,14 @@
 #include <array>
 
 #include "program.hpp"
+#include "ringBuffer.hpp"
 
 #include "triangle.hpp"
 #include "material.hpp"
 #include "mesh.hpp"
 #include "bvh.hpp"
+#include "geometryArena.hpp"
+#include "sceneGraph.hpp"
 
 #include <glad/gl.h>
 
@@ -19,7 +22,43 @@ namespace glr{
 class Scene;
 using ScenePtr = std::shared_ptr<Scene>;
 
+// elements [_Begin, _End) of a buffer changed since the last upload
+struct DirtyRange {
+    size_t _Begin = 0;
+    size_t _End = 0;
+
+    bool isEmpty() const;
+    // grows to cover both ranges, the elements in between are uploaded again
+    void add(size_t begin, size_t end);
+    void clear();
+};
+
+struct SceneStatistics {
+    // bytes sent by the last call to sendDataToGpu
+    size_t _UploadedBytes = 0;
+    // in milliseconds, cpu side of the last call to sendDataToGpu
+    double _UploadTime = 0.;
+    // the bvh of a mesh is only built when its geometry changes, the top level one when an instance moves
+    uint32_t _NbBLAS_Builds = 0;
+    uint32_t _NbTLAS_Builds = 0;
+};
+
+/**
+ * Scene stored in shader storage buffers at bindings 1 to 5, mirrors shaders/common/scene.glsl
+ * The buffers keep a cpu copy, the edits only mark the elements they change and sendDataToGpu uploads these ranges
+ * The geometry of a mesh is stored once, the instances place it with their own transform and material
+ * Each instance is a node of a scene graph, its model is the world matrix of the node
+ * The transforms change the most, they are written in a new slice of a ring buffer instead
+ * The bvh has two levels in the same buffer, a top level one over the instances in a region of fixed size
+ * followed by the bottom level ones of the meshes, cf shaders/common/traversal.glsl
+*/
 class Scene{
+    public:
+        SceneStatistics _Statistics = {};
+        // nodes reserved at the beginning of the bvh buffer for the top level bvh
+        static const size_t TLAS_NB_NODES = 2*cr::Mesh::MAX_NB_INSTANCES - 1;
+        static const uint32_t NO_INSTANCE = 0xFFFFFFFF;
+
     private:
         std::vector<cr::Material> _Materials = {cr::Material()}; // always one default material
         std::vector<cr::MeshPtr> _Meshes = {};
@@ -27,38 +66,111 @@ class Scene{
         uint32_t _MaterialIdGenerator = 0;
         
         GLuint _TrianglesSSBO = 0;
+        GLuint _VerticesSSBO = 0;
         GLuint _MaterialsSSBO = 0;
-        GLuint _MeshModelsSSBO = 0;
+        RingBufferPtr _MeshModelsRingBuffer = nullptr;
+        RingBufferAllocation _MeshModelsAllocation = {};
         GLuint _BVH_SSBO = 0;
 
-        uint32_t _NbTriangles = 0;
         uint32_t _NbMaterials = 1; // the default one
         uint32_t _NbMeshes = 0;
-
-        // tmp
-        cr::BVH_Ptr _BVH = nullptr;
+        uint32_t _NbInstances = 0;
+
+        // content of the buffers, one model per instance in their order of addition
+        // the triangles and the vertices of all the meshes are uploaded straight from the arena
+        cr::GeometryArena _Geometry = {};
+        std::vector<cr::MaterialGPU> _MaterialsGPU = {cr::MaterialGPU()};
+        std::vector<cr::MeshModelGPU> _MeshModelsGPU = {};
+        // vertices and triangles of each mesh in the arena
+        std::vector<cr::GeometryRange> _MeshRanges = {};
+        // index of the first bvh node of each mesh
+        std::vector<uint32_t> _MeshFirstNodes = {};
+        // box of each mesh in model space, the top level bvh is built from them
+        std::vector<cr::AABB_GPU> _MeshBoxes = {};
+        // nodes of the bottom level bvh of all the meshes, they follow the TLAS_NB_NODES nodes of the top level one in the buffer
+        std::vector<cr::BVH_NodeGPU> _BLAS_NodesGPU = {};
+        std::vector<cr::BVH_NodeGPU> _TLAS_NodesGPU = {};
+        // mesh and node of each instance
+        std::vector<uint32_t> _InstanceMeshes = {};
+        std::vector<uint32_t> _InstanceNodes = {};
+        // transforms of the instances and of the groups above them
+        cr::SceneGraph _Graph = {};
+        // instance of each node, NO_INSTANCE for the groups
+        std::vector<uint32_t> _NodeInstances = {};
+
+        DirtyRange _DirtyTriangles = {};
+        DirtyRange _DirtyVertices = {};
+        DirtyRange _DirtyMaterials = {0, 1};
+        // meshes whose bottom level bvh must be built again
+        std::vector<uint32_t> _DirtyMeshBVHs = {};
+        DirtyRange _DirtyBLAS_Nodes = {};
+        bool _AreMeshModelsDirty = false;
+        bool _IsTLAS_Dirty = false;
+
+        // incremented each time the scene changes
+        uint32_t _Version = 0;
 
     public:
         Scene();
 
     public:
-        std::vector<cr::TriangleGPU> getTriangleToGPUData() const;
-        std::vector<cr::MaterialGPU> getMaterialToGPUData() const;
-        std::vector<cr::MeshModelGPU> getMeshModelToGPUData() const;
-        std::vector<cr::BVH_NodeGPU> getBVH_NodesToGPUData(cr::BVH_Ptr bvh) const;
-
+        const std::vector<cr::TriangleGPU>& getTriangleToGPUData() const;
+        const std::vector<glm::vec3>& getVertexToGPUData() const;
+        const std::vector<cr::MaterialGPU>& getMaterialToGPUData() const;
+        // one model per instance
+        const std::vector<cr::MeshModelGPU>& getMeshModelToGPUData() const;
+        uint32_t getNbTriangles() const;
+        uint32_t getNbMaterials() const;
+        uint32_t getNbMeshes() const;
+        uint32_t getNbInstances() const;
+        uint32_t getInstanceNode(uint32_t instanceIndex) const;
+        const cr::SceneGraph& getGraph() const;
+        cr::MeshPtr getMesh(uint32_t meshIndex) const;
+        const glm::vec4& getMaterialColor(uint32_t materialId) const;
+
+        // adds an instance of the mesh with its own model and material
         void addMesh(cr::MeshPtr mesh);
+        // the geometry is only added the first time the mesh is seen, the model is relative to the parent node
+        void addInstance(cr::MeshPtr mesh, const glm::mat4& model, uint32_t materialId, uint32_t parentNode = cr::SceneGraph::NO_PARENT);
+        // same with the bottom level bvh of the mesh already built, by a loading thread
+        void addInstance(cr::MeshPtr mesh, cr::BVH_Ptr meshBVH, const glm::mat4& model, uint32_t materialId, uint32_t parentNode = cr::SceneGraph::NO_PARENT);
+        // node without geometry moving the instances below it, returns the node
+        uint32_t addGroup(const glm::mat4& model, uint32_t parentNode = cr::SceneGraph::NO_PARENT);
         void addMaterial(const glm::vec4& color);
         void addRandomMaterial();
 
+        // edits, meshes and instances are referred to by their order of addition
+        void setMaterialColor(uint32_t materialId, const glm::vec4& color);
+        // the models are relative to the parent node
+        void setNodeModel(uint32_t node, const glm::mat4& model);
+        void setInstanceModel(uint32_t instanceIndex, const glm::mat4& model);
+        void setInstanceMaterial(uint32_t instanceIndex, uint32_t materialId);
+        // to call after moving the vertices of a mesh, their number must stay the same
+        void updateMeshVertices(uint32_t meshIndex);
+
+        // compare two versions to know if the scene changed in between
+        uint32_t getVersion() const;
+        // true if sendDataToGpu has something to upload
+        bool isDirty() const;
+
         void sendDataToGpu(ProgramPtr program);
 
     private:
         void createSSBO();
         void bindSSBO();
-
-        void recursiveTopDownTraversalBVH(std::vector<cr::BVH_NodeGPU>& bvhNodesGPU, cr::BVH_Ptr bvh, uint32_t nodeId) const;
-        void recursiveBottomUpTraversalBVH(std::vector<cr::BVH_NodeGPU>& bvhNodesGPU, cr::BVH_Ptr bvh, uint32_t nodeId) const;
+        // returns the number of uploaded bytes
+        size_t updateSSBO();
+        // returns the index of the mesh, or -1 if it doesn't fit in the buffers
+        int32_t addMeshGeometry(cr::MeshPtr mesh, cr::BVH_Ptr meshBVH);
+        void buildBLAS(uint32_t meshIndex);
+        // writes the nodes of the bottom level bvh of the mesh at its place
+        void setMeshBVH(uint32_t meshIndex, const cr::BVH_Ptr& bvh);
+        void buildTLAS();
+        // copies the world matrices which changed since the last upload in the models
+        void updateInstanceModels();
+        void checkMeshIndex(uint32_t meshIndex) const;
+        void checkInstanceIndex(uint32_t instanceIndex) const;
+        void checkMaterialId(uint32_t materialId) const;
 };
 
 }
\ No newline at end of file
@@ -26,6 +26,7 @@ void Program::setShader(ShaderPtr shader){
             _Shaders[shader->getType()] = shader;
     }
     linkShaders();
+    reflectUniforms();
 }
 
 void Program::linkShaders() const {
@@ -58,6 +59,33 @@ void Program::linkShaders() const {
     };
 }
 
+void Program::reflectUniforms(){
+    _UniformLocations.clear();
+    GLint nbUniforms = 0;
+    glGetProgramiv(_Id, GL_ACTIVE_UNIFORMS, &nbUniforms);
+    GLint maxNameLength = 0;
+    glGetProgramiv(_Id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+    std::vector<GLchar> name(std::max(maxNameLength, 1));
+    for(GLint i=0; i<nbUniforms; i++){
+        GLsizei nameLength = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(_Id, i, maxNameLength, &nameLength, &size, &type, name.data());
+        std::string uniformName(name.data(), nameLength);
+        GLint location = glGetUniformLocation(_Id, uniformName.c_str());
+        // uniforms inside blocks have no location
+        if(location < 0){
+            continue;
+        }
+        // arrays are reported as `name[0]'
+        size_t arrayPosition = uniformName.find("[0]");
+        if(arrayPosition != std::string::npos && arrayPosition + 3 == uniformName.size()){
+            _UniformLocations[uniformName.substr(0, arrayPosition)] = location;
+        }
+        _UniformLocations[uniformName] = location;
+    }
+}
+
 Program::Program(ShaderPtr vertex, ShaderPtr fragment){
     assert(vertex->getType() == VERTEX_SHADER);
     assert(fragment->getType() == FRAGMENT_SHADER);
@@ -73,6 +101,7 @@ Program::Program(ShaderPtr vertex, ShaderPtr fragment){
         );
     }
     linkShaders();
+    reflectUniforms();
 }
 
 Program::Program(ShaderPtr compute){
@@ -88,55 +117,62 @@ Program::Program(ShaderPtr compute){
         );
     }
     linkShaders();
+    reflectUniforms();
 }
 
 bool Program::isInit() const {
     return _Id != 0;
 }
 
-GLuint Program::getLocation(const std::string & name) const { 
-    use(); 
-    return glGetUniformLocation(_Id, name.c_str()); 
+GLint Program::getLocation(const std::string & name) const { 
+    auto location = _UniformLocations.find(name);
+    // -1 is silently ignored by glProgramUniform*
+    return location == _UniformLocations.end() ? -1 : location->second;
 }
 
 void Program::setBool(const std::string & name, bool value) const { 
-    use(); 
-    glUniform1i(getLocation(name.c_str()), value ? 1 : 0); 
+    glProgramUniform1i(_Id, getLocation(name), value ? 1 : 0); 
 }
 
 void Program::setFloat(const std::string & name, float value) const { 
-    use(); 
-    glUniform1f(getLocation(name.c_str()), value); 
+    glProgramUniform1f(_Id, getLocation(name), value); 
 }
 
 void Program::setInt(const std::string & name, int value) const { 
-    use(); 
-    glUniform1i(getLocation(name.c_str()), value); 
+    glProgramUniform1i(_Id, getLocation(name), value); 
 }
 
 void Program::setUInt(const std::string & name, unsigned int value) const { 
-    use(); 
-    glUniform1ui(getLocation(name.c_str()), int(value)); 
+    glProgramUniform1ui(_Id, getLocation(name), value); 
 }
 
 void Program::setVec2(const std::string & name, const glm::vec2 & value) const { 
-    use(); 
-    glUniform2fv(getLocation(name.c_str()), 1, glm::value_ptr(value)); 
+    glProgramUniform2fv(_Id, getLocation(name), 1, glm::value_ptr(value)); 
 }
 
 void Program::setVec3(const std::string & name, const glm::vec3 & value) const { 
-    use(); 
-    glUniform3fv(getLocation(name.c_str()), 1, glm::value_ptr(value)); 
+    glProgramUniform3fv(_Id, getLocation(name), 1, glm::value_ptr(value)); 
 }
 
 void Program::setVec4(const std::string & name, const glm::vec4 & value) const { 
-    use(); 
-    glUniform4fv(getLocation(name.c_str()), 1, glm::value_ptr(value)); 
+    glProgramUniform4fv(_Id, getLocation(name), 1, glm::value_ptr(value)); 
 }
 
 void Program::setMat4(const std::string & name, const glm::mat4 & value) const { 
-    use(); 
-    glUniformMatrix4fv(getLocation(name.c_str()), 1, GL_FALSE, glm::value_ptr(value)); 
+    glProgramUniformMatrix4fv(_Id, getLocation(name), 1, GL_FALSE, glm::value_ptr(value)); 
+}
+
+void Program::setStorageBlockBinding(const std::string & name, GLuint binding) const {
+    GLuint index = glGetProgramResourceIndex(_Id, GL_SHADER_STORAGE_BLOCK, name.c_str());
+    if(index == GL_INVALID_INDEX){
+        cr::ErrorHandler::handle(
+            __FILE__, 
+            __LINE__, 
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to find the storage block " + name + "!\n"
+        );
+    }
+    glShaderStorageBlockBinding(_Id, index, binding);
 }
 
 GLuint Program::getId() const{
@@ -5,6 +5,8 @@
 #include "shader.hpp"
 #include <glad/gl.h>
 #include <map>
+#include <string>
+#include <unordered_map>
 
 namespace glr{
 
@@ -24,7 +26,7 @@ class Program{
         ~Program();
 
     public:
-        GLuint getLocation(const std::string & name) const;
+        GLint getLocation(const std::string & name) const;
         void setBool(const std::string & name, bool value) const;
         void setFloat(const std::string & name, float value) const;
         void setInt(const std::string & name, int value) const;
@@ -33,14 +35,19 @@ class Program{
         void setVec3(const std::string & name, const glm::vec3 & value) const;
         void setVec4(const std::string & name, const glm::vec4 & value) const;
         void setMat4(const std::string & name, const glm::mat4 & value) const;
+        // redirects a storage block to another binding point than the one of the shader
+        void setStorageBlockBinding(const std::string & name, GLuint binding) const;
         GLuint getId() const;
 
     private:
         GLuint _Id = 0;
         std::map<ShaderType, ShaderPtr> _Shaders;
+        // active uniforms queried once at link time
+        std::unordered_map<std::string, GLint> _UniformLocations;
 
     private:
         void linkShaders() const;
+        void reflectUniforms();
 };
 
 }
\ No newline at end of file
@@ -21,26 +21,62 @@ ShaderType Shader::getType() const {
     return _Type;
 }
 
-const std::string Shader::readShaderFile() const{
-    std::string shaderCode;
-    std::ifstream shaderFile;
+const std::string Shader::readFile(const std::string& path){
+    std::string code;
+    std::ifstream file;
 
     try {
-        shaderFile.open(_FilePath);
-        std::stringstream shaderStream;
-        shaderStream << shaderFile.rdbuf();
-        shaderFile.close();
-        shaderCode = shaderStream.str();
+        file.open(path);
+        std::stringstream stream;
+        stream << file.rdbuf();
+        file.close();
+        code = stream.str();
     }
     catch(std::ifstream::failure &e){
         cr::ErrorHandler::handle(
             __FILE__, 
             __LINE__, 
             cr::ErrorCode::IO_ERROR,
-            "Failed to read the file: " + _FilePath + "%s!\n"
+            "Failed to read the file: " + path + "%s!\n"
         );
     }
-    return shaderCode;
+    return code;
+}
+
+const std::string Shader::resolveIncludes(const std::string& shaderCode, std::set<std::string>& includedFiles){
+    // replace the `#include "file"' lines by the content of the file
+    // the path is relative to the shader directory and a file is only included once
+    const std::string INCLUDE_DIRECTIVE = "#include";
+    std::stringstream input(shaderCode);
+    std::string resolvedCode;
+    std::string line;
+    while(std::getline(input, line)){
+        size_t directivePosition = line.find_first_not_of(" \t");
+        if(directivePosition == std::string::npos || line.compare(directivePosition, INCLUDE_DIRECTIVE.size(), INCLUDE_DIRECTIVE) != 0){
+            resolvedCode += line + "\n";
+            continue;
+        }
+        size_t pathBegin = line.find('"', directivePosition);
+        size_t pathEnd = pathBegin == std::string::npos ? std::string::npos : line.find('"', pathBegin + 1);
+        if(pathEnd == std::string::npos){
+            cr::ErrorHandler::handle(
+                __FILE__, 
+                __LINE__, 
+                cr::ErrorCode::BAD_VALUE_ERROR,
+                "Malformed include directive: " + line + "!\n"
+            );
+        }
+        std::string path = SHADER_DIRECTORY + line.substr(pathBegin + 1, pathEnd - pathBegin - 1);
+        if(includedFiles.insert(path).second){
+            resolvedCode += resolveIncludes(readFile(path), includedFiles);
+        }
+    }
+    return resolvedCode;
+}
+
+const std::string Shader::readShaderFile() const{
+    std::set<std::string> includedFiles = {_FilePath};
+    return resolveIncludes(readFile(_FilePath), includedFiles);
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <set>
 #include <string>
 #include <glad/gl.h>
 
@@ -37,6 +38,8 @@ class Shader{
 
     private:
         const std::string readShaderFile() const;
+        static const std::string readFile(const std::string& path);
+        static const std::string resolveIncludes(const std::string& shaderCode, std::set<std::string>& includedFiles);
         void compileShader(const std::string& shaderCode);
 
 };
@@ -0,0 +1,131 @@
+#include "radixSort.hpp"
+
+#include <cassert>
+
+#include "errorHandler.hpp"
+#include "shader.hpp"
+
+namespace glr{
+
+RadixSort::RadixSort(uint32_t capacity, uint32_t nbKeyBits){
+    if(nbKeyBits == 0 || nbKeyBits > MAX_NB_KEY_BITS){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::BAD_VALUE_ERROR,
+            "The radix sort handles keys of 1 to 30 bits!\n"
+        );
+    }
+    _Capacity = capacity;
+    _NbKeyBits = nbKeyBits;
+    initPrograms();
+    initBuffers();
+}
+
+RadixSort::~RadixSort(){
+    glDeleteBuffers(2, _KeysSSBO);
+    glDeleteBuffers(2, _PayloadsSSBO);
+    glDeleteBuffers(1, &_GlobalHistogramSSBO);
+    glDeleteBuffers(1, &_PartitionsSSBO);
+}
+
+void RadixSort::initPrograms(){
+    auto loadProgram = [](const std::string& fileName){
+        ShaderPtr computeShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "ploc/preprocessing/sort/" + fileName, COMPUTE_SHADER));
+        return ProgramPtr(new Program(computeShader));
+    };
+    _HistogramProgram = loadProgram("histogramOfGlobalDigitCounts.glsl");
+    _BinningProgram = loadProgram("chainedScanDigitBinning.glsl");
+
+    // the kernels keep their own bindings, they are moved out of the way of the scene buffers
+    _HistogramProgram->setStorageBlockBinding("uValuesToSortSSBO", KEYS_BINDING);
+    _HistogramProgram->setStorageBlockBinding("uGlobalHistogramSSBO", GLOBAL_HISTOGRAM_BINDING);
+
+    _BinningProgram->setStorageBlockBinding("uValuesToSortSSBO", KEYS_BINDING);
+    _BinningProgram->setStorageBlockBinding("uPayloadsSSBO", PAYLOADS_BINDING);
+    _BinningProgram->setStorageBlockBinding("uSortedValuesSSBO", SORTED_KEYS_BINDING);
+    _BinningProgram->setStorageBlockBinding("uSortedPayloadsSSBO", SORTED_PAYLOADS_BINDING);
+    _BinningProgram->setStorageBlockBinding("uGlobalHistogramSSBO", GLOBAL_HISTOGRAM_BINDING);
+    _BinningProgram->setStorageBlockBinding("uPartitionsSSBO", PARTITIONS_BINDING);
+}
+
+void RadixSort::initBuffers(){
+    GLsizeiptr valuesSize = sizeof(uint32_t) * static_cast<GLsizeiptr>(_Capacity);
+    uint32_t nbPartitions = (_Capacity + PARTITION_SIZE - 1) / PARTITION_SIZE;
+
+    glCreateBuffers(2, _KeysSSBO);
+    glCreateBuffers(2, _PayloadsSSBO);
+    glCreateBuffers(1, &_GlobalHistogramSSBO);
+    glCreateBuffers(1, &_PartitionsSSBO);
+    if(_KeysSSBO[0] == 0 || _KeysSSBO[1] == 0 || _PayloadsSSBO[0] == 0 || _PayloadsSSBO[1] == 0
+        || _GlobalHistogramSSBO == 0 || _PartitionsSSBO == 0){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__,
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to create the radix sort buffers!\n"
+        );
+    }
+
+    for(int i=0; i<2; i++){
+        glNamedBufferStorage(_KeysSSBO[i], valuesSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+        glNamedBufferStorage(_PayloadsSSBO[i], valuesSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    }
+    // one count per bit
+    glNamedBufferStorage(_GlobalHistogramSSBO, sizeof(uint32_t) * 32, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    // partition counter followed by the status of each partition
+    glNamedBufferStorage(_PartitionsSSBO, sizeof(uint32_t) * (nbPartitions + 1), nullptr, GL_DYNAMIC_STORAGE_BIT);
+}
+
+GLuint RadixSort::getKeys() const {
+    return _KeysSSBO[_Current];
+}
+
+GLuint RadixSort::getPayloads() const {
+    return _PayloadsSSBO[_Current];
+}
+
+void RadixSort::computeGlobalHistogram(uint32_t nbValues) const {
+    glClearNamedBufferData(_GlobalHistogramSSBO, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, KEYS_BINDING, _KeysSSBO[_Current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GLOBAL_HISTOGRAM_BINDING, _GlobalHistogramSSBO);
+
+    _HistogramProgram->use();
+    _HistogramProgram->setUInt("uNbValuesToSort", nbValues);
+    // each work group counts PARTITION_SIZE values
+    glDispatchCompute((nbValues + PARTITION_SIZE - 1) / PARTITION_SIZE, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void RadixSort::binning(uint32_t nbValues, uint32_t bitPosition, bool isPartitionLocal){
+    glClearNamedBufferData(_PartitionsSSBO, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, KEYS_BINDING, _KeysSSBO[_Current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PAYLOADS_BINDING, _PayloadsSSBO[_Current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SORTED_KEYS_BINDING, _KeysSSBO[1 - _Current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SORTED_PAYLOADS_BINDING, _PayloadsSSBO[1 - _Current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GLOBAL_HISTOGRAM_BINDING, _GlobalHistogramSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PARTITIONS_BINDING, _PartitionsSSBO);
+
+    _BinningProgram->use();
+    _BinningProgram->setUInt("uNbValuesToSort", nbValues);
+    _BinningProgram->setUInt("uBitPosition", bitPosition);
+    _BinningProgram->setBool("uIsPartitionLocal", isPartitionLocal);
+    glDispatchCompute((nbValues + PARTITION_SIZE - 1) / PARTITION_SIZE, 1, 1);
+    // the partitions are cleared again by the next pass
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    _Current = 1 - _Current;
+}
+
+void RadixSort::sort(uint32_t nbValues, bool isPartitionLocal){
+    assert(nbValues <= _Capacity);
+    if(nbValues == 0){
+        return;
+    }
+    // least significant bit first, each pass is stable
+    if(!isPartitionLocal){
+        computeGlobalHistogram(nbValues);
+    }
+    for(uint32_t bit=0; bit<_NbKeyBits; bit++){
+        binning(nbValues, bit, isPartitionLocal);
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <glad/gl.h>
+#include <memory>
+
+#include "program.hpp"
+
+namespace glr{
+
+class RadixSort;
+using RadixSortPtr = std::shared_ptr<RadixSort>;
+
+/**
+ * Stable GPU sort of 32 bits keys carrying a 32 bits payload
+ * One binary digit is sorted per pass with the kernels of shaders/ploc/preprocessing/sort
+*/
+class RadixSort {
+    public:
+        // values sorted by one work group of the binning kernel
+        static const uint32_t PARTITION_SIZE = 16 * 16 * 8;
+        // the look back stores its counts on 30 bits
+        static const uint32_t MAX_NB_KEY_BITS = 30;
+
+    private:
+        // out of the range used by the scene and the wavefront tracer
+        static const GLuint KEYS_BINDING = 11;
+        static const GLuint PAYLOADS_BINDING = 12;
+        static const GLuint SORTED_KEYS_BINDING = 13;
+        static const GLuint SORTED_PAYLOADS_BINDING = 14;
+        static const GLuint GLOBAL_HISTOGRAM_BINDING = 15;
+        static const GLuint PARTITIONS_BINDING = 16;
+
+        uint32_t _Capacity = 0;
+        uint32_t _NbKeyBits = 0;
+
+        ProgramPtr _HistogramProgram = nullptr;
+        ProgramPtr _BinningProgram = nullptr;
+
+        // ping pong buffers, the current ones hold the input then the sorted output
+        GLuint _KeysSSBO[2] = {0, 0};
+        GLuint _PayloadsSSBO[2] = {0, 0};
+        uint32_t _Current = 0;
+        GLuint _GlobalHistogramSSBO = 0;
+        GLuint _PartitionsSSBO = 0;
+
+    public:
+        // only the lowest nbKeyBits bits of the keys are sorted
+        RadixSort(uint32_t capacity, uint32_t nbKeyBits);
+        ~RadixSort();
+
+    public:
+        GLuint getKeys() const;
+        GLuint getPayloads() const;
+
+        // sorts the first nbValues keys of getKeys()
+        // if isPartitionLocal, each block of PARTITION_SIZE values is sorted on its own
+        void sort(uint32_t nbValues, bool isPartitionLocal);
+
+    private:
+        void initPrograms();
+        void initBuffers();
+
+        void computeGlobalHistogram(uint32_t nbValues) const;
+        void binning(uint32_t nbValues, uint32_t bitPosition, bool isPartitionLocal);
+};
+
+}
\ No newline at end of file
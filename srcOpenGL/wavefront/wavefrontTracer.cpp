@@ -0,0 +1,201 @@
+#include "wavefrontTracer.hpp"
+
+#include <cassert>
+
+#include "errorHandler.hpp"
+#include "shader.hpp"
+
+namespace glr{
+
+WavefrontTracer::WavefrontTracer(uint32_t width, uint32_t height){
+    _Width = width;
+    _Height = height;
+    initPrograms();
+    initBuffers();
+}
+
+WavefrontTracer::~WavefrontTracer(){
+    glDeleteBuffers(1, &_CountersSSBO);
+    glDeleteBuffers(2, _RayQueuesSSBO);
+    glDeleteBuffers(1, &_HitsSSBO);
+    glDeleteBuffers(1, &_ShadowQueueSSBO);
+    glDeleteQueries(1, &_TimerQuery);
+}
+
+void WavefrontTracer::initPrograms(){
+    auto loadProgram = [](const std::string& fileName){
+        ShaderPtr computeShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "wavefront/" + fileName, COMPUTE_SHADER));
+        return ProgramPtr(new Program(computeShader));
+    };
+    _RayGenerationProgram = loadProgram("rayGeneration.glsl");
+    _ExtensionProgram = loadProgram("extension.glsl");
+    _ShadingProgram = loadProgram("shading.glsl");
+    _ConnectProgram = loadProgram("connect.glsl");
+    _DispatchProgram = loadProgram("dispatch.glsl");
+    _RayKeysProgram = loadProgram("rayKeys.glsl");
+    _RayPermutationProgram = loadProgram("rayPermutation.glsl");
+
+    glm::uvec2 imageSize = glm::uvec2(_Width, _Height);
+    for(ProgramPtr program : {_RayGenerationProgram, _ExtensionProgram, _ShadingProgram, _ConnectProgram, _DispatchProgram,
+                                _RayKeysProgram, _RayPermutationProgram}){
+        glProgramUniform2ui(program->getId(), program->getLocation("uImageSize"), imageSize.x, imageSize.y);
+    }
+    _RayKeysProgram->setUInt("uQueueCapacity", _Width * _Height);
+
+    // the size of the groups is only declared in shaders/wavefront/wavefront.glsl
+    GLint groupSize[3] = {0, 0, 0};
+    glGetProgramiv(_RayKeysProgram->getId(), GL_COMPUTE_WORK_GROUP_SIZE, groupSize);
+    _GroupSize = static_cast<uint32_t>(groupSize[0]);
+    assert(_GroupSize > 0);
+}
+
+void WavefrontTracer::initBuffers(){
+    // every pixel has at most one ray in flight
+    GLsizeiptr nbPixels = static_cast<GLsizeiptr>(_Width) * _Height;
+
+    glCreateBuffers(1, &_CountersSSBO);
+    glCreateBuffers(2, _RayQueuesSSBO);
+    glCreateBuffers(1, &_HitsSSBO);
+    glCreateBuffers(1, &_ShadowQueueSSBO);
+    if(_CountersSSBO == 0 || _RayQueuesSSBO[0] == 0 || _RayQueuesSSBO[1] == 0 
+        || _HitsSSBO == 0 || _ShadowQueueSSBO == 0){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__, 
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to create the wavefront buffers!\n"
+        );
+    }
+
+    glNamedBufferStorage(_CountersSSBO, sizeof(WavefrontCountersGPU), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    glNamedBufferStorage(_RayQueuesSSBO[0], sizeof(WavefrontRayGPU) * nbPixels, nullptr, 0);
+    glNamedBufferStorage(_RayQueuesSSBO[1], sizeof(WavefrontRayGPU) * nbPixels, nullptr, 0);
+    glNamedBufferStorage(_HitsSSBO, sizeof(WavefrontHitGPU) * nbPixels, nullptr, 0);
+    glNamedBufferStorage(_ShadowQueueSSBO, sizeof(WavefrontShadowRayGPU) * nbPixels, nullptr, 0);
+
+    _RaySort = RadixSortPtr(new RadixSort(static_cast<uint32_t>(nbPixels), NB_RAY_KEY_BITS));
+
+    glCreateQueries(GL_TIME_ELAPSED, 1, &_TimerQuery);
+    if(_TimerQuery == 0){
+        cr::ErrorHandler::handle(
+            __FILE__, __LINE__, 
+            cr::ErrorCode::OPENGL_ERROR,
+            "Failed to create the wavefront timer query!\n"
+        );
+    }
+}
+
+void WavefrontTracer::generateRays() const {
+    // the primary rays of the pixels that are not converged are appended to the empty queue
+    WavefrontCountersGPU counters{};
+    glNamedBufferSubData(_CountersSSBO, 0, sizeof(WavefrontCountersGPU), &counters);
+
+    _RayGenerationProgram->use();
+    glDispatchCompute((_Width + 15) / 16, (_Height + 15) / 16, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+}
+
+void WavefrontTracer::extend() const {
+    _ExtensionProgram->use();
+    glDispatchCompute(_Parameters._NbPersistentWorkGroups, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void WavefrontTracer::shade() const {
+    runDispatchStage(WAVEFRONT_STAGE_SHADING);
+    _ShadingProgram->use();
+    _ShadingProgram->setUInt("uMaxDepth", static_cast<uint32_t>(_Parameters._MaxDepth));
+    glDispatchComputeIndirect(offsetof(WavefrontCountersGPU, _ShadingDispatch));
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+}
+
+void WavefrontTracer::connect() const {
+    runDispatchStage(WAVEFRONT_STAGE_CONNECT);
+    _ConnectProgram->use();
+    glDispatchComputeIndirect(offsetof(WavefrontCountersGPU, _ConnectDispatch));
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+}
+
+void WavefrontTracer::runDispatchStage(WavefrontStage stage) const {
+    // the counters never leave the GPU
+    _DispatchProgram->use();
+    _DispatchProgram->setUInt("uStage", stage);
+    glDispatchCompute(1, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
+
+void WavefrontTracer::sortRays(){
+    // keys of the whole queue, the empty slots sort at the end
+    // so that the count of rays never has to be read back
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, RAY_KEYS_BINDING, _RaySort->getKeys());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, RAY_INDICES_BINDING, _RaySort->getPayloads());
+    _RayKeysProgram->use();
+    uint32_t capacity = _Width * _Height;
+    glDispatchCompute((capacity + _GroupSize - 1) / _GroupSize, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    _RaySort->sort(capacity, _Parameters._RaySorting == RAY_SORTING_TILES);
+
+    // gather the rays in the sorted order
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, RAY_INDICES_BINDING, _RaySort->getPayloads());
+    _RayPermutationProgram->use();
+    glDispatchCompute((capacity + _GroupSize - 1) / _GroupSize, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    swapRayQueues();
+}
+
+void WavefrontTracer::bindRayQueues() const {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, RAY_QUEUE_BINDING, _RayQueuesSSBO[_CurrentQueue]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, NEXT_RAY_QUEUE_BINDING, _RayQueuesSSBO[1 - _CurrentQueue]);
+}
+
+void WavefrontTracer::swapRayQueues(){
+    _CurrentQueue = 1 - _CurrentQueue;
+    bindRayQueues();
+}
+
+double WavefrontTracer::timeStage(const std::function<void()>& stage) const {
+    if(!_Parameters._IsProfilingOn){
+        stage();
+        return 0.;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, _TimerQuery);
+    stage();
+    glEndQuery(GL_TIME_ELAPSED);
+    GLuint64 elapsedTime = 0;
+    glGetQueryObjectui64v(_TimerQuery, GL_QUERY_RESULT, &elapsedTime);
+    return static_cast<double>(elapsedTime) * 1e-6;
+}
+
+void WavefrontTracer::render(){
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COUNTERS_BINDING, _CountersSSBO);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, _CountersSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HITS_BINDING, _HitsSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SHADOW_QUEUE_BINDING, _ShadowQueueSSBO);
+
+    _Statistics = {};
+    _CurrentQueue = 0;
+    bindRayQueues();
+    _Statistics._RayGenerationTime = timeStage([this](){generateRays();});
+
+    // empty queues result in empty dispatches, the loop never reads the counters back
+    for(int depth=0; depth<=_Parameters._MaxDepth; depth++){
+        // the rasterised primary hits are already in the order of the queue
+        bool isExtended = depth > 0 || !_Parameters._IsPrimaryRasterized;
+        if(isExtended && _Parameters._RaySorting != RAY_SORTING_NONE && depth >= _Parameters._MinSortedDepth){
+            _Statistics._SortTime += timeStage([this](){sortRays();});
+        }
+        if(isExtended){
+            _Statistics._ExtensionTime += timeStage([this](){extend();});
+        }
+        _Statistics._ShadingTime += timeStage([this](){shade();});
+        _Statistics._ConnectTime += timeStage([this](){connect();});
+        runDispatchStage(WAVEFRONT_STAGE_NEXT_BOUNCE);
+        // the bounce rays become the current queue
+        swapRayQueues();
+    }
+
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glad/gl.h>
+#include <functional>
+#include <memory>
+
+#include "program.hpp"
+#include "radixSort.hpp"
+
+namespace glr{
+
+class WavefrontTracer;
+using WavefrontTracerPtr = std::shared_ptr<WavefrontTracer>;
+
+// mirrors the structures of shaders/wavefront/wavefront.glsl
+struct alignas(16) WavefrontRayGPU {
+    glm::vec4 _Origin;
+    glm::vec4 _Direction;
+    glm::vec4 _Throughput;
+    uint32_t _PixelIndex;
+    uint32_t _Depth;
+};
+
+struct alignas(16) WavefrontShadowRayGPU {
+    glm::vec4 _Origin;
+    glm::vec4 _Direction;
+    glm::vec4 _Contribution;
+    uint32_t _PixelIndex;
+};
+
+struct alignas(16) WavefrontHitGPU {
+    glm::vec4 _Coords;
+    uint32_t _DidHit;
+    uint32_t _TriangleId;
+    uint32_t _InstanceId;
+};
+
+struct WavefrontCountersGPU {
+    uint32_t _ExtensionCount = 0;
+    uint32_t _NextExtensionCount = 0;
+    uint32_t _ShadowCount = 0;
+    uint32_t _ExtensionHead = 0;
+    uint32_t _ShadingDispatch[3] = {0, 0, 0};
+    uint32_t _ConnectDispatch[3] = {0, 0, 0};
+};
+
+enum WavefrontStage {
+    WAVEFRONT_STAGE_SHADING = 0,
+    WAVEFRONT_STAGE_CONNECT = 1,
+    WAVEFRONT_STAGE_NEXT_BOUNCE = 2,
+};
+
+enum RaySortingMode {
+    RAY_SORTING_NONE,
+    // the whole queue is sorted
+    RAY_SORTING_GLOBAL,
+    // each tile of RadixSort::PARTITION_SIZE consecutive rays is sorted on its own
+    RAY_SORTING_TILES,
+};
+
+struct WavefrontParameters {
+    // enough groups to fill the GPU, the extension threads are persistent
+    uint32_t _NbPersistentWorkGroups = 256;
+    int _MaxDepth = 1;
+    RaySortingMode _RaySorting = RAY_SORTING_NONE;
+    // primary rays are already coherent
+    int _MinSortedDepth = 1;
+    // the primary hits are read from the visibility buffer bound by glr::VisibilityBuffer
+    bool _IsPrimaryRasterized = false;
+    // stalls on every stage to time it
+    bool _IsProfilingOn = false;
+
+    bool operator==(const WavefrontParameters&) const = default;
+};
+
+// GPU times of the last frame in milliseconds, only filled when profiling
+struct WavefrontStatistics {
+    double _RayGenerationTime = 0.;
+    double _SortTime = 0.;
+    double _ExtensionTime = 0.;
+    double _ShadingTime = 0.;
+    double _ConnectTime = 0.;
+};
+
+class WavefrontTracer {
+    public:
+        WavefrontParameters _Parameters = {};
+        WavefrontStatistics _Statistics = {};
+
+    private:
+        static const GLuint COUNTERS_BINDING = 6;
+        static const GLuint RAY_QUEUE_BINDING = 7;
+        static const GLuint NEXT_RAY_QUEUE_BINDING = 8;
+        static const GLuint HITS_BINDING = 9;
+        static const GLuint SHADOW_QUEUE_BINDING = 10;
+        static const GLuint RAY_KEYS_BINDING = 11;
+        static const GLuint RAY_INDICES_BINDING = 12;
+        // octant, Morton code of the origin cell and invalid flag, cf shaders/wavefront/rayKeys.glsl
+        static const uint32_t NB_RAY_KEY_BITS = 13;
+
+        uint32_t _Width = 0;
+        uint32_t _Height = 0;
+        // WAVEFRONT_GROUP_SIZE, read back from the compiled shaders
+        uint32_t _GroupSize = 0;
+
+        ProgramPtr _RayGenerationProgram = nullptr;
+        ProgramPtr _ExtensionProgram = nullptr;
+        ProgramPtr _ShadingProgram = nullptr;
+        ProgramPtr _ConnectProgram = nullptr;
+        ProgramPtr _DispatchProgram = nullptr;
+        ProgramPtr _RayKeysProgram = nullptr;
+        ProgramPtr _RayPermutationProgram = nullptr;
+
+        RadixSortPtr _RaySort = nullptr;
+        GLuint _TimerQuery = 0;
+        uint32_t _CurrentQueue = 0;
+
+        GLuint _CountersSSBO = 0;
+        GLuint _RayQueuesSSBO[2] = {0, 0};
+        GLuint _HitsSSBO = 0;
+        GLuint _ShadowQueueSSBO = 0;
+
+    public:
+        WavefrontTracer(uint32_t width, uint32_t height);
+        ~WavefrontTracer();
+
+    public:
+        // traces the image bound to image unit 0
+        void render();
+
+    private:
+        void initPrograms();
+        void initBuffers();
+
+        void generateRays() const;
+        void extend() const;
+        void shade() const;
+        void connect() const;
+        void runDispatchStage(WavefrontStage stage) const;
+        void sortRays();
+
+        void bindRayQueues() const;
+        void swapRayQueues();
+        // returns the GPU time of the stage in milliseconds, 0 if not profiling
+        double timeStage(const std::function<void()>& stage) const;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+
+#include "application.hpp"
+
+namespace glr{
+
+///// constants
+const uint32_t IMAGE_WIDTH = 256;
+const uint32_t IMAGE_HEIGHT = 256;
+const uint32_t NB_PIXELS = IMAGE_WIDTH * IMAGE_HEIGHT;
+// the convergence is only checked every few samples
+const uint32_t NB_SAMPLES = 64;
+
+
+///// helpers
+GLuint initImage(){
+    GLuint texture = 0;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    assert(texture != 0);
+    glTextureStorage2D(texture, 1, GL_RGBA32F, IMAGE_WIDTH, IMAGE_HEIGHT);
+    glBindImageTexture(0, texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    return texture;
+}
+
+std::vector<glm::vec4> readImage(GLuint texture){
+    std::vector<glm::vec4> pixels(NB_PIXELS);
+    glGetTextureImage(texture, 0, GL_RGBA, GL_FLOAT, sizeof(glm::vec4) * NB_PIXELS, pixels.data());
+    return pixels;
+}
+
+// the same sample in every pixel, as written by a tracer
+void accumulateSample(AccumulationBufferPtr accumulation, GLuint texture, const glm::vec4& value){
+    glClearTexImage(texture, 0, GL_RGBA, GL_FLOAT, &value);
+    accumulation->accumulate();
+}
+
+// left half constant, right half alternating between 0 and 2
+void accumulateHalfNoisySample(AccumulationBufferPtr accumulation, GLuint texture, uint32_t sampleIndex){
+    std::vector<glm::vec4> pixels(NB_PIXELS);
+    float noisyValue = sampleIndex % 2 == 0 ? 0.f : 2.f;
+    for(uint32_t i=0; i<NB_PIXELS; i++){
+        float value = i % IMAGE_WIDTH < IMAGE_WIDTH / 2 ? 0.5f : noisyValue;
+        pixels[i] = glm::vec4(value, value, value, 1.f);
+    }
+    glTextureSubImage2D(texture, 0, 0, 0, IMAGE_WIDTH, IMAGE_HEIGHT, GL_RGBA, GL_FLOAT, pixels.data());
+    accumulation->accumulate();
+}
+
+std::vector<uint32_t> readSampleCounts(AccumulationBufferPtr accumulation){
+    std::vector<uint32_t> counts(NB_PIXELS);
+    glGetTextureImage(accumulation->getSampleCountsTexture(), 0, GL_RED_INTEGER, GL_UNSIGNED_INT, sizeof(uint32_t) * NB_PIXELS, counts.data());
+    return counts;
+}
+
+void assertImage(GLuint texture, const glm::vec4& expected){
+    std::vector<glm::vec4> pixels = readImage(texture);
+    for(uint32_t i=0; i<NB_PIXELS; i++){
+        assert(glm::length(pixels[i] - expected) < 1e-5f);
+    }
+}
+
+
+///// tests
+void testCameraVersion(){
+    fprintf(stderr, "\nBegin test: camera version...\n");
+    cr::Camera camera(glm::vec3(0.f, 0.f, -5.f), static_cast<float>(IMAGE_WIDTH) / IMAGE_HEIGHT);
+    uint32_t version = camera.getVersion();
+    camera.processKeyboard(cr::FORWARD, 0.1f);
+    assert(camera.getVersion() != version);
+    version = camera.getVersion();
+    camera.ProcessMouseMovement(1.f, 0.f);
+    assert(camera.getVersion() != version);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testMean(AccumulationBufferPtr accumulation, GLuint texture){
+    fprintf(stderr, "\nBegin test: mean...\n");
+    accumulation->reset();
+    assert(accumulation->getJitter() == glm::vec2(0.f));
+    // samples 1, 2, 3 and 4
+    for(uint32_t i=1; i<=4; i++){
+        accumulateSample(accumulation, texture, glm::vec4(static_cast<float>(i), 0.f, 1.f, 1.f));
+        assert(accumulation->getJitter().x >= 0.f && accumulation->getJitter().x < 1.f);
+        assert(accumulation->getJitter().y >= 0.f && accumulation->getJitter().y < 1.f);
+    }
+    assert(accumulation->getNbSamples() == 4);
+    assertImage(texture, glm::vec4(2.5f, 0.f, 1.f, 1.f));
+
+    // the previous samples are forgotten
+    accumulation->reset();
+    accumulateSample(accumulation, texture, glm::vec4(0.5f, 0.5f, 0.5f, 1.f));
+    assertImage(texture, glm::vec4(0.5f, 0.5f, 0.5f, 1.f));
+    fprintf(stderr, "\tOk\n");
+}
+
+void testConvergence(AccumulationBufferPtr accumulation, GLuint texture){
+    fprintf(stderr, "\nBegin test: convergence...\n");
+    accumulation->_Parameters._MaxNbSamples = 2 * NB_SAMPLES;
+
+    // without noise the first check succeeds
+    accumulation->reset();
+    for(uint32_t i=0; i<NB_SAMPLES && !accumulation->isConverged(); i++){
+        accumulateSample(accumulation, texture, glm::vec4(0.3f, 0.6f, 0.9f, 1.f));
+    }
+    assert(accumulation->isConverged());
+    assert(accumulation->getNbSamples() < NB_SAMPLES);
+    assert(accumulation->getNbNonConvergedPixels() == 0);
+
+    // samples alternating between 0 and 2 never reach a 1% error in a few samples
+    accumulation->reset();
+    for(uint32_t i=0; i<NB_SAMPLES; i++){
+        float value = i % 2 == 0 ? 0.f : 2.f;
+        accumulateSample(accumulation, texture, glm::vec4(value, value, value, 1.f));
+    }
+    assert(!accumulation->isConverged());
+    assert(accumulation->getNbNonConvergedPixels() == NB_PIXELS);
+    assertImage(texture, glm::vec4(1.f, 1.f, 1.f, 1.f));
+
+    // until the maximum number of samples
+    while(!accumulation->isConverged()){
+        accumulateSample(accumulation, texture, glm::vec4(1.f, 1.f, 1.f, 1.f));
+    }
+    assert(accumulation->getNbSamples() == 2 * NB_SAMPLES);
+    fprintf(stderr, "\tOk\n");
+}
+
+
+void testAdaptiveSampling(AccumulationBufferPtr accumulation, GLuint texture){
+    fprintf(stderr, "\nBegin test: adaptive sampling...\n");
+    const uint32_t convergedFlag = 0x80000000u;
+    const uint32_t lowErrorFlag = 0x40000000u;
+    accumulation->_Parameters._IsAdaptive = true;
+    accumulation->_Parameters._MinNbSamples = 8;
+    accumulation->_Parameters._MaxNbSamples = 2 * NB_SAMPLES;
+    accumulation->reset();
+    for(uint32_t i=0; i<NB_SAMPLES; i++){
+        accumulateHalfNoisySample(accumulation, texture, i);
+    }
+
+    // the constant pixels stopped at the minimum number of samples, except the ones next to the noisy half
+    std::vector<uint32_t> counts = readSampleCounts(accumulation);
+    for(uint32_t i=0; i<NB_PIXELS; i++){
+        if(i % IMAGE_WIDTH < IMAGE_WIDTH / 2 - 1){
+            assert(counts[i] == (8 | lowErrorFlag | convergedFlag));
+        } else if(i % IMAGE_WIDTH == IMAGE_WIDTH / 2 - 1){
+            assert(counts[i] == (NB_SAMPLES | lowErrorFlag));
+        } else {
+            assert(counts[i] == NB_SAMPLES);
+        }
+    }
+    assert(!accumulation->isConverged());
+    assert(accumulation->getNbNonConvergedPixels() == NB_PIXELS / 2);
+    std::vector<glm::vec4> pixels = readImage(texture);
+    for(uint32_t i=0; i<NB_PIXELS; i++){
+        float expected = i % IMAGE_WIDTH < IMAGE_WIDTH / 2 ? 0.5f : 1.f;
+        assert(glm::length(pixels[i] - glm::vec4(expected, expected, expected, 1.f)) < 1e-5f);
+    }
+
+    // a reset gives every pixel its samples back
+    accumulation->reset();
+    accumulateSample(accumulation, texture, glm::vec4(1.f));
+    counts = readSampleCounts(accumulation);
+    for(uint32_t i=0; i<NB_PIXELS; i++){
+        assert(counts[i] == 1);
+    }
+    accumulation->_Parameters = {};
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace glr;
+
+///// main
+int main() {
+    Application app = Application::dummyApplication();
+    GLuint texture = initImage();
+    AccumulationBufferPtr accumulation = AccumulationBufferPtr(new AccumulationBuffer(IMAGE_WIDTH, IMAGE_HEIGHT));
+
+    testCameraVersion();
+    testMean(accumulation, texture);
+    testConvergence(accumulation, texture);
+    testAdaptiveSampling(accumulation, texture);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
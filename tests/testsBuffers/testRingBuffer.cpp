@@ -0,0 +1,87 @@
+#include <iostream>
+#include <cassert>
+#include <set>
+#include <vector>
+
+#include "application.hpp"
+
+namespace glr{
+
+///// constants
+const GLsizeiptr SLICE_SIZE = 1024;
+const uint32_t NB_FRAMES = 64;
+
+
+///// helpers
+std::vector<uint32_t> readBuffer(RingBufferPtr ringBuffer, const RingBufferAllocation& allocation){
+    std::vector<uint32_t> content(allocation._Size / sizeof(uint32_t));
+    glGetNamedBufferSubData(ringBuffer->getId(), allocation._Offset, allocation._Size, content.data());
+    return content;
+}
+
+
+///// tests
+void testAllocations(){
+    fprintf(stderr, "\nBegin test: allocations...\n");
+    RingBufferPtr ringBuffer = RingBufferPtr(new RingBuffer(SLICE_SIZE));
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    // two allocations of the same slice do not overlap and keep the binding alignment
+    std::vector<uint32_t> first = {1, 2, 3};
+    std::vector<uint32_t> second = {4, 5};
+    RingBufferAllocation firstAllocation = ringBuffer->write(first.data(), sizeof(uint32_t) * first.size());
+    RingBufferAllocation secondAllocation = ringBuffer->write(second.data(), sizeof(uint32_t) * second.size());
+    assert(firstAllocation._Offset % alignment == 0 && secondAllocation._Offset % alignment == 0);
+    assert(secondAllocation._Offset >= firstAllocation._Offset + firstAllocation._Size);
+    // the mapping is coherent, no flush is needed
+    assert(readBuffer(ringBuffer, firstAllocation) == first);
+    assert(readBuffer(ringBuffer, secondAllocation) == second);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testSlices(){
+    fprintf(stderr, "\nBegin test: slices...\n");
+    RingBufferPtr ringBuffer = RingBufferPtr(new RingBuffer(SLICE_SIZE));
+    std::set<GLintptr> offsets{};
+    for(uint32_t i=0; i<RingBuffer::DEFAULT_NB_SLICES; i++){
+        ringBuffer->beginFrame();
+        RingBufferAllocation allocation = ringBuffer->write(&i, sizeof(uint32_t));
+        ringBuffer->bind(GL_UNIFORM_BUFFER, 0, allocation);
+        offsets.insert(allocation._Offset);
+    }
+    // each frame writes in its own slice, then the first one is used again
+    assert(offsets.size() == RingBuffer::DEFAULT_NB_SLICES);
+    ringBuffer->beginFrame();
+    assert(offsets.contains(ringBuffer->allocate(sizeof(uint32_t))._Offset));
+    fprintf(stderr, "\tOk\n");
+}
+
+void testNoStall(){
+    fprintf(stderr, "\nBegin test: no stall...\n");
+    RingBufferPtr ringBuffer = RingBufferPtr(new RingBuffer(SLICE_SIZE));
+    // the gpu is done with everything, the fences are already signaled
+    for(uint32_t i=0; i<NB_FRAMES; i++){
+        ringBuffer->beginFrame();
+        RingBufferAllocation allocation = ringBuffer->write(&i, sizeof(uint32_t));
+        ringBuffer->bind(GL_UNIFORM_BUFFER, 0, allocation);
+        glFinish();
+        assert(readBuffer(ringBuffer, allocation)[0] == i);
+    }
+    assert(ringBuffer->getNbStalls() == 0);
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace glr;
+
+///// main
+int main() {
+    Application app = Application::dummyApplication();
+
+    testAllocations();
+    testSlices();
+    testNoStall();
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
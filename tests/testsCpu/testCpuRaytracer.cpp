@@ -0,0 +1,282 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cpuRaytracer.hpp"
+#include "cpuScene.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t NB_RAYS = 2 << 12;
+const uint32_t IMAGE_WIDTH = 128;
+const uint32_t IMAGE_HEIGHT = 96;
+const uint32_t PACKET_SIZE = 16;
+const glm::vec4 MODEL_COLOR = glm::vec4(0.2f, 0.3f, 0.1f, 1.f);
+const std::string IMAGE_PATH = "testCpuRaytracer.ppm";
+
+
+///// helpers
+CpuScenePtr initScene(){
+    std::vector<Material> materials = {Material(), Material(MODEL_COLOR)};
+
+    MeshPtr teapot = Mesh::load(Mesh::MODELS_DIRECTORY + "teapot.obj");
+    teapot->setMaterial(1);
+    MeshPtr cube = Mesh::primitiveCube();
+    cube->setPosition(glm::vec3(2.f, 0.f, 1.f));
+    cube->setMaterial(1);
+
+    return CpuScenePtr(new CpuScene({teapot, cube}, materials));
+}
+
+Hit bruteForce(const CpuScenePtr& scene, const RaySetup& ray, float tMax = INFINITY){
+    Hit closestHit{};
+    closestHit._Coords.w = tMax;
+    for(uint32_t instance=0; instance<scene->getNbInstances(); instance++){
+        const MeshModelGPU& model = scene->getInstance(instance);
+        RaySetup modelRay = scene->getInstanceRay(ray, instance);
+        for(uint32_t i=model._FirstTriangle; i<model._FirstTriangle + model._NbTriangles; i++){
+            Hit hit = scene->rayTriangleIntersection(modelRay, i, closestHit._Coords.w);
+            if(hit._DidHit){
+                hit._InstanceId = instance;
+                closestHit = hit;
+            }
+        }
+    }
+    return closestHit;
+}
+
+bool isOccludedBruteForce(const CpuScenePtr& scene, const RaySetup& ray, float tMin){
+    for(uint32_t instance=0; instance<scene->getNbInstances(); instance++){
+        const MeshModelGPU& model = scene->getInstance(instance);
+        RaySetup modelRay = scene->getInstanceRay(ray, instance);
+        for(uint32_t i=model._FirstTriangle; i<model._FirstTriangle + model._NbTriangles; i++){
+            if(scene->isTriangleOccluding(modelRay, i, tMin, INFINITY)){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+CameraGPU initCamera(){
+    float aspectRatio = static_cast<float>(IMAGE_WIDTH) / static_cast<float>(IMAGE_HEIGHT);
+    Camera camera = Camera(glm::vec3(0.f, 0.f, -5.f), aspectRatio);
+    return camera.getGpuData();
+}
+
+
+///// tests
+void testTraversal(const CpuScenePtr& scene){
+    fprintf(stderr, "\nBegin test: bvh traversal against brute force...\n");
+    CpuRaytracer raytracer = CpuRaytracer(scene, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> distrib(-1.f, 1.f);
+    uint32_t nbHits = 0;
+    for(uint32_t i=0; i<NB_RAYS; i++){
+        // rays from around the scene towards its center
+        glm::vec3 origin = 6.f * glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        glm::vec3 target = glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        RaySetup ray = Intersection::setupRay({origin, glm::normalize(target - origin)});
+        Hit expected = bruteForce(scene, ray);
+        Hit hit = raytracer.traceClosest(ray, INFINITY);
+        assert(hit._DidHit == expected._DidHit);
+        if(hit._DidHit){
+            assert(hit._Coords.w == expected._Coords.w);
+            nbHits++;
+        }
+    }
+    // the test is meaningless if every ray misses
+    assert(nbHits > NB_RAYS / 10);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testPacket(const CpuScenePtr& scene){
+    fprintf(stderr, "\nBegin test: packet traversal...\n");
+    CpuRaytracer raytracer = CpuRaytracer(scene, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    CameraGPU camera = initCamera();
+
+    // primary rays of each tile
+    std::vector<RaySetup> rays{};
+    for(uint32_t tileY=0; tileY<IMAGE_HEIGHT; tileY+=PACKET_SIZE){
+        for(uint32_t tileX=0; tileX<IMAGE_WIDTH; tileX+=PACKET_SIZE){
+            for(uint32_t y=tileY; y<tileY+PACKET_SIZE; y++){
+                for(uint32_t x=tileX; x<tileX+PACKET_SIZE; x++){
+                    glm::vec2 pos = glm::vec2(static_cast<float>(x) / IMAGE_WIDTH, static_cast<float>(y) / IMAGE_HEIGHT);
+                    rays.push_back(Intersection::setupRay(CpuRaytracer::getRay(camera, pos)));
+                }
+            }
+        }
+    }
+    // incoherent rays fall back to the single ray traversal
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> distrib(-1.f, 1.f);
+    for(uint32_t i=0; i<PACKET_SIZE*PACKET_SIZE; i++){
+        glm::vec3 origin = 6.f * glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        rays.push_back(Intersection::setupRay({origin, glm::vec3(distrib(gen), distrib(gen), distrib(gen)) - origin}));
+    }
+
+    const uint32_t packetSize = PACKET_SIZE * PACKET_SIZE;
+    std::vector<Hit> hits = std::vector<Hit>(rays.size());
+    auto start = std::chrono::steady_clock::now();
+    for(size_t i=0; i<rays.size(); i+=packetSize){
+        raytracer.tracePacket(
+            std::span<const RaySetup>(rays).subspan(i, packetSize),
+            std::span<Hit>(hits).subspan(i, packetSize)
+        );
+    }
+    std::chrono::duration<double> packetTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for(size_t i=0; i<rays.size(); i++){
+        Hit expected = raytracer.traceClosest(rays[i], INFINITY);
+        // a different triangle can be found on a shared edge, at the same distance
+        assert(hits[i]._DidHit == expected._DidHit);
+        assert(hits[i]._Coords.w == expected._Coords.w);
+    }
+    std::chrono::duration<double> singleTime = std::chrono::steady_clock::now() - start;
+    fprintf(stderr, "\tpackets: %f ms, single rays: %f ms\n", 1000. * packetTime.count(), 1000. * singleTime.count());
+    fprintf(stderr, "\tOk\n");
+}
+
+void testAnyHit(const CpuScenePtr& scene){
+    fprintf(stderr, "\nBegin test: any hit...\n");
+    // the largest child is on the left
+    for(const BVH_NodeGPU& node : scene->getBVH_Nodes()){
+        if(node._LeftChild != 0 || node._RightChild != 0){
+            const std::vector<BVH_NodeGPU>& nodes = scene->getBVH_Nodes();
+            assert(AABB::getSurfaceArea(nodes[node._LeftChild]._BoundingBox) >= AABB::getSurfaceArea(nodes[node._RightChild]._BoundingBox));
+        }
+    }
+
+    CpuRaytracer raytracer = CpuRaytracer(scene, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> distrib(-1.f, 1.f);
+    uint32_t nbOccluded = 0;
+    for(uint32_t i=0; i<NB_RAYS; i++){
+        glm::vec3 origin = 6.f * glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        glm::vec3 target = glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        RaySetup ray = Intersection::setupRay({origin, glm::normalize(target - origin)});
+        Hit closestHit = raytracer.traceClosest(ray, INFINITY);
+
+        // nothing is hit before the closest hit
+        if(closestHit._DidHit){
+            assert(!raytracer.traceAnyHit(ray, 0.f, 0.99f * closestHit._Coords.w));
+        }
+
+        // the interval starts in the middle of the geometry
+        float tMin = 6.f * (distrib(gen) + 1.f);
+        bool isOccluded = isOccludedBruteForce(scene, ray, tMin);
+        assert(raytracer.traceAnyHit(ray, tMin, INFINITY) == isOccluded);
+        nbOccluded += isOccluded ? 1 : 0;
+    }
+    // both cases are tested
+    assert(nbOccluded > NB_RAYS / 10 && nbOccluded < NB_RAYS);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testBatchedQueries(const CpuScenePtr& scene){
+    fprintf(stderr, "\nBegin test: batched queries...\n");
+    CpuRaytracer raytracer = CpuRaytracer(scene, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> distrib(-1.f, 1.f);
+    std::vector<Ray> rays{};
+    for(uint32_t i=0; i<NB_RAYS; i++){
+        glm::vec3 origin = 6.f * glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        glm::vec3 target = glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        // some rays stop before the geometry
+        float tMax = i % 2 == 0 ? INFINITY : 6.f * (distrib(gen) + 1.f);
+        rays.push_back({origin, glm::normalize(target - origin), tMax});
+    }
+
+    std::vector<Hit> hits = std::vector<Hit>(rays.size());
+    std::unique_ptr<bool[]> areOccluded = std::unique_ptr<bool[]>(new bool[rays.size()]);
+    raytracer.traceClosest(rays, hits);
+    raytracer.traceAnyHit(rays, std::span<bool>(areOccluded.get(), rays.size()));
+
+    uint32_t nbOccluded = 0;
+    for(size_t i=0; i<rays.size(); i++){
+        RaySetup ray = Intersection::setupRay(rays[i]);
+        Hit expected = raytracer.traceClosest(ray, rays[i]._TMax);
+        assert(hits[i]._DidHit == expected._DidHit);
+        assert(hits[i]._Coords.w == expected._Coords.w);
+        // any triangle in range occludes the ray
+        bool isOccluded = bruteForce(scene, ray, rays[i]._TMax)._DidHit;
+        assert(areOccluded[i] == isOccluded);
+        assert(areOccluded[i] == hits[i]._DidHit);
+        nbOccluded += isOccluded ? 1 : 0;
+    }
+    // both cases are tested
+    assert(nbOccluded > NB_RAYS / 10 && nbOccluded < NB_RAYS);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testRender(const CpuScenePtr& scene){
+    fprintf(stderr, "\nBegin test: render...\n");
+    CpuRaytracer raytracer = CpuRaytracer(scene, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    CameraGPU camera = initCamera();
+    std::vector<glm::vec4> image = raytracer.render(camera);
+    assert(image.size() == IMAGE_WIDTH * IMAGE_HEIGHT);
+    assert(raytracer._Statistics._NbRays == IMAGE_WIDTH * IMAGE_HEIGHT);
+    fprintf(stderr, "\t%f Mrays/s\n", raytracer._Statistics.getRaysPerSecond() / 1e6);
+
+    for(uint32_t y=0; y<IMAGE_HEIGHT; y++){
+        for(uint32_t x=0; x<IMAGE_WIDTH; x++){
+            glm::vec2 pos = glm::vec2(static_cast<float>(x) / IMAGE_WIDTH, static_cast<float>(y) / IMAGE_HEIGHT);
+            Hit expected = bruteForce(scene, Intersection::setupRay(CpuRaytracer::getRay(camera, pos)));
+            glm::vec4 expectedColor = glm::vec4(0.f, 0.f, 0.f, 1.f);
+            if(expected._DidHit){
+                expectedColor += MODEL_COLOR;
+            }
+            assert(image[y*IMAGE_WIDTH + x] == expectedColor);
+        }
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testWriteImage(const CpuScenePtr& scene){
+    fprintf(stderr, "\nBegin test: write image...\n");
+    CpuRaytracer raytracer = CpuRaytracer(scene, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    std::vector<glm::vec4> image = raytracer.render(initCamera());
+    CpuRaytracer::writeImage(IMAGE_PATH, image, IMAGE_WIDTH, IMAGE_HEIGHT);
+
+    FILE* file = fopen(IMAGE_PATH.c_str(), "rb");
+    assert(file != nullptr);
+    uint32_t width = 0, height = 0, maxValue = 0;
+    assert(fscanf(file, "P6 %u %u %u", &width, &height, &maxValue) == 3);
+    assert(width == IMAGE_WIDTH && height == IMAGE_HEIGHT && maxValue == 255);
+    fgetc(file);
+    std::vector<unsigned char> pixels = std::vector<unsigned char>(3 * width * height);
+    assert(fread(pixels.data(), 1, pixels.size(), file) == pixels.size());
+    fclose(file);
+    remove(IMAGE_PATH.c_str());
+
+    // the first row of the file is the top of the image
+    for(uint32_t x=0; x<IMAGE_WIDTH; x++){
+        glm::vec4 color = image[(IMAGE_HEIGHT-1)*IMAGE_WIDTH + x];
+        assert(pixels[3*x] == static_cast<unsigned char>(std::lround(color.r * 255.f)));
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    CpuScenePtr scene = initScene();
+    testTraversal(scene);
+    testPacket(scene);
+    testAnyHit(scene);
+    testBatchedQueries(scene);
+    testRender(scene);
+    testWriteImage(scene);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "simdKernels.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t NB_RAYS = 2 << 10;
+const uint32_t NB_TRIANGLES = 2 << 8;
+const uint32_t NB_BOXES = 2 << 8;
+const SimdIsa ISAS[] = {SIMD_SSE4, SIMD_AVX2, SIMD_AVX512};
+const char* ISA_NAMES[] = {"sse4", "avx2", "avx512"};
+
+
+///// helpers
+bool isSameFloat(float a, float b){
+    // bitwise so that NaN and signed zeros are compared too
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+std::vector<RaySetup> initRays(std::mt19937& gen){
+    std::uniform_real_distribution<float> distrib(-1.f, 1.f);
+    std::vector<RaySetup> rays{};
+    for(uint32_t i=0; i<NB_RAYS; i++){
+        glm::vec3 origin = 3.f * glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        // aimed at the primitives
+        glm::vec3 direction = glm::vec3(distrib(gen), distrib(gen), distrib(gen)) - origin;
+        // axis aligned directions exercise the infinite inverses
+        if(i % 8 == 0){
+            direction[i % 3] = 0.f;
+        }
+        if(i % 16 == 0){
+            direction[(i+1) % 3] = 0.f;
+        }
+        rays.push_back(Intersection::setupRay({origin, direction}));
+    }
+    return rays;
+}
+
+std::vector<glm::vec3> initTriangles(std::mt19937& gen, TrianglesSoA& soa){
+    std::uniform_real_distribution<float> distrib(-1.f, 1.f);
+    std::vector<glm::vec3> vertices{};
+    for(uint32_t i=0; i<NB_TRIANGLES; i++){
+        glm::vec3 p0 = glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        glm::vec3 p1 = p0 + 0.5f * glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        glm::vec3 p2 = p0 + 0.5f * glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        // degenerate and shared edge triangles
+        if(i % 32 == 1){
+            p2 = p1;
+        }
+        if(i % 32 == 2){
+            p0 = vertices[vertices.size()-3];
+            p1 = vertices[vertices.size()-2];
+        }
+        vertices.push_back(p0);
+        vertices.push_back(p1);
+        vertices.push_back(p2);
+        soa.push(p0, p1, p2);
+    }
+    return vertices;
+}
+
+std::vector<AABB_GPU> initBoxes(std::mt19937& gen, AABBsSoA& soa){
+    std::uniform_real_distribution<float> distrib(-1.f, 1.f);
+    std::vector<AABB_GPU> boxes{};
+    for(uint32_t i=0; i<NB_BOXES; i++){
+        glm::vec3 a = glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        glm::vec3 b = glm::vec3(distrib(gen), distrib(gen), distrib(gen));
+        AABB_GPU box{};
+        box._Min = glm::min(a, b);
+        box._Max = glm::max(a, b);
+        // flat boxes, as produced by axis aligned triangles
+        if(i % 16 == 3){
+            box._Max[i % 3] = box._Min[i % 3];
+        }
+        boxes.push_back(box);
+        soa.push(box);
+    }
+    return boxes;
+}
+
+Hit closestTriangleReference(const RaySetup& ray, const std::vector<glm::vec3>& vertices, uint32_t first, uint32_t count, float tMax){
+    Hit closestHit{};
+    for(uint32_t i=first; i<first+count; i++){
+        Hit hit{};
+        if(Intersection::rayTriangleMollerTrumbore(ray, vertices[3*i], vertices[3*i+1], vertices[3*i+2], tMax, hit)){
+            hit._TriangleId = i;
+            closestHit = hit;
+            tMax = hit._Coords.w;
+        }
+    }
+    return closestHit;
+}
+
+
+///// tests
+void testTriangles(const SimdKernels& kernels, const std::vector<RaySetup>& rays){
+    fprintf(stderr, "\nBegin test: %s triangles...\n", ISA_NAMES[kernels._Isa]);
+    std::mt19937 gen(42);
+    TrianglesSoA soa{};
+    std::vector<glm::vec3> vertices = initTriangles(gen, soa);
+    assert(soa.size() == NB_TRIANGLES);
+
+    uint32_t nbHits = 0;
+    for(uint32_t r=0; r<rays.size(); r++){
+        // every start and remainder within a register, then the whole array
+        uint32_t first = r % kernels._Width;
+        uint32_t count = r % 2 == 0 ? NB_TRIANGLES - first : (r / 2) % (2 * kernels._Width);
+        float tMax = r % 3 == 0 ? 2.f : INFINITY;
+
+        Hit expected = closestTriangleReference(rays[r], vertices, first, count, tMax);
+        Hit hit{};
+        bool didHit = kernels._ClosestTriangle(rays[r], soa, first, count, tMax, hit);
+        assert(didHit == expected._DidHit);
+        if(didHit){
+            assert(hit._TriangleId == expected._TriangleId);
+            for(int i=0; i<4; i++){
+                assert(isSameFloat(hit._Coords[i], expected._Coords[i]));
+            }
+            nbHits++;
+        }
+    }
+    // the test is meaningless if every ray misses
+    assert(nbHits > NB_RAYS / 4);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testBoxes(const SimdKernels& kernels, const std::vector<RaySetup>& rays){
+    fprintf(stderr, "\nBegin test: %s boxes...\n", ISA_NAMES[kernels._Isa]);
+    std::mt19937 gen(42);
+    AABBsSoA soa{};
+    std::vector<AABB_GPU> boxes = initBoxes(gen, soa);
+    assert(soa.size() == NB_BOXES);
+
+    std::vector<float> tEntries = std::vector<float>(NB_BOXES);
+    for(uint32_t r=0; r<rays.size(); r++){
+        uint32_t first = r % kernels._Width;
+        uint32_t count = NB_BOXES - first - (r / kernels._Width) % kernels._Width;
+        float tMax = r % 3 == 0 ? 1.f : INFINITY;
+
+        uint32_t nbHits = kernels._IntersectBoxes(rays[r], soa, first, count, tMax, tEntries.data());
+        uint32_t nbExpectedHits = 0;
+        for(uint32_t i=0; i<count; i++){
+            float tEntry = -1.f;
+            if(Intersection::rayAABB(rays[r], boxes[first+i], tMax, tEntry)){
+                nbExpectedHits++;
+            }
+            assert(isSameFloat(tEntries[i], tEntry));
+        }
+        assert(nbHits == nbExpectedHits);
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testRangeEnd(const SimdKernels& kernels, const std::vector<RaySetup>& rays){
+    fprintf(stderr, "\nBegin test: %s range end...\n", ISA_NAMES[kernels._Isa]);
+    // a single padded block, every first that is not a multiple of the width ends at the last allocated float
+    std::mt19937 gen(7);
+    TrianglesSoA triangles{};
+    AABBsSoA boxes{};
+    std::vector<glm::vec3> vertices = initTriangles(gen, triangles);
+    std::vector<AABB_GPU> aabbs = initBoxes(gen, boxes);
+    TrianglesSoA block{};
+    AABBsSoA boxBlock{};
+    for(uint32_t i=0; i<TrianglesSoA::PADDING; i++){
+        block.push(vertices[3*i], vertices[3*i+1], vertices[3*i+2]);
+        boxBlock.push(aabbs[i]);
+    }
+    for(int axis=0; axis<3; axis++){
+        assert(block._P0[axis].size() == TrianglesSoA::PADDING && boxBlock._Min[axis].size() == AABBsSoA::PADDING);
+    }
+
+    std::vector<float> tEntries = std::vector<float>(AABBsSoA::PADDING);
+    for(uint32_t r=0; r<rays.size(); r++){
+        uint32_t first = r % TrianglesSoA::PADDING;
+        uint32_t count = TrianglesSoA::PADDING - first;
+        Hit expected = closestTriangleReference(rays[r], vertices, first, count, INFINITY);
+        Hit hit{};
+        assert(kernels._ClosestTriangle(rays[r], block, first, count, INFINITY, hit) == expected._DidHit);
+        assert(!hit._DidHit || hit._TriangleId == expected._TriangleId);
+
+        uint32_t nbHits = kernels._IntersectBoxes(rays[r], boxBlock, first, count, INFINITY, tEntries.data());
+        uint32_t nbExpectedHits = 0;
+        for(uint32_t i=0; i<count; i++){
+            float tEntry = -1.f;
+            nbExpectedHits += Intersection::rayAABB(rays[r], aabbs[first+i], INFINITY, tEntry) ? 1 : 0;
+            assert(isSameFloat(tEntries[i], tEntry));
+        }
+        assert(nbHits == nbExpectedHits);
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    std::mt19937 gen(0);
+    std::vector<RaySetup> rays = initRays(gen);
+    for(SimdIsa isa : ISAS){
+        if(!SimdKernels::isSupported(isa)){
+            fprintf(stderr, "\n%s is not supported, skipped\n", ISA_NAMES[isa]);
+            continue;
+        }
+        const SimdKernels& kernels = SimdKernels::get(isa);
+        assert(kernels._Isa == isa);
+        testTriangles(kernels, rays);
+        testBoxes(kernels, rays);
+        testRangeEnd(kernels, rays);
+    }
+    fprintf(stderr, "\nDispatched to %s\n", ISA_NAMES[SimdKernels::get()._Isa]);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
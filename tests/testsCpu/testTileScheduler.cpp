@@ -0,0 +1,119 @@
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "tileScheduler.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t IMAGE_WIDTH = 203;
+const uint32_t IMAGE_HEIGHT = 117;
+const uint32_t TILE_SIZE = 16;
+const uint32_t NB_THREADS[] = {1, 2, 4, 7};
+
+
+///// tests
+void testCoverage(){
+    fprintf(stderr, "\nBegin test: every pixel rendered once...\n");
+    for(uint32_t nbThreads : NB_THREADS){
+        TileScheduler scheduler = TileScheduler(nbThreads);
+        std::vector<Tile> tiles = TileScheduler::getMortonOrderedTiles(IMAGE_WIDTH, IMAGE_HEIGHT, TILE_SIZE);
+        std::vector<std::atomic<uint32_t>> pixels = std::vector<std::atomic<uint32_t>>(IMAGE_WIDTH * IMAGE_HEIGHT);
+        scheduler.run(tiles, [&](const Tile& tile){
+            for(uint32_t y=tile._Y0; y<tile._Y1; y++){
+                for(uint32_t x=tile._X0; x<tile._X1; x++){
+                    pixels[y*IMAGE_WIDTH + x]++;
+                }
+            }
+        });
+        for(const std::atomic<uint32_t>& pixel : pixels){
+            assert(pixel == 1);
+        }
+
+        uint32_t nbTiles = 0;
+        assert(scheduler._Statistics._Threads.size() == nbThreads);
+        for(const TileSchedulerThreadStatistics& thread : scheduler._Statistics._Threads){
+            nbTiles += thread._NbTiles;
+            assert(thread._BusyTime <= scheduler._Statistics._WallTime);
+        }
+        assert(nbTiles == tiles.size());
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testMortonOrder(){
+    fprintf(stderr, "\nBegin test: morton order...\n");
+    std::vector<Tile> tiles = TileScheduler::getMortonOrderedTiles(4 * TILE_SIZE, 4 * TILE_SIZE, TILE_SIZE);
+    assert(tiles.size() == 16);
+    // each group of four tiles is a 2x2 block
+    for(uint32_t block=0; block<4; block++){
+        const Tile& first = tiles[4*block];
+        assert(first._X0 % (2*TILE_SIZE) == 0 && first._Y0 % (2*TILE_SIZE) == 0);
+        assert(tiles[4*block + 1]._X0 == first._X0 + TILE_SIZE && tiles[4*block + 1]._Y0 == first._Y0);
+        assert(tiles[4*block + 2]._X0 == first._X0 && tiles[4*block + 2]._Y0 == first._Y0 + TILE_SIZE);
+        assert(tiles[4*block + 3]._X0 == first._X0 + TILE_SIZE && tiles[4*block + 3]._Y0 == first._Y0 + TILE_SIZE);
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testAdaptiveTileSize(){
+    fprintf(stderr, "\nBegin test: adaptive tile size...\n");
+    TileScheduler fewThreads = TileScheduler(1);
+    TileScheduler manyThreads = TileScheduler(64);
+    uint32_t largeTiles = fewThreads.getAdaptiveTileSize(1920, 1080, 64);
+    uint32_t smallTiles = manyThreads.getAdaptiveTileSize(1920, 1080, 64);
+    assert(largeTiles == 64);
+    assert(smallTiles < largeTiles && smallTiles >= TileScheduler::MIN_TILE_SIZE);
+    uint32_t nbTiles = TileScheduler::getMortonOrderedTiles(1920, 1080, smallTiles).size();
+    assert(nbTiles >= TileScheduler::TILES_PER_THREAD * 64 || smallTiles == TileScheduler::MIN_TILE_SIZE);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testStealing(){
+    fprintf(stderr, "\nBegin test: work stealing...\n");
+    const uint32_t nbThreads = 4;
+    TileScheduler scheduler = TileScheduler(nbThreads);
+    std::vector<Tile> tiles = TileScheduler::getMortonOrderedTiles(IMAGE_WIDTH, IMAGE_HEIGHT, TILE_SIZE);
+    // the range of the first thread is the only expensive one
+    uint32_t nbExpensiveTiles = tiles.size() / nbThreads;
+    std::vector<Tile> expensiveTiles(tiles.begin(), tiles.begin() + nbExpensiveTiles);
+    scheduler.run(tiles, [&](const Tile& tile){
+        // stands for dense geometry
+        for(const Tile& expensiveTile : expensiveTiles){
+            if(expensiveTile._X0 == tile._X0 && expensiveTile._Y0 == tile._Y0){
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    });
+
+    uint32_t nbStolenTiles = 0;
+    for(uint32_t i=0; i<nbThreads; i++){
+        const TileSchedulerThreadStatistics& thread = scheduler._Statistics._Threads[i];
+        fprintf(stderr, "\tthread %u: busy %f ms, idle %f ms, %u tiles, %u stolen\n",
+            i, 1000. * thread._BusyTime, 1000. * thread._IdleTime, thread._NbTiles, thread._NbStolenTiles
+        );
+        nbStolenTiles += thread._NbStolenTiles;
+    }
+    // the other threads help the first one
+    assert(nbStolenTiles > 0);
+    assert(scheduler._Statistics._Threads[0]._NbTiles < nbExpensiveTiles);
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    testCoverage();
+    testMortonOrder();
+    testAdaptiveTileSize();
+    testStealing();
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "cpuRaytracer.hpp"
+#include "cpuScene.hpp"
+#include "denoiser.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t IMAGE_WIDTH = 64;
+const uint32_t IMAGE_HEIGHT = 32;
+const uint32_t NB_PIXELS = IMAGE_WIDTH * IMAGE_HEIGHT;
+// two walls meeting in the middle of the image, the right one is brighter
+const glm::vec3 LEFT_ALBEDO = glm::vec3(1.f, 0.5f, 0.25f);
+const glm::vec3 RIGHT_ALBEDO = glm::vec3(0.25f, 0.5f, 1.f);
+const float LEFT_ILLUMINATION = 0.5f;
+const float RIGHT_ILLUMINATION = 1.f;
+const float NOISE_AMPLITUDE = 0.25f;
+
+
+///// helpers
+bool isLeft(size_t index){
+    return index % IMAGE_WIDTH < IMAGE_WIDTH / 2;
+}
+
+std::vector<DenoiserGuide> initGuides(){
+    std::vector<DenoiserGuide> guides = std::vector<DenoiserGuide>(NB_PIXELS);
+    for(size_t i=0; i<NB_PIXELS; i++){
+        guides[i]._Normal = isLeft(i) ? glm::vec3(0.f, 0.f, -1.f) : glm::vec3(-1.f, 0.f, 0.f);
+        guides[i]._Depth = 5.f;
+        guides[i]._Albedo = isLeft(i) ? LEFT_ALBEDO : RIGHT_ALBEDO;
+    }
+    return guides;
+}
+
+std::vector<glm::vec4> initImage(const std::vector<DenoiserGuide>& guides, float noiseAmplitude){
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> distrib(-noiseAmplitude, noiseAmplitude);
+    std::vector<glm::vec4> image = std::vector<glm::vec4>(NB_PIXELS);
+    for(size_t i=0; i<NB_PIXELS; i++){
+        float illumination = (isLeft(i) ? LEFT_ILLUMINATION : RIGHT_ILLUMINATION) + distrib(gen);
+        image[i] = glm::vec4(guides[i]._Albedo * illumination, 1.f);
+    }
+    return image;
+}
+
+float getMeanError(const std::vector<glm::vec4>& image, const std::vector<glm::vec4>& reference){
+    float error = 0.f;
+    for(size_t i=0; i<image.size(); i++){
+        error += glm::length(image[i] - reference[i]);
+    }
+    return error / image.size();
+}
+
+
+///// tests
+void testKernelWeights(){
+    fprintf(stderr, "\nBegin test: kernel weights...\n");
+    float sum = 0.f;
+    for(int32_t dy=-2; dy<=2; dy++){
+        for(int32_t dx=-2; dx<=2; dx++){
+            sum += Denoiser::getKernelWeight(dx, dy);
+            assert(Denoiser::getKernelWeight(dx, dy) == Denoiser::getKernelWeight(-dx, dy));
+        }
+    }
+    assert(std::abs(sum - 1.f) < 1e-6f);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testNoiseFreeImage(){
+    fprintf(stderr, "\nBegin test: noise free image...\n");
+    // a flat illumination has no variance, the albedo is kept as it is
+    std::vector<DenoiserGuide> guides = initGuides();
+    std::vector<glm::vec4> image = initImage(guides, 0.f);
+    Denoiser denoiser = Denoiser(IMAGE_WIDTH, IMAGE_HEIGHT);
+    std::vector<glm::vec4> denoisedImage = denoiser.denoise(image, guides);
+    for(size_t i=0; i<NB_PIXELS; i++){
+        assert(glm::length(denoisedImage[i] - image[i]) < 1e-5f);
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testEdgePreservation(){
+    fprintf(stderr, "\nBegin test: edge preservation...\n");
+    std::vector<DenoiserGuide> guides = initGuides();
+    std::vector<glm::vec4> reference = initImage(guides, 0.f);
+    std::vector<glm::vec4> image = initImage(guides, NOISE_AMPLITUDE);
+    Denoiser denoiser = Denoiser(IMAGE_WIDTH, IMAGE_HEIGHT);
+    std::vector<glm::vec4> denoisedImage = denoiser.denoise(image, guides);
+
+    float noisyError = getMeanError(image, reference);
+    float denoisedError = getMeanError(denoisedImage, reference);
+    fprintf(stderr, "\tmean error %.3e instead of %.3e\n", denoisedError, noisyError);
+    assert(denoisedError < noisyError / 4.f);
+    // nothing leaks across the crease, the two sides are far apart
+    for(uint32_t y=0; y<IMAGE_HEIGHT; y++){
+        for(uint32_t x=IMAGE_WIDTH / 2 - 1; x<=IMAGE_WIDTH / 2; x++){
+            size_t index = y * IMAGE_WIDTH + x;
+            assert(glm::length(denoisedImage[index] - reference[index]) < NOISE_AMPLITUDE / 2.f);
+        }
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testMisses(){
+    fprintf(stderr, "\nBegin test: misses...\n");
+    // the top rows see the sky
+    std::vector<DenoiserGuide> guides = initGuides();
+    for(size_t i=NB_PIXELS / 2; i<NB_PIXELS; i++){
+        guides[i] = DenoiserGuide{};
+    }
+    std::vector<glm::vec4> image = initImage(guides, NOISE_AMPLITUDE);
+    Denoiser denoiser = Denoiser(IMAGE_WIDTH, IMAGE_HEIGHT);
+    std::vector<glm::vec4> denoisedImage = denoiser.denoise(image, guides);
+    for(size_t i=NB_PIXELS / 2; i<NB_PIXELS; i++){
+        assert(glm::length(denoisedImage[i] - image[i]) < 1e-6f);
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testRaytracerGuides(){
+    fprintf(stderr, "\nBegin test: raytracer guides...\n");
+    std::vector<Material> materials = {Material(), Material({0.2, 0.3, 0.1, 1.})};
+    MeshPtr teapot = Mesh::load(Mesh::MODELS_DIRECTORY + "teapot.obj");
+    teapot->setMaterial(1);
+    CpuScenePtr scene = CpuScenePtr(new CpuScene({teapot}, materials));
+    Camera camera = Camera(glm::vec3(0.f, 0.f, -5.f), static_cast<float>(IMAGE_WIDTH) / IMAGE_HEIGHT);
+    CpuRaytracer raytracer = CpuRaytracer(scene, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    std::vector<DenoiserGuide> guides = raytracer.renderGuides(camera.getGpuData());
+
+    // the corners miss the teapot
+    assert(guides[0]._Normal == glm::vec3(0.f) && guides[0]._Albedo == glm::vec3(1.f));
+    uint32_t nbHits = 0;
+    for(const DenoiserGuide& guide : guides){
+        if(guide._Normal == glm::vec3(0.f)){
+            continue;
+        }
+        nbHits++;
+        assert(std::abs(glm::length(guide._Normal) - 1.f) < 1e-4f);
+        assert(guide._Depth > 0.f && guide._Depth < 10.f);
+        assert(glm::length(guide._Albedo - glm::vec3(0.2f, 0.3f, 0.1f)) < 1e-6f);
+    }
+    assert(nbHits > 0 && nbHits < NB_PIXELS);
+
+    // the noise free image of the raytracer is barely changed
+    std::vector<glm::vec4> image = raytracer.render(camera.getGpuData());
+    raytracer._Parameters._Denoiser._IsOn = true;
+    std::vector<glm::vec4> denoisedImage = raytracer.render(camera.getGpuData());
+    assert(getMeanError(denoisedImage, image) < 1e-3f);
+    assert(raytracer._Statistics._DenoisingTime > 0.);
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    testKernelWeights();
+    testNoiseFreeImage();
+    testEdgePreservation();
+    testMisses();
+    testRaytracerGuides();
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
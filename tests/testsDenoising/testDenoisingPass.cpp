@@ -0,0 +1,133 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include "application.hpp"
+#include "denoiser.hpp"
+
+namespace glr{
+
+///// constants
+const uint32_t IMAGE_WIDTH = 64;
+const uint32_t IMAGE_HEIGHT = 32;
+const uint32_t NB_PIXELS = IMAGE_WIDTH * IMAGE_HEIGHT;
+const float NOISE_AMPLITUDE = 0.25f;
+
+
+///// helpers
+GLuint initImage(){
+    GLuint texture = 0;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    assert(texture != 0);
+    glTextureStorage2D(texture, 1, GL_RGBA32F, IMAGE_WIDTH, IMAGE_HEIGHT);
+    glBindImageTexture(0, texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    return texture;
+}
+
+std::vector<glm::vec4> readImage(GLuint texture){
+    std::vector<glm::vec4> pixels(NB_PIXELS);
+    glGetTextureImage(texture, 0, GL_RGBA, GL_FLOAT, sizeof(glm::vec4) * NB_PIXELS, pixels.data());
+    return pixels;
+}
+
+void writeImage(GLuint texture, const std::vector<glm::vec4>& pixels){
+    glTextureSubImage2D(texture, 0, 0, 0, IMAGE_WIDTH, IMAGE_HEIGHT, GL_RGBA, GL_FLOAT, pixels.data());
+}
+
+// two walls meeting in the middle of the image under a strip of sky, as written by a tracer
+std::vector<cr::DenoiserGuide> initGuides(){
+    std::vector<cr::DenoiserGuide> guides = std::vector<cr::DenoiserGuide>(NB_PIXELS);
+    for(size_t i=0; i<NB_PIXELS; i++){
+        if(i >= NB_PIXELS - 4 * IMAGE_WIDTH){
+            continue;
+        }
+        bool isLeft = i % IMAGE_WIDTH < IMAGE_WIDTH / 2;
+        guides[i]._Normal = isLeft ? glm::vec3(0.f, 0.f, -1.f) : glm::vec3(-1.f, 0.f, 0.f);
+        guides[i]._Depth = 5.f + 0.01f * (i % IMAGE_WIDTH);
+        guides[i]._Albedo = isLeft ? glm::vec3(1.f, 0.5f, 0.25f) : glm::vec3(0.25f, 0.5f, 1.f);
+    }
+    return guides;
+}
+
+void writeGuides(DenoisingPassPtr denoisingPass, const std::vector<cr::DenoiserGuide>& guides){
+    std::vector<glm::vec4> normalDepths(NB_PIXELS);
+    std::vector<glm::vec4> albedos(NB_PIXELS);
+    for(size_t i=0; i<NB_PIXELS; i++){
+        normalDepths[i] = glm::vec4(guides[i]._Normal, guides[i]._Depth);
+        albedos[i] = glm::vec4(guides[i]._Albedo, 1.f);
+    }
+    writeImage(denoisingPass->getNormalDepthTexture(), normalDepths);
+    writeImage(denoisingPass->getAlbedoTexture(), albedos);
+}
+
+std::vector<glm::vec4> initNoisyImage(const std::vector<cr::DenoiserGuide>& guides){
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> distrib(-NOISE_AMPLITUDE, NOISE_AMPLITUDE);
+    std::vector<glm::vec4> image = std::vector<glm::vec4>(NB_PIXELS);
+    for(size_t i=0; i<NB_PIXELS; i++){
+        float illumination = (i % IMAGE_WIDTH < IMAGE_WIDTH / 2 ? 0.5f : 1.f) + distrib(gen);
+        image[i] = glm::vec4(guides[i]._Albedo * illumination, 1.f);
+    }
+    return image;
+}
+
+
+///// tests
+void testMatchesCpu(DenoisingPassPtr denoisingPass, GLuint texture){
+    fprintf(stderr, "\nBegin test: matches the cpu denoiser...\n");
+    std::vector<cr::DenoiserGuide> guides = initGuides();
+    std::vector<glm::vec4> image = initNoisyImage(guides);
+    writeGuides(denoisingPass, guides);
+    writeImage(texture, image);
+
+    for(uint32_t nbIterations : {1u, 3u, 5u}){
+        denoisingPass->_Parameters._NbIterations = nbIterations;
+        denoisingPass->denoise();
+        std::vector<glm::vec4> pixels = readImage(denoisingPass->getTexture());
+        cr::Denoiser denoiser = cr::Denoiser(IMAGE_WIDTH, IMAGE_HEIGHT, denoisingPass->_Parameters);
+        std::vector<glm::vec4> expected = denoiser.denoise(image, guides);
+        for(uint32_t i=0; i<NB_PIXELS; i++){
+            assert(glm::length(pixels[i] - expected[i]) < 1e-3f);
+        }
+    }
+    // the traced image is left as it is
+    std::vector<glm::vec4> pixels = readImage(texture);
+    for(uint32_t i=0; i<NB_PIXELS; i++){
+        assert(pixels[i] == image[i]);
+    }
+    denoisingPass->_Parameters = {._IsOn = true};
+    fprintf(stderr, "\tOk\n");
+}
+
+void testUpToDate(DenoisingPassPtr denoisingPass){
+    fprintf(stderr, "\nBegin test: up to date...\n");
+    denoisingPass->denoise();
+    assert(denoisingPass->isUpToDate());
+    // a new traced image
+    denoisingPass->invalidate();
+    assert(!denoisingPass->isUpToDate());
+    denoisingPass->denoise();
+    assert(denoisingPass->isUpToDate());
+    // new parameters
+    denoisingPass->_Parameters._LuminancePhi *= 2.f;
+    assert(!denoisingPass->isUpToDate());
+    denoisingPass->_Parameters = {._IsOn = true};
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace glr;
+
+///// main
+int main() {
+    Application app = Application::dummyApplication();
+    GLuint texture = initImage();
+    DenoisingPassPtr denoisingPass = DenoisingPassPtr(new DenoisingPass(IMAGE_WIDTH, IMAGE_HEIGHT));
+
+    testMatchesCpu(denoisingPass, texture);
+    testUpToDate(denoisingPass);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include "intersection.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t NB_RAYS = 2 << 14;
+const uint32_t NB_FAN_TRIANGLES = 7;
+
+
+///// helpers
+bool hitsAny(const RaySetup& ray, const std::vector<glm::vec3>& vertices){
+    for(size_t i=0; i<vertices.size(); i+=3){
+        Hit hit{};
+        if(Intersection::rayTriangle(ray, vertices[i], vertices[i+1], vertices[i+2], INFINITY, hit)){
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<glm::vec3> initFan(const glm::vec3& center){
+    // triangles sharing the center vertex and their consecutive edges
+    std::vector<glm::vec3> vertices{};
+    for(uint32_t i=0; i<NB_FAN_TRIANGLES; i++){
+        float theta0 = 2.f * 3.14159265f * i / NB_FAN_TRIANGLES;
+        float theta1 = 2.f * 3.14159265f * (i+1) / NB_FAN_TRIANGLES;
+        vertices.push_back(center);
+        vertices.push_back(center + glm::vec3(std::cos(theta0), std::sin(theta0), 0.f));
+        vertices.push_back(center + glm::vec3(std::cos(theta1), std::sin(theta1), 0.f));
+    }
+    return vertices;
+}
+
+
+///// tests
+void testSharedEdges(){
+    fprintf(stderr, "\nBegin test: shared edges...\n");
+    // a square split along its diagonal
+    std::vector<glm::vec3> vertices = {
+        {-1.f, -1.f, 0.f}, {1.f, -1.f, 0.f}, {1.f, 1.f, 0.f},
+        {-1.f, -1.f, 0.f}, {1.f, 1.f, 0.f}, {-1.f, 1.f, 0.f},
+    };
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> distrib(-0.99f, 0.99f);
+    for(uint32_t i=0; i<NB_RAYS; i++){
+        // rays aimed exactly at the diagonal from random origins
+        float x = distrib(gen);
+        glm::vec3 origin = glm::vec3(distrib(gen), distrib(gen), -5.f);
+        Ray ray{origin, glm::vec3(x, x, 0.f) - origin};
+        assert(hitsAny(Intersection::setupRay(ray), vertices));
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testSharedVertex(){
+    fprintf(stderr, "\nBegin test: shared vertex...\n");
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> distrib(-10.f, 10.f);
+    for(uint32_t i=0; i<NB_RAYS; i++){
+        glm::vec3 center = glm::vec3(distrib(gen), distrib(gen), 0.f);
+        std::vector<glm::vec3> vertices = initFan(center);
+        glm::vec3 origin = glm::vec3(distrib(gen), distrib(gen), distrib(gen) - 20.f);
+        Ray ray{origin, center - origin};
+        assert(hitsAny(Intersection::setupRay(ray), vertices));
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testBackFace(){
+    fprintf(stderr, "\nBegin test: back face...\n");
+    glm::vec3 p0 = {-1.f, -1.f, 0.f};
+    glm::vec3 p1 = {1.f, -1.f, 0.f};
+    glm::vec3 p2 = {0.f, 1.f, 0.f};
+    Ray front{{0.f, 0.f, -1.f}, {0.f, 0.f, 1.f}};
+    Ray back{{0.f, 0.f, 1.f}, {0.f, 0.f, -1.f}};
+    Hit frontHit{};
+    Hit backHit{};
+    assert(Intersection::rayTriangle(Intersection::setupRay(front), p0, p1, p2, INFINITY, frontHit));
+    assert(Intersection::rayTriangle(Intersection::setupRay(back), p0, p1, p2, INFINITY, backHit));
+    assert(std::abs(frontHit._Coords.w - 1.f) < 1e-6f);
+    assert(std::abs(backHit._Coords.w - 1.f) < 1e-6f);
+    // barycentric coordinates sum to one and match the hit point
+    glm::vec3 point = frontHit._Coords.x * p0 + frontHit._Coords.y * p1 + frontHit._Coords.z * p2;
+    assert(glm::length(point) < 1e-6f);
+    // out of range
+    Hit farHit{};
+    assert(!Intersection::rayTriangle(Intersection::setupRay(front), p0, p1, p2, 0.5f, farHit));
+    fprintf(stderr, "\tOk\n");
+}
+
+void testSlabs(){
+    fprintf(stderr, "\nBegin test: slabs...\n");
+    AABB_GPU box{};
+    box._Min = glm::vec3(-1.f);
+    box._Max = glm::vec3(1.f);
+    float tEntry = 0.f;
+    // axis aligned ray with null direction components
+    Ray axis{{0.f, 0.f, -5.f}, {0.f, 0.f, 1.f}};
+    assert(Intersection::rayAABB(Intersection::setupRay(axis), box, INFINITY, tEntry));
+    assert(std::abs(tEntry - 4.f) < 1e-6f);
+    // grazing the face of the box
+    Ray grazing{{1.f, 0.f, -5.f}, {0.f, 0.f, 1.f}};
+    assert(Intersection::rayAABB(Intersection::setupRay(grazing), box, INFINITY, tEntry));
+    // flat box, as produced by axis aligned triangles
+    AABB_GPU flatBox{};
+    flatBox._Min = glm::vec3(-1.f, -1.f, 0.f);
+    flatBox._Max = glm::vec3(1.f, 1.f, 0.f);
+    Ray diagonal{{-3.f, -2.f, -1.f}, {3.f, 2.f, 1.f}};
+    assert(Intersection::rayAABB(Intersection::setupRay(diagonal), flatBox, INFINITY, tEntry));
+    // missing and behind the origin
+    Ray miss{{0.f, 2.f, -5.f}, {0.f, 0.f, 1.f}};
+    assert(!Intersection::rayAABB(Intersection::setupRay(miss), box, INFINITY, tEntry));
+    Ray behind{{0.f, 0.f, 5.f}, {0.f, 0.f, 1.f}};
+    assert(!Intersection::rayAABB(Intersection::setupRay(behind), box, INFINITY, tEntry));
+    // closer hit already found
+    assert(!Intersection::rayAABB(Intersection::setupRay(axis), box, 3.f, tEntry));
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    testSharedEdges();
+    testSharedVertex();
+    testBackFace();
+    testSlabs();
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+
+#include "application.hpp"
+
+namespace glr{
+
+///// constants
+const uint32_t IMAGE_WIDTH = 256;
+const uint32_t IMAGE_HEIGHT = 256;
+const uint32_t NB_PIXELS = IMAGE_WIDTH * IMAGE_HEIGHT;
+const glm::vec4 BACKGROUND_COLOR = glm::vec4(0.f, 0.f, 0.f, 1.f);
+// the rasterizer and the ray tracer may disagree on the silhouette
+const float MAX_MISMATCH_RATIO = 0.005f;
+
+
+///// helpers
+GLuint initImage(){
+    GLuint texture = 0;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    assert(texture != 0);
+    glTextureStorage2D(texture, 1, GL_RGBA32F, IMAGE_WIDTH, IMAGE_HEIGHT);
+    glBindImageTexture(0, texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    return texture;
+}
+
+std::vector<glm::vec4> readImage(GLuint texture){
+    std::vector<glm::vec4> pixels(NB_PIXELS);
+    glGetTextureImage(texture, 0, GL_RGBA, GL_FLOAT, sizeof(glm::vec4) * NB_PIXELS, pixels.data());
+    return pixels;
+}
+
+void updateFrameUBO(UniformBufferPtr ubo, bool isPrimaryRasterized){
+    cr::Camera camera(glm::vec3(0.f, 0.f, -5.f), static_cast<float>(IMAGE_WIDTH) / IMAGE_HEIGHT);
+    FrameDataGPU frameData{};
+    frameData._Camera = camera.getGpuData();
+    frameData._IsPrimaryRasterized = isPrimaryRasterized ? 1 : 0;
+    ubo->update(&frameData, sizeof(FrameDataGPU));
+}
+
+ScenePtr initScene(){
+    ScenePtr scene = ScenePtr(new Scene());
+    scene->addMaterial({0.2, 0.3, 0.1, 1.});
+    cr::MeshPtr model = cr::Mesh::load(cr::Mesh::MODELS_DIRECTORY + "teapot.obj");
+    model->setMaterial(1);
+    scene->addMesh(model);
+    return scene;
+}
+
+std::vector<glm::vec4> renderMegakernel(ProgramPtr program, GLuint texture){
+    program->use();
+    glDispatchCompute(IMAGE_WIDTH / 16, IMAGE_HEIGHT / 16, 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+    return readImage(texture);
+}
+
+float getMismatchRatio(const std::vector<glm::vec4>& traced, const std::vector<glm::vec4>& rasterized, const glm::vec4& missColor){
+    uint32_t nbMismatches = 0;
+    uint32_t nbHits = 0;
+    for(uint32_t i=0; i<NB_PIXELS; i++){
+        bool tracedHit = glm::length(traced[i] - missColor) > 1e-5f;
+        bool rasterizedHit = glm::length(rasterized[i] - missColor) > 1e-5f;
+        nbMismatches += tracedHit != rasterizedHit ? 1 : 0;
+        nbHits += tracedHit ? 1 : 0;
+    }
+    assert(nbHits > 0);
+    fprintf(stderr, "\t%u mismatches out of %u hits\n", nbMismatches, nbHits);
+    return static_cast<float>(nbMismatches) / NB_PIXELS;
+}
+
+
+///// tests
+void testMegakernel(ProgramPtr megakernel, UniformBufferPtr ubo, VisibilityBufferPtr visibility, ScenePtr scene, GLuint texture){
+    fprintf(stderr, "\nBegin test: megakernel...\n");
+    updateFrameUBO(ubo, false);
+    std::vector<glm::vec4> traced = renderMegakernel(megakernel, texture);
+    updateFrameUBO(ubo, true);
+    visibility->render(scene->getMeshModelToGPUData());
+    std::vector<glm::vec4> rasterized = renderMegakernel(megakernel, texture);
+    assert(getMismatchRatio(traced, rasterized, BACKGROUND_COLOR) < MAX_MISMATCH_RATIO);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testWavefront(WavefrontTracerPtr tracer, UniformBufferPtr ubo, VisibilityBufferPtr visibility, ScenePtr scene, GLuint texture){
+    fprintf(stderr, "\nBegin test: wavefront...\n");
+    // only the direct lighting, the misses show the sky
+    const glm::vec4 SKY_COLOR = glm::vec4(0.2f, 0.3f, 0.3f, 1.f);
+    tracer->_Parameters._MaxDepth = 0;
+
+    updateFrameUBO(ubo, false);
+    tracer->_Parameters._IsPrimaryRasterized = false;
+    tracer->render();
+    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+    std::vector<glm::vec4> traced = readImage(texture);
+
+    updateFrameUBO(ubo, true);
+    tracer->_Parameters._IsPrimaryRasterized = true;
+    visibility->render(scene->getMeshModelToGPUData());
+    tracer->render();
+    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+    std::vector<glm::vec4> rasterized = readImage(texture);
+
+    assert(getMismatchRatio(traced, rasterized, SKY_COLOR) < MAX_MISMATCH_RATIO);
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace glr;
+
+///// main
+int main() {
+    Application app = Application::dummyApplication();
+    GLuint texture = initImage();
+    UniformBufferPtr frameUBO = UniformBufferPtr(new UniformBuffer(sizeof(FrameDataGPU), 0));
+
+    ShaderPtr computeShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "raytracer.glsl", COMPUTE_SHADER));
+    ProgramPtr megakernel = ProgramPtr(new Program(computeShader));
+    ScenePtr scene = initScene();
+    scene->sendDataToGpu(megakernel);
+    VisibilityBufferPtr visibility = VisibilityBufferPtr(new VisibilityBuffer(IMAGE_WIDTH, IMAGE_HEIGHT));
+    WavefrontTracerPtr tracer = WavefrontTracerPtr(new WavefrontTracer(IMAGE_WIDTH, IMAGE_HEIGHT));
+
+    testMegakernel(megakernel, frameUBO, visibility, scene, texture);
+    testWavefront(tracer, frameUBO, visibility, scene, texture);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "adaptiveSampling.hpp"
+#include "cpuRaytracer.hpp"
+#include "cpuScene.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t IMAGE_WIDTH = 128;
+const uint32_t IMAGE_HEIGHT = 96;
+const uint32_t NB_PIXELS = IMAGE_WIDTH * IMAGE_HEIGHT;
+const uint32_t MIN_NB_SAMPLES = 8;
+const uint32_t MAX_NB_SAMPLES = 64;
+
+
+///// helpers
+CpuScenePtr initScene(){
+    std::vector<Material> materials = {Material(), Material({0.2, 0.3, 0.1, 1.})};
+    MeshPtr teapot = Mesh::load(Mesh::MODELS_DIRECTORY + "teapot.obj");
+    teapot->setMaterial(1);
+    return CpuScenePtr(new CpuScene({teapot}, materials));
+}
+
+CameraGPU initCamera(){
+    Camera camera = Camera(glm::vec3(0.f, 0.f, -5.f), static_cast<float>(IMAGE_WIDTH) / IMAGE_HEIGHT);
+    return camera.getGpuData();
+}
+
+double getRmse(const std::vector<glm::vec4>& image, const std::vector<glm::vec4>& reference){
+    double error = 0.;
+    for(size_t i=0; i<image.size(); i++){
+        glm::vec3 difference = glm::vec3(image[i] - reference[i]);
+        error += glm::dot(difference, difference);
+    }
+    return std::sqrt(error / image.size());
+}
+
+
+///// tests
+void testPixelConvergence(){
+    fprintf(stderr, "\nBegin test: pixel convergence...\n");
+    AdaptiveSampling pixels = AdaptiveSampling(3, 1, {true, 0.01f, MIN_NB_SAMPLES, MAX_NB_SAMPLES});
+    // a constant pixel stops at the minimum number of samples unless it is next to a noisy one
+    // the noisy one goes on until the maximum
+    for(uint32_t i=0; i<MAX_NB_SAMPLES; i++){
+        for(uint32_t x=0; x<2; x++){
+            if(!pixels.isConverged(x, 0)){
+                pixels.addSample(x, 0, glm::vec4(0.5f, 0.5f, 0.5f, 1.f));
+            }
+        }
+        if(!pixels.isConverged(2, 0)){
+            float value = i % 2 == 0 ? 0.f : 2.f;
+            pixels.addSample(2, 0, glm::vec4(value, value, value, 1.f));
+        }
+        pixels.updateConvergence();
+    }
+    assert(pixels.isConverged(0, 0) && pixels.getNbSamples(0, 0) == MIN_NB_SAMPLES);
+    assert(pixels.isConverged(1, 0) && pixels.getNbSamples(1, 0) == MAX_NB_SAMPLES);
+    assert(pixels.isConverged(2, 0) && pixels.getNbSamples(2, 0) == MAX_NB_SAMPLES);
+    assert(pixels.getTotalNbSamples() == MIN_NB_SAMPLES + 2 * MAX_NB_SAMPLES);
+    assert(pixels.getMean(0, 0) == glm::vec4(0.5f, 0.5f, 0.5f, 1.f));
+    assert(pixels.getMean(2, 0) == glm::vec4(1.f, 1.f, 1.f, 1.f));
+    assert(pixels.isConverged(Tile{0, 0, 3, 1}));
+
+    // logarithmic scale from blue for one sample to red for the maximum
+    std::vector<glm::vec4> heatMap = pixels.getHeatMap();
+    assert(glm::vec3(heatMap[0]) == AdaptiveSampling::getHeatMapColor(std::log2(MIN_NB_SAMPLES) / std::log2(MAX_NB_SAMPLES)));
+    assert(glm::vec3(heatMap[2]) == AdaptiveSampling::getHeatMapColor(1.f));
+    assert(AdaptiveSampling::getHeatMapColor(0.f).b > AdaptiveSampling::getHeatMapColor(0.f).r);
+    assert(AdaptiveSampling::getHeatMapColor(1.f).r > AdaptiveSampling::getHeatMapColor(1.f).b);
+
+    pixels.reset();
+    assert(!pixels.isConverged(0, 0) && pixels.getTotalNbSamples() == 0);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testAdaptiveRender(const CpuScenePtr& scene){
+    fprintf(stderr, "\nBegin test: adaptive render...\n");
+    CameraGPU camera = initCamera();
+    CpuRaytracerParameters parameters{IMAGE_WIDTH, IMAGE_HEIGHT};
+    parameters._Sampling = {false, 0.01f, MIN_NB_SAMPLES, MAX_NB_SAMPLES};
+    CpuRaytracer raytracer = CpuRaytracer(scene, parameters);
+    std::vector<glm::vec4> uniform = raytracer.render(camera);
+    uint64_t uniformNbRays = raytracer._Statistics._NbRays;
+    assert(uniformNbRays == static_cast<uint64_t>(NB_PIXELS) * MAX_NB_SAMPLES);
+    assert(raytracer._Statistics._NbPasses == MAX_NB_SAMPLES);
+
+    // only the silhouette is noisy, the flat pixels stop early
+    raytracer._Parameters._Sampling._IsOn = true;
+    std::vector<glm::vec4> adaptive = raytracer.render(camera);
+    uint64_t adaptiveNbRays = raytracer._Statistics._NbRays;
+    double rmse = getRmse(adaptive, uniform);
+    fprintf(stderr, "\t%.2f spp instead of %u, rmse %.2e\n", static_cast<double>(adaptiveNbRays) / NB_PIXELS, MAX_NB_SAMPLES, rmse);
+    assert(2 * adaptiveNbRays < uniformNbRays);
+    assert(rmse < 1e-2);
+
+    // the heat map shows more samples on the edges than on the background
+    raytracer._Parameters._IsHeatMapDisplayed = true;
+    std::vector<glm::vec4> heatMap = raytracer.render(camera);
+    bool hasMaxSamples = false;
+    for(const glm::vec4& color : heatMap){
+        hasMaxSamples |= color == glm::vec4(AdaptiveSampling::getHeatMapColor(1.f), 1.f);
+    }
+    assert(hasMaxSamples);
+    assert(glm::vec3(heatMap[0]) == AdaptiveSampling::getHeatMapColor(std::log2(MIN_NB_SAMPLES) / std::log2(MAX_NB_SAMPLES)));
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main(){
+    CpuScenePtr scene = initScene();
+    testPixelConvergence();
+    testAdaptiveRender(scene);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
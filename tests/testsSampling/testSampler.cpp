@@ -0,0 +1,175 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "blueNoise.hpp"
+#include "sampler.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t NB_PIXELS = 64;
+const uint32_t NB_SAMPLES = 256;
+const uint32_t NB_DIMENSIONS = 4;
+const SamplerType SAMPLER_TYPES[] = {SAMPLER_WHITE_NOISE, SAMPLER_SOBOL, SAMPLER_RANK1_LATTICE, SAMPLER_BLUE_NOISE};
+
+
+///// helpers
+glm::uvec2 getPixel(uint32_t i){
+    return glm::uvec2(i % 8, i / 8) * 37u;
+}
+
+// smooth integrand of [0,1]^2, integrates to 1/4
+float integrand(const glm::vec2& u){
+    return u.x * u.y;
+}
+
+float getRmse(const Sampler& sampler, uint32_t nbSamples){
+    float error = 0.f;
+    for(uint32_t pixel=0; pixel<NB_PIXELS; pixel++){
+        float estimate = 0.f;
+        for(uint32_t i=0; i<nbSamples; i++){
+            estimate += integrand(sampler.get2D(getPixel(pixel), i, 0));
+        }
+        float difference = estimate / nbSamples - 0.25f;
+        error += difference * difference;
+    }
+    return std::sqrt(error / NB_PIXELS);
+}
+
+
+///// tests
+void testRange(Sampler& sampler){
+    fprintf(stderr, "\nBegin test: range...\n");
+    for(SamplerType type : SAMPLER_TYPES){
+        sampler.setSamplerType(type);
+        for(uint32_t pixel=0; pixel<NB_PIXELS; pixel++){
+            for(uint32_t dimension=0; dimension<NB_DIMENSIONS; dimension++){
+                for(uint32_t i=0; i<NB_SAMPLES; i++){
+                    glm::vec2 u = sampler.get2D(getPixel(pixel), i, dimension);
+                    float v = sampler.get1D(getPixel(pixel), i, dimension);
+                    assert(u.x >= 0.f && u.x < 1.f && u.y >= 0.f && u.y < 1.f);
+                    assert(v >= 0.f && v < 1.f);
+                }
+            }
+        }
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testSobolNets(Sampler& sampler){
+    fprintf(stderr, "\nBegin test: sobol (0,m,2)-nets...\n");
+    sampler.setSamplerType(SAMPLER_SOBOL);
+    // the first 2^m points have one point in each elementary interval of area 2^-m
+    for(uint32_t m=4; m<=8; m++){
+        uint32_t nbPoints = 1u << m;
+        for(uint32_t pixel=0; pixel<NB_PIXELS; pixel++){
+            for(uint32_t k=0; k<=m; k++){
+                uint32_t nbColumns = 1u << k;
+                uint32_t nbRows = 1u << (m - k);
+                std::vector<uint32_t> counts(nbPoints, 0);
+                for(uint32_t i=0; i<nbPoints; i++){
+                    glm::vec2 u = sampler.get2D(getPixel(pixel), i, 1);
+                    uint32_t cell = static_cast<uint32_t>(u.y * nbRows) * nbColumns + static_cast<uint32_t>(u.x * nbColumns);
+                    counts[cell]++;
+                }
+                for(uint32_t count : counts){
+                    assert(count == 1);
+                }
+            }
+        }
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testLattice(Sampler& sampler){
+    fprintf(stderr, "\nBegin test: rank-1 lattice...\n");
+    sampler.setSamplerType(SAMPLER_RANK1_LATTICE);
+    // the first 2^m points are stratified in each dimension
+    for(uint32_t m=2; m<=8; m++){
+        uint32_t nbPoints = 1u << m;
+        std::vector<uint32_t> countsX(nbPoints, 0);
+        std::vector<uint32_t> countsY(nbPoints, 0);
+        for(uint32_t i=0; i<nbPoints; i++){
+            glm::vec2 u = sampler.get2D(getPixel(3), i, 2);
+            countsX[static_cast<uint32_t>(u.x * nbPoints)]++;
+            countsY[static_cast<uint32_t>(u.y * nbPoints)]++;
+        }
+        for(uint32_t i=0; i<nbPoints; i++){
+            assert(countsX[i] == 1 && countsY[i] == 1);
+        }
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testBlueNoise(){
+    fprintf(stderr, "\nBegin test: blue noise...\n");
+    std::vector<uint16_t> ranks = BlueNoise::generate(1);
+    assert(ranks.size() == BlueNoise::NB_TEXELS);
+    std::vector<bool> isUsed(BlueNoise::NB_TEXELS, false);
+    for(uint16_t rank : ranks){
+        assert(!isUsed[rank]);
+        isUsed[rank] = true;
+    }
+
+    // neighbours of a blue noise are further apart than the expected 1/3 of white noise
+    double difference = 0.;
+    for(uint32_t y=0; y<BlueNoise::SIZE; y++){
+        for(uint32_t x=0; x<BlueNoise::SIZE; x++){
+            float value = ranks[y * BlueNoise::SIZE + x] / static_cast<float>(BlueNoise::NB_TEXELS);
+            float right = ranks[y * BlueNoise::SIZE + (x + 1) % BlueNoise::SIZE] / static_cast<float>(BlueNoise::NB_TEXELS);
+            float bottom = ranks[((y + 1) % BlueNoise::SIZE) * BlueNoise::SIZE + x] / static_cast<float>(BlueNoise::NB_TEXELS);
+            difference += std::abs(value - right) + std::abs(value - bottom);
+        }
+    }
+    difference /= 2. * BlueNoise::NB_TEXELS;
+    fprintf(stderr, "\tneighbour difference: %.3f\n", difference);
+    assert(difference > 0.36);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testConvergence(Sampler& sampler){
+    fprintf(stderr, "\nBegin test: convergence...\n");
+    const uint32_t nbSamples = 64;
+    sampler.setSamplerType(SAMPLER_WHITE_NOISE);
+    float whiteNoise = getRmse(sampler, nbSamples);
+    for(SamplerType type : {SAMPLER_SOBOL, SAMPLER_RANK1_LATTICE, SAMPLER_BLUE_NOISE}){
+        sampler.setSamplerType(type);
+        float rmse = getRmse(sampler, nbSamples);
+        fprintf(stderr, "\tsampler %d: %.2e, white noise: %.2e\n", type, rmse, whiteNoise);
+        assert(rmse < 0.5f * whiteNoise);
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testGpuData(Sampler& sampler){
+    fprintf(stderr, "\nBegin test: gpu data...\n");
+    sampler.setSamplerType(SAMPLER_SOBOL);
+    sampler.setSamplerType(5, SAMPLER_BLUE_NOISE);
+    std::vector<uint32_t> data = sampler.getGpuData();
+    assert(data.size() == Sampler::GPU_BLUE_NOISE_OFFSET + BlueNoise::NB_TEXELS);
+    assert(data[Sampler::GPU_DIMENSION_SAMPLERS_OFFSET + 4] == SAMPLER_SOBOL);
+    assert(data[Sampler::GPU_DIMENSION_SAMPLERS_OFFSET + 5] == SAMPLER_BLUE_NOISE);
+    // first direction numbers of the van der Corput and second Sobol dimensions
+    assert(data[0] == 0x80000000u && data[1] == 0x40000000u);
+    assert(data[Sampler::NB_SOBOL_BITS] == 0x80000000u && data[Sampler::NB_SOBOL_BITS + 1] == 0xC0000000u);
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main(){
+    Sampler sampler = Sampler();
+    testRange(sampler);
+    testSobolNets(sampler);
+    testLattice(sampler);
+    testBlueNoise();
+    testConvergence(sampler);
+    testGpuData(sampler);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "assetLoader.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t NB_PRODUCERS = 4;
+const uint32_t NB_CONSUMERS = 2;
+const uint32_t NB_VALUES_PER_PRODUCER = 100000;
+const std::vector<std::string> MODELS = {"teapot.obj", "suzanne.obj", "stanford-bunny.obj"};
+
+
+///// helpers
+bool isSameNode(const BVH_NodeGPU& node1, const BVH_NodeGPU& node2){
+    return node1._BoundingBox._Min == node2._BoundingBox._Min && node1._BoundingBox._Max == node2._BoundingBox._Max
+        && node1._TriangleId == node2._TriangleId
+        && node1._LeftChild == node2._LeftChild && node1._RightChild == node2._RightChild;
+}
+
+// what the scene builds for a mesh stored after the triangles and the vertices of a cube
+std::vector<BVH_NodeGPU> getSceneNodes(const MeshPtr& mesh, uint32_t firstNode){
+    MeshPtr cube = Mesh::primitiveCube();
+    std::vector<glm::vec3> vertices = cube->_Vertices;
+    vertices.insert(vertices.end(), mesh->getVertices().begin(), mesh->getVertices().end());
+    std::vector<TriangleGPU> triangles = std::vector<TriangleGPU>(cube->getNbTriangles() + mesh->getNbTriangles());
+    for(size_t t=0; t<mesh->getNbTriangles(); t++){
+        for(uint32_t v=0; v<3; v++){
+            triangles[cube->getNbTriangles() + t]._Indices[v] = cube->getNbVertices() + mesh->getIndices()[3 * t + v];
+        }
+    }
+    BVH_Ptr bvh = BVH::buildBottomLevel(triangles, cube->getNbTriangles(), mesh->getNbTriangles(), vertices);
+    return bvh->getFlattenedNodes(firstNode, cube->getNbTriangles());
+}
+
+
+///// tests
+void testLockFreeQueue(){
+    fprintf(stderr, "\nBegin test: lock free queue...\n");
+    LockFreeQueue<uint32_t> small = LockFreeQueue<uint32_t>(3);
+    assert(small.getCapacity() == 4);
+    uint32_t value = 0;
+    assert(!small.tryPop(value));
+    for(uint32_t i=0; i<4; i++){
+        assert(small.tryPush(i));
+    }
+    assert(!small.tryPush(4));
+    assert(small.tryPop(value) && value == 0);
+    assert(small.tryPush(4));
+
+    // every value is popped exactly once whatever the interleaving
+    LockFreeQueue<uint32_t> queue = LockFreeQueue<uint32_t>(64);
+    std::vector<std::atomic<uint32_t>> nbPops(NB_PRODUCERS * NB_VALUES_PER_PRODUCER);
+    std::atomic<uint32_t> nbPopped = 0;
+    std::vector<std::thread> threads{};
+    for(uint32_t p=0; p<NB_PRODUCERS; p++){
+        threads.emplace_back([&, p](){
+            for(uint32_t i=0; i<NB_VALUES_PER_PRODUCER; i++){
+                while(!queue.tryPush(p * NB_VALUES_PER_PRODUCER + i)){
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(uint32_t c=0; c<NB_CONSUMERS; c++){
+        threads.emplace_back([&](){
+            uint32_t popped = 0;
+            while(nbPopped < nbPops.size()){
+                if(queue.tryPop(popped)){
+                    nbPops[popped]++;
+                    nbPopped++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(std::thread& thread : threads){
+        thread.join();
+    }
+    for(const std::atomic<uint32_t>& count : nbPops){
+        assert(count == 1);
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testThreadPool(){
+    fprintf(stderr, "\nBegin test: thread pool...\n");
+    std::atomic<uint32_t> nbDone = 0;
+    {
+        ThreadPool pool = ThreadPool(3);
+        assert(pool.getNbThreads() == 3);
+        for(uint32_t i=0; i<100; i++){
+            pool.submit([&](){nbDone++;});
+        }
+        while(nbDone < 100){
+            std::this_thread::yield();
+        }
+    }
+    assert(nbDone == 100);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testAssetLoader(){
+    fprintf(stderr, "\nBegin test: asset loader...\n");
+    auto start = std::chrono::steady_clock::now();
+    AssetLoader loader = AssetLoader();
+    std::vector<uint32_t> requests{};
+    for(const std::string& model : MODELS){
+        requests.push_back(loader.loadMesh(Mesh::MODELS_DIRECTORY + model));
+    }
+    // the requests return at once
+    std::chrono::duration<double, std::milli> requestTime = std::chrono::steady_clock::now() - start;
+    assert(loader.getNbPending() == MODELS.size());
+
+    std::vector<bool> isLoaded(MODELS.size(), false);
+    LoadedMesh loadedMesh{};
+    for(uint32_t nbLoaded=0; nbLoaded<MODELS.size();){
+        if(!loader.tryPopMesh(loadedMesh)){
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t index = std::find(requests.begin(), requests.end(), loadedMesh._RequestId) - requests.begin();
+        assert(index < MODELS.size() && !isLoaded[index]);
+        isLoaded[index] = true;
+        nbLoaded++;
+        fprintf(stderr, "\t%s: %zu triangles in %.3f ms\n", MODELS[index].c_str(), loadedMesh._Mesh->getNbTriangles(), loadedMesh._LoadTime);
+
+        // same bvh as the one built by the scene once flattened at the place of the mesh
+        std::vector<BVH_NodeGPU> nodes = loadedMesh._BVH->getFlattenedNodes(100, 12);
+        std::vector<BVH_NodeGPU> expected = getSceneNodes(loadedMesh._Mesh, 100);
+        assert(nodes.size() == expected.size());
+        for(size_t i=0; i<nodes.size(); i++){
+            assert(isSameNode(nodes[i], expected[i]));
+        }
+    }
+    fprintf(stderr, "\t%zu requests in %.3f ms\n", MODELS.size(), requestTime.count());
+    assert(loader.isIdle() && !loader.tryPopMesh(loadedMesh));
+    fprintf(stderr, "\tOk\n");
+}
+
+void testLoadErrors(){
+    fprintf(stderr, "\nBegin test: load errors...\n");
+    std::string malformed = (std::filesystem::temp_directory_path() / "testAssetLoader_malformed.ply").string();
+    FILE* file = fopen(malformed.c_str(), "wb");
+    assert(file != nullptr);
+    fputs("not a mesh\n", file);
+    fclose(file);
+
+    // the errors are reported with the meshes instead of exiting, the good meshes still load
+    AssetLoader loader = AssetLoader();
+    uint32_t missingRequest = loader.loadMesh(Mesh::MODELS_DIRECTORY + "missing.obj");
+    uint32_t malformedRequest = loader.loadMesh(malformed);
+    uint32_t goodRequest = loader.loadMesh(Mesh::MODELS_DIRECTORY + MODELS[0]);
+    LoadedMesh loadedMesh{};
+    for(uint32_t nbLoaded=0; nbLoaded<3;){
+        if(!loader.tryPopMesh(loadedMesh)){
+            std::this_thread::yield();
+            continue;
+        }
+        nbLoaded++;
+        bool isFailed = loadedMesh._RequestId == missingRequest || loadedMesh._RequestId == malformedRequest;
+        assert(isFailed || loadedMesh._RequestId == goodRequest);
+        assert(loadedMesh._DidFail == isFailed && (loadedMesh._Mesh == nullptr) == isFailed);
+        assert(loadedMesh._Error.empty() != isFailed);
+        if(isFailed){
+            fprintf(stderr, "\treported: %s", loadedMesh._Error.c_str());
+        }
+    }
+    assert(loader.isIdle());
+
+    std::filesystem::remove(malformed);
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    testLockFreeQueue();
+    testThreadPool();
+    testAssetLoader();
+    testLoadErrors();
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
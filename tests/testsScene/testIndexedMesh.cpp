@@ -0,0 +1,122 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+
+#include "cpuScene.hpp"
+#include "geometryArena.hpp"
+#include "mesh.hpp"
+
+namespace cr{
+
+///// constants
+// three vec4 positions and a padded model id per triangle before the vertices were shared
+const size_t UNINDEXED_TRIANGLE_SIZE = 64;
+
+
+///// helpers
+size_t getIndexedSize(const MeshPtr& mesh){
+    return sizeof(TriangleGPU) * mesh->getNbTriangles() + sizeof(glm::vec3) * mesh->getNbVertices();
+}
+
+
+///// tests
+void testPrimitives(){
+    fprintf(stderr, "\nBegin test: primitives...\n");
+    MeshPtr cube = Mesh::primitiveCube();
+    assert(cube->_Vertices.size() == 8);
+    assert(cube->getNbTriangles() == 12);
+    // the faces look outwards
+    for(size_t i=0; i<cube->getNbTriangles(); i++){
+        glm::vec3 p0 = cube->_Vertices[cube->_Indices[3 * i]];
+        glm::vec3 p1 = cube->_Vertices[cube->_Indices[3 * i + 1]];
+        glm::vec3 p2 = cube->_Vertices[cube->_Indices[3 * i + 2]];
+        assert(glm::length(glm::cross(p1 - p0, p2 - p0)) > 0.f);
+    }
+    MeshPtr square = Mesh::primitiveSquare();
+    assert(square->_Vertices.size() == 4 && square->getNbTriangles() == 2);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testLoad(){
+    fprintf(stderr, "\nBegin test: load...\n");
+    for(const char* name : {"teapot.obj", "stanford-bunny.obj"}){
+        MeshPtr mesh = Mesh::load(Mesh::MODELS_DIRECTORY + name);
+        assert(mesh->getIndices().size() % 3 == 0);
+        for(uint32_t index : mesh->getIndices()){
+            assert(index < mesh->getNbVertices());
+        }
+        size_t unindexedSize = UNINDEXED_TRIANGLE_SIZE * mesh->getNbTriangles();
+        float ratio = static_cast<float>(unindexedSize) / getIndexedSize(mesh);
+        fprintf(stderr, "\t%s: %zu triangles, %zu vertices, %zu bytes instead of %zu (%.2fx smaller)\n",
+            name, mesh->getNbTriangles(), mesh->getNbVertices(), getIndexedSize(mesh), unindexedSize, ratio);
+        assert(ratio > 2.5f);
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testSceneVertices(){
+    fprintf(stderr, "\nBegin test: scene vertices...\n");
+    // the indices of the second mesh are offset by the vertices of the first one
+    MeshPtr square = Mesh::primitiveSquare();
+    MeshPtr cube = Mesh::primitiveCube();
+    cube->setPosition(glm::vec3(0.f, 0.f, 4.f));
+    CpuScene scene = CpuScene({square, cube}, {Material()});
+    assert(scene.getNbTriangles() == 14);
+    assert(scene.getNbVertices() == 12);
+    for(uint32_t i=0; i<cube->getNbTriangles(); i++){
+        glm::vec3 p0, p1, p2;
+        scene.getTriangleVertices(1, square->getNbTriangles() + i, p0, p1, p2);
+        assert(p0 == cube->_Vertices[cube->_Indices[3 * i]] + glm::vec3(0.f, 0.f, 4.f));
+        assert(p1 == cube->_Vertices[cube->_Indices[3 * i + 1]] + glm::vec3(0.f, 0.f, 4.f));
+        assert(p2 == cube->_Vertices[cube->_Indices[3 * i + 2]] + glm::vec3(0.f, 0.f, 4.f));
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testGeometryArena(){
+    fprintf(stderr, "\nBegin test: geometry arena...\n");
+    GeometryArena arena = GeometryArena();
+    MeshPtr cube = Mesh::primitiveCube();
+    MeshPtr teapot = Mesh::load(Mesh::MODELS_DIRECTORY + "teapot.obj");
+    MeshPtr bunny = Mesh::load(Mesh::MODELS_DIRECTORY + "stanford-bunny.obj");
+    const glm::vec3* vertices = arena.getVertices().data();
+    const TriangleGPU* triangles = arena.getTriangles().data();
+
+    GeometryRange cubeRange = arena.append(*cube, 0);
+    GeometryRange teapotRange = arena.append(*teapot, 1);
+    // written in place, the storage never moves
+    assert(arena.getVertices().data() == vertices && arena.getTriangles().data() == triangles);
+    assert(teapotRange._FirstVertex == 8 && teapotRange._FirstTriangle == 12);
+    assert(arena.getNbVertices() == 8 + teapot->getNbVertices());
+    assert(arena.getNbTriangles() == 12 + teapot->getNbTriangles());
+    for(uint32_t i=0; i<teapotRange._NbTriangles; i++){
+        const TriangleGPU& triangle = triangles[teapotRange._FirstTriangle + i];
+        assert(triangle._MeshId == 1);
+        for(uint32_t v=0; v<3; v++){
+            assert(vertices[triangle._Indices[v]] == teapot->getVertices()[teapot->getIndices()[3 * i + v]]);
+        }
+    }
+
+    // the bunny has more triangles than the buffers
+    assert(!arena.canFit(*bunny));
+    assert(arena.canFit(*teapot));
+
+    cube->_Vertices[0] = glm::vec3(2.f);
+    arena.updateVertices(cubeRange, *cube);
+    assert(vertices[0] == glm::vec3(2.f) && vertices[8] == teapot->getVertices()[0]);
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    testPrimitives();
+    testLoad();
+    testSceneVertices();
+    testGeometryArena();
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "cpuRaytracer.hpp"
+#include "cpuScene.hpp"
+
+namespace cr{
+
+///// constants
+// the flattened forest still fits in the triangle buffer
+const uint32_t FOREST_SIZE = 3;
+// 8 times as many triangles as the triangle buffer can hold
+const uint32_t LARGE_FOREST_SIZE = 32;
+const uint32_t NB_RAYS = 2 << 12;
+const uint32_t IMAGE_WIDTH = 64;
+const uint32_t IMAGE_HEIGHT = 48;
+const float DISTANCE_TOLERANCE = 1e-3f;
+
+
+///// helpers
+// a grid of rotated and scaled copies of the same mesh, one material out of two
+std::vector<MeshInstance> initForest(const MeshPtr& mesh, uint32_t size){
+    std::vector<MeshInstance> instances{};
+    for(uint32_t x=0; x<size; x++){
+        for(uint32_t z=0; z<size; z++){
+            glm::mat4 model = glm::mat4(1.f);
+            float angle = 0.7f * (x + 3 * z);
+            float scale = 0.3f + 0.05f * ((x + z) % 4);
+            model[0] = scale * glm::vec4(std::cos(angle), 0.f, -std::sin(angle), 0.f);
+            model[1] = scale * glm::vec4(0.f, 1.f, 0.f, 0.f);
+            model[2] = scale * glm::vec4(std::sin(angle), 0.f, std::cos(angle), 0.f);
+            model[3] = glm::vec4(2.f * x - (size - 1.f), 0.f, 2.f * z - (size - 1.f), 1.f);
+            instances.push_back({mesh, model, 1 + (x + z) % 2});
+        }
+    }
+    return instances;
+}
+
+// the same scene with the transforms applied to copies of the vertices
+CpuScenePtr initFlattenedScene(const std::vector<MeshInstance>& instances, const std::vector<Material>& materials){
+    std::vector<MeshPtr> meshes{};
+    for(const MeshInstance& instance : instances){
+        MeshPtr copy = MeshPtr(new Mesh());
+        for(const glm::vec3& vertex : instance._Mesh->getVertices()){
+            copy->_Vertices.push_back(glm::vec3(instance._ModelMatrix * glm::vec4(vertex, 1.f)));
+        }
+        copy->_Indices.assign(instance._Mesh->getIndices().begin(), instance._Mesh->getIndices().end());
+        copy->setMaterial(instance._MaterialId);
+        meshes.push_back(copy);
+    }
+    return CpuScenePtr(new CpuScene(meshes, materials));
+}
+
+RaySetup getRandomRay(std::mt19937& gen){
+    std::uniform_real_distribution<float> distrib(-1.f, 1.f);
+    glm::vec3 origin = 8.f * glm::vec3(distrib(gen), distrib(gen) + 1.f, distrib(gen));
+    glm::vec3 target = static_cast<float>(FOREST_SIZE) * glm::vec3(distrib(gen), 0.1f * distrib(gen), distrib(gen));
+    return Intersection::setupRay({origin, glm::normalize(target - origin)});
+}
+
+
+///// tests
+void testGeometryStoredOnce(const MeshPtr& mesh, const CpuScenePtr& instanced, const CpuScenePtr& flattened){
+    fprintf(stderr, "\nBegin test: geometry stored once...\n");
+    assert(instanced->getNbInstances() == FOREST_SIZE * FOREST_SIZE);
+    assert(instanced->getNbMeshes() == 1);
+    assert(instanced->getNbTriangles() == mesh->getNbTriangles());
+    assert(instanced->getNbVertices() == mesh->getNbVertices());
+    assert(flattened->getNbTriangles() == FOREST_SIZE * FOREST_SIZE * mesh->getNbTriangles());
+    // one top level node per instance and a single bottom level bvh
+    assert(instanced->getBVH_Nodes().size() == 2 * instanced->getNbInstances() - 1 + 2 * mesh->getNbTriangles() - 1);
+    fprintf(stderr, "\t%zu nodes instead of %zu\n", instanced->getBVH_Nodes().size(), flattened->getBVH_Nodes().size());
+    fprintf(stderr, "\tOk\n");
+}
+
+void testSameHits(const CpuScenePtr& instanced, const CpuScenePtr& flattened){
+    fprintf(stderr, "\nBegin test: same hits as the flattened scene...\n");
+    CpuRaytracer instancedRaytracer = CpuRaytracer(instanced, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    CpuRaytracer flattenedRaytracer = CpuRaytracer(flattened, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    std::mt19937 gen(42);
+    uint32_t nbHits = 0;
+    for(uint32_t i=0; i<NB_RAYS; i++){
+        RaySetup ray = getRandomRay(gen);
+        Hit expected = flattenedRaytracer.traceClosest(ray, INFINITY);
+        Hit hit = instancedRaytracer.traceClosest(ray, INFINITY);
+        assert(hit._DidHit == expected._DidHit);
+        if(!hit._DidHit){
+            continue;
+        }
+        // the rays are transformed, not the vertices
+        assert(std::abs(hit._Coords.w - expected._Coords.w) < DISTANCE_TOLERANCE * expected._Coords.w);
+        // the instances keep the order of the flattened meshes
+        assert(instanced->getInstanceMaterial(hit._InstanceId)._Color == flattened->getInstanceMaterial(expected._InstanceId)._Color);
+        glm::vec3 p0, p1, p2, q0, q1, q2;
+        instanced->getTriangleVertices(hit._InstanceId, hit._TriangleId, p0, p1, p2);
+        flattened->getTriangleVertices(expected._InstanceId, expected._TriangleId, q0, q1, q2);
+        assert(glm::length(p0 - q0) + glm::length(p1 - q1) + glm::length(p2 - q2) < DISTANCE_TOLERANCE);
+
+        // the shadow rays go through the same two levels
+        assert(!instancedRaytracer.traceAnyHit(ray, 0.f, 0.99f * hit._Coords.w));
+        assert(instancedRaytracer.traceAnyHit(ray, 0.f, 1.01f * hit._Coords.w));
+        nbHits++;
+    }
+    assert(nbHits > NB_RAYS / 10);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testSameImage(const CpuScenePtr& instanced, const CpuScenePtr& flattened){
+    fprintf(stderr, "\nBegin test: same image as the flattened scene...\n");
+    Camera camera = Camera(glm::vec3(0.f, 3.f, -6.f), static_cast<float>(IMAGE_WIDTH) / IMAGE_HEIGHT);
+    camera.ProcessMouseMovement(0.f, 200.f);
+    // the packets enter the instances together
+    CpuRaytracer instancedRaytracer = CpuRaytracer(instanced, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    CpuRaytracer flattenedRaytracer = CpuRaytracer(flattened, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    std::vector<glm::vec4> image = instancedRaytracer.render(camera.getGpuData());
+    std::vector<glm::vec4> expected = flattenedRaytracer.render(camera.getGpuData());
+    uint32_t nbDifferences = 0;
+    uint32_t nbModelPixels = 0;
+    for(size_t i=0; i<image.size(); i++){
+        nbDifferences += image[i] != expected[i] ? 1 : 0;
+        nbModelPixels += expected[i] != glm::vec4(0.f, 0.f, 0.f, 1.f) ? 1 : 0;
+    }
+    fprintf(stderr, "\t%u different pixels out of %u on the models\n", nbDifferences, nbModelPixels);
+    // only the silhouettes may change with the rounding of the transformed rays
+    assert(nbModelPixels > image.size() / 10);
+    assert(nbDifferences < image.size() / 100);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testLargeForest(const MeshPtr& mesh, const std::vector<Material>& materials){
+    fprintf(stderr, "\nBegin test: large forest...\n");
+    std::vector<MeshInstance> forest = initForest(mesh, LARGE_FOREST_SIZE);
+    CpuScenePtr scene = CpuScenePtr(new CpuScene(forest, materials));
+    assert(scene->getNbInstances() == forest.size());
+    assert(forest.size() * mesh->getNbTriangles() > 8 * Triangle::MAX_NB_TRIANGLES);
+    CpuRaytracer raytracer = CpuRaytracer(scene, {IMAGE_WIDTH, IMAGE_HEIGHT});
+    // every instance can be hit from above
+    for(uint32_t i=0; i<forest.size(); i++){
+        glm::vec3 position = glm::vec3(forest[i]._ModelMatrix[3]);
+        RaySetup ray = Intersection::setupRay({position + glm::vec3(0.f, 10.f, 0.f), glm::vec3(0.f, -1.f, 0.f)});
+        Hit hit = raytracer.traceClosest(ray, INFINITY);
+        assert(hit._DidHit && hit._InstanceId == i);
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    std::vector<Material> materials = {Material(), Material(glm::vec4(0.2f, 0.5f, 0.1f, 1.f)), Material(glm::vec4(0.6f, 0.3f, 0.1f, 1.f))};
+    MeshPtr teapot = Mesh::load(Mesh::MODELS_DIRECTORY + "teapot.obj");
+    std::vector<MeshInstance> forest = initForest(teapot, FOREST_SIZE);
+    CpuScenePtr instanced = CpuScenePtr(new CpuScene(forest, materials));
+    CpuScenePtr flattened = initFlattenedScene(forest, materials);
+
+    testGeometryStoredOnce(teapot, instanced, flattened);
+    testSameHits(instanced, flattened);
+    testSameImage(instanced, flattened);
+    testLargeForest(teapot, materials);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "meshCache.hpp"
+#include "objLoader.hpp"
+
+namespace cr{
+
+///// constants
+const std::string SOURCE_MODEL = "teapot.obj";
+
+
+///// helpers
+// the cache is written beside the source, a copy keeps the resources untouched
+std::string copySource(){
+    std::filesystem::path path = std::filesystem::temp_directory_path() / ("testMeshCache_" + SOURCE_MODEL);
+    std::filesystem::copy_file(Mesh::MODELS_DIRECTORY + SOURCE_MODEL, path, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::remove(MeshCache::getPath(path.string()));
+    return path.string();
+}
+
+bool isSameGeometry(const Mesh& mesh, const Mesh& expected){
+    return std::equal(mesh.getVertices().begin(), mesh.getVertices().end(), expected.getVertices().begin(), expected.getVertices().end())
+        && std::equal(mesh.getIndices().begin(), mesh.getIndices().end(), expected.getIndices().begin(), expected.getIndices().end());
+}
+
+void flipByte(const std::string& path, size_t offset){
+    FILE* file = fopen(path.c_str(), "r+b");
+    assert(file != nullptr);
+    fseek(file, offset, SEEK_SET);
+    int byte = fgetc(file);
+    fseek(file, offset, SEEK_SET);
+    fputc(byte ^ 0xFF, file);
+    fclose(file);
+}
+
+// a triangle past the vertices with a checksum that matches it, as a foreign writer could produce
+void writeOutOfRangeIndex(const std::string& path){
+    std::stringstream stream;
+    stream << std::ifstream(path, std::ios::binary).rdbuf();
+    std::string content = stream.str();
+    MeshCacheHeader header{};
+    std::memcpy(&header, content.data(), sizeof(header));
+    uint32_t index = static_cast<uint32_t>(header._NbVertices);
+    std::memcpy(content.data() + header._IndicesOffset, &index, sizeof(index));
+    header._Checksum = MeshCache::getChecksum(content.data() + sizeof(header), content.size() - sizeof(header));
+    std::memcpy(content.data(), &header, sizeof(header));
+    std::ofstream(path, std::ios::binary).write(content.data(), content.size());
+}
+
+
+///// tests
+void testRoundTrip(){
+    fprintf(stderr, "\nBegin test: round trip...\n");
+    std::string source = copySource();
+    MeshPtr expected = ObjLoader::load(source);
+
+    // the first load parses the source and writes the cache
+    MeshPtr parsed = Mesh::load(source);
+    assert(std::filesystem::exists(MeshCache::getPath(source)));
+    assert(!parsed->_Vertices.empty());
+    assert(isSameGeometry(*parsed, *expected));
+
+    // the next ones read the mapped pages
+    MeshPtr mapped = Mesh::load(source);
+    assert(mapped->_Vertices.empty() && mapped->_Indices.empty());
+    assert(isSameGeometry(*mapped, *expected));
+    assert(reinterpret_cast<uintptr_t>(mapped->getVertices().data()) % MeshCache::BLOCK_ALIGNMENT == 0);
+    assert(reinterpret_cast<uintptr_t>(mapped->getIndices().data()) % MeshCache::BLOCK_ALIGNMENT == 0);
+    fprintf(stderr, "\t%s: %zu bytes of cache\n", SOURCE_MODEL.c_str(), std::filesystem::file_size(MeshCache::getPath(source)));
+
+    std::filesystem::remove(MeshCache::getPath(source));
+    std::filesystem::remove(source);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testInvalidation(){
+    fprintf(stderr, "\nBegin test: invalidation...\n");
+    std::string source = copySource();
+    std::string cache = MeshCache::getPath(source);
+    MeshPtr expected = ObjLoader::load(source);
+    Mesh::load(source);
+
+    // a corrupted block fails the checksum, the source is parsed and the cache written again
+    flipByte(cache, sizeof(MeshCacheHeader) + 5);
+    assert(MeshCache::load(source) == nullptr);
+    MeshPtr reloaded = Mesh::load(source);
+    assert(!reloaded->_Vertices.empty() && isSameGeometry(*reloaded, *expected));
+    assert(MeshCache::load(source) != nullptr);
+
+    // so do indices past the vertices behind a right checksum
+    writeOutOfRangeIndex(cache);
+    assert(MeshCache::load(source) == nullptr);
+    assert(isSameGeometry(*Mesh::load(source), *expected));
+    assert(MeshCache::load(source) != nullptr);
+
+    // and a newer source
+    std::filesystem::last_write_time(source, std::filesystem::last_write_time(source) + std::chrono::seconds(1));
+    assert(MeshCache::load(source) == nullptr);
+    assert(!Mesh::load(source)->_Vertices.empty());
+    assert(MeshCache::load(source) != nullptr);
+
+    std::filesystem::remove(cache);
+    std::filesystem::remove(source);
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    testRoundTrip();
+    testInvalidation();
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "gltfLoader.hpp"
+#include "objLoader.hpp"
+#include "plyLoader.hpp"
+
+namespace cr{
+
+///// constants
+const std::string SOURCE_MODEL = "teapot.obj";
+const float NORMALIZED_EPSILON = 1e-4f;
+
+
+///// helpers
+std::string getPath(const std::string& name){
+    return (std::filesystem::temp_directory_path() / ("testMeshImport_" + name)).string();
+}
+
+void writeFile(const std::string& path, const std::string& content){
+    FILE* file = fopen(path.c_str(), "wb");
+    assert(file != nullptr);
+    fwrite(content.data(), 1, content.size(), file);
+    fclose(file);
+}
+
+template <typename T>
+void append(std::string& content, T value){
+    content.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+bool isMapped(const Mesh& mesh){
+    return mesh._Vertices.empty() && mesh._Indices.empty();
+}
+
+bool isSameGeometry(const Mesh& mesh, const Mesh& expected, float epsilon = 0.f){
+    if(mesh.getNbVertices() != expected.getNbVertices() || mesh.getNbTriangles() != expected.getNbTriangles()) return false;
+    for(size_t v=0; v<mesh.getNbVertices(); v++){
+        glm::vec3 difference = glm::abs(mesh.getVertices()[v] - expected.getVertices()[v]);
+        if(difference.x > epsilon || difference.y > epsilon || difference.z > epsilon) return false;
+    }
+    return std::equal(mesh.getIndices().begin(), mesh.getIndices().end(), expected.getIndices().begin());
+}
+
+// the header is padded with a comment to move the vertices by the given offset
+std::string writePly(const Mesh& mesh, size_t padding){
+    std::string header = "ply\nformat binary_little_endian 1.0\n";
+    header += "element vertex " + std::to_string(mesh.getNbVertices()) + "\n";
+    header += "property float x\nproperty float y\nproperty float z\n";
+    header += "element face " + std::to_string(mesh.getNbTriangles()) + "\n";
+    header += "property list uchar uint vertex_indices\nend_header\n";
+    std::string comment = "comment ";
+    size_t size = header.size() + comment.size() + 1;
+    comment.append((padding + 4 - size % 4) % 4, 'x');
+    std::string content = header.substr(0, 3) + "\n" + comment + header.substr(3);
+    for(const glm::vec3& vertex : mesh.getVertices()){
+        append(content, vertex);
+    }
+    for(size_t t=0; t<mesh.getNbTriangles(); t++){
+        append<uint8_t>(content, 3);
+        for(uint32_t c=0; c<3; c++){
+            append(content, mesh.getIndices()[3 * t + c]);
+        }
+    }
+    return content;
+}
+
+// doubles, an extra property on both elements and quads made of pairs of triangles
+std::string writeConvertedPly(const Mesh& mesh){
+    std::string faces = "";
+    size_t nbFaces = 0;
+    std::span<const uint32_t> indices = mesh.getIndices();
+    for(size_t t=0; t<mesh.getNbTriangles(); t++, nbFaces++){
+        append<int32_t>(faces, 0);
+        // the fan of a quad a b c d is a b c then a c d
+        bool isQuad = t + 1 < mesh.getNbTriangles() && indices[3 * t] == indices[3 * t + 3] && indices[3 * t + 2] == indices[3 * t + 4];
+        append<uint8_t>(faces, isQuad ? 4 : 3);
+        for(uint32_t c=0; c<3; c++){
+            append<int32_t>(faces, indices[3 * t + c]);
+        }
+        if(isQuad){
+            append<int32_t>(faces, indices[3 * t + 5]);
+            t++;
+        }
+    }
+
+    std::string content = "ply\nformat binary_little_endian 1.0\n";
+    content += "element vertex " + std::to_string(mesh.getNbVertices()) + "\n";
+    content += "property double x\nproperty uchar red\nproperty double y\nproperty double z\n";
+    content += "element face " + std::to_string(nbFaces) + "\n";
+    content += "property int flags\nproperty list uchar int vertex_indices\nend_header\n";
+    for(const glm::vec3& vertex : mesh.getVertices()){
+        append<double>(content, vertex.x);
+        append<uint8_t>(content, 255);
+        append<double>(content, vertex.y);
+        append<double>(content, vertex.z);
+    }
+    return content + faces;
+}
+
+// the triangles split in primitives, the positions are float or normalized shorts and the indices ushort or uint
+std::string writeGlb(const Mesh& mesh, size_t nbPrimitives, bool isNormalized, bool isShortIndices, glm::vec3& scale){
+    std::string bin = "";
+    std::string accessors = "";
+    std::string views = "";
+    std::string primitives = "";
+    scale = glm::vec3(0.f);
+    for(const glm::vec3& vertex : mesh.getVertices()){
+        scale = glm::max(scale, glm::abs(vertex));
+    }
+    size_t nbTriangles = mesh.getNbTriangles();
+    for(size_t p=0; p<nbPrimitives; p++){
+        // each primitive keeps all the vertices, its indices are local to it
+        size_t firstTriangle = nbTriangles * p / nbPrimitives;
+        size_t lastTriangle = nbTriangles * (p + 1) / nbPrimitives;
+        std::string index = std::to_string(2 * p);
+        size_t positionsOffset = bin.size();
+        for(const glm::vec3& vertex : mesh.getVertices()){
+            if(isNormalized){
+                for(uint32_t axis=0; axis<3; axis++){
+                    append<int16_t>(bin, static_cast<int16_t>(std::round(vertex[axis] / scale[axis] * 32767.f)));
+                }
+                append<int16_t>(bin, 0);
+            } else {
+                append(bin, vertex);
+            }
+        }
+        size_t indicesOffset = bin.size();
+        for(size_t i=3*firstTriangle; i<3*lastTriangle; i++){
+            if(isShortIndices){
+                append<uint16_t>(bin, static_cast<uint16_t>(mesh.getIndices()[i]));
+            } else {
+                append<uint32_t>(bin, mesh.getIndices()[i]);
+            }
+        }
+        bin.append((4 - bin.size() % 4) % 4, '\0');
+        views += std::string(p > 0 ? "," : "")
+            + "{\"buffer\":0,\"byteOffset\":" + std::to_string(positionsOffset) + ",\"byteLength\":" + std::to_string(indicesOffset - positionsOffset)
+            + (isNormalized ? ",\"byteStride\":8" : "") + "},"
+            + "{\"buffer\":0,\"byteOffset\":" + std::to_string(indicesOffset) + ",\"byteLength\":" + std::to_string(bin.size() - indicesOffset) + "}";
+        accessors += std::string(p > 0 ? "," : "")
+            + "{\"bufferView\":" + index + ",\"componentType\":" + (isNormalized ? "5122,\"normalized\":true" : "5126")
+            + ",\"count\":" + std::to_string(mesh.getNbVertices()) + ",\"type\":\"VEC3\"},"
+            + "{\"bufferView\":" + std::to_string(2 * p + 1) + ",\"componentType\":" + (isShortIndices ? "5123" : "5125")
+            + ",\"count\":" + std::to_string(3 * (lastTriangle - firstTriangle)) + ",\"type\":\"SCALAR\"}";
+        primitives += std::string(p > 0 ? "," : "")
+            + "{\"attributes\":{\"POSITION\":" + index + "},\"indices\":" + std::to_string(2 * p + 1) + ",\"mode\":4}";
+    }
+    std::string json = "{\"asset\":{\"version\":\"2.0\",\"generator\":\"test \\\"import\\\"\"},"
+        "\"buffers\":[{\"byteLength\":" + std::to_string(bin.size()) + "}],"
+        "\"bufferViews\":[" + views + "],\"accessors\":[" + accessors + "],"
+        "\"meshes\":[{\"name\":\"teapot\",\"primitives\":[" + primitives + "]}],"
+        "\"nodes\":[{\"mesh\":0,\"scale\":[1.0,1e0,-1.5E+0]}],\"extras\":{\"flags\":[true,false,null]}}";
+    json.append((4 - json.size() % 4) % 4, ' ');
+
+    std::string content = "";
+    append<uint32_t>(content, GltfLoader::GLB_MAGIC);
+    append<uint32_t>(content, GltfLoader::GLB_VERSION);
+    append<uint32_t>(content, static_cast<uint32_t>(12 + 8 + json.size() + 8 + bin.size()));
+    append<uint32_t>(content, static_cast<uint32_t>(json.size()));
+    append<uint32_t>(content, GltfLoader::JSON_CHUNK);
+    content += json;
+    append<uint32_t>(content, static_cast<uint32_t>(bin.size()));
+    append<uint32_t>(content, GltfLoader::BIN_CHUNK);
+    content += bin;
+    return content;
+}
+
+// the primitives of the same vertices are merged one after the other
+MeshPtr getMergedMesh(const Mesh& mesh, size_t nbPrimitives){
+    MeshPtr merged = MeshPtr(new Mesh());
+    size_t nbTriangles = mesh.getNbTriangles();
+    for(size_t p=0; p<nbPrimitives; p++){
+        uint32_t firstVertex = static_cast<uint32_t>(merged->_Vertices.size());
+        merged->_Vertices.insert(merged->_Vertices.end(), mesh.getVertices().begin(), mesh.getVertices().end());
+        for(size_t i=3*(nbTriangles*p/nbPrimitives); i<3*(nbTriangles*(p+1)/nbPrimitives); i++){
+            merged->_Indices.push_back(firstVertex + mesh.getIndices()[i]);
+        }
+    }
+    return merged;
+}
+
+
+///// tests
+void testPly(const Mesh& expected){
+    fprintf(stderr, "\nBegin test: ply...\n");
+    // float vertices read from the pages when aligned, copied otherwise
+    std::string path = getPath("teapot.ply");
+    writeFile(path, writePly(expected, 0));
+    MeshPtr mapped = Mesh::load(path);
+    assert(mapped->_Vertices.empty() && !mapped->_Indices.empty());
+    assert(isSameGeometry(*mapped, expected));
+
+    writeFile(path, writePly(expected, 1));
+    MeshPtr unaligned = PlyLoader::load(path);
+    assert(!unaligned->_Vertices.empty());
+    assert(isSameGeometry(*unaligned, expected));
+
+    // the quads are split in the same triangles
+    writeFile(path, writeConvertedPly(expected));
+    MeshPtr converted = PlyLoader::load(path);
+    assert(isSameGeometry(*converted, expected, 1e-6f));
+    fprintf(stderr, "\t%s: %zu vertices, %zu triangles\n", path.c_str(), converted->getNbVertices(), converted->getNbTriangles());
+
+    std::filesystem::remove(path);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testGlb(const Mesh& expected){
+    fprintf(stderr, "\nBegin test: glb...\n");
+    std::string path = getPath("teapot.glb");
+    glm::vec3 scale;
+    // a single float and uint primitive is read from the pages
+    writeFile(path, writeGlb(expected, 1, false, false, scale));
+    MeshPtr mapped = Mesh::load(path);
+    assert(isMapped(*mapped));
+    assert(isSameGeometry(*mapped, expected));
+
+    // the short indices are widened
+    writeFile(path, writeGlb(expected, 1, false, true, scale));
+    MeshPtr widened = GltfLoader::load(path);
+    assert(widened->_Vertices.empty() && !widened->_Indices.empty());
+    assert(isSameGeometry(*widened, expected));
+
+    // the primitives are merged
+    MeshPtr merged = getMergedMesh(expected, 3);
+    writeFile(path, writeGlb(expected, 3, false, false, scale));
+    MeshPtr primitives = GltfLoader::load(path);
+    assert(!primitives->_Vertices.empty() && !primitives->_Indices.empty());
+    assert(isSameGeometry(*primitives, *merged));
+
+    // the normalized positions are scaled back to the model
+    writeFile(path, writeGlb(expected, 3, true, true, scale));
+    MeshPtr normalized = GltfLoader::load(path);
+    for(glm::vec3& vertex : normalized->_Vertices){
+        vertex *= scale;
+    }
+    assert(isSameGeometry(*normalized, *merged, NORMALIZED_EPSILON * glm::max(scale.x, glm::max(scale.y, scale.z))));
+    fprintf(stderr, "\t%s: %zu vertices, %zu triangles\n", path.c_str(), normalized->getNbVertices(), normalized->getNbTriangles());
+
+    std::filesystem::remove(path);
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    MeshPtr expected = ObjLoader::load(Mesh::MODELS_DIRECTORY + SOURCE_MODEL);
+    testPly(*expected);
+    testGlb(*expected);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <tiny_obj_loader.h>
+
+#include "errorHandler.hpp"
+#include "objLoader.hpp"
+
+namespace cr{
+
+///// constants
+// quads, negative indices, texture and normal indices, comments and windows line breaks
+const std::string HANDWRITTEN_OBJ =
+    "# a quad and a triangle\r\n"
+    "mtllib none.mtl\n"
+    "o quad\n"
+    "v 0 0 0\n"
+    "v +1.0 0 0\r\n"
+    "  v 1 1e0 0\n"
+    "v 0 1 -0.5\n"
+    "vt 0 0\n"
+    "vn 0 0 1\n"
+    "s off\n"
+    "f 1/1/1 2/1/1 3/1/1 4/1/1\n"
+    "g triangle\n"
+    "usemtl none\n"
+    "v 2 2 2\n"
+    "f -1//1 -4//1 -3//1\r\n"
+    "f 5 1 2";
+const std::vector<glm::vec3> EXPECTED_VERTICES = {
+    {0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}, {1.f, 1.f, 0.f}, {0.f, 1.f, -0.5f}, {2.f, 2.f, 2.f}
+};
+const std::vector<uint32_t> EXPECTED_INDICES = {0, 1, 2, 0, 2, 3, 4, 1, 2, 4, 0, 1};
+
+
+///// helpers
+std::string writeTemporaryFile(const std::string& name, const std::string& content){
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    FILE* file = fopen(path.c_str(), "wb");
+    assert(file != nullptr);
+    fwrite(content.data(), 1, content.size(), file);
+    fclose(file);
+    return path;
+}
+
+// the positions and the triangles read by tinyobj
+MeshPtr loadTinyObj(const std::string& path){
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+    bool isLoaded = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str());
+    assert(isLoaded);
+    MeshPtr mesh = MeshPtr(new Mesh());
+    for(size_t v=0; v<attrib.vertices.size(); v+=3){
+        mesh->_Vertices.push_back({attrib.vertices[v], attrib.vertices[v + 1], attrib.vertices[v + 2]});
+    }
+    for(const tinyobj::shape_t& shape : shapes){
+        for(const tinyobj::index_t& index : shape.mesh.indices){
+            mesh->_Indices.push_back(static_cast<uint32_t>(index.vertex_index));
+        }
+    }
+    return mesh;
+}
+
+
+///// tests
+void testHandwritten(){
+    fprintf(stderr, "\nBegin test: handwritten obj...\n");
+    std::string path = writeTemporaryFile("testObjLoader.obj", HANDWRITTEN_OBJ);
+    // the result doesn't depend on where the file is cut
+    for(uint32_t nbChunks : {1, 2, 3, 7, 64}){
+        MeshPtr mesh = ObjLoader::load(path, nbChunks);
+        assert(mesh->_Vertices == EXPECTED_VERTICES);
+        assert(mesh->_Indices == EXPECTED_INDICES);
+    }
+    std::filesystem::remove(path);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testOutOfRangeIndex(){
+    fprintf(stderr, "\nBegin test: out of range index...\n");
+    // 2^32 + 1 would wrap to the first vertex
+    std::string path = writeTemporaryFile("testObjLoader_range.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4294967297\n");
+    ErrorHandler::setRecoverable(true);
+    bool isRejected = false;
+    try {
+        ObjLoader::load(path);
+    } catch(const FatalError&){
+        isRejected = true;
+    }
+    ErrorHandler::setRecoverable(false);
+    assert(isRejected);
+    std::filesystem::remove(path);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testSameAsTinyObj(){
+    fprintf(stderr, "\nBegin test: same as tinyobj...\n");
+    for(const char* name : {"teapot.obj", "stanford-bunny.obj", "suzanne.obj"}){
+        std::string path = Mesh::MODELS_DIRECTORY + name;
+        MeshPtr expected = loadTinyObj(path);
+        for(uint32_t nbChunks : {0, 16}){
+            MeshPtr mesh = ObjLoader::load(path, nbChunks);
+            assert(mesh->_Vertices == expected->_Vertices);
+            assert(mesh->_Indices == expected->_Indices);
+        }
+        fprintf(stderr, "\t%s: %zu triangles, %zu vertices\n", name, expected->getNbTriangles(), expected->_Vertices.size());
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    testHandwritten();
+    testOutOfRangeIndex();
+    testSameAsTinyObj();
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <glm/ext.hpp>
+
+#include "sceneGraph.hpp"
+
+namespace cr{
+
+///// constants
+const uint32_t NB_NODES = 50000;
+// a fraction of the nodes is animated every frame
+const uint32_t NB_ANIMATED_NODES = 5000;
+const uint32_t NB_FRAMES = 20;
+const float MATRIX_TOLERANCE = 1e-4f;
+
+
+///// helpers
+glm::mat4 getRandomMatrix(std::mt19937& gen){
+    std::uniform_real_distribution<float> distrib(-1.f, 1.f);
+    glm::mat4 matrix = glm::translate(glm::mat4(1.f), glm::vec3(distrib(gen), distrib(gen), distrib(gen)));
+    matrix = glm::rotate(matrix, distrib(gen), glm::normalize(glm::vec3(distrib(gen), distrib(gen), distrib(gen)) + glm::vec3(0.f, 2.f, 0.f)));
+    return glm::scale(matrix, glm::vec3(1.f + 0.01f * distrib(gen)));
+}
+
+// a random forest, the parent of a node is one of the nodes before it
+SceneGraph initGraph(std::mt19937& gen, uint32_t nbNodes){
+    SceneGraph graph = SceneGraph();
+    for(uint32_t node=0; node<nbNodes; node++){
+        uint32_t parent = node == 0 || gen() % 10 == 0 ? SceneGraph::NO_PARENT : gen() % node;
+        graph.addNode(getRandomMatrix(gen), parent);
+    }
+    return graph;
+}
+
+// walks up the parents
+glm::mat4 getExpectedWorldMatrix(const SceneGraph& graph, uint32_t node){
+    glm::mat4 world = graph.getLocalMatrix(node);
+    for(uint32_t parent = graph.getParent(node); parent != SceneGraph::NO_PARENT; parent = graph.getParent(parent)){
+        world = graph.getLocalMatrix(parent) * world;
+    }
+    return world;
+}
+
+bool isSameMatrix(const glm::mat4& m1, const glm::mat4& m2){
+    for(uint32_t i=0; i<4; i++){
+        if(glm::length(m1[i] - m2[i]) > MATRIX_TOLERANCE * (1.f + glm::length(m2[i]))){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isDescendant(const SceneGraph& graph, uint32_t node, uint32_t ancestor){
+    for(; node != SceneGraph::NO_PARENT; node = graph.getParent(node)){
+        if(node == ancestor){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+///// tests
+void testHierarchy(){
+    fprintf(stderr, "\nBegin test: hierarchy...\n");
+    SceneGraph graph = SceneGraph();
+    glm::mat4 translation = glm::translate(glm::mat4(1.f), glm::vec3(1.f, 2.f, 3.f));
+    glm::mat4 rotation = glm::rotate(glm::mat4(1.f), 0.5f, glm::vec3(0.f, 1.f, 0.f));
+    uint32_t root = graph.addNode(translation);
+    uint32_t child = graph.addNode(rotation, root);
+    uint32_t grandChild = graph.addNode(translation, child);
+    uint32_t other = graph.addNode(rotation);
+    assert(graph.isDirty());
+    assert(graph.updateWorldMatrices().size() == 4);
+    assert(!graph.isDirty());
+    assert(graph.getWorldMatrix(grandChild) == translation * rotation * translation);
+    assert(graph.getWorldMatrix(other) == rotation);
+
+    // nothing to do until a node moves
+    assert(graph.updateWorldMatrices().empty());
+    graph.setLocalMatrix(child, translation);
+    std::vector<uint32_t> updatedNodes = graph.updateWorldMatrices();
+    assert((updatedNodes == std::vector<uint32_t>{child, grandChild}));
+    assert(graph.getWorldMatrix(grandChild) == translation * translation * translation);
+    assert(graph.getWorldMatrix(root) == translation);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testDirtySubtrees(){
+    fprintf(stderr, "\nBegin test: dirty subtrees...\n");
+    std::mt19937 gen(42);
+    SceneGraph graph = initGraph(gen, NB_NODES);
+    graph.updateWorldMatrices();
+    for(uint32_t node=0; node<NB_NODES; node++){
+        assert(isSameMatrix(graph.getWorldMatrix(node), getExpectedWorldMatrix(graph, node)));
+    }
+
+    // only the subtrees of the moved nodes are computed again, the first nodes have the largest ones
+    std::vector<uint32_t> movedNodes = {
+        static_cast<uint32_t>(gen() % 10), static_cast<uint32_t>(gen() % 100), static_cast<uint32_t>(gen() % NB_NODES)
+    };
+    for(uint32_t node : movedNodes){
+        graph.setLocalMatrix(node, getRandomMatrix(gen));
+    }
+    std::vector<uint32_t> updatedNodes = graph.updateWorldMatrices();
+    uint32_t nbExpected = 0;
+    for(uint32_t node=0; node<NB_NODES; node++){
+        bool isMoved = false;
+        for(uint32_t movedNode : movedNodes){
+            isMoved |= isDescendant(graph, node, movedNode);
+        }
+        nbExpected += isMoved ? 1 : 0;
+        assert(isSameMatrix(graph.getWorldMatrix(node), getExpectedWorldMatrix(graph, node)));
+    }
+    fprintf(stderr, "\t%zu nodes updated out of %u\n", updatedNodes.size(), NB_NODES);
+    assert(updatedNodes.size() == nbExpected);
+    assert(std::is_sorted(updatedNodes.begin(), updatedNodes.end()));
+    fprintf(stderr, "\tOk\n");
+}
+
+void testAnimation(){
+    fprintf(stderr, "\nBegin test: animation...\n");
+    std::mt19937 gen(7);
+    SceneGraph graph = initGraph(gen, NB_NODES);
+    graph.updateWorldMatrices();
+    std::vector<glm::mat4> matrices(NB_ANIMATED_NODES);
+    for(glm::mat4& matrix : matrices){
+        matrix = getRandomMatrix(gen);
+    }
+
+    double totalTime = 0.;
+    for(uint32_t frame=0; frame<NB_FRAMES; frame++){
+        auto start = std::chrono::steady_clock::now();
+        for(uint32_t i=0; i<NB_ANIMATED_NODES; i++){
+            graph.setLocalMatrix((frame * 7919 + i * 13) % NB_NODES, matrices[i]);
+        }
+        graph.updateWorldMatrices();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        totalTime += elapsed.count();
+    }
+    fprintf(stderr, "\t%u animated nodes out of %u: %.3f ms per frame\n", NB_ANIMATED_NODES, NB_NODES, totalTime / NB_FRAMES);
+    for(uint32_t node=0; node<NB_NODES; node++){
+        assert(isSameMatrix(graph.getWorldMatrix(node), getExpectedWorldMatrix(graph, node)));
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace cr;
+
+///// main
+int main() {
+    testHierarchy();
+    testDirtySubtrees();
+    testAnimation();
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+
+#include <glm/ext.hpp>
+
+#include "application.hpp"
+
+namespace glr{
+
+///// constants
+const GLuint VERTICES_BINDING = 1;
+const GLuint MATERIALS_BINDING = 2;
+const GLuint TRIANGLES_BINDING = 3;
+const GLuint MODELS_BINDING = 4;
+
+
+///// helpers
+ScenePtr initScene(){
+    ScenePtr scene = ScenePtr(new Scene());
+    scene->addMaterial({0.2, 0.3, 0.1, 1.});
+    scene->addMaterial({0.8, 0.8, 0.8, 1.});
+    cr::MeshPtr model = cr::Mesh::load(cr::Mesh::MODELS_DIRECTORY + "teapot.obj");
+    model->setMaterial(1);
+    scene->addMesh(model);
+    return scene;
+}
+
+// content of the buffer range bound to the given binding point
+template <typename T>
+std::vector<T> readSSBO(GLuint binding, size_t nbElements){
+    GLint ssbo = 0;
+    GLint64 offset = 0;
+    glGetIntegeri_v(GL_SHADER_STORAGE_BUFFER_BINDING, binding, &ssbo);
+    glGetInteger64i_v(GL_SHADER_STORAGE_BUFFER_START, binding, &offset);
+    assert(ssbo != 0);
+    std::vector<T> elements(nbElements);
+    glGetNamedBufferSubData(ssbo, offset, sizeof(T) * nbElements, elements.data());
+    return elements;
+}
+
+void checkMaterials(ScenePtr scene){
+    std::vector<cr::MaterialGPU> materials = readSSBO<cr::MaterialGPU>(MATERIALS_BINDING, scene->getNbMaterials());
+    for(uint32_t i=0; i<scene->getNbMaterials(); i++){
+        assert(materials[i]._Color == scene->getMaterialColor(i));
+    }
+}
+
+
+///// tests
+void testFirstUpload(ScenePtr scene, ProgramPtr program){
+    fprintf(stderr, "\nBegin test: first upload...\n");
+    assert(scene->isDirty());
+    scene->sendDataToGpu(program);
+    assert(!scene->isDirty());
+    assert(scene->_Statistics._NbBLAS_Builds == 1 && scene->_Statistics._NbTLAS_Builds == 1);
+    // nothing beyond the used elements
+    size_t minBytes = sizeof(cr::MaterialGPU) * scene->getNbMaterials()
+        + sizeof(cr::TriangleGPU) * scene->getNbTriangles()
+        + sizeof(glm::vec3) * scene->getVertexToGPUData().size()
+        + sizeof(cr::MeshModelGPU) * scene->getNbInstances();
+    assert(scene->_Statistics._UploadedBytes > minBytes);
+    assert(scene->_Statistics._UploadedBytes < minBytes + sizeof(cr::BVH_NodeGPU) * 2 * (scene->getNbTriangles() + scene->getNbInstances()));
+    checkMaterials(scene);
+    std::vector<cr::TriangleGPU> triangles = readSSBO<cr::TriangleGPU>(TRIANGLES_BINDING, scene->getNbTriangles());
+    for(uint32_t i=0; i<scene->getNbTriangles(); i++){
+        for(uint32_t v=0; v<3; v++){
+            assert(triangles[i]._Indices[v] == scene->getTriangleToGPUData()[i]._Indices[v]);
+        }
+        assert(triangles[i]._MeshId == 0);
+    }
+    std::vector<glm::vec3> vertices = readSSBO<glm::vec3>(VERTICES_BINDING, scene->getVertexToGPUData().size());
+    assert(vertices == scene->getVertexToGPUData());
+    fprintf(stderr, "\tOk\n");
+}
+
+void testNothingChanged(ScenePtr scene, ProgramPtr program){
+    fprintf(stderr, "\nBegin test: nothing changed...\n");
+    uint32_t version = scene->getVersion();
+    scene->sendDataToGpu(program);
+    assert(scene->_Statistics._UploadedBytes == 0);
+    assert(scene->_Statistics._NbBLAS_Builds == 1 && scene->_Statistics._NbTLAS_Builds == 1);
+    assert(scene->getVersion() == version);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testMaterialEdit(ScenePtr scene, ProgramPtr program){
+    fprintf(stderr, "\nBegin test: material edit...\n");
+    uint32_t version = scene->getVersion();
+    scene->setMaterialColor(2, {0.1, 0.2, 0.9, 1.});
+    assert(scene->isDirty() && scene->getVersion() != version);
+    scene->sendDataToGpu(program);
+    fprintf(stderr, "\tuploaded %zu bytes in %.3f ms\n", scene->_Statistics._UploadedBytes, scene->_Statistics._UploadTime);
+    // a single material and no bvh
+    assert(scene->_Statistics._UploadedBytes == sizeof(cr::MaterialGPU));
+    assert(scene->_Statistics._NbBLAS_Builds == 1 && scene->_Statistics._NbTLAS_Builds == 1);
+    checkMaterials(scene);
+
+    // the range covers both edits
+    scene->setMaterialColor(1, {0.5, 0.5, 0.5, 1.});
+    scene->setMaterialColor(2, {0.9, 0.2, 0.1, 1.});
+    scene->sendDataToGpu(program);
+    assert(scene->_Statistics._UploadedBytes == 2 * sizeof(cr::MaterialGPU));
+    checkMaterials(scene);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testTransformEdit(ScenePtr scene, ProgramPtr program){
+    fprintf(stderr, "\nBegin test: transform edit...\n");
+    glm::mat4 model = glm::mat4(1.f);
+    model[3] = glm::vec4(0.5f, 0.f, 0.f, 1.f);
+    scene->setInstanceModel(0, model);
+    scene->sendDataToGpu(program);
+    // the model and the top level bvh, the triangles and the bvh of the mesh are left as they are
+    assert(scene->_Statistics._NbBLAS_Builds == 1 && scene->_Statistics._NbTLAS_Builds == 2);
+    assert(scene->_Statistics._UploadedBytes == sizeof(cr::MeshModelGPU) + sizeof(cr::BVH_NodeGPU) * (2 * scene->getNbInstances() - 1));
+    std::vector<cr::MeshModelGPU> models = readSSBO<cr::MeshModelGPU>(MODELS_BINDING, 1);
+    assert(models[0]._ModelMatrix == model && models[0]._InvModelMatrix == glm::inverse(model));
+
+    // a new material does not move anything, the models go to the next slice
+    GLint64 offset = 0;
+    glGetInteger64i_v(GL_SHADER_STORAGE_BUFFER_START, MODELS_BINDING, &offset);
+    scene->setInstanceMaterial(0, 2);
+    scene->sendDataToGpu(program);
+    assert(scene->_Statistics._UploadedBytes == sizeof(cr::MeshModelGPU));
+    assert(scene->_Statistics._NbBLAS_Builds == 1 && scene->_Statistics._NbTLAS_Builds == 2);
+    models = readSSBO<cr::MeshModelGPU>(MODELS_BINDING, 1);
+    assert(models[0]._MaterialId == 2 && models[0]._ModelMatrix == model);
+    GLint64 newOffset = 0;
+    glGetInteger64i_v(GL_SHADER_STORAGE_BUFFER_START, MODELS_BINDING, &newOffset);
+    assert(newOffset != offset);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testNewInstance(ScenePtr scene, ProgramPtr program){
+    fprintf(stderr, "\nBegin test: new instance...\n");
+    uint32_t nbTriangles = scene->getNbTriangles();
+    glm::mat4 model = glm::mat4(1.f);
+    model[3] = glm::vec4(-2.f, 0.f, 0.f, 1.f);
+    scene->addInstance(scene->getMesh(0), model, 1);
+    scene->sendDataToGpu(program);
+    // the geometry is shared, only the models and the top level bvh are sent
+    assert(scene->getNbMeshes() == 1 && scene->getNbInstances() == 2);
+    assert(scene->getNbTriangles() == nbTriangles);
+    assert(scene->_Statistics._NbBLAS_Builds == 1 && scene->_Statistics._NbTLAS_Builds == 3);
+    assert(scene->_Statistics._UploadedBytes == 2 * sizeof(cr::MeshModelGPU) + sizeof(cr::BVH_NodeGPU) * (2 * scene->getNbInstances() - 1));
+    std::vector<cr::MeshModelGPU> models = readSSBO<cr::MeshModelGPU>(MODELS_BINDING, 2);
+    assert(models[1]._ModelMatrix == model && models[1]._MaterialId == 1);
+    assert(models[1]._BVH_Root == models[0]._BVH_Root && models[1]._NbTriangles == nbTriangles);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testGroup(ScenePtr scene, ProgramPtr program){
+    fprintf(stderr, "\nBegin test: group...\n");
+    glm::mat4 groupModel = glm::mat4(1.f);
+    groupModel[3] = glm::vec4(0.f, 3.f, 0.f, 1.f);
+    glm::mat4 model = glm::mat4(1.f);
+    model[3] = glm::vec4(1.f, 0.f, 0.f, 1.f);
+    glm::mat4 scaledModel = glm::scale(glm::mat4(1.f), glm::vec3(2.f));
+    uint32_t group = scene->addGroup(groupModel);
+    scene->addInstance(scene->getMesh(0), model, 1, group);
+    scene->addInstance(scene->getMesh(0), scaledModel, 1, group);
+    scene->sendDataToGpu(program);
+    uint32_t nbTLAS_Builds = scene->_Statistics._NbTLAS_Builds;
+    std::vector<cr::MeshModelGPU> models = readSSBO<cr::MeshModelGPU>(MODELS_BINDING, 4);
+    assert(models[2]._ModelMatrix == groupModel * model);
+
+    // moving the group moves the instances below it, the others are left as they are
+    groupModel[3] = glm::vec4(0.f, -3.f, 0.f, 1.f);
+    scene->setNodeModel(group, groupModel);
+    assert(scene->isDirty());
+    scene->sendDataToGpu(program);
+    assert(scene->_Statistics._NbBLAS_Builds == 1 && scene->_Statistics._NbTLAS_Builds == nbTLAS_Builds + 1);
+    assert(scene->_Statistics._UploadedBytes == 4 * sizeof(cr::MeshModelGPU) + sizeof(cr::BVH_NodeGPU) * (2 * scene->getNbInstances() - 1));
+    std::vector<cr::MeshModelGPU> newModels = readSSBO<cr::MeshModelGPU>(MODELS_BINDING, 4);
+    assert(newModels[0]._ModelMatrix == models[0]._ModelMatrix && newModels[1]._ModelMatrix == models[1]._ModelMatrix);
+    assert(newModels[2]._ModelMatrix == groupModel * model);
+    assert(newModels[3]._ModelMatrix == groupModel * scaledModel);
+    assert(newModels[3]._InvModelMatrix == glm::inverse(groupModel * scaledModel));
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace glr;
+
+///// main
+int main() {
+    Application app = Application::dummyApplication();
+    ShaderPtr computeShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "raytracer.glsl", COMPUTE_SHADER));
+    ProgramPtr megakernel = ProgramPtr(new Program(computeShader));
+    ScenePtr scene = initScene();
+
+    testFirstUpload(scene, megakernel);
+    testNothingChanged(scene, megakernel);
+    testMaterialEdit(scene, megakernel);
+    testTransformEdit(scene, megakernel);
+    testNewInstance(scene, megakernel);
+    testGroup(scene, megakernel);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+#include "application.hpp"
+#include "radixSort.hpp"
+
+namespace glr{
+
+///// constants
+const uint32_t NB_KEY_BITS = 13;
+const uint32_t CAPACITY = 10 * RadixSort::PARTITION_SIZE + 123;
+
+
+///// helpers
+std::vector<uint32_t> initRandomKeys(uint32_t nbValues){
+    std::mt19937 gen(42);
+    // few distinct keys to check the stability
+    std::uniform_int_distribution<uint32_t> distrib(0, (1 << NB_KEY_BITS) - 1);
+    std::vector<uint32_t> keys(nbValues);
+    for(uint32_t i=0; i<nbValues; i++){
+        keys[i] = distrib(gen);
+    }
+    return keys;
+}
+
+void expectedSort(std::vector<uint32_t>& keys, std::vector<uint32_t>& payloads, uint32_t begin, uint32_t end){
+    std::vector<uint32_t> order(end - begin);
+    std::iota(order.begin(), order.end(), begin);
+    std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b){
+        return keys[a] < keys[b];
+    });
+    std::vector<uint32_t> sortedKeys(order.size());
+    std::vector<uint32_t> sortedPayloads(order.size());
+    for(size_t i=0; i<order.size(); i++){
+        sortedKeys[i] = keys[order[i]];
+        sortedPayloads[i] = payloads[order[i]];
+    }
+    std::copy(sortedKeys.begin(), sortedKeys.end(), keys.begin() + begin);
+    std::copy(sortedPayloads.begin(), sortedPayloads.end(), payloads.begin() + begin);
+}
+
+void runTest(RadixSort& radixSort, uint32_t nbValues, bool isPartitionLocal){
+    std::vector<uint32_t> keys = initRandomKeys(nbValues);
+    std::vector<uint32_t> payloads(nbValues);
+    std::iota(payloads.begin(), payloads.end(), 0);
+    glNamedBufferSubData(radixSort.getKeys(), 0, sizeof(uint32_t) * nbValues, keys.data());
+    glNamedBufferSubData(radixSort.getPayloads(), 0, sizeof(uint32_t) * nbValues, payloads.data());
+
+    radixSort.sort(nbValues, isPartitionLocal);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    std::vector<uint32_t> results(nbValues);
+    std::vector<uint32_t> resultPayloads(nbValues);
+    glGetNamedBufferSubData(radixSort.getKeys(), 0, sizeof(uint32_t) * nbValues, results.data());
+    glGetNamedBufferSubData(radixSort.getPayloads(), 0, sizeof(uint32_t) * nbValues, resultPayloads.data());
+
+    if(isPartitionLocal){
+        for(uint32_t begin=0; begin<nbValues; begin+=RadixSort::PARTITION_SIZE){
+            expectedSort(keys, payloads, begin, std::min(begin + RadixSort::PARTITION_SIZE, nbValues));
+        }
+    } else {
+        expectedSort(keys, payloads, 0, nbValues);
+    }
+
+    for(uint32_t i=0; i<nbValues; i++){
+        assert(results[i] == keys[i]);
+        assert(resultPayloads[i] == payloads[i]);
+    }
+}
+
+
+///// tests
+void testSmall(RadixSort& radixSort){
+    fprintf(stderr, "\nBegin test: small...\n");
+    runTest(radixSort, 100, false);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testGlobal(RadixSort& radixSort){
+    fprintf(stderr, "\nBegin test: global...\n");
+    runTest(radixSort, CAPACITY, false);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testPartitionLocal(RadixSort& radixSort){
+    fprintf(stderr, "\nBegin test: partition local...\n");
+    runTest(radixSort, CAPACITY, true);
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace glr;
+
+///// main
+int main() {
+    Application app = Application::dummyApplication();
+    RadixSort radixSort(CAPACITY, NB_KEY_BITS);
+
+    testSmall(radixSort);
+    testGlobal(radixSort);
+    testPartitionLocal(radixSort);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
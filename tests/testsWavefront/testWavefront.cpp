@@ -0,0 +1,157 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+
+#include "application.hpp"
+
+namespace glr{
+
+///// constants
+const uint32_t IMAGE_WIDTH = 256;
+const uint32_t IMAGE_HEIGHT = 256;
+const uint32_t NB_PIXELS = IMAGE_WIDTH * IMAGE_HEIGHT;
+const glm::vec4 BACKGROUND_COLOR = glm::vec4(0.f, 0.f, 0.f, 1.f);
+const glm::vec4 SKY_COLOR = glm::vec4(0.2f, 0.3f, 0.3f, 1.f);
+const uint32_t NB_BENCHMARK_FRAMES = 10;
+
+
+///// helpers
+GLuint initImage(){
+    GLuint texture = 0;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    assert(texture != 0);
+    glTextureStorage2D(texture, 1, GL_RGBA32F, IMAGE_WIDTH, IMAGE_HEIGHT);
+    glBindImageTexture(0, texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    return texture;
+}
+
+std::vector<glm::vec4> readImage(GLuint texture){
+    std::vector<glm::vec4> pixels(NB_PIXELS);
+    glGetTextureImage(texture, 0, GL_RGBA, GL_FLOAT, sizeof(glm::vec4) * NB_PIXELS, pixels.data());
+    return pixels;
+}
+
+UniformBufferPtr initFrameUBO(){
+    cr::Camera camera(glm::vec3(0.f, 0.f, -5.f), static_cast<float>(IMAGE_WIDTH) / IMAGE_HEIGHT);
+    FrameDataGPU frameData{};
+    frameData._Camera = camera.getGpuData();
+    UniformBufferPtr ubo = UniformBufferPtr(new UniformBuffer(sizeof(FrameDataGPU), 0));
+    ubo->update(&frameData, sizeof(FrameDataGPU));
+    return ubo;
+}
+
+ScenePtr initScene(){
+    ScenePtr scene = ScenePtr(new Scene());
+    scene->addMaterial({0.2, 0.3, 0.1, 1.});
+    // concave enough for the bounces to hit the mesh again
+    cr::MeshPtr model = cr::Mesh::load(cr::Mesh::MODELS_DIRECTORY + "teapot.obj");
+    model->setMaterial(1);
+    scene->addMesh(model);
+    return scene;
+}
+
+std::vector<glm::vec4> renderMegakernel(ProgramPtr program, GLuint texture){
+    program->use();
+    glDispatchCompute(IMAGE_WIDTH / 16, IMAGE_HEIGHT / 16, 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+    return readImage(texture);
+}
+
+std::vector<glm::vec4> renderWavefront(WavefrontTracerPtr tracer, GLuint texture){
+    tracer->render();
+    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+    return readImage(texture);
+}
+
+
+///// tests
+void testPrimaryVisibility(ProgramPtr megakernel, WavefrontTracerPtr tracer, GLuint texture){
+    fprintf(stderr, "\nBegin test: primary visibility...\n");
+    // without bounces the wavefront tracer sees the sky exactly where the megakernel misses
+    tracer->_Parameters._MaxDepth = 0;
+    std::vector<glm::vec4> reference = renderMegakernel(megakernel, texture);
+    std::vector<glm::vec4> wavefront = renderWavefront(tracer, texture);
+    uint32_t nbHits = 0;
+    for(uint32_t i=0; i<NB_PIXELS; i++){
+        bool referenceHit = reference[i] != BACKGROUND_COLOR;
+        bool wavefrontHit = glm::length(wavefront[i] - SKY_COLOR) > 1e-5f;
+        assert(referenceHit == wavefrontHit);
+        nbHits += referenceHit ? 1 : 0;
+    }
+    // the model covers part of the image
+    assert(nbHits > 0 && nbHits < NB_PIXELS);
+    fprintf(stderr, "\tOk\n");
+}
+
+void testBounces(WavefrontTracerPtr tracer, GLuint texture){
+    fprintf(stderr, "\nBegin test: bounces...\n");
+    // the queues drain without leaving invalid values in the image
+    tracer->_Parameters._MaxDepth = 4;
+    std::vector<glm::vec4> wavefront = renderWavefront(tracer, texture);
+    for(uint32_t i=0; i<NB_PIXELS; i++){
+        for(int c=0; c<3; c++){
+            assert(wavefront[i][c] >= 0.f && !std::isnan(wavefront[i][c]) && !std::isinf(wavefront[i][c]));
+        }
+    }
+    fprintf(stderr, "\tOk\n");
+}
+
+void testRaySorting(WavefrontTracerPtr tracer, GLuint texture){
+    fprintf(stderr, "\nBegin test: ray sorting...\n");
+    // the random numbers only depend on the pixel and the depth so the order of the rays does not change the image
+    tracer->_Parameters._MaxDepth = 4;
+    tracer->_Parameters._IsProfilingOn = true;
+    std::vector<glm::vec4> reference = {};
+    const char* names[] = {"none", "global", "tiles"};
+    for(RaySortingMode mode : {RAY_SORTING_NONE, RAY_SORTING_GLOBAL, RAY_SORTING_TILES}){
+        tracer->_Parameters._RaySorting = mode;
+        double sortTime = 0.;
+        double extensionTime = 0.;
+        std::vector<glm::vec4> wavefront = {};
+        for(uint32_t i=0; i<NB_BENCHMARK_FRAMES; i++){
+            wavefront = renderWavefront(tracer, texture);
+            sortTime += tracer->_Statistics._SortTime;
+            extensionTime += tracer->_Statistics._ExtensionTime;
+        }
+        fprintf(stderr, "\tsorting %s: sort %.3f ms, extension %.3f ms, total %.3f ms\n", 
+            names[mode],
+            sortTime / NB_BENCHMARK_FRAMES, 
+            extensionTime / NB_BENCHMARK_FRAMES,
+            (sortTime + extensionTime) / NB_BENCHMARK_FRAMES
+        );
+        if(mode == RAY_SORTING_NONE){
+            reference = wavefront;
+            continue;
+        }
+        for(uint32_t i=0; i<NB_PIXELS; i++){
+            assert(glm::length(wavefront[i] - reference[i]) < 1e-5f);
+        }
+    }
+    tracer->_Parameters._RaySorting = RAY_SORTING_NONE;
+    tracer->_Parameters._IsProfilingOn = false;
+    fprintf(stderr, "\tOk\n");
+}
+
+}
+
+using namespace glr;
+
+///// main
+int main() {
+    Application app = Application::dummyApplication();
+    GLuint texture = initImage();
+    UniformBufferPtr frameUBO = initFrameUBO();
+    SamplerBufferPtr samplerBuffer = SamplerBufferPtr(new SamplerBuffer(cr::SamplerPtr(new cr::Sampler())));
+
+    ShaderPtr computeShader = ShaderPtr(new Shader(Shader::SHADER_DIRECTORY + "raytracer.glsl", COMPUTE_SHADER));
+    ProgramPtr megakernel = ProgramPtr(new Program(computeShader));
+    ScenePtr scene = initScene();
+    scene->sendDataToGpu(megakernel);
+    WavefrontTracerPtr tracer = WavefrontTracerPtr(new WavefrontTracer(IMAGE_WIDTH, IMAGE_HEIGHT));
+
+    testPrimaryVisibility(megakernel, tracer, texture);
+    testBounces(tracer, texture);
+    testRaySorting(tracer, texture);
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file